@@ -26,7 +26,21 @@
 #include "private.h"
 
 static void linphone_buffer_destroy(LinphoneBuffer *buffer) {
+	if (buffer->content && !buffer->is_view) belle_sip_free(buffer->content);
+}
+
+// Makes sure the buffer owns an allocation of at least the given size, keeping the current one when it is large
+// enough so that a buffer refilled chunk after chunk does not reallocate each time.
+static void linphone_buffer_reserve(LinphoneBuffer *buffer, size_t capacity) {
+	if (buffer->is_view) {
+		buffer->content = NULL;
+		buffer->capacity = 0;
+		buffer->is_view = FALSE;
+	}
+	if (buffer->content && buffer->capacity >= capacity) return;
 	if (buffer->content) belle_sip_free(buffer->content);
+	buffer->content = reinterpret_cast<uint8_t *>(belle_sip_malloc(capacity));
+	buffer->capacity = capacity;
 }
 
 BELLE_SIP_DECLARE_NO_IMPLEMENTED_INTERFACES(LinphoneBuffer);
@@ -78,21 +92,20 @@ const uint8_t *linphone_buffer_get_content(const LinphoneBuffer *buffer) {
 }
 
 void linphone_buffer_set_content(LinphoneBuffer *buffer, const uint8_t *content, size_t size) {
+	linphone_buffer_reserve(buffer, size + 1);
 	buffer->size = size;
-	if (buffer->content) belle_sip_free(buffer->content);
-	buffer->content = reinterpret_cast<uint8_t *>(belle_sip_malloc(size + 1));
-	memcpy(buffer->content, content, size);
+	memmove(buffer->content, content, size);
 	((char *)buffer->content)[size] = '\0';
 }
 
 const char *linphone_buffer_get_string_content(const LinphoneBuffer *buffer) {
+	// The memory borrowed by a view is not NUL terminated, the string is read from a copy.
+	if (buffer->is_view) linphone_buffer_detach_view((LinphoneBuffer *)buffer);
 	return (const char *)buffer->content;
 }
 
 void linphone_buffer_set_string_content(LinphoneBuffer *buffer, const char *content) {
-	buffer->size = strlen(content);
-	if (buffer->content) belle_sip_free(buffer->content);
-	buffer->content = (uint8_t *)belle_sip_strdup(content);
+	linphone_buffer_set_content(buffer, (const uint8_t *)content, strlen(content));
 }
 
 size_t linphone_buffer_get_size(const LinphoneBuffer *buffer) {
@@ -106,3 +119,32 @@ void linphone_buffer_set_size(LinphoneBuffer *buffer, size_t size) {
 bool_t linphone_buffer_is_empty(const LinphoneBuffer *buffer) {
 	return (buffer->size == 0) ? TRUE : FALSE;
 }
+
+LinphoneBuffer *linphone_buffer_new_view(const uint8_t *data, size_t size) {
+	LinphoneBuffer *buffer = linphone_buffer_new();
+	buffer->content = (uint8_t *)data;
+	buffer->size = size;
+	buffer->is_view = TRUE;
+	return buffer;
+}
+
+void linphone_buffer_detach_view(LinphoneBuffer *buffer) {
+	if (!buffer->is_view) return;
+	const uint8_t *data = buffer->content;
+	size_t size = buffer->size;
+	buffer->content = reinterpret_cast<uint8_t *>(belle_sip_malloc(size + 1));
+	buffer->capacity = size + 1;
+	buffer->is_view = FALSE;
+	if (size > 0) memcpy(buffer->content, data, size);
+	((char *)buffer->content)[size] = '\0';
+}
+
+void linphone_buffer_release_view(LinphoneBuffer *buffer) {
+	// The application kept a reference on the chunk, it must not outlive the memory it borrows.
+	if (linphone_buffer_is_shared(buffer)) linphone_buffer_detach_view(buffer);
+	linphone_buffer_unref(buffer);
+}
+
+bool_t linphone_buffer_is_shared(const LinphoneBuffer *buffer) {
+	return buffer->base.ref > 1 ? TRUE : FALSE;
+}
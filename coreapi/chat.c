@@ -61,6 +61,10 @@ const bctbx_list_t *linphone_core_get_chat_rooms(LinphoneCore *lc) {
 	return lc->chat_rooms;
 }
 
+bctbx_list_t *linphone_core_get_chat_rooms_range(LinphoneCore *lc, int begin, int end) {
+	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(L_GET_CPP_PTR_FROM_C_OBJECT(lc)->getChatRoomsRange(begin, end));
+}
+
 LinphoneChatRoom *linphone_core_create_client_group_chat_room(LinphoneCore *lc, const char *subject, bool_t fallback) {
 	return linphone_core_create_client_group_chat_room_2(lc, subject, fallback, FALSE);
 }
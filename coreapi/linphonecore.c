@@ -163,6 +163,7 @@ static void set_sip_network_reachable(LinphoneCore *lc, bool_t isReachable, time
 static void set_media_network_reachable(LinphoneCore *lc, bool_t isReachable);
 static void linphone_core_run_hooks(LinphoneCore *lc);
 static void linphone_core_zrtp_cache_close(LinphoneCore *lc);
+static LinphoneStatus _linphone_core_config_sync(LinphoneCore *core, bool_t in_background);
 void linphone_core_zrtp_cache_db_init(LinphoneCore *lc, const char *fileName);
 static LinphoneStatus
 _linphone_core_set_sip_transports(LinphoneCore *lc, const LinphoneSipTransports *tr_config, bool_t applyIt);
@@ -4463,7 +4464,7 @@ void linphone_core_iterate(LinphoneCore *lc) {
 	if (one_second_elapsed) {
 		bctbx_list_t *elem = NULL;
 		if (linphone_config_needs_commit(lc->config)) {
-			linphone_core_config_sync(lc);
+			_linphone_core_config_sync(lc, TRUE);
 		}
 		for (elem = lc->friends_lists; elem != NULL; elem = bctbx_list_next(elem)) {
 			LinphoneFriendList *list = (LinphoneFriendList *)elem->data;
@@ -7895,6 +7896,7 @@ void _linphone_core_stop_async_end(LinphoneCore *lc) {
 	// We have to disconnect mainDB later since sip_config_uninit iterates
 	L_GET_PRIVATE_FROM_C_OBJECT(lc)->disconnectMainDb();
 
+	linphone_config_flush_background_sync(lc->config);
 	if (linphone_config_needs_commit(lc->config)) linphone_core_config_sync(lc);
 
 	bctbx_list_for_each(lc->call_logs, (void (*)(void *))linphone_call_log_unref);
@@ -9756,6 +9758,35 @@ bctbx_list_t *linphone_core_get_conference_information_list_after_time(LinphoneC
 	return get_conference_information_list(core, time);
 }
 
+#ifndef _MSC_VER
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif // _MSC_VER
+void linphone_core_get_conference_information_list_async(LinphoneCore *core,
+                                                         time_t time,
+                                                         LinphoneCoreListCb callback,
+                                                         void *user_data) {
+#ifdef HAVE_DB_STORAGE
+	auto &mainDb = L_GET_PRIVATE_FROM_C_OBJECT(core)->mainDb;
+	if (mainDb) {
+		auto onResult = [core, callback, user_data](const std::list<std::shared_ptr<ConferenceInfo>> &result) {
+			// The conference infos are kept alive by the result during the callback.
+			bctbx_list_t *results = NULL;
+			for (const auto &conf : result)
+				results = bctbx_list_append(results, conf->toC());
+			callback(core, results, user_data);
+			bctbx_list_free(results);
+		};
+		mainDb->getConferenceInfosAsync(time, onResult);
+		return;
+	}
+#endif
+	L_GET_CPP_PTR_FROM_C_OBJECT(core)->doLater([core, callback, user_data]() { callback(core, NULL, user_data); });
+}
+#ifndef _MSC_VER
+#pragma GCC diagnostic pop
+#endif // _MSC_VER
+
 void linphone_core_delete_conference_information(LinphoneCore *core, LinphoneConferenceInfo *conference_info) {
 	CoreLogContextualizer logContextualizer(core);
 #ifdef HAVE_DB_STORAGE
@@ -9772,7 +9803,7 @@ bool_t linphone_core_ldap_available(BCTBX_UNUSED(LinphoneCore *core)) {
 #endif
 }
 
-LinphoneStatus linphone_core_config_sync(LinphoneCore *core) {
+static LinphoneStatus _linphone_core_config_sync(LinphoneCore *core, bool_t in_background) {
 	CoreLogContextualizer logContextualizer(core);
 #if TARGET_OS_IPHONE
 	auto helper = getPlatformHelpers(core)->getSharedCoreHelpers();
@@ -9782,9 +9813,18 @@ LinphoneStatus linphone_core_config_sync(LinphoneCore *core) {
 		return -1;
 	}
 #endif
+	if (in_background) {
+		/* Never block the core thread on disk, coalesce the changes made within the delay in a single write. */
+		int delay_ms = linphone_config_get_int(core->config, "misc", "config_sync_delay_ms", 1000);
+		return linphone_config_sync_in_background(core->config, delay_ms);
+	}
 	return linphone_config_sync(core->config);
 }
 
+LinphoneStatus linphone_core_config_sync(LinphoneCore *core) {
+	return _linphone_core_config_sync(core, FALSE);
+}
+
 bool_t linphone_core_empty_chatrooms_deletion_enabled(const LinphoneCore *core) {
 	return L_GET_CPP_PTR_FROM_C_OBJECT(core)->emptyChatroomsDeletionEnabled();
 }
@@ -45,6 +45,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #if !defined(_WIN32_WCE)
 #include <errno.h>
 #include <sys/stat.h>
@@ -89,14 +97,39 @@ typedef struct _LpSectionParam {
 	char *value;
 } LpSectionParam;
 
+/* Lookup indexes over the lists, which keep the file ordering. Keys point to the names owned by the indexed objects. */
+typedef std::unordered_map<std::string_view, LpItem *> LpItemIndex;
+typedef std::unordered_map<std::string_view, struct _LpSection *> LpSectionIndex;
+
 typedef struct _LpSection {
 	char *name;
 	bctbx_list_t *items;
+	LpItemIndex *items_index;
 	bctbx_list_t *params;
+	std::string *serialized; // Cached text of the section in the file, NULL when the section changed since.
 	bool_t overwrite; // If set to true, will add overwrite=true to all items of this section when converted to xml
 	bool_t skip;      // If set to true, won't be dumped when converted to xml
 } LpSection;
 
+/* Writes snapshots of the configuration to disk in a background thread. A snapshot posted while the previous one is
+ * still waiting for its delay replaces it. */
+typedef struct _LpConfigWriter {
+	std::thread thread;
+	std::mutex mutex; // Protects the fields below, up to the write mutex.
+	std::condition_variable cond;
+	std::string pending;
+	unsigned long long pending_seq = 0;
+	bool has_pending = false;
+	bool writing = false; // The thread took the pending snapshot and is writing it.
+	std::condition_variable written_cond;
+	bool stop = false;
+	std::chrono::steady_clock::time_point deadline;
+	unsigned long long next_seq = 0;
+	std::mutex write_mutex; // Serializes file writes, protects written_seq.
+	unsigned long long written_seq = 0;
+	std::atomic<int> write_status{0}; // Result of the last write when it failed, see linphone_config_write_file().
+} LpConfigWriter;
+
 struct _LpConfig {
 	belle_sip_object_t base;
 	bctbx_vfs_file_t *pFile;
@@ -104,7 +137,9 @@ struct _LpConfig {
 	char *tmpfilename;
 	char *factory_filename;
 	bctbx_list_t *sections;
+	LpSectionIndex *sections_index;
 	bctbx_vfs_t *g_bctbx_vfs;
+	LpConfigWriter *writer;
 	bool_t modified;
 	bool_t readonly;
 	bool_t abort_sync;
@@ -163,6 +198,7 @@ LpSectionParam *lp_section_param_new(const char *key, const char *value) {
 LpSection *lp_section_new(const char *name) {
 	LpSection *sec = lp_new0(LpSection, 1);
 	sec->name = ortp_strdup(name);
+	sec->items_index = new LpItemIndex();
 	return sec;
 }
 
@@ -185,31 +221,77 @@ void lp_section_destroy(LpSection *sec) {
 	bctbx_list_for_each(sec->items, lp_item_destroy);
 	bctbx_list_for_each(sec->params, lp_section_param_destroy);
 	bctbx_list_free(sec->items);
+	delete sec->items_index;
+	delete sec->serialized;
 	free(sec);
 }
 
+static void lp_section_set_dirty(LpSection *sec) {
+	delete sec->serialized;
+	sec->serialized = NULL;
+}
+
 void lp_section_add_item(LpSection *sec, LpItem *item) {
 	sec->items = bctbx_list_append(sec->items, (void *)item);
+	lp_section_set_dirty(sec);
+	/* The first item with a given key is the one looked up. */
+	if (!item->is_comment) sec->items_index->emplace(item->key, item);
 }
 
 void linphone_config_add_section(LpConfig *lpconfig, LpSection *section) {
 	lpconfig->sections = bctbx_list_append(lpconfig->sections, (void *)section);
+	if (!lpconfig->sections_index) lpconfig->sections_index = new LpSectionIndex();
+	lpconfig->sections_index->emplace(section->name, section);
 }
 
 void linphone_config_add_section_param(LpSection *section, LpSectionParam *param) {
 	section->params = bctbx_list_append(section->params, (void *)param);
+	lp_section_set_dirty(section);
 }
 
 void linphone_config_remove_section(LpConfig *lpconfig, LpSection *section) {
 	lpconfig->sections = bctbx_list_remove(lpconfig->sections, (void *)section);
+	auto it = lpconfig->sections_index->find(section->name);
+	if (it != lpconfig->sections_index->end() && it->second == section) {
+		lpconfig->sections_index->erase(it);
+		/* Index the next section with the same name, if any. */
+		for (bctbx_list_t *elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem)) {
+			LpSection *sec = (LpSection *)elem->data;
+			if (strcmp(sec->name, section->name) == 0) {
+				lpconfig->sections_index->emplace(sec->name, sec);
+				break;
+			}
+		}
+	}
 	lp_section_destroy(section);
 }
 
 void lp_section_remove_item(LpSection *sec, LpItem *item) {
 	sec->items = bctbx_list_remove(sec->items, (void *)item);
+	lp_section_set_dirty(sec);
+	if (!item->is_comment) {
+		auto it = sec->items_index->find(item->key);
+		if (it != sec->items_index->end() && it->second == item) {
+			sec->items_index->erase(it);
+			/* Index the next item with the same key, if any. */
+			for (bctbx_list_t *elem = sec->items; elem != NULL; elem = bctbx_list_next(elem)) {
+				LpItem *other = (LpItem *)elem->data;
+				if (!other->is_comment && strcmp(other->key, item->key) == 0) {
+					sec->items_index->emplace(other->key, other);
+					break;
+				}
+			}
+		}
+	}
 	lp_item_destroy(item);
 }
 
+static void linphone_config_clear_sections(LpConfig *lpconfig) {
+	if (lpconfig->sections) bctbx_list_free_with_data(lpconfig->sections, (bctbx_list_free_func)lp_section_destroy);
+	lpconfig->sections = NULL;
+	if (lpconfig->sections_index) lpconfig->sections_index->clear();
+}
+
 static bool_t is_first_char(const char *start, const char *pos) {
 	const char *p;
 	for (p = start; p < pos; p++) {
@@ -227,17 +309,9 @@ static int is_a_comment(const char *str) {
 }
 
 LpSection *linphone_config_find_section(const LpConfig *lpconfig, const char *name) {
-	LpSection *sec;
-	bctbx_list_t *elem = lpconfig->sections;
-	/*printf("Looking for section %s\n",name);*/
-	for (; elem != NULL; elem = bctbx_list_next(elem)) {
-		sec = (LpSection *)elem->data;
-		if (strcmp(sec->name, name) == 0) {
-			/*printf("Section %s found\n",name);*/
-			return sec;
-		}
-	}
-	return NULL;
+	if (!lpconfig->sections_index) return NULL;
+	auto it = lpconfig->sections_index->find(name);
+	return (it == lpconfig->sections_index->end()) ? NULL : it->second;
 }
 
 LpSectionParam *lp_section_find_param(const LpSection *sec, const char *key) {
@@ -267,17 +341,8 @@ LpItem *lp_section_find_comment(const LpSection *sec, const char *comment) {
 }
 
 LpItem *lp_section_find_item(const LpSection *sec, const char *name) {
-	bctbx_list_t *elem;
-	LpItem *item;
-	/*printf("Looking for item %s\n",name);*/
-	for (elem = sec->items; elem != NULL; elem = bctbx_list_next(elem)) {
-		item = (LpItem *)elem->data;
-		if (!item->is_comment && strcmp(item->key, name) == 0) {
-			/*printf("Item %s found\n",name);*/
-			return item;
-		}
-	}
-	return NULL;
+	auto it = sec->items_index->find(name);
+	return (it == sec->items_index->end()) ? NULL : it->second;
 }
 
 bctbx_list_t *lp_section_get_items(const LpSection *sec) {
@@ -387,6 +452,7 @@ static LpSection *linphone_config_parse_line(LpConfig *lpconfig, char *line, LpS
 							} else {
 								ortp_free(item->value);
 								item->value = ortp_strdup(pos1);
+								lp_section_set_dirty(cur);
 							}
 							/*ms_message("Found %s=%s",key,pos1);*/
 						} else {
@@ -446,9 +512,240 @@ LpConfig *linphone_config_new_from_buffer(const char *buffer) {
 	return conf;
 }
 
+/* Binary snapshot of the parsed configuration, stored next to the config file. As long as the config and factory files
+ * are unchanged, it is loaded instead of parsing them. It goes through the same VFS as the config file. */
+
+static bool_t snapshot_cache_enabled = FALSE;
+
+static const char lp_snapshot_magic[4] = {'L', 'P', 'C', 'S'};
+static const uint32_t lp_snapshot_version = 1;
+
+typedef struct _LpSnapshotSource {
+	uint64_t size;
+	int64_t mtime;
+	uint64_t hash;
+} LpSnapshotSource;
+
+typedef struct _LpSnapshotReader {
+	const char *pos;
+	const char *end;
+} LpSnapshotReader;
+
+void linphone_config_enable_snapshot_cache(bool_t enable) {
+	snapshot_cache_enabled = enable;
+}
+
+static uint64_t lp_snapshot_hash(const char *data, size_t size) {
+	/* FNV-1a */
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static bool_t linphone_config_read_whole_file(LpConfig *lpconfig, const char *path, std::string &content) {
+	bctbx_vfs_file_t *pFile = bctbx_file_open(lpconfig->g_bctbx_vfs, path, "r");
+	if (pFile == NULL) return FALSE;
+	int64_t size = bctbx_file_size(pFile);
+	bool_t ret = (size >= 0);
+	if (ret && size > 0) {
+		content.resize((size_t)size);
+		ret = (bctbx_file_read(pFile, &content[0], (size_t)size, 0) == (ssize_t)size);
+	}
+	bctbx_file_close(pFile);
+	return ret;
+}
+
+/* A missing file is described by zeroes. */
+static void linphone_config_describe_snapshot_source(LpConfig *lpconfig, const char *path, LpSnapshotSource *source) {
+	struct stat fileStat;
+	std::string content;
+	memset(source, 0, sizeof(*source));
+	if (path == NULL || stat(path, &fileStat) != 0) return;
+	if (!linphone_config_read_whole_file(lpconfig, path, content)) return;
+	source->size = content.size();
+	source->mtime = (int64_t)fileStat.st_mtime;
+	source->hash = lp_snapshot_hash(content.data(), content.size());
+}
+
+static void lp_snapshot_put(std::string &out, const void *data, size_t size) {
+	out.append((const char *)data, size);
+}
+
+static void lp_snapshot_put_u32(std::string &out, uint32_t value) {
+	lp_snapshot_put(out, &value, sizeof(value));
+}
+
+static void lp_snapshot_put_string(std::string &out, const char *value) {
+	uint32_t size = value ? (uint32_t)strlen(value) : 0;
+	lp_snapshot_put_u32(out, size);
+	if (size > 0) lp_snapshot_put(out, value, size);
+}
+
+static bool_t lp_snapshot_get(LpSnapshotReader *reader, void *data, size_t size) {
+	if ((size_t)(reader->end - reader->pos) < size) return FALSE;
+	memcpy(data, reader->pos, size);
+	reader->pos += size;
+	return TRUE;
+}
+
+static bool_t lp_snapshot_get_u32(LpSnapshotReader *reader, uint32_t *value) {
+	return lp_snapshot_get(reader, value, sizeof(*value));
+}
+
+static bool_t lp_snapshot_get_string(LpSnapshotReader *reader, std::string &value) {
+	uint32_t size;
+	if (!lp_snapshot_get_u32(reader, &size) || (size_t)(reader->end - reader->pos) < size) return FALSE;
+	value.assign(reader->pos, size);
+	reader->pos += size;
+	return TRUE;
+}
+
+static char *linphone_config_get_snapshot_filename(const LpConfig *lpconfig) {
+	return bctbx_strdup_printf("%s.snapshot", lpconfig->filename);
+}
+
+static void linphone_config_save_snapshot_cache(LpConfig *lpconfig) {
+	LpSnapshotSource sources[2];
+	linphone_config_describe_snapshot_source(lpconfig, lpconfig->filename, &sources[0]);
+	linphone_config_describe_snapshot_source(lpconfig, lpconfig->factory_filename, &sources[1]);
+
+	std::string payload;
+	lp_snapshot_put_string(payload, lpconfig->factory_filename);
+	lp_snapshot_put(payload, sources, sizeof(sources));
+	lp_snapshot_put_u32(payload, (uint32_t)bctbx_list_size(lpconfig->sections));
+	for (bctbx_list_t *elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem)) {
+		LpSection *sec = (LpSection *)elem->data;
+		lp_snapshot_put_string(payload, sec->name);
+		lp_snapshot_put_u32(payload, (uint32_t)bctbx_list_size(sec->params));
+		for (bctbx_list_t *it = sec->params; it != NULL; it = bctbx_list_next(it)) {
+			LpSectionParam *param = (LpSectionParam *)it->data;
+			lp_snapshot_put_string(payload, param->key);
+			lp_snapshot_put_string(payload, param->value);
+		}
+		lp_snapshot_put_u32(payload, (uint32_t)bctbx_list_size(sec->items));
+		for (bctbx_list_t *it = sec->items; it != NULL; it = bctbx_list_next(it)) {
+			LpItem *item = (LpItem *)it->data;
+			payload.push_back(item->is_comment ? 1 : 0);
+			lp_snapshot_put_string(payload, item->is_comment ? NULL : item->key);
+			lp_snapshot_put_string(payload, item->value);
+		}
+	}
+
+	std::string content;
+	lp_snapshot_put(content, lp_snapshot_magic, sizeof(lp_snapshot_magic));
+	lp_snapshot_put_u32(content, lp_snapshot_version);
+	uint64_t hash = lp_snapshot_hash(payload.data(), payload.size());
+	lp_snapshot_put(content, &hash, sizeof(hash));
+	content.append(payload);
+
+	char *filename = linphone_config_get_snapshot_filename(lpconfig);
+	char *tmpfilename = bctbx_strdup_printf("%s.tmp", filename);
+	bctbx_vfs_file_t *pFile = bctbx_file_open(lpconfig->g_bctbx_vfs, tmpfilename, "w");
+	if (pFile != NULL) {
+		ssize_t written = bctbx_file_write(pFile, content.data(), content.size(), 0);
+		bctbx_file_close(pFile);
+		if (written != (ssize_t)content.size()) {
+			ms_warning("Could not write config snapshot %s", tmpfilename);
+			remove(tmpfilename);
+		} else {
+#ifdef RENAME_REQUIRES_NONEXISTENT_NEW_PATH
+			remove(filename);
+#endif
+			if (rename(tmpfilename, filename) != 0)
+				ms_warning("Cannot rename %s into %s: %s", tmpfilename, filename, strerror(errno));
+		}
+	}
+	bctbx_free(tmpfilename);
+	bctbx_free(filename);
+}
+
+static bool_t linphone_config_load_snapshot_sections(LpConfig *lpconfig, LpSnapshotReader *reader) {
+	uint32_t sectionCount;
+	std::string key, value;
+	if (!lp_snapshot_get_u32(reader, &sectionCount)) return FALSE;
+	if (!lpconfig->sections_index) lpconfig->sections_index = new LpSectionIndex();
+	lpconfig->sections_index->reserve(sectionCount);
+	for (uint32_t i = 0; i < sectionCount; i++) {
+		uint32_t count;
+		if (!lp_snapshot_get_string(reader, value)) return FALSE;
+		LpSection *sec = lp_section_new(value.c_str());
+		/* Prepended then reversed, the lists are not walked at each insertion. */
+		lpconfig->sections = bctbx_list_prepend(lpconfig->sections, sec);
+		lpconfig->sections_index->emplace(sec->name, sec);
+
+		if (!lp_snapshot_get_u32(reader, &count)) return FALSE;
+		for (uint32_t j = 0; j < count; j++) {
+			if (!lp_snapshot_get_string(reader, key) || !lp_snapshot_get_string(reader, value)) return FALSE;
+			sec->params = bctbx_list_prepend(sec->params, lp_section_param_new(key.c_str(), value.c_str()));
+		}
+		sec->params = bctbx_list_reverse(sec->params);
+
+		if (!lp_snapshot_get_u32(reader, &count)) return FALSE;
+		sec->items_index->reserve(count);
+		for (uint32_t j = 0; j < count; j++) {
+			char isComment;
+			if (!lp_snapshot_get(reader, &isComment, 1) || !lp_snapshot_get_string(reader, key) ||
+			    !lp_snapshot_get_string(reader, value))
+				return FALSE;
+			LpItem *item = isComment ? lp_comment_new(value.c_str()) : lp_item_new(key.c_str(), value.c_str());
+			sec->items = bctbx_list_prepend(sec->items, item);
+			if (!item->is_comment) sec->items_index->emplace(item->key, item);
+		}
+		sec->items = bctbx_list_reverse(sec->items);
+	}
+	lpconfig->sections = bctbx_list_reverse(lpconfig->sections);
+	return reader->pos == reader->end;
+}
+
+static bool_t linphone_config_load_snapshot_cache(LpConfig *lpconfig) {
+	char *filename = linphone_config_get_snapshot_filename(lpconfig);
+	std::string content;
+	bool_t found = (bctbx_file_exist(filename) == 0) && linphone_config_read_whole_file(lpconfig, filename, content);
+	bctbx_free(filename);
+	if (!found) return FALSE;
+
+	LpSnapshotReader reader = {content.data(), content.data() + content.size()};
+	char magic[sizeof(lp_snapshot_magic)];
+	uint32_t version;
+	uint64_t hash;
+	if (!lp_snapshot_get(&reader, magic, sizeof(magic)) || memcmp(magic, lp_snapshot_magic, sizeof(magic)) != 0 ||
+	    !lp_snapshot_get_u32(&reader, &version) || version != lp_snapshot_version ||
+	    !lp_snapshot_get(&reader, &hash, sizeof(hash)) ||
+	    hash != lp_snapshot_hash(reader.pos, (size_t)(reader.end - reader.pos))) {
+		ms_warning("Ignoring invalid config snapshot of %s", lpconfig->filename);
+		return FALSE;
+	}
+
+	std::string factoryFilename;
+	LpSnapshotSource savedSources[2], sources[2];
+	if (!lp_snapshot_get_string(&reader, factoryFilename) ||
+	    factoryFilename != (lpconfig->factory_filename ? lpconfig->factory_filename : "") ||
+	    !lp_snapshot_get(&reader, savedSources, sizeof(savedSources)))
+		return FALSE;
+	linphone_config_describe_snapshot_source(lpconfig, lpconfig->filename, &sources[0]);
+	linphone_config_describe_snapshot_source(lpconfig, lpconfig->factory_filename, &sources[1]);
+	if (memcmp(sources, savedSources, sizeof(sources)) != 0) {
+		ms_message("Config snapshot of %s is outdated", lpconfig->filename);
+		return FALSE;
+	}
+
+	if (!linphone_config_load_snapshot_sections(lpconfig, &reader)) {
+		ms_warning("Could not load config snapshot of %s", lpconfig->filename);
+		linphone_config_clear_sections(lpconfig);
+		return FALSE;
+	}
+	ms_message("Config information loaded from snapshot of %s", lpconfig->filename);
+	return TRUE;
+}
+
 static int _linphone_config_init_from_files(LinphoneConfig *lpconfig, const char *config_filename) {
 	bool_t file_exists = FALSE;
 	bool_t tmp_file_exists = FALSE;
+	bool_t use_snapshot_cache = FALSE;
+	bool_t loaded_from_snapshot = FALSE;
 	lpconfig->g_bctbx_vfs = bctbx_vfs_get_default();
 
 	if (config_filename != NULL && config_filename[0] != '\0') {
@@ -499,13 +796,18 @@ static int _linphone_config_init_from_files(LinphoneConfig *lpconfig, const char
 			ms_warning("Simulating a read failure.");
 		}
 		if (lpconfig->pFile != NULL) {
-			int parsed_size = linphone_config_parse(lpconfig, lpconfig->pFile);
+			/* A temporary file left by a crash is never covered by the snapshot. */
+			use_snapshot_cache = snapshot_cache_enabled && !tmp_file_exists;
+			if (use_snapshot_cache) loaded_from_snapshot = linphone_config_load_snapshot_cache(lpconfig);
+			if (!loaded_from_snapshot) {
+				int parsed_size = linphone_config_parse(lpconfig, lpconfig->pFile);
+				if (parsed_size <= 0) {
+					ms_error("No parsed content from configuration file, parsed_size=[%i]", parsed_size);
+				}
+			}
 			bctbx_file_close(lpconfig->pFile);
 			lpconfig->pFile = NULL;
 			lpconfig->modified = FALSE;
-			if (parsed_size <= 0) {
-				ms_error("No parsed content from configuration file, parsed_size=[%i]", parsed_size);
-			}
 		} else if (file_exists || tmp_file_exists) {
 			ms_error("File [%s] exists but cannot be opened ! ", lpconfig->filename);
 			/* This is a major failure: throw an error as it is dangerous to go further.
@@ -513,7 +815,10 @@ static int _linphone_config_init_from_files(LinphoneConfig *lpconfig, const char
 			goto fail;
 		}
 	}
-	_linphone_config_apply_factory_config(lpconfig);
+	if (!loaded_from_snapshot) {
+		_linphone_config_apply_factory_config(lpconfig);
+		if (use_snapshot_cache) linphone_config_save_snapshot_cache(lpconfig);
+	}
 	return 0;
 
 fail:
@@ -671,11 +976,16 @@ void lp_item_set_value(LpItem *item, const char *value) {
 	}
 }
 
+static void linphone_config_stop_writer(LpConfig *lpconfig);
+
 static void _linphone_config_uninit(LpConfig *lpconfig) {
+	linphone_config_stop_writer(lpconfig);
 	if (lpconfig->filename != NULL) ortp_free(lpconfig->filename);
 	if (lpconfig->tmpfilename) ortp_free(lpconfig->tmpfilename);
 	if (lpconfig->factory_filename) bctbx_free(lpconfig->factory_filename);
-	if (lpconfig->sections) bctbx_list_free_with_data(lpconfig->sections, (bctbx_list_free_func)lp_section_destroy);
+	linphone_config_clear_sections(lpconfig);
+	delete lpconfig->sections_index;
+	lpconfig->sections_index = NULL;
 }
 
 LpConfig *linphone_config_ref(LpConfig *lpconfig) {
@@ -860,6 +1170,7 @@ void linphone_config_set_string(LpConfig *lpconfig, const char *section, const c
 			if ((value != NULL) && (value[0] != '\0')) {
 				if (strcmp(value, item->value) == 0) return;
 				lp_item_set_value(item, value);
+				lp_section_set_dirty(sec);
 			} else {
 				lp_section_remove_item(sec, item);
 			}
@@ -969,67 +1280,57 @@ void linphone_config_set_skip_flag_for_section(LpConfig *lpconfig, const char *s
 	}
 }
 
-void lp_item_write(LpItem *item, LpConfig *lpconfig) {
-	int ret = -1;
+static void lp_item_serialize(LpItem *item, std::string &out) {
 	if (item->is_comment) {
-		ret = (int)bctbx_file_fprintf(lpconfig->pFile, 0, "%s\n", item->value);
-
+		out.append(item->value).append("\n");
 	} else if (item->value && item->value[0] != '\0') {
-		ret = (int)bctbx_file_fprintf(lpconfig->pFile, 0, "%s=%s\n", item->key, item->value);
-	}
-
-	else {
+		out.append(item->key).append("=").append(item->value).append("\n");
+	} else {
 		ms_warning("Not writing item %s to file, it is empty", item->key);
 	}
-	if (ret < 0) {
-		ms_error("lp_item_write : not writing item to file");
-	}
 }
 
-void lp_section_param_write(LpSectionParam *param, LpConfig *lpconfig) {
+static void lp_section_param_serialize(LpSectionParam *param, std::string &out) {
 	if (param->value && param->value[0] != '\0') {
-		bctbx_file_fprintf(lpconfig->pFile, 0, " %s=%s", param->key, param->value);
-
+		out.append(" ").append(param->key).append("=").append(param->value);
 	} else {
 		ms_warning("Not writing param %s to file, it is empty", param->key);
 	}
 }
 
-void lp_section_write(LpSection *sec, LpConfig *lpconfig) {
-
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "[%s", sec->name) < 0)
-		ms_error("lp_section_write : write error on %s", sec->name);
-	bctbx_list_for_each2(sec->params, (void (*)(void *, void *))lp_section_param_write, (void *)lpconfig);
+/* Only the sections which changed since the previous serialization are serialized again. */
+static const std::string &lp_section_serialize(LpSection *sec) {
+	if (sec->serialized) return *sec->serialized;
 
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "]\n") < 0) ms_error("lp_section_write : write error ");
-	bctbx_list_for_each2(sec->items, (void (*)(void *, void *))lp_item_write, (void *)lpconfig);
-
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "\n") < 0) ms_error("lp_section_write : write error");
+	std::string *out = new std::string("[");
+	out->append(sec->name);
+	for (bctbx_list_t *elem = sec->params; elem != NULL; elem = bctbx_list_next(elem))
+		lp_section_param_serialize((LpSectionParam *)elem->data, *out);
+	out->append("]\n");
+	for (bctbx_list_t *elem = sec->items; elem != NULL; elem = bctbx_list_next(elem))
+		lp_item_serialize((LpItem *)elem->data, *out);
+	out->append("\n");
+	sec->serialized = out;
+	return *out;
 }
 
-void linphone_config_simulate_read_failure(bool_t value) {
-	simulate_read_failure = value;
+static std::string linphone_config_serialize(LpConfig *lpconfig) {
+	std::string out;
+	for (bctbx_list_t *elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem))
+		out.append(lp_section_serialize((LpSection *)elem->data));
+	return out;
 }
 
-void linphone_config_simulate_crash_during_sync(LinphoneConfig *lpconfig, bool_t value) {
-	lpconfig->abort_sync = value;
-}
-
-LinphoneStatus linphone_config_sync(LpConfig *lpconfig) {
-	bctbx_vfs_file_t *pFile = NULL;
-	if (lpconfig->filename == NULL) return -1;
-	if (lpconfig->readonly) return 0;
-
+/* Returns -2 if the temporary file cannot be opened, -1 on other errors. Must be called with the write mutex held. */
+static int linphone_config_write_file(LpConfig *lpconfig, const std::string &content) {
 #ifndef _WIN32
 	/* don't create group/world-accessible files */
 	(void)umask(S_IRWXG | S_IRWXO);
 #endif
-	pFile = bctbx_file_open(lpconfig->g_bctbx_vfs, lpconfig->tmpfilename, "w");
-	lpconfig->pFile = pFile;
+	bctbx_vfs_file_t *pFile = bctbx_file_open(lpconfig->g_bctbx_vfs, lpconfig->tmpfilename, "w");
 	if (pFile == NULL) {
 		ms_warning("Could not write %s ! Maybe it is read-only. Configuration will not be saved.", lpconfig->filename);
-		lpconfig->readonly = TRUE;
-		return -1;
+		return -2;
 	}
 
 	if (lpconfig->abort_sync) {
@@ -1038,10 +1339,13 @@ LinphoneStatus linphone_config_sync(LpConfig *lpconfig) {
 		return -1;
 	}
 
-	bctbx_list_for_each2(lpconfig->sections, (void (*)(void *, void *))lp_section_write, (void *)lpconfig);
+	if (!content.empty() && bctbx_file_write(pFile, content.data(), content.size(), 0) < 0) {
+		ms_error("linphone_config_sync(): write error on %s", lpconfig->tmpfilename);
+		bctbx_file_close(pFile);
+		return -1;
+	}
 	bctbx_file_sync(pFile);
 	bctbx_file_close(pFile);
-	lpconfig->pFile = NULL;
 
 #ifdef RENAME_REQUIRES_NONEXISTENT_NEW_PATH
 	/* On windows, rename() does not accept that the newpath is an existing file, while it is accepted on Unix.
@@ -1052,15 +1356,151 @@ LinphoneStatus linphone_config_sync(LpConfig *lpconfig) {
 #endif
 	if (rename(lpconfig->tmpfilename, lpconfig->filename) != 0) {
 		ms_error("Cannot rename %s into %s: %s", lpconfig->tmpfilename, lpconfig->filename, strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+/* Writes the snapshot unless a more recent one was written meanwhile. */
+static int linphone_config_write_snapshot(LpConfig *lpconfig, const std::string &content, unsigned long long seq) {
+	LpConfigWriter *writer = lpconfig->writer;
+	std::lock_guard<std::mutex> writeLock(writer->write_mutex);
+	if (seq < writer->written_seq) return 0;
+	writer->written_seq = seq;
+	return linphone_config_write_file(lpconfig, content);
+}
+
+static void linphone_config_writer_run(LpConfig *lpconfig) {
+	LpConfigWriter *writer = lpconfig->writer;
+	std::unique_lock<std::mutex> lock(writer->mutex);
+	while (true) {
+		writer->cond.wait(lock, [writer] { return writer->stop || writer->has_pending; });
+		if (!writer->has_pending) break;
+		/* Let the next snapshots replace this one until its deadline, unless the config is being destroyed. */
+		writer->cond.wait_until(lock, writer->deadline, [writer] { return writer->stop; });
+		if (!writer->has_pending) continue;
+
+		std::string content = std::move(writer->pending);
+		unsigned long long seq = writer->pending_seq;
+		writer->pending.clear();
+		writer->has_pending = false;
+		writer->writing = true;
+		lock.unlock();
+		int ret = linphone_config_write_snapshot(lpconfig, content, seq);
+		if (ret != 0) {
+			/* The modified flag belongs to the core thread, linphone_config_needs_commit() reports the failure. */
+			ms_error("Could not write %s in the background, the changes will be synced again", lpconfig->filename);
+			writer->write_status = ret;
+		}
+		lock.lock();
+		writer->writing = false;
+		writer->written_cond.notify_all();
+	}
+}
+
+static LpConfigWriter *linphone_config_get_writer(LpConfig *lpconfig) {
+	if (!lpconfig->writer) lpconfig->writer = new LpConfigWriter();
+	return lpconfig->writer;
+}
+
+static void linphone_config_stop_writer(LpConfig *lpconfig) {
+	LpConfigWriter *writer = lpconfig->writer;
+	if (!writer) return;
+	if (writer->thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(writer->mutex);
+			writer->stop = true;
+		}
+		writer->cond.notify_one();
+		/* Pending changes are written before the thread exits. */
+		writer->thread.join();
+	}
+	delete writer;
+	lpconfig->writer = NULL;
+}
+
+void linphone_config_simulate_read_failure(bool_t value) {
+	simulate_read_failure = value;
+}
+
+void linphone_config_simulate_crash_during_sync(LinphoneConfig *lpconfig, bool_t value) {
+	lpconfig->abort_sync = value;
+}
+
+LinphoneStatus linphone_config_sync(LpConfig *lpconfig) {
+	if (lpconfig->filename == NULL) return -1;
+	if (lpconfig->readonly) return 0;
+
+	LpConfigWriter *writer = linphone_config_get_writer(lpconfig);
+	unsigned long long seq;
+	{
+		/* This snapshot supersedes the one waiting in the background, if any. */
+		std::lock_guard<std::mutex> lock(writer->mutex);
+		writer->pending.clear();
+		writer->has_pending = false;
+		writer->write_status = 0;
+		seq = ++writer->next_seq;
 	}
+	int ret = linphone_config_write_snapshot(lpconfig, linphone_config_serialize(lpconfig), seq);
+	if (ret == -2) lpconfig->readonly = TRUE;
+	if (ret != 0) return -1;
 	lpconfig->modified = FALSE;
 	return 0;
 }
 
+LinphoneStatus linphone_config_sync_in_background(LpConfig *lpconfig, int delay_ms) {
+	if (lpconfig->filename == NULL) return -1;
+	if (lpconfig->readonly) return 0;
+
+	LpConfigWriter *writer = linphone_config_get_writer(lpconfig);
+	if (writer->write_status == -2) {
+		/* Same as linphone_config_sync(), the changes stay uncommitted. */
+		lpconfig->readonly = TRUE;
+		return -1;
+	}
+	std::string content = linphone_config_serialize(lpconfig);
+	{
+		std::lock_guard<std::mutex> lock(writer->mutex);
+		if (!writer->has_pending)
+			writer->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms > 0 ? delay_ms : 0);
+		writer->pending = std::move(content);
+		writer->pending_seq = ++writer->next_seq;
+		writer->has_pending = true;
+		writer->write_status = 0;
+		if (!writer->thread.joinable()) writer->thread = std::thread(linphone_config_writer_run, lpconfig);
+	}
+	writer->cond.notify_one();
+	lpconfig->modified = FALSE;
+	return 0;
+}
+
+void linphone_config_flush_background_sync(LpConfig *lpconfig) {
+	LpConfigWriter *writer = lpconfig->writer;
+	if (!writer) return;
+	std::string content;
+	unsigned long long seq = 0;
+	{
+		std::unique_lock<std::mutex> lock(writer->mutex);
+		if (writer->has_pending) {
+			content = std::move(writer->pending);
+			seq = writer->pending_seq;
+			writer->pending.clear();
+			writer->has_pending = false;
+		}
+		/* Wait for a write in progress in the background thread. */
+		writer->written_cond.wait(lock, [writer] { return !writer->writing; });
+	}
+	if (seq != 0) {
+		int ret = linphone_config_write_snapshot(lpconfig, content, seq);
+		if (ret != 0) {
+			ms_error("Could not write %s, the changes will be synced again", lpconfig->filename);
+			writer->write_status = ret;
+		}
+	}
+}
+
 void linphone_config_reload(LinphoneConfig *lpconfig) {
-	bctbx_list_for_each(lpconfig->sections, (void (*)(void *))lp_section_destroy);
-	bctbx_list_free(lpconfig->sections);
-	lpconfig->sections = NULL;
+	linphone_config_clear_sections(lpconfig);
 	linphone_config_read_file(lpconfig, lpconfig->filename);
 }
 
@@ -1104,7 +1544,7 @@ void linphone_config_clean_section(LpConfig *lpconfig, const char *section) {
 }
 
 bool_t linphone_config_needs_commit(const LpConfig *lpconfig) {
-	return lpconfig->modified;
+	return lpconfig->modified || (lpconfig->writer && lpconfig->writer->write_status != 0);
 }
 
 static const char *DEFAULT_VALUES_SUFFIX = "_default_values";
@@ -530,6 +530,12 @@ void _linphone_chat_message_notify_new_message_reaction(LinphoneChatMessage *msg
 void _linphone_chat_message_notify_reaction_removed(LinphoneChatMessage *msg, const LinphoneAddress *address);
 void _linphone_chat_message_notify_participant_imdn_state_changed(LinphoneChatMessage *msg,
                                                                   const LinphoneParticipantImdnState *state);
+/* A view borrows its content, which must outlive it: release it with linphone_buffer_release_view(). */
+LinphoneBuffer *linphone_buffer_new_view(const uint8_t *data, size_t size);
+void linphone_buffer_detach_view(LinphoneBuffer *buffer);
+void linphone_buffer_release_view(LinphoneBuffer *buffer);
+bool_t linphone_buffer_is_shared(const LinphoneBuffer *buffer);
+
 void _linphone_chat_message_notify_file_transfer_recv(LinphoneChatMessage *msg,
                                                       LinphoneContent *content,
                                                       const LinphoneBuffer *buffer);
@@ -962,6 +968,11 @@ LinphoneVideoDefinition *linphone_factory_find_supported_video_definition_by_nam
 
 const char *_linphone_config_load_from_xml_string(LpConfig *lpc, const char *buffer);
 void _linphone_config_apply_factory_config(LpConfig *config);
+/* Same as linphone_config_sync() but the file is written by a background thread, at most delay_ms later. Changes
+ * synced again before that are written at once. */
+LinphoneStatus linphone_config_sync_in_background(LpConfig *lpconfig, int delay_ms);
+/* Writes at once the changes still waiting in the background, if any. */
+void linphone_config_flush_background_sync(LpConfig *lpconfig);
 
 SalCustomHeader *linphone_info_message_get_headers(const LinphoneInfoMessage *im);
 void linphone_info_message_set_headers(LinphoneInfoMessage *im, const SalCustomHeader *headers);
@@ -270,6 +270,8 @@ struct _LinphoneBuffer {
 	void *user_data;
 	uint8_t *content; /**< A pointer to the buffer content */
 	size_t size;      /**< The size of the buffer content */
+	size_t capacity;  /**< The size of the allocation behind content, 0 for a view */
+	bool_t is_view;   /**< The content is borrowed from the creator of the buffer and must not be freed */
 };
 
 BELLE_SIP_DECLARE_VPTR_NO_EXPORT(LinphoneBuffer);
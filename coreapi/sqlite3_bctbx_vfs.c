@@ -30,6 +30,280 @@
 
 #include "private.h"
 
+/************************ LOCKS AND SHARED MEMORY ***********************/
+/** The locks and the shared memory (wal-index) of a database file are kept in a node shared by all the connections
+of the process to this file. It lets several connections use the write-ahead log, and no unencrypted wal-index is
+written next to an encrypted database. The database must not be accessed by another process at the same time. */
+
+struct sqlite3_bctbx_node_t {
+	char *zName;
+	int nRef;
+	int eLock;                      /* Strongest lock held by a connection. */
+	int nShared;                    /* Number of connections holding at least a SHARED lock. */
+	int nShmRef;                    /* Number of connections using the shared memory. */
+	int szRegion;                   /* Size of the shared memory regions. */
+	int nRegion;                    /* Number of shared memory regions. */
+	char **apRegion;                /* Shared memory regions. */
+	int aShmLock[SQLITE_SHM_NLOCK]; /* -1 when locked exclusively, number of SHARED locks otherwise. */
+	sqlite3_bctbx_node_t *pNext;
+};
+
+static sqlite3_bctbx_node_t *sqlite3bctbx_nodes = NULL;
+
+static sqlite3_mutex *sqlite3bctbx_mutex(void) {
+	return sqlite3_mutex_alloc(SQLITE_MUTEX_STATIC_APP1);
+}
+
+/**
+ * Returns the node of the file fName, created if no other connection opened this file.
+ * @param  fName  full path of the database file.
+ * @return        the node, to release with sqlite3bctbx_nodeRelease.
+ */
+static sqlite3_bctbx_node_t *sqlite3bctbx_nodeAcquire(const char *fName) {
+	sqlite3_bctbx_node_t *pNode;
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	for (pNode = sqlite3bctbx_nodes; pNode != NULL && strcmp(pNode->zName, fName) != 0; pNode = pNode->pNext)
+		;
+	if (pNode == NULL) {
+		pNode = (sqlite3_bctbx_node_t *)bctbx_malloc0(sizeof(sqlite3_bctbx_node_t));
+		pNode->zName = bctbx_strdup(fName);
+		pNode->pNext = sqlite3bctbx_nodes;
+		sqlite3bctbx_nodes = pNode;
+	}
+	pNode->nRef++;
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	return pNode;
+}
+
+/* Must be called with the mutex held. */
+static void sqlite3bctbx_shmFree(sqlite3_bctbx_node_t *pNode) {
+	int i;
+	for (i = 0; i < pNode->nRegion; i++)
+		bctbx_free(pNode->apRegion[i]);
+	bctbx_free(pNode->apRegion);
+	pNode->apRegion = NULL;
+	pNode->nRegion = 0;
+}
+
+static void sqlite3bctbx_nodeRelease(sqlite3_bctbx_node_t *pNode) {
+	sqlite3_bctbx_node_t **ppNode;
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	if (--pNode->nRef == 0) {
+		for (ppNode = &sqlite3bctbx_nodes; *ppNode != pNode; ppNode = &(*ppNode)->pNext)
+			;
+		*ppNode = pNode->pNext;
+		sqlite3bctbx_shmFree(pNode);
+		bctbx_free(pNode->zName);
+		bctbx_free(pNode);
+	}
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+}
+
+/**
+ * Checks if another connection holds a RESERVED, PENDING or EXCLUSIVE lock on the file.
+ * @param  p       sqlite3_file file handle pointer.
+ * @param  pResOut set to 1 if such a lock is held, 0 otherwise.
+ * @return         SQLITE_OK
+ */
+static int sqlite3bctbx_CheckReservedLock(sqlite3_file *p, int *pResOut) {
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
+	*pResOut = 0;
+	if (pFile->pNode != NULL) {
+		sqlite3_mutex_enter(sqlite3bctbx_mutex());
+		*pResOut = pFile->pNode->eLock > SQLITE_LOCK_SHARED;
+		sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	}
+	return SQLITE_OK;
+}
+
+/**
+ * Upgrades the lock held by the connection on the file, following the rules of the unix VFS: any number of
+ * SHARED locks, at most one RESERVED lock beside them, and PENDING prevents new SHARED locks until the holder
+ * gets the EXCLUSIVE one.
+ * @param  p      sqlite3_file file handle pointer.
+ * @param  eLock  SQLITE_LOCK_SHARED, SQLITE_LOCK_RESERVED or SQLITE_LOCK_EXCLUSIVE
+ * @return        SQLITE_OK on success, SQLITE_BUSY if the lock is held by another connection.
+ */
+static int sqlite3bctbx_Lock(sqlite3_file *p, int eLock) {
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
+	sqlite3_bctbx_node_t *pNode = pFile->pNode;
+	int rc = SQLITE_OK;
+
+	if (pNode == NULL || pFile->eLock >= eLock) return SQLITE_OK;
+
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	if (pFile->eLock != pNode->eLock && (pNode->eLock >= SQLITE_LOCK_PENDING || eLock > SQLITE_LOCK_SHARED)) {
+		rc = SQLITE_BUSY;
+	} else {
+		if (pFile->eLock == SQLITE_LOCK_NONE) {
+			pNode->nShared++;
+			if (pNode->eLock == SQLITE_LOCK_NONE) pNode->eLock = SQLITE_LOCK_SHARED;
+			pFile->eLock = SQLITE_LOCK_SHARED;
+		}
+		if (eLock == SQLITE_LOCK_EXCLUSIVE && pNode->nShared > 1) {
+			pFile->eLock = pNode->eLock = SQLITE_LOCK_PENDING;
+			rc = SQLITE_BUSY;
+		} else if (eLock > SQLITE_LOCK_SHARED) {
+			pFile->eLock = pNode->eLock = eLock;
+		}
+	}
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	return rc;
+}
+
+/**
+ * Downgrades the lock held by the connection on the file.
+ * @param  p      sqlite3_file file handle pointer.
+ * @param  eLock  SQLITE_LOCK_SHARED or SQLITE_LOCK_NONE
+ * @return        SQLITE_OK
+ */
+static int sqlite3bctbx_Unlock(sqlite3_file *p, int eLock) {
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
+	sqlite3_bctbx_node_t *pNode = pFile->pNode;
+
+	if (pNode == NULL || pFile->eLock <= eLock) return SQLITE_OK;
+
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	if (pFile->eLock > SQLITE_LOCK_SHARED) pNode->eLock = SQLITE_LOCK_SHARED;
+	if (eLock == SQLITE_LOCK_NONE && --pNode->nShared == 0) pNode->eLock = SQLITE_LOCK_NONE;
+	pFile->eLock = eLock;
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	return SQLITE_OK;
+}
+
+/**
+ * Maps the region iRegion of the shared memory of the file, allocating it if bExtend is set.
+ * @param  p        sqlite3_file file handle pointer.
+ * @param  iRegion  index of the region
+ * @param  szRegion size of the regions
+ * @param  bExtend  allocate the region if it does not exist yet
+ * @param  pp       set to the region, or to NULL if it does not exist
+ * @return          SQLITE_OK on success, an SQLITE_IOERR code otherwise.
+ */
+static int sqlite3bctbx_ShmMap(sqlite3_file *p, int iRegion, int szRegion, int bExtend, void volatile **pp) {
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
+	sqlite3_bctbx_node_t *pNode = pFile->pNode;
+	int rc = SQLITE_OK;
+
+	*pp = NULL;
+	if (pNode == NULL) return SQLITE_IOERR_SHMMAP;
+
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	if (!pFile->bShmMapped) {
+		pFile->bShmMapped = 1;
+		pNode->nShmRef++;
+	}
+	if (pNode->nRegion > 0 && pNode->szRegion != szRegion) {
+		rc = SQLITE_IOERR_SHMSIZE;
+	} else if (iRegion >= pNode->nRegion && bExtend) {
+		char **apRegion = (char **)bctbx_realloc(pNode->apRegion, (size_t)(iRegion + 1) * sizeof(char *));
+		if (apRegion == NULL) {
+			rc = SQLITE_IOERR_NOMEM;
+		} else {
+			pNode->apRegion = apRegion;
+			pNode->szRegion = szRegion;
+			while (pNode->nRegion <= iRegion) {
+				pNode->apRegion[pNode->nRegion] = (char *)bctbx_malloc0((size_t)szRegion);
+				if (pNode->apRegion[pNode->nRegion] == NULL) {
+					rc = SQLITE_IOERR_NOMEM;
+					break;
+				}
+				pNode->nRegion++;
+			}
+		}
+	}
+	if (rc == SQLITE_OK && iRegion < pNode->nRegion) *pp = pNode->apRegion[iRegion];
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	return rc;
+}
+
+/* Must be called with the mutex held. */
+static void sqlite3bctbx_shmUnlock(sqlite3_bctbx_file_t *pFile, int offset, int n) {
+	sqlite3_bctbx_node_t *pNode = pFile->pNode;
+	int i;
+	for (i = offset; i < offset + n; i++) {
+		if (pFile->shmExclMask & (1 << i)) pNode->aShmLock[i] = 0;
+		else if (pFile->shmSharedMask & (1 << i)) pNode->aShmLock[i]--;
+	}
+	pFile->shmExclMask &= (unsigned short)~((1 << (offset + n)) - (1 << offset));
+	pFile->shmSharedMask &= (unsigned short)~((1 << (offset + n)) - (1 << offset));
+}
+
+/**
+ * Acquires or releases the shared memory locks offset to offset + n - 1.
+ * @param  p      sqlite3_file file handle pointer.
+ * @param  offset first lock
+ * @param  n      number of locks
+ * @param  flags  SQLITE_SHM_LOCK or SQLITE_SHM_UNLOCK, with SQLITE_SHM_SHARED or SQLITE_SHM_EXCLUSIVE
+ * @return        SQLITE_OK on success, SQLITE_BUSY if a lock is held by another connection.
+ */
+static int sqlite3bctbx_ShmLock(sqlite3_file *p, int offset, int n, int flags) {
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
+	sqlite3_bctbx_node_t *pNode = pFile->pNode;
+	unsigned short mask = (unsigned short)((1 << (offset + n)) - (1 << offset));
+	int rc = SQLITE_OK;
+	int i;
+
+	if (pNode == NULL) return SQLITE_IOERR_SHMLOCK;
+
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	if (flags & SQLITE_SHM_UNLOCK) {
+		sqlite3bctbx_shmUnlock(pFile, offset, n);
+	} else if (flags & SQLITE_SHM_SHARED) { /* SQLite only takes SHARED locks one by one. */
+		if ((pFile->shmSharedMask & mask) == 0) {
+			if (pNode->aShmLock[offset] < 0) {
+				rc = SQLITE_BUSY;
+			} else {
+				pNode->aShmLock[offset]++;
+				pFile->shmSharedMask |= mask;
+			}
+		}
+	} else {
+		for (i = offset; i < offset + n && rc == SQLITE_OK; i++) {
+			if ((pFile->shmExclMask & (1 << i)) == 0 && pNode->aShmLock[i] != 0) rc = SQLITE_BUSY;
+		}
+		if (rc == SQLITE_OK) {
+			for (i = offset; i < offset + n; i++)
+				pNode->aShmLock[i] = -1;
+			pFile->shmExclMask |= mask;
+		}
+	}
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	return rc;
+}
+
+/**
+ * Memory barrier between the accesses of the connections to the shared memory.
+ * @param  p  sqlite3_file file handle pointer.
+ */
+static void sqlite3bctbx_ShmBarrier(BCTBX_UNUSED(sqlite3_file *p)) {
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+}
+
+/**
+ * Releases the shared memory of the connection. When no connection uses it anymore it is freed: the next one
+ * rebuilds the wal-index from the write-ahead log.
+ * @param  p          sqlite3_file file handle pointer.
+ * @param  deleteFlag unused, the shared memory is never stored in a file.
+ * @return            SQLITE_OK
+ */
+static int sqlite3bctbx_ShmUnmap(sqlite3_file *p, BCTBX_UNUSED(int deleteFlag)) {
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
+	sqlite3_bctbx_node_t *pNode = pFile->pNode;
+
+	if (pNode == NULL || !pFile->bShmMapped) return SQLITE_OK;
+
+	sqlite3_mutex_enter(sqlite3bctbx_mutex());
+	sqlite3bctbx_shmUnlock(pFile, 0, SQLITE_SHM_NLOCK);
+	pFile->bShmMapped = 0;
+	if (--pNode->nShmRef == 0) sqlite3bctbx_shmFree(pNode);
+	sqlite3_mutex_leave(sqlite3bctbx_mutex());
+	return SQLITE_OK;
+}
+
+/************************ END OF LOCKS AND SHARED MEMORY ***********************/
+
 /**
  * Closes the file whose file descriptor is stored in the file handle p.
  * @param  p 	sqlite3_file file handle pointer.
@@ -40,6 +314,13 @@ static int sqlite3bctbx_Close(sqlite3_file *p) {
 	int ret;
 	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t *)p;
 
+	if (pFile->pNode != NULL) {
+		sqlite3bctbx_ShmUnmap(p, 0);
+		sqlite3bctbx_Unlock(p, SQLITE_LOCK_NONE);
+		sqlite3bctbx_nodeRelease(pFile->pNode);
+		pFile->pNode = NULL;
+	}
+
 	ret = bctbx_file_close(pFile->pbctbx_file);
 	if (!ret) {
 		return SQLITE_OK;
@@ -178,40 +459,6 @@ static int sqlite3bctbx_FileControl(BCTBX_UNUSED(sqlite3_file *p), BCTBX_UNUSED(
 	return SQLITE_NOTFOUND;
 }
 
-/**
- * The lock file mechanism is not used with this VFS : checking
- * the reserved lock is always OK.
- * @param  pUnused sqlite3_file file handle pointer.
- * @param  pResOut set to 0 since there is no lock mechanism.
- * @return         SQLITE_OK
- */
-static int sqlite3bctbx_nolockCheckReservedLock(BCTBX_UNUSED(sqlite3_file *pUnused), int *pResOut) {
-	*pResOut = 0;
-	return SQLITE_OK;
-}
-
-/**
- * The lock file mechanism is not used with this VFS : locking the file
- * is always OK.
- * @param  pUnused sqlite3_file file handle pointer.
- * @param  unused  unused
- * @return         SQLITE_OK
- */
-static int sqlite3bctbx_nolockLock(BCTBX_UNUSED(sqlite3_file *pUnused), BCTBX_UNUSED(int unused)) {
-	return SQLITE_OK;
-}
-
-/**
- * The lock file mechanism is not used with this VFS : unlocking the file
- * is always OK.
- * @param  pUnused sqlite3_file file handle pointer.
- * @param  unused  unused
- * @return         SQLITE_OK
- */
-static int sqlite3bctbx_nolockUnlock(BCTBX_UNUSED(sqlite3_file *pUnused), BCTBX_UNUSED(int unused)) {
-	return SQLITE_OK;
-}
-
 /**
  * Simply sync the file contents given through the file handle p
  * to the persistent media.
@@ -230,7 +477,7 @@ static int sqlite3bctbx_Sync(sqlite3_file *p, BCTBX_UNUSED(int flags)) {
 /**
  * Opens the file fName and populates the structure pointed by p
  * with the necessary io_methods
- * Methods not implemented for version 1 : xTruncate, xSectorSize.
+ * Methods not implemented : xSectorSize, xFetch, xUnfetch.
  * Initializes some fields in the p structure, some of which where already
  * initialized by SQLite.
  * @param  pVfs      sqlite3_vfs VFS pointer.
@@ -243,19 +490,23 @@ static int sqlite3bctbx_Sync(sqlite3_file *p, BCTBX_UNUSED(int flags)) {
 static int
 sqlite3bctbx_Open(BCTBX_UNUSED(sqlite3_vfs *pVfs), const char *fName, sqlite3_file *p, int flags, int *pOutFlags) {
 	static const sqlite3_io_methods sqlite3_bctbx_io = {
-	    1,                     /* iVersion         Structure version number */
+	    2,                     /* iVersion         Structure version number */
 	    sqlite3bctbx_Close,    /* xClose */
 	    sqlite3bctbx_Read,     /* xRead */
 	    sqlite3bctbx_Write,    /* xWrite */
 	    sqlite3bctbx_Truncate, /* xTruncate */
 	    sqlite3bctbx_Sync,
 	    sqlite3bctbx_FileSize,
-	    sqlite3bctbx_nolockLock,
-	    sqlite3bctbx_nolockUnlock,
-	    sqlite3bctbx_nolockCheckReservedLock,
+	    sqlite3bctbx_Lock,
+	    sqlite3bctbx_Unlock,
+	    sqlite3bctbx_CheckReservedLock,
 	    sqlite3bctbx_FileControl,
 	    NULL, /* xSectorSize */
-	    sqlite3bctbx_DeviceCharacteristics
+	    sqlite3bctbx_DeviceCharacteristics,
+	    sqlite3bctbx_ShmMap,
+	    sqlite3bctbx_ShmLock,
+	    sqlite3bctbx_ShmBarrier,
+	    sqlite3bctbx_ShmUnmap
 	    /*other function points follows, all NULL but not present in all sqlite3 versions.*/
 	};
 
@@ -289,6 +540,12 @@ sqlite3bctbx_Open(BCTBX_UNUSED(sqlite3_vfs *pVfs), const char *fName, sqlite3_fi
 		return SQLITE_CANTOPEN;
 	}
 
+	pFile->pNode = (flags & SQLITE_OPEN_MAIN_DB) ? sqlite3bctbx_nodeAcquire(fName) : NULL;
+	pFile->eLock = SQLITE_LOCK_NONE;
+	pFile->bShmMapped = 0;
+	pFile->shmSharedMask = 0;
+	pFile->shmExclMask = 0;
+
 	if (pOutFlags) {
 		*pOutFlags = flags;
 	}
@@ -36,6 +36,11 @@
 #define MAXPATHNAME 512
 #define BCTBX_SQLITE3_VFS "sqlite3bctbx_vfs"
 
+/**
+ * Lock and shared memory state of a database file, shared by all the connections of the process to this file.
+ */
+typedef struct sqlite3_bctbx_node_t sqlite3_bctbx_node_t;
+
 /**
  * sqlite3_bctbx_file_t VFS file structure.
  */
@@ -43,6 +48,11 @@ typedef struct sqlite3_bctbx_file_t sqlite3_bctbx_file_t;
 struct sqlite3_bctbx_file_t {
 	sqlite3_file base; /* Base class. Must be first. */
 	bctbx_vfs_file_t *pbctbx_file;
+	sqlite3_bctbx_node_t *pNode;  /* Set for main database files only. */
+	int eLock;                    /* Lock held by this connection: SQLITE_LOCK_NONE, SQLITE_LOCK_SHARED... */
+	int bShmMapped;               /* The connection uses the shared memory of the node. */
+	unsigned short shmSharedMask; /* Shared memory locks held by this connection. */
+	unsigned short shmExclMask;
 };
 
 /**
@@ -87,7 +97,9 @@ sqlite3_vfs *sqlite3_bctbx_vfs_create(void);
  * Registers sqlite3bctbx_vfs to SQLite VFS. If makeDefault is 1,
  * the VFS will be used by default.
  * Methods not implemented by sqlite3_bctbx_vfs_t are initialized to the one
- * used by the unix-none VFS where all locking file operations are no-ops.
+ * used by the unix-none VFS.
+ * File locks and the shared memory used by the write-ahead log are only kept in memory: they synchronize the
+ * connections of this process, the database files must not be accessed by another process at the same time.
  * @param  makeDefault  set to 1 to make the newly registered VFS be the default one, set to 0 instead.
  */
 void sqlite3_bctbx_vfs_register(int makeDefault);
@@ -150,6 +150,12 @@ linphone_proxy_config_is_server_config_changed(const LinphoneProxyConfig *obj);
 LINPHONE_PUBLIC LinphoneProxyConfigAddressComparisonResult
 linphone_proxy_config_address_equal(const LinphoneAddress *a, const LinphoneAddress *b);
 
+LINPHONE_PUBLIC LinphoneBuffer *linphone_buffer_new_view(const uint8_t *data, size_t size);
+LINPHONE_PUBLIC void linphone_buffer_release_view(LinphoneBuffer *buffer);
+
+LINPHONE_PUBLIC LinphoneStatus linphone_config_sync_in_background(LinphoneConfig *lpconfig, int delay_ms);
+LINPHONE_PUBLIC void linphone_config_flush_background_sync(LinphoneConfig *lpconfig);
+
 LINPHONE_PUBLIC MediaStream *linphone_call_get_stream(LinphoneCall *call, LinphoneStreamType type);
 LINPHONE_PUBLIC VideoStream *linphone_core_get_preview_stream(LinphoneCore *call);
 LINPHONE_PUBLIC bool_t linphone_call_get_all_muted(const LinphoneCall *call);
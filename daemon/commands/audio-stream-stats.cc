@@ -65,3 +65,15 @@ void AudioStreamStatsCommand::exec(Daemon *app, const string &args) {
 	resp.setBody(ev.getBody());
 	app->sendResponse(resp);
 }
+
+bool AudioStreamStatsCommand::execWithoutLock(Daemon *app, const string &args) {
+	int sid;
+	istringstream ist(args);
+	ist >> sid;
+	string body;
+	if (ist.fail() || !app->getAudioStreamStatsSnapshot(sid, body)) return false;
+	Response resp;
+	resp.setBody(body);
+	app->sendResponse(resp);
+	return true;
+}
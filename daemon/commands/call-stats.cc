@@ -70,8 +70,16 @@ void CallStatsCommand::exec(Daemon *app, const string &args) {
 		}
 	}
 
-	ostringstream ostr;
-	ostr << CallStatsEvent(app, call, linphone_call_get_audio_stats(call)).getBody();
-	ostr << CallStatsEvent(app, call, linphone_call_get_video_stats(call)).getBody();
-	app->sendResponse(Response(ostr.str(), Response::Ok));
+	app->sendResponse(Response(app->getCallStatsBody(call), Response::Ok));
+}
+
+bool CallStatsCommand::execWithoutLock(Daemon *app, const string &args) {
+	// The current call can only be looked up with the lock held.
+	int cid;
+	istringstream ist(args);
+	ist >> cid;
+	string body;
+	if (ist.fail() || !app->getCallStatsSnapshot(cid, body)) return false;
+	app->sendResponse(Response(body, Response::Ok));
+	return true;
 }
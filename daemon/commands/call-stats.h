@@ -28,6 +28,7 @@ public:
 	CallStatsCommand();
 
 	void exec(Daemon *app, const std::string &args) override;
+	bool execWithoutLock(Daemon *app, const std::string &args) override;
 };
 
 #endif // LINPHONE_DAEMON_COMMAND_CALL_STATS_H_
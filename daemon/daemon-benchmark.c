@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2010-2022 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Measures how many commands per second linphone-daemon answers, with several clients pipelining their commands. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+#include "ortp/ortp.h"
+
+#define REQUEST_ID_MARKER "Request-Id: "
+#define PIPELINE_DEPTH 32
+
+typedef struct _BenchmarkClient {
+	bctbx_pipe_t fd;
+	int sent;
+	int received;
+	/* End of the previous read, in case the marker was split between two reads. */
+	char tail[sizeof(REQUEST_ID_MARKER)];
+	size_t tail_size;
+} BenchmarkClient;
+
+#ifndef _WIN32
+
+static int send_commands(BenchmarkClient *client, const char *command, int count) {
+	char line[1024];
+	while (client->sent < count && client->sent - client->received < PIPELINE_DEPTH) {
+		int size = snprintf(line, sizeof(line), "#%i %s\n", client->sent, command);
+		if (bctbx_pipe_write(client->fd, (uint8_t *)line, size) < 0) return -1;
+		client->sent++;
+	}
+	return 0;
+}
+
+static int read_responses(BenchmarkClient *client) {
+	char buf[32768 + sizeof(REQUEST_ID_MARKER)];
+	const size_t marker_size = strlen(REQUEST_ID_MARKER);
+	memcpy(buf, client->tail, client->tail_size);
+	int ret = bctbx_pipe_read(client->fd, (uint8_t *)buf + client->tail_size, 32768);
+	if (ret <= 0) return -1;
+	size_t size = client->tail_size + (size_t)ret;
+
+	for (const char *pos = buf; (size_t)(pos - buf) + marker_size <= size; pos++) {
+		if (memcmp(pos, REQUEST_ID_MARKER, marker_size) == 0) client->received++;
+	}
+	client->tail_size = size < marker_size - 1 ? size : marker_size - 1;
+	memcpy(client->tail, buf + size - client->tail_size, client->tail_size);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	const char *command = "version";
+	int client_count = 1;
+	int command_count = 1000;
+	int i;
+
+	if (argc < 2) {
+		ortp_error("Usage: %s pipename [clients] [commands per client] [command]", argv[0]);
+		return 1;
+	}
+	if (argc > 2) client_count = atoi(argv[2]);
+	if (argc > 3) command_count = atoi(argv[3]);
+	if (argc > 4) command = argv[4];
+	if (client_count <= 0 || command_count <= 0) {
+		ortp_error("The numbers of clients and commands must be positive.");
+		return 1;
+	}
+
+	ortp_init();
+	ortp_set_log_level_mask(NULL, ORTP_MESSAGE | ORTP_WARNING | ORTP_ERROR | ORTP_FATAL);
+
+	BenchmarkClient *clients = (BenchmarkClient *)calloc((size_t)client_count, sizeof(BenchmarkClient));
+	struct pollfd *pfds = (struct pollfd *)calloc((size_t)client_count, sizeof(struct pollfd));
+	for (i = 0; i < client_count; i++) {
+		clients[i].fd = bctbx_client_pipe_connect(argv[1]);
+		if (clients[i].fd == (bctbx_pipe_t)-1) {
+			ortp_error("Could not connect to control pipe: %s", strerror(errno));
+			return -1;
+		}
+		pfds[i].fd = clients[i].fd;
+		pfds[i].events = POLLIN;
+	}
+
+	uint64_t start = bctbx_get_cur_time_ms();
+	int done = 0;
+	int failed = 0;
+	for (i = 0; i < client_count; i++) {
+		if (send_commands(&clients[i], command, command_count) < 0) failed = 1;
+	}
+	while (!failed && done < client_count) {
+		if (poll(pfds, (nfds_t)client_count, 5000) <= 0) {
+			ortp_error("No response from the daemon.");
+			failed = 1;
+			break;
+		}
+		for (i = 0; i < client_count; i++) {
+			BenchmarkClient *client = &clients[i];
+			if (!(pfds[i].revents & POLLIN)) continue;
+			if (read_responses(client) < 0 || send_commands(client, command, command_count) < 0) {
+				ortp_error("Connection to the daemon lost.");
+				failed = 1;
+				break;
+			}
+			if (client->received >= command_count) {
+				pfds[i].fd = -1; /* poll() ignores it */
+				done++;
+			}
+		}
+	}
+	uint64_t duration = bctbx_get_cur_time_ms() - start;
+
+	int total = 0;
+	for (i = 0; i < client_count; i++) {
+		total += clients[i].received;
+		bctbx_client_pipe_close(clients[i].fd);
+	}
+	printf("%i commands answered in %llu ms with %i clients: %.1f commands per second\n", total,
+	       (unsigned long long)duration, client_count, duration > 0 ? (double)total * 1000.0 / (double)duration : 0.0);
+	free(pfds);
+	free(clients);
+	return failed ? 1 : 0;
+}
+
+#else
+
+int main(int argc, char *argv[]) {
+	ortp_error("%s is not supported on Windows.", argc > 0 ? argv[0] : "linphone-daemon-benchmark");
+	return 1;
+}
+
+#endif
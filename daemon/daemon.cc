@@ -38,6 +38,7 @@
 #endif
 
 #ifndef _WIN32
+#include <fcntl.h>
 #include <poll.h>
 #endif
 
@@ -333,6 +334,7 @@ Daemon::Daemon(const char *config_path,
 	ms_mutex_init(&mMutex, NULL);
 	mServerFd = (bctbx_pipe_t)-1;
 	mChildFd = (bctbx_pipe_t)-1;
+	mReplyFd = (bctbx_pipe_t)-1;
 	if (pipe_path == NULL) {
 #ifdef HAVE_READLINE
 		const char *homedir = getenv("HOME");
@@ -345,7 +347,7 @@ Daemon::Daemon(const char *config_path,
 	} else {
 		mServerFd = bctbx_server_pipe_create_by_path(pipe_path);
 #ifndef _WIN32
-		listen(mServerFd, 2);
+		listen(mServerFd, SOMAXCONN);
 		fprintf(stdout, "Server unix socket created, path=%s fd=%i\n", pipe_path, (int)mServerFd);
 #else
 		fprintf(stdout, "Named pipe  created, path=%s fd=%p\n", pipe_path, mServerFd);
@@ -464,9 +466,42 @@ AudioStream *Daemon::findAudioStream(int id) {
 void Daemon::removeAudioStream(int id) {
 	map<int, AudioStreamAndOther *>::iterator it = mAudioStreams.find(id);
 	if (it != mAudioStreams.end()) {
-		mAudioStreams.erase(it);
 		delete (it->second);
+		mAudioStreams.erase(it);
 	}
+	lock_guard<mutex> lock(mSnapshotsMutex);
+	mAudioStreamStatsSnapshots.erase(id);
+}
+
+string Daemon::getCallStatsBody(LinphoneCall *call) {
+	ostringstream ostr;
+	LinphoneCallStats *stats = linphone_call_get_audio_stats(call);
+	if (stats) {
+		ostr << CallStatsEvent(this, call, stats).getBody();
+		linphone_call_stats_unref(stats);
+	}
+	stats = linphone_call_get_video_stats(call);
+	if (stats) {
+		ostr << CallStatsEvent(this, call, stats).getBody();
+		linphone_call_stats_unref(stats);
+	}
+	return ostr.str();
+}
+
+bool Daemon::getCallStatsSnapshot(int id, string &body) {
+	lock_guard<mutex> lock(mSnapshotsMutex);
+	auto it = mCallStatsSnapshots.find(id);
+	if (it == mCallStatsSnapshots.end()) return false;
+	body = it->second;
+	return true;
+}
+
+bool Daemon::getAudioStreamStatsSnapshot(int id, string &body) {
+	lock_guard<mutex> lock(mSnapshotsMutex);
+	auto it = mAudioStreamStatsSnapshots.find(id);
+	if (it == mAudioStreamStatsSnapshots.end()) return false;
+	body = it->second;
+	return true;
 }
 
 static bool compareCommands(const DaemonCommand *command1, const DaemonCommand *command2) {
@@ -567,6 +602,12 @@ bool Daemon::pullEvent() {
 void Daemon::callStateChanged(LinphoneCall *call, LinphoneCallState state, BCTBX_UNUSED(const char *msg)) {
 	queueEvent(new CallEvent(this, call, state));
 
+	if (state == LinphoneCallReleased) {
+		int id = updateCallId(call);
+		lock_guard<mutex> lock(mSnapshotsMutex);
+		mCallStatsSnapshots.erase(id);
+	}
+
 	if (state == LinphoneCallIncomingReceived && mAutoAnswer) {
 		linphone_call_accept(call);
 	}
@@ -577,6 +618,12 @@ void Daemon::messageReceived(BCTBX_UNUSED(LinphoneChatRoom *cr), LinphoneChatMes
 }
 
 void Daemon::callStatsUpdated(LinphoneCall *call, const LinphoneCallStats *stats) {
+	string body = getCallStatsBody(call);
+	{
+		lock_guard<mutex> lock(mSnapshotsMutex);
+		mCallStatsSnapshots[updateCallId(call)] = std::move(body);
+	}
+
 	if (mUseStatsEvents) {
 		/* don't queue periodical updates (3 per seconds for just bandwidth updates) */
 		if (!(_linphone_call_stats_get_updated(stats) & LINPHONE_CALL_STATS_PERIODICAL_UPDATE)) {
@@ -618,8 +665,13 @@ void Daemon::iterateStreamStats() {
 			OrtpEventType evt = ortp_event_get_type(ev);
 			if (evt == ORTP_EVENT_RTCP_PACKET_RECEIVED || evt == ORTP_EVENT_RTCP_PACKET_EMITTED) {
 				linphone_call_stats_fill(it->second->stats, &it->second->stream->ms, ev);
-				if (mUseStatsEvents)
-					mEventQueue.push(new AudioStreamStatsEvent(this, it->second->stream, it->second->stats));
+				AudioStreamStatsEvent *statsEvent = new AudioStreamStatsEvent(this, it->second->stream, it->second->stats);
+				{
+					lock_guard<mutex> lock(mSnapshotsMutex);
+					mAudioStreamStatsSnapshots[it->first] = statsEvent->getBody();
+				}
+				if (mUseStatsEvents) mEventQueue.push(statsEvent);
+				else delete statsEvent;
 			}
 			ortp_event_destroy(ev);
 		}
@@ -629,7 +681,7 @@ void Daemon::iterateStreamStats() {
 void Daemon::iterate() {
 	linphone_core_iterate(mLc);
 	iterateStreamStats();
-	if (mChildFd == (bctbx_pipe_t)-1) {
+	if (!hasClients()) {
 		if (!mEventQueue.empty()) {
 			Event *r = mEventQueue.front();
 			mEventQueue.pop();
@@ -641,40 +693,128 @@ void Daemon::iterate() {
 }
 
 void Daemon::execCommand(const string &command) {
-	istringstream ist(command);
-	string name;
-	ist >> name;
-	stringbuf argsbuf;
-	ist.get(argsbuf);
-	string args = argsbuf.str();
-	if (!args.empty() && (args[0] == ' ')) args.erase(0, 1);
-	list<DaemonCommand *>::iterator it =
-	    find_if(mCommands.begin(), mCommands.end(), [&name](const DaemonCommand *dc) { return dc->matches(name); });
-	if (it != mCommands.end()) {
-		ms_mutex_lock(&mMutex);
-		(*it)->exec(this, args);
-		ms_mutex_unlock(&mMutex);
-	} else {
-		sendResponse(Response("Unknown command."));
+	execRequests({DaemonRequest{mChildFd, "", command}});
+}
+
+void Daemon::execRequests(const list<DaemonRequest> &requests) {
+	// The lock is taken once for all the requests which need it, they are executed in order.
+	bool locked = false;
+	for (const auto &request : requests) {
+		istringstream ist(request.command);
+		string name;
+		ist >> name;
+		stringbuf argsbuf;
+		ist.get(argsbuf);
+		string args = argsbuf.str();
+		if (!args.empty() && (args[0] == ' ')) args.erase(0, 1);
+
+		mReplyFd = request.client;
+		mRequestId = request.id;
+		list<DaemonCommand *>::iterator it =
+		    find_if(mCommands.begin(), mCommands.end(), [&name](const DaemonCommand *dc) { return dc->matches(name); });
+		if (it == mCommands.end()) {
+			sendResponse(Response("Unknown command."));
+		} else if (locked || !(*it)->execWithoutLock(this, args)) {
+			if (!locked) {
+				ms_mutex_lock(&mMutex);
+				locked = true;
+			}
+			(*it)->exec(this, args);
+		}
 	}
+	if (locked) ms_mutex_unlock(&mMutex);
+	mReplyFd = (bctbx_pipe_t)-1;
+	mRequestId.clear();
 }
 
 void Daemon::sendResponse(const Response &resp) {
 	string buf = resp.toBuf();
-	if (mChildFd != (bctbx_pipe_t)-1) {
-		if (bctbx_pipe_write(mChildFd, (uint8_t *)buf.c_str(), (int)buf.size()) == -1) {
-			ms_error("Fail to write to pipe: %s", strerror(errno));
-		}
-	} else {
+	if (!mRequestId.empty()) buf = "Request-Id: " + mRequestId + "\n" + buf;
+	if (mReplyFd == (bctbx_pipe_t)-1) {
 		cout << buf << flush;
+		return;
+	}
+#ifndef _WIN32
+	// The socket of a client is non-blocking: a client which does not read its responses must not stall the others.
+	DaemonClient *client = findClient(mReplyFd);
+	if (!client) {
+		ms_warning("Dropping response to disconnected client.");
+		return;
+	}
+	if (client->broken) return;
+	client->output += buf;
+	flushClient(*client);
+#else
+	if (bctbx_pipe_write(mReplyFd, (uint8_t *)buf.c_str(), (int)buf.size()) == -1) {
+		ms_error("Fail to write to pipe: %s", strerror(errno));
+	}
+#endif
+}
+
+DaemonClient *Daemon::findClient(ortp_pipe_t fd) {
+	for (DaemonClient &client : mClients) {
+		if (client.fd == fd) return &client;
 	}
+	return nullptr;
+}
+
+void Daemon::flushClient(DaemonClient &client) {
+#ifndef _WIN32
+	// Maximum size of the responses waiting for a client, it is disconnected beyond.
+	const size_t maxOutputSize = 4 * 1024 * 1024;
+	while (!client.output.empty()) {
+		ssize_t ret = write(client.fd, client.output.data(), client.output.size());
+		if (ret < 0) {
+			if (errno == EINTR) continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				ms_error("Fail to write to pipe: %s", strerror(errno));
+				client.broken = true;
+			}
+			break;
+		}
+		client.output.erase(0, (size_t)ret);
+	}
+	if (client.output.size() > maxOutputSize) {
+		ms_error("Client does not read its responses, disconnecting it.");
+		client.broken = true;
+	}
+	if (client.broken) client.output.clear();
+#else
+	(void)client;
+#endif
 }
 
 void Daemon::queueEvent(Event *ev) {
 	mEventQueue.push(ev);
 }
 
-string Daemon::readPipe() {
+bool Daemon::hasClients() const {
+	return mChildFd != (bctbx_pipe_t)-1 || !mClients.empty();
+}
+
+void Daemon::readClient(ortp_pipe_t client, string &input, const string &data, list<DaemonRequest> &requests) {
+	// Each line is a command, the end of the data waits in input for the rest of its line.
+	input += data;
+	size_t begin = 0;
+	size_t end;
+	for (; (end = input.find('\n', begin)) != string::npos; begin = end + 1) {
+		string line = input.substr(begin, end - begin);
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (line.empty()) continue;
+		DaemonRequest request{client, "", line};
+		if (line[0] == '#') {
+			size_t pos = line.find(' ');
+			if (pos == string::npos) continue;
+			request.id = line.substr(1, pos - 1);
+			request.command = line.substr(pos + 1);
+		}
+		requests.push_back(std::move(request));
+	}
+	input.erase(0, begin);
+}
+
+list<DaemonRequest> Daemon::readPipe() {
+	list<DaemonRequest> requests;
 	char buffer[32768];
 	memset(buffer, '\0', sizeof(buffer));
 #ifdef _WIN32
@@ -683,7 +823,7 @@ string Daemon::readPipe() {
 		ms_message("Client accepted");
 	}
 	if (mChildFd != (bctbx_pipe_t)-1) {
-		int ret = bctbx_pipe_read(mChildFd, (uint8_t *)buffer, sizeof(buffer));
+		int ret = bctbx_pipe_read(mChildFd, (uint8_t *)buffer, sizeof(buffer) - 1);
 		if (ret == -1) {
 			ms_error("Fail to read from pipe: %s", strerror(errno));
 			mChildFd = (bctbx_pipe_t)-1;
@@ -691,59 +831,72 @@ string Daemon::readPipe() {
 			if (ret == 0) {
 				ms_message("Client disconnected");
 				mChildFd = (bctbx_pipe_t)-1;
-				return "";
+				return requests;
 			}
-			buffer[ret] = '\0';
-			return buffer;
+			// A read of the named pipe is a whole message, i.e. a single command when it has no line feed.
+			string data(buffer, (size_t)ret);
+			if (data.back() != '\n') data += '\n';
+			readClient(mChildFd, mChildInput, data, requests);
 		}
 	}
 #else
-	struct pollfd pfd[2];
-	int nfds = 1;
-	memset(&pfd[0], 0, sizeof(pfd));
-	if (mServerFd != (bctbx_pipe_t)-1) {
-		pfd[0].events = POLLIN;
-		pfd[0].fd = mServerFd;
-	}
-	if (mChildFd != (bctbx_pipe_t)-1) {
-		pfd[1].events = POLLIN;
-		pfd[1].fd = mChildFd;
-		nfds++;
+	// The server socket comes first, then one entry per client.
+	vector<struct pollfd> pfds(1 + mClients.size());
+	pfds[0].fd = mServerFd;
+	pfds[0].events = POLLIN;
+	size_t i = 1;
+	for (const DaemonClient &client : mClients) {
+		pfds[i].fd = client.fd;
+		pfds[i].events = client.output.empty() ? POLLIN : POLLIN | POLLOUT;
+		i++;
 	}
-	int err = poll(pfd, (nfds_t)nfds, 50);
-	if (err > 0) {
-		if (mServerFd != (bctbx_pipe_t)-1 && (pfd[0].revents & POLLIN)) {
-			struct sockaddr_storage addr;
-			socklen_t addrlen = sizeof(addr);
-			int childfd = accept(mServerFd, (struct sockaddr *)&addr, &addrlen);
-			if (childfd != -1) {
-				if (mChildFd != (bctbx_pipe_t)-1) {
-					ms_error("Cannot accept two client at the same time");
-					close(childfd);
-				} else {
-					mChildFd = (bctbx_pipe_t)childfd;
-					return "";
+	int err = poll(pfds.data(), (nfds_t)pfds.size(), 50);
+	if (err <= 0) return requests;
+
+	i = 1;
+	for (auto it = mClients.begin(); it != mClients.end(); i++) {
+		DaemonClient &client = *it;
+		if (pfds[i].revents & POLLOUT) flushClient(client);
+		if (!client.broken && (pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+			ssize_t ret = read(client.fd, buffer, sizeof(buffer));
+			if (ret > 0) {
+				// Clients which write one command per write without a line feed are still served: such a read is a
+				// whole command when nothing is buffered. Pipelined commands are split on line feeds.
+				string data(buffer, (size_t)ret);
+				if (client.input.empty() && data.find('\n') == string::npos) data += '\n';
+				readClient(client.fd, client.input, data, requests);
+				if (client.input.size() > sizeof(buffer)) {
+					ms_error("Command line too long, disconnecting client.");
+					client.broken = true;
 				}
-			}
-		}
-		if (mChildFd != (bctbx_pipe_t)-1 && (pfd[1].revents & POLLIN)) {
-			int ret;
-			if ((ret = bctbx_pipe_read(mChildFd, (uint8_t *)buffer, sizeof(buffer))) == -1) {
+			} else if (ret == 0) {
+				ms_message("Client disconnected");
+				client.broken = true;
+			} else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
 				ms_error("Fail to read from pipe: %s", strerror(errno));
-			} else {
-				if (ret == 0) {
-					ms_message("Client disconnected");
-					bctbx_server_pipe_close_client(mChildFd);
-					mChildFd = (bctbx_pipe_t)-1;
-					return "";
-				}
-				buffer[ret] = '\0';
-				return buffer;
+				client.broken = true;
 			}
 		}
+		if (!client.broken) {
+			++it;
+			continue;
+		}
+		bctbx_server_pipe_close_client(client.fd);
+		it = mClients.erase(it);
+	}
+
+	if (pfds[0].revents & POLLIN) {
+		struct sockaddr_storage addr;
+		socklen_t addrlen = sizeof(addr);
+		int childfd = accept(mServerFd, (struct sockaddr *)&addr, &addrlen);
+		if (childfd != -1) {
+			ms_message("Client accepted");
+			fcntl(childfd, F_SETFL, fcntl(childfd, F_GETFL) | O_NONBLOCK);
+			mClients.push_back(DaemonClient{(bctbx_pipe_t)childfd, "", "", false});
+		}
 	}
 #endif
-	return "";
+	return requests;
 }
 
 void Daemon::dumpCommandsHelp() {
@@ -844,6 +997,9 @@ static void printHelp() {
 	     << "\t--pipe <pipepath>          Create an unix server socket in the specified path to receive commands from. "
 	        "For Windows just use a name instead of a path."
 	     << endl
+	     << "\t                           Commands are separated by line feeds, a single command may omit it. A "
+	        "command prefixed with \"#<id> \" gets a response starting with \"Request-Id: <id>\"."
+	     << endl
 	     << "\t--log <path>               Supply a file where the log will be saved." << endl
 	     << "\t--factory-config <path>    Supply a readonly linphonerc style config file to start with." << endl
 	     << "\t--config <path>            Supply a linphonerc style config file to start with." << endl
@@ -894,11 +1050,10 @@ int Daemon::run() {
 				add_history(line.c_str());
 #endif
 			}
+			if (!line.empty()) execCommand(line);
 		} else {
-			line = readPipe();
-		}
-		if (!line.empty()) {
-			execCommand(line);
+			list<DaemonRequest> requests = readPipe();
+			if (!requests.empty()) execRequests(requests);
 		}
 		if (eof && mRunning) {
 			mRunning = false; // ctrl+d
@@ -947,6 +1102,8 @@ Daemon::~Daemon() {
 	if (mChildFd != (bctbx_pipe_t)-1) {
 		bctbx_server_pipe_close_client(mChildFd);
 	}
+	for (const DaemonClient &client : mClients)
+		bctbx_server_pipe_close_client(client.fd);
 	if (mServerFd != (bctbx_pipe_t)-1) {
 		bctbx_server_pipe_close(mServerFd);
 	}
@@ -1045,6 +1202,10 @@ int main(int argc, char *argv[]) {
 
 	the_app = &app;
 	signal(SIGINT, sighandler);
+#ifndef _WIN32
+	// A client may disconnect before reading its responses.
+	signal(SIGPIPE, SIG_IGN);
+#endif
 	app.enableStatsEvents(stats_enabled);
 	app.enableLSD(lsd_enabled);
 	app.enableAutoAnswer(auto_answer);
@@ -21,6 +21,7 @@
 #ifndef DAEMON_H_
 #define DAEMON_H_
 
+#include <bctoolbox/defs.h>
 #include <bctoolbox/list.h>
 #include <linphone/core.h>
 #include <linphone/core_utils.h>
@@ -29,6 +30,7 @@
 
 #include <list>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <sstream>
 #include <string>
@@ -77,6 +79,11 @@ class DaemonCommand {
 public:
 	virtual ~DaemonCommand() = default;
 	virtual void exec(Daemon *app, const std::string &args) = 0;
+	// Answers the command without the core lock, from the snapshots kept by the daemon. Returns false when it cannot,
+	// exec() is then called with the lock held.
+	virtual bool execWithoutLock(BCTBX_UNUSED(Daemon *app), BCTBX_UNUSED(const std::string &args)) {
+		return false;
+	}
 	bool matches(const std::string &name) const;
 	const std::string getHelp() const;
 	const std::string &getProto() const {
@@ -249,6 +256,23 @@ struct AudioStreamAndOther {
 	}
 };
 
+/* A command read from a client of the pipe. Clients may prefix a command with "#<id> " to pipeline several of them,
+ * the response then starts with a "Request-Id: <id>" line. */
+struct DaemonRequest {
+	ortp_pipe_t client;
+	std::string id;
+	std::string command;
+};
+
+/* A client of the daemon socket. Its commands run once their line is complete, its responses wait in output while
+ * the socket is not writable. */
+struct DaemonClient {
+	ortp_pipe_t fd;
+	std::string input;
+	std::string output;
+	bool broken;
+};
+
 class Daemon {
 	friend class DaemonCommand;
 
@@ -290,6 +314,9 @@ public:
 	void enableLSD(bool enabled);
 	void enableAutoAnswer(bool enabled);
 	void callPlayingComplete(int id);
+	std::string getCallStatsBody(LinphoneCall *call);
+	bool getCallStatsSnapshot(int id, std::string &body);
+	bool getAudioStreamStatsSnapshot(int id, std::string &body);
 	void setAutoVideo(bool enabled) {
 		mAutoVideo = enabled;
 	}
@@ -309,8 +336,16 @@ private:
 	void messageReceived(LinphoneChatRoom *cr, LinphoneChatMessage *msg);
 
 	void execCommand(const std::string &command);
+	void execRequests(const std::list<DaemonRequest> &requests);
 	std::string readLine(const std::string &, bool *);
-	std::string readPipe();
+	std::list<DaemonRequest> readPipe();
+	void readClient(ortp_pipe_t client,
+	                std::string &input,
+	                const std::string &data,
+	                std::list<DaemonRequest> &requests);
+	DaemonClient *findClient(ortp_pipe_t fd);
+	void flushClient(DaemonClient &client);
+	bool hasClients() const;
 	void iterate();
 	void iterateStreamStats();
 	void startThread();
@@ -323,6 +358,10 @@ private:
 	std::queue<Event *> mEventQueue;
 	ortp_pipe_t mServerFd;
 	ortp_pipe_t mChildFd;
+	std::string mChildInput;
+	std::list<DaemonClient> mClients;
+	ortp_pipe_t mReplyFd;
+	std::string mRequestId;
 	std::string mHistfile;
 	bool mRunning;
 	bool mUseStatsEvents;
@@ -335,6 +374,10 @@ private:
 	ms_thread_t mThread;
 	ms_mutex_t mMutex;
 	std::map<int, AudioStreamAndOther *> mAudioStreams;
+	// Stats bodies refreshed by the iterate thread, for the commands answered without the core lock.
+	std::mutex mSnapshotsMutex;
+	std::map<int, std::string> mCallStatsSnapshots;
+	std::map<int, std::string> mAudioStreamStatsSnapshots;
 };
 
 #endif // DAEMON_H_
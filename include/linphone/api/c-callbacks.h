@@ -569,6 +569,14 @@ typedef void (*LinphoneChatRoomCbsNewMessageReactionCb)(LinphoneChatRoom *chat_r
                                                         LinphoneChatMessage *message,
                                                         const LinphoneChatMessageReaction *reaction);
 
+/**
+ * Callback used to return the result of an asynchronous query of the history of a chat room.
+ * @param chat_room #LinphoneChatRoom object @notnil
+ * @param results The list of results, only valid during the call. Take a reference to keep an element. @maybenil
+ * @param user_data The user data given to the query. @maybenil
+ */
+typedef void (*LinphoneChatRoomListCb)(LinphoneChatRoom *chat_room, const bctbx_list_t *results, void *user_data);
+
 /**
  * @}
  **/
@@ -249,6 +249,19 @@ LINPHONE_PUBLIC bool_t linphone_chat_room_is_empty(LinphoneChatRoom *chat_room);
  */
 LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_media_contents(LinphoneChatRoom *chat_room);
 
+/**
+ * Asynchronous version of linphone_chat_room_get_media_contents(): the database is queried from another thread and
+ * the callback is called later, from linphone_core_iterate(). It is not called if the core is stopped first.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which matching contents should be
+ * retrieved. @notnil
+ * @param callback The callback to which the list of contents \bctbx_list{LinphoneContent} is given. @notnil
+ * @param user_data The user data given to the callback. @maybenil
+ * @donotwrap
+ */
+LINPHONE_PUBLIC void linphone_chat_room_get_media_contents_async(LinphoneChatRoom *chat_room,
+                                                                 LinphoneChatRoomListCb callback,
+                                                                 void *user_data);
+
 /**
  * Gets all contents for which content-type starts with either text/ or application/.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which matching contents should be
@@ -325,6 +338,34 @@ LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_events(LinphoneChat
 LINPHONE_PUBLIC bctbx_list_t *
 linphone_chat_room_get_history_range_events(LinphoneChatRoom *chat_room, int begin, int end);
 
+/**
+ * Asynchronous version of linphone_chat_room_get_history_range_events(): the database is queried from another thread
+ * and the callback is called later, from linphone_core_iterate(). It is not called if the core is stopped first.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved
+ * @notnil
+ * @param begin The first event of the range to be retrieved. History most recent event has index 0.
+ * @param end The last event of the range to be retrieved. History oldest event has index of history size - 1
+ * @param callback The callback to which the list of events \bctbx_list{LinphoneEventLog} is given. @notnil
+ * @param user_data The user data given to the callback. @maybenil
+ * @donotwrap
+ */
+LINPHONE_PUBLIC void linphone_chat_room_get_history_range_events_async(
+    LinphoneChatRoom *chat_room, int begin, int end, LinphoneChatRoomListCb callback, void *user_data);
+
+/**
+ * Gets up to limit events older than the given one, sorted from oldest to most recent.
+ * Unlike linphone_chat_room_get_history_range_events(), the cost of a call does not grow with the depth of the page,
+ * pass the first event of the previously returned list to scroll back further.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved
+ * @notnil
+ * @param before The event before which events are retrieved, NULL to get the most recent ones. @maybenil
+ * @param limit The maximum number of events to retrieve.
+ * @return The list of the found events. \bctbx_list{LinphoneEventLog} @tobefreed
+ */
+LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_events_before(LinphoneChatRoom *chat_room,
+                                                                           const LinphoneEventLog *before,
+                                                                           int limit);
+
 /**
  * Gets the number of events in a chat room.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which size has to be computed
@@ -351,6 +392,22 @@ LINPHONE_PUBLIC LinphoneChatMessage *linphone_chat_room_get_last_message_in_hist
 LINPHONE_PUBLIC LinphoneChatMessage *linphone_chat_room_find_message(LinphoneChatRoom *chat_room,
                                                                      const char *message_id);
 
+/**
+ * Asynchronous version of linphone_chat_room_find_message(): the database is queried from another thread and the
+ * callback is called later, from linphone_core_iterate(). It is not called if the core is stopped first.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which the message should be
+ * retrieved @notnil
+ * @param message_id The id of the message to find @notnil
+ * @param callback The callback to which the list of the matching messages \bctbx_list{LinphoneChatMessage} is given.
+ * @notnil
+ * @param user_data The user data given to the callback. @maybenil
+ * @donotwrap
+ */
+LINPHONE_PUBLIC void linphone_chat_room_find_messages_async(LinphoneChatRoom *chat_room,
+                                                            const char *message_id,
+                                                            LinphoneChatRoomListCb callback,
+                                                            void *user_data);
+
 /**
  * Notifies the destination of the chat message being composed that the user is typing a new message.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which a new message is being
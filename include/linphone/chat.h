@@ -47,6 +47,16 @@ extern "C" {
  **/
 LINPHONE_PUBLIC const bctbx_list_t *linphone_core_get_chat_rooms(LinphoneCore *core);
 
+/**
+ * Returns a range of the chat rooms returned by linphone_core_get_chat_rooms(), most recently updated first.
+ * When [misc] lazy_chat_rooms_loading is enabled, only the chat rooms of the range are loaded from the database.
+ * @param core #LinphoneCore object @notnil
+ * @param begin Index of the first chat room of the range.
+ * @param end Index after the last chat room of the range, a negative value means until the last chat room.
+ * @return List of chat rooms. \bctbx_list{LinphoneChatRoom} @tobefreed @maybenil
+ **/
+LINPHONE_PUBLIC bctbx_list_t *linphone_core_get_chat_rooms_range(LinphoneCore *core, int begin, int end);
+
 /**
  * Creates and returns the default chat room parameters.
  * @param core #LinphoneCore object @notnil
@@ -208,6 +208,14 @@ LINPHONE_PUBLIC void linphone_core_set_tag_100rel_support_level(LinphoneCore *co
  */
 typedef void (*LinphoneCoreCbFunc)(LinphoneCore *core, void *user_data);
 
+/**
+ * Callback used to return the result of an asynchronous database query.
+ * @param core #LinphoneCore object @notnil
+ * @param results The list of results, only valid during the call. Take a reference to keep an element. @maybenil
+ * @param user_data The user data given to the query. @maybenil
+ */
+typedef void (*LinphoneCoreListCb)(LinphoneCore *core, const bctbx_list_t *results, void *user_data);
+
 /**
  * This structure holds all callbacks that the application should implement.
  * None is mandatory.
@@ -3651,6 +3659,17 @@ LINPHONE_PUBLIC void linphone_core_set_rtp_no_xmit_on_audio_mute(LinphoneCore *c
  **/
 LINPHONE_PUBLIC const bctbx_list_t *linphone_core_get_call_logs(LinphoneCore *core);
 
+/**
+ * Asynchronous version of linphone_core_get_call_logs(): the database is queried from another thread and the callback
+ * is called later, from linphone_core_iterate(). It is not called if the core is stopped first.
+ * Requires ENABLE_DB_STORAGE to work.
+ * @param core #LinphoneCore object @notnil
+ * @param callback The callback to which the list of call logs \bctbx_list{LinphoneCallLog} is given. @notnil
+ * @param user_data The user data given to the callback. @maybenil
+ * @donotwrap
+ **/
+LINPHONE_PUBLIC void linphone_core_get_call_logs_async(LinphoneCore *core, LinphoneCoreListCb callback, void *user_data);
+
 /**
  * Get the list of call logs (past calls).
  * At the contrary of linphone_core_get_call_logs, it is your responsibility to unref the logs and free this list once
@@ -7114,6 +7133,23 @@ LINPHONE_PUBLIC bctbx_list_t *linphone_core_get_future_conference_information_li
  */
 LINPHONE_PUBLIC bctbx_list_t *linphone_core_get_conference_information_list_after_time(LinphoneCore *core, time_t time);
 
+/**
+ * Asynchronous version of linphone_core_get_conference_information_list_after_time(): the database is queried from
+ * another thread and the callback is called later, from linphone_core_iterate(). It is not called if the core is
+ * stopped first.
+ * @param core #LinphoneCore object. @notnil
+ * @param time Time to retrieve conference info, -1 to retrieve all of them.
+ * @param callback The callback to which the list of conference infos \bctbx_list{LinphoneConferenceInfo} is given.
+ * @notnil
+ * @param user_data The user data given to the callback. @maybenil
+ * @ingroup conference
+ * @donotwrap
+ */
+LINPHONE_PUBLIC void linphone_core_get_conference_information_list_async(LinphoneCore *core,
+                                                                         time_t time,
+                                                                         LinphoneCoreListCb callback,
+                                                                         void *user_data);
+
 /**
  * Deletes a conference information from DB.
  * @param core #LinphoneCore object. @notnil
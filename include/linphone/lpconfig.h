@@ -172,6 +172,16 @@ LINPHONE_PUBLIC const char *linphone_config_get_factory_filename(const LinphoneC
  */
 LINPHONE_PUBLIC const char *linphone_config_get_temporary_filename(const LinphoneConfig *config);
 
+/**
+ * Enables or disables, for the whole process, the binary snapshot cache of the configurations created from files.
+ * When enabled, a parsed configuration is saved in a binary snapshot next to its file, and later loaded instead of
+ * parsing the config and factory files again, as long as they did not change. Disabled by default.
+ * @ingroup misc
+ * @param enable TRUE to enable the snapshot cache, FALSE to disable it.
+ * @donotwrap
+ */
+LINPHONE_PUBLIC void linphone_config_enable_snapshot_cache(bool_t enable);
+
 /**
  * Retrieves a configuration item as a string, given its section, key, and default value.
  *
@@ -866,7 +866,12 @@ list<shared_ptr<AbstractChatRoom>> Account::getChatRooms() const {
 	}
 
 	auto localAddress = mParams->mIdentityAddress;
-	const list<shared_ptr<AbstractChatRoom>> chatRooms = getCore()->getChatRooms();
+	// Only the deferred chat rooms of this account are built.
+	CorePrivate *dCore = getCore()->getPrivate();
+	dCore->loadDeferredChatRooms([&](const MainDb::ChatRoomDescriptor &descriptor) {
+		return localAddress->weakEqual(*descriptor.conferenceId.getLocalAddress());
+	});
+	const list<shared_ptr<AbstractChatRoom>> chatRooms = dCore->getLoadedChatRooms();
 	for (auto chatRoom : chatRooms) {
 		if (localAddress->weakEqual(*chatRoom->getLocalAddress())) {
 			results.push_back(chatRoom);
@@ -66,7 +66,7 @@ Address::Address(const string &address, bool assumeGrUri) {
 	}
 }
 
-Address::Address(const Address &other) : HybridObject(other) {
+Address::Address(const Address &other) : HybridObject(other), mCache(other.mCache) {
 	SalAddress *salAddress = other.mImpl;
 	if (salAddress) mImpl = sal_address_clone(salAddress);
 	else mImpl = sal_address_new_empty();
@@ -76,9 +76,11 @@ Address::Address() {
 	mImpl = sal_address_new_empty();
 }
 
-Address::Address(Address &&other) : bellesip::HybridObject<LinphoneAddress, Address>(std::move(other)) {
+Address::Address(Address &&other)
+    : bellesip::HybridObject<LinphoneAddress, Address>(std::move(other)), mCache(std::move(other.mCache)) {
 	mImpl = other.mImpl;
 	other.mImpl = nullptr;
+	other.resetCache();
 }
 
 Address::Address(SalAddress *addr, bool acquire) {
@@ -106,6 +108,7 @@ Address &Address::operator=(const Address &other) {
 		if (mImpl) sal_address_unref(mImpl);
 		SalAddress *salAddress = other.mImpl;
 		mImpl = salAddress ? sal_address_clone(salAddress) : nullptr;
+		mCache = other.mCache;
 	}
 
 	return *this;
@@ -122,7 +125,51 @@ bool Address::operator!=(const Address &other) const {
 }
 
 bool Address::operator<(const Address &other) const {
-	return toStringOrdered() < other.toStringOrdered();
+	return getCachedOrdered() < other.getCachedOrdered();
+}
+
+size_t Address::getHash() const {
+	if (!mCache.hasHash.load(memory_order_acquire)) {
+		// operator==() compares the domains case insensitively and ignores the display name.
+		string key;
+		const char *domain = getDomainCstr();
+		if (domain) {
+			key = getSecure() ? "sips:" : "sip:";
+			key += getUsername();
+			key += "@";
+			for (const char *c = domain; *c; c++)
+				key += (char)tolower((unsigned char)*c);
+			key += ":" + to_string(getPort());
+		} else {
+			key = getCachedUriOnly();
+		}
+		// Concurrent computations store the same value.
+		mCache.hash.store(hash<string>()(key), memory_order_relaxed);
+		mCache.hasHash.store(true, memory_order_release);
+	}
+	return mCache.hash.load(memory_order_relaxed);
+}
+
+Address::Cache::Cache(const Cache &other) {
+	*this = other;
+}
+
+Address::Cache &Address::Cache::operator=(const Cache &other) {
+	if (this == &other) return *this;
+
+	// Only the published forms of the other cache are read, they are not modified anymore.
+	auto copy = [](const atomic<bool> &otherHas, const string &otherValue, atomic<bool> &has, string &value) {
+		const bool published = otherHas.load(memory_order_acquire);
+		value = published ? otherValue : string();
+		has.store(published, memory_order_relaxed);
+	};
+	copy(other.hasUriOnly, other.uriOnly, hasUriOnly, uriOnly);
+	copy(other.hasUriOnlyOrdered, other.uriOnlyOrdered, hasUriOnlyOrdered, uriOnlyOrdered);
+	copy(other.hasOrdered, other.ordered, hasOrdered, ordered);
+	const bool hashPublished = other.hasHash.load(memory_order_acquire);
+	hash.store(hashPublished ? other.hash.load(memory_order_relaxed) : 0, memory_order_relaxed);
+	hasHash.store(hashPublished, memory_order_relaxed);
+	return *this;
 }
 
 // -----------------------------------------------------------------------------
@@ -147,6 +194,7 @@ void Address::setImpl(const SalAddress *addr) {
 void Address::setImpl(SalAddress *addr) {
 	if (mImpl) sal_address_unref(mImpl);
 	mImpl = addr;
+	resetCache();
 }
 
 void Address::clearSipAddressesCache() {
@@ -188,6 +236,7 @@ bool Address::setDisplayName(const string &displayName) {
 	if (!mImpl) return false;
 
 	sal_address_set_display_name(mImpl, L_STRING_TO_C(displayName));
+	resetCache();
 	return true;
 }
 
@@ -203,6 +252,7 @@ bool Address::setUsername(const string &username) {
 	if (!mImpl) return false;
 
 	sal_address_set_username(mImpl, L_STRING_TO_C(username));
+	resetCache();
 	return true;
 }
 
@@ -218,6 +268,7 @@ bool Address::setDomain(const string &domain) {
 	if (!mImpl) return false;
 
 	sal_address_set_domain(mImpl, L_STRING_TO_C(domain));
+	resetCache();
 	return true;
 }
 
@@ -229,6 +280,7 @@ bool Address::setPort(int port) {
 	if (!mImpl) return false;
 
 	sal_address_set_port(mImpl, port);
+	resetCache();
 	return true;
 }
 
@@ -240,6 +292,7 @@ bool Address::setTransport(Transport transport) {
 	if (!mImpl) return false;
 
 	sal_address_set_transport(mImpl, static_cast<SalTransport>(transport));
+	resetCache();
 	return true;
 }
 
@@ -251,6 +304,7 @@ bool Address::setSecure(bool enabled) {
 	if (!mImpl) return false;
 
 	sal_address_set_secure(mImpl, enabled);
+	resetCache();
 	return true;
 }
 
@@ -261,6 +315,7 @@ bool Address::isSip() const {
 bool Address::setMethodParam(const std::string &value) {
 	if (!mImpl) return false;
 	sal_address_set_method_param(mImpl, value.c_str());
+	resetCache();
 	return true;
 }
 
@@ -284,6 +339,7 @@ bool Address::setPassword(const string &password) {
 	if (!mImpl) return false;
 
 	sal_address_set_password(mImpl, L_STRING_TO_C(password));
+	resetCache();
 	return true;
 }
 
@@ -291,6 +347,7 @@ bool Address::clean() {
 	if (!mImpl) return false;
 
 	sal_address_clean(mImpl);
+	resetCache();
 	return true;
 }
 
@@ -305,58 +362,86 @@ std::string Address::toString() const {
 	return ret;
 }
 
-string Address::toStringUriOnlyOrdered() const {
-	ostringstream res;
-	res << getScheme() << ":";
-	if (!getUsername().empty()) {
-		char *tmp = belle_sip_uri_to_escaped_username(getUsername().c_str());
-		res << tmp << "@";
-		ms_free(tmp);
+static void appendParams(string &res, const map<string, string> &params) {
+	for (const auto &param : params) {
+		res += ";";
+		res += param.first;
+		if (!param.second.empty()) {
+			res += "=";
+			res += param.second;
+		}
 	}
+}
 
-	if (getDomain().find(":") != string::npos) {
-		res << "[" << getDomain() << "]";
-	} else {
-		res << getDomain();
-	}
+const string &Address::getCachedUriOnlyOrdered() const {
+	if (mCache.hasUriOnlyOrdered.load(memory_order_acquire)) return mCache.uriOnlyOrdered;
+
+	lock_guard<mutex> lock(mCache.mutex);
+	if (!mCache.hasUriOnlyOrdered.load(memory_order_relaxed)) {
+		string res = getScheme() + ":";
+		const char *username = getUsernameCstr();
+		if (username && username[0] != '\0') {
+			char *tmp = belle_sip_uri_to_escaped_username(username);
+			res += tmp;
+			res += "@";
+			ms_free(tmp);
+		}
 
-	const auto uriParams = getUriParams();
-	for (const auto &param : uriParams) {
-		const auto &name = param.first;
-		res << ";" << name;
-		const auto &value = param.second;
-		if (!value.empty()) {
-			res << "=" << value;
+		const string domain = getDomain();
+		if (domain.find(":") != string::npos) {
+			res += "[" + domain + "]";
+		} else {
+			res += domain;
 		}
+
+		appendParams(res, getUriParams());
+		mCache.uriOnlyOrdered = std::move(res);
+		mCache.hasUriOnlyOrdered.store(true, memory_order_release);
 	}
-	return res.str();
+	return mCache.uriOnlyOrdered;
 }
 
-string Address::toStringOrdered() const {
-	auto res = toStringUriOnlyOrdered();
-	const auto uriParams = getUriParams();
-	for (const auto &param : uriParams) {
-		const auto &name = param.first;
-		res += ";";
-		res += name;
-		const auto &value = param.second;
-		if (!value.empty()) {
-			res += "=";
-			res += value;
-		}
+const string &Address::getCachedOrdered() const {
+	if (mCache.hasOrdered.load(memory_order_acquire)) return mCache.ordered;
+
+	// Computed before locking, the mutex is not recursive.
+	string res = getCachedUriOnlyOrdered();
+	lock_guard<mutex> lock(mCache.mutex);
+	if (!mCache.hasOrdered.load(memory_order_relaxed)) {
+		appendParams(res, getUriParams());
+		mCache.ordered = std::move(res);
+		mCache.hasOrdered.store(true, memory_order_release);
+	}
+	return mCache.ordered;
+}
+
+const string &Address::getCachedUriOnly() const {
+	if (mCache.hasUriOnly.load(memory_order_acquire)) return mCache.uriOnly;
+
+	lock_guard<mutex> lock(mCache.mutex);
+	if (!mCache.hasUriOnly.load(memory_order_relaxed)) {
+		char *buf = isValid() ? sal_address_as_string_uri_only(mImpl) : nullptr;
+		mCache.uriOnly = L_C_TO_STRING(buf);
+		if (buf) bctbx_free(buf);
+		mCache.hasUriOnly.store(true, memory_order_release);
 	}
-	return res;
+	return mCache.uriOnly;
+}
+
+string Address::toStringUriOnlyOrdered() const {
+	return getCachedUriOnlyOrdered();
+}
+
+string Address::toStringOrdered() const {
+	return getCachedOrdered();
 }
 
 char *Address::asStringUriOnlyCstr() const {
-	return isValid() ? sal_address_as_string_uri_only(mImpl) : ms_strdup("");
+	return ms_strdup(getCachedUriOnly().c_str());
 }
 
 std::string Address::asStringUriOnly() const {
-	char *buf = asStringUriOnlyCstr();
-	std::string tmp(L_C_TO_STRING(buf));
-	bctbx_free(buf);
-	return tmp;
+	return getCachedUriOnly();
 }
 
 bool Address::weakEqual(const Address &address) const {
@@ -379,6 +464,7 @@ bool Address::setHeader(const string &headerName, const string &headerValue) {
 	if (!mImpl) return false;
 
 	sal_address_set_header(mImpl, L_STRING_TO_C(headerName), L_STRING_TO_C(headerValue));
+	resetCache();
 	return true;
 }
 
@@ -398,6 +484,7 @@ bool Address::setParam(const string &paramName, const string &paramValue) {
 	if (!mImpl) return false;
 
 	sal_address_set_param(mImpl, L_STRING_TO_C(paramName), L_STRING_TO_C(paramValue));
+	resetCache();
 	return true;
 }
 
@@ -405,6 +492,7 @@ bool Address::setParams(const string &params) {
 	if (!mImpl) return false;
 
 	sal_address_set_params(mImpl, L_STRING_TO_C(params));
+	resetCache();
 	return true;
 }
 
@@ -412,6 +500,7 @@ bool Address::removeParam(const string &uriParamName) {
 	if (!mImpl) return false;
 
 	sal_address_remove_param(mImpl, L_STRING_TO_C(uriParamName));
+	resetCache();
 	return true;
 }
 
@@ -431,6 +520,7 @@ bool Address::setUriParam(const string &uriParamName, const string &uriParamValu
 	if (!mImpl) return false;
 
 	sal_address_set_uri_param(mImpl, L_STRING_TO_C(uriParamName), L_STRING_TO_C(uriParamValue));
+	resetCache();
 	return true;
 }
 
@@ -438,6 +528,7 @@ bool Address::setUriParams(const string &uriParams) {
 	if (!mImpl) return false;
 
 	sal_address_set_uri_params(mImpl, L_STRING_TO_C(uriParams));
+	resetCache();
 	return true;
 }
 
@@ -445,6 +536,7 @@ bool Address::removeUriParam(const string &uriParamName) {
 	if (!mImpl) return false;
 
 	sal_address_remove_uri_param(mImpl, L_STRING_TO_C(uriParamName));
+	resetCache();
 	return true;
 }
 
@@ -21,6 +21,8 @@
 #ifndef _L_ADDRESS_H_
 #define _L_ADDRESS_H_
 
+#include <atomic>
+#include <mutex>
 #include <ostream>
 #include <unordered_map>
 
@@ -64,6 +66,9 @@ public:
 
 	bool operator<(const Address &other) const;
 
+	// Hash of the fields compared by operator==().
+	size_t getHash() const;
+
 	bool isValid() const;
 
 	std::string getScheme() const;
@@ -152,7 +157,34 @@ protected:
 	static SalAddress *getSalAddressFromCache(const std::string &address, bool assumeGrUri);
 
 private:
+	// Forms of the address computed on first use, reset by anything that modifies it. A const address may be read
+	// by several threads: each form is computed under the mutex and published by its flag, it does not change
+	// until the address is modified.
+	struct Cache {
+		Cache() = default;
+		Cache(const Cache &other);
+		Cache &operator=(const Cache &other);
+
+		std::string uriOnly;
+		std::string uriOnlyOrdered;
+		std::string ordered;
+		std::atomic<size_t> hash{0};
+		std::atomic<bool> hasUriOnly{false};
+		std::atomic<bool> hasUriOnlyOrdered{false};
+		std::atomic<bool> hasOrdered{false};
+		std::atomic<bool> hasHash{false};
+		std::mutex mutex;
+	};
+
+	const std::string &getCachedUriOnly() const;
+	const std::string &getCachedUriOnlyOrdered() const;
+	const std::string &getCachedOrdered() const;
+	inline void resetCache() {
+		mCache = Cache();
+	}
+
 	SalAddress *mImpl = nullptr;
+	mutable Cache mCache;
 	struct SalAddressDeleter {
 		void operator()(SalAddress *addr) {
 			sal_address_unref(addr);
@@ -170,4 +202,13 @@ inline std::ostream &operator<<(std::ostream &os, const Address &address) {
 
 LINPHONE_END_NAMESPACE
 
+namespace std {
+template <>
+struct hash<LinphonePrivate::Address> {
+	std::size_t operator()(const LinphonePrivate::Address &address) const {
+		return address.getHash();
+	}
+};
+} // namespace std
+
 #endif // ifndef _L_ADDRESS_H_
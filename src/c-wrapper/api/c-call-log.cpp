@@ -297,6 +297,25 @@ const bctbx_list_t *linphone_core_get_call_history(LinphoneCore *lc) {
 	return lc->call_logs;
 }
 
+void linphone_core_get_call_logs_async(LinphoneCore *lc, LinphoneCoreListCb callback, void *user_data) {
+#ifdef HAVE_DB_STORAGE
+	std::unique_ptr<MainDb> &mainDb = L_GET_PRIVATE_FROM_C_OBJECT(lc)->mainDb;
+	if (mainDb) {
+		auto onResult = [lc, callback, user_data](const std::list<std::shared_ptr<CallLog>> &result) {
+			// The call logs are kept alive by the result during the callback.
+			bctbx_list_t *results = NULL;
+			for (const auto &log : result)
+				results = bctbx_list_append(results, log->toC());
+			callback(lc, results, user_data);
+			bctbx_list_free(results);
+		};
+		mainDb->getCallHistoryAsync(lc->max_call_logs, onResult);
+		return;
+	}
+#endif
+	L_GET_CPP_PTR_FROM_C_OBJECT(lc)->doLater([lc, callback, user_data]() { callback(lc, lc->call_logs, user_data); });
+}
+
 void linphone_core_delete_call_history(LinphoneCore *lc) {
 	if (!lc) return;
 
@@ -61,6 +61,29 @@ L_DECLARE_C_OBJECT_IMPL_WITH_XTORS(ChatRoom,
 static void _linphone_chat_room_constructor(BCTBX_UNUSED(LinphoneChatRoom *cr)) {
 }
 
+template <typename T>
+static bctbx_list_t *getResolvedCList(const list<shared_ptr<T>> &cppList) {
+	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(cppList);
+}
+
+static bctbx_list_t *getResolvedCList(const list<shared_ptr<LinphonePrivate::Content>> &cppList) {
+	return LinphonePrivate::Content::getCListFromCppList(cppList, true);
+}
+
+// Calls back with the C list of the result, unless the chat room was destroyed meanwhile.
+template <typename T>
+static LinphonePrivate::MainDb::AsyncResultCb<T>
+makeAsyncResultCb(LinphoneChatRoom *cr, LinphoneChatRoomListCb callback, void *user_data) {
+	weak_ptr<LinphonePrivate::AbstractChatRoom> weakChatRoom = L_GET_CPP_PTR_FROM_C_OBJECT(cr);
+	return [weakChatRoom, callback, user_data](const list<shared_ptr<T>> &result) {
+		shared_ptr<LinphonePrivate::AbstractChatRoom> chatRoom = weakChatRoom.lock();
+		if (!chatRoom) return;
+		bctbx_list_t *results = getResolvedCList(result);
+		callback(L_GET_C_BACK_PTR(chatRoom), results, user_data);
+		bctbx_list_free_with_data(results, (bctbx_list_free_func)belle_sip_object_unref);
+	};
+}
+
 static void _linphone_chat_room_destructor(LinphoneChatRoom *cr) {
 	_linphone_chat_room_clear_callbacks(cr);
 	if (cr->composingAddresses) bctbx_list_free(cr->composingAddresses);
@@ -313,6 +336,15 @@ bctbx_list_t *linphone_chat_room_get_media_contents(LinphoneChatRoom *cr) {
 	return LinphonePrivate::Content::getCListFromCppList(contents, true);
 }
 
+void linphone_chat_room_get_media_contents_async(LinphoneChatRoom *cr,
+                                                 LinphoneChatRoomListCb callback,
+                                                 void *user_data) {
+	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
+	shared_ptr<LinphonePrivate::AbstractChatRoom> chatRoom = L_GET_CPP_PTR_FROM_C_OBJECT(cr);
+	chatRoom->getCore()->getPrivate()->mainDb->getMediaContentsAsync(
+	    chatRoom->getConferenceId(), makeAsyncResultCb<LinphonePrivate::Content>(cr, callback, user_data));
+}
+
 bctbx_list_t *linphone_chat_room_get_document_contents(LinphoneChatRoom *cr) {
 	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
 	list<shared_ptr<LinphonePrivate::Content>> contents = L_GET_CPP_PTR_FROM_C_OBJECT(cr)->getDocumentContents();
@@ -359,6 +391,25 @@ bctbx_list_t *linphone_chat_room_get_history_range_events(LinphoneChatRoom *cr,
 	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(L_GET_CPP_PTR_FROM_C_OBJECT(cr)->getHistoryRange(begin, end));
 }
 
+void linphone_chat_room_get_history_range_events_async(
+    LinphoneChatRoom *cr, int begin, int end, LinphoneChatRoomListCb callback, void *user_data) {
+	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
+	shared_ptr<LinphonePrivate::AbstractChatRoom> chatRoom = L_GET_CPP_PTR_FROM_C_OBJECT(cr);
+	// Same filter as ChatRoom::getHistoryRange().
+	chatRoom->getCore()->getPrivate()->mainDb->getHistoryRangeAsync(
+	    chatRoom->getConferenceId(), begin, end,
+	    LinphonePrivate::MainDb::FilterMask({LinphonePrivate::MainDb::Filter::ConferenceChatMessageFilter,
+	                                         LinphonePrivate::MainDb::Filter::ConferenceInfoNoDeviceFilter}),
+	    makeAsyncResultCb<LinphonePrivate::EventLog>(cr, callback, user_data));
+}
+
+bctbx_list_t *
+linphone_chat_room_get_history_events_before(LinphoneChatRoom *cr, const LinphoneEventLog *before, int limit) {
+	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
+	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(L_GET_CPP_PTR_FROM_C_OBJECT(cr)->getHistoryBefore(
+	    before ? L_GET_CPP_PTR_FROM_C_OBJECT(before) : nullptr, limit));
+}
+
 int linphone_chat_room_get_history_events_size(LinphoneChatRoom *cr) {
 	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
 	return L_GET_CPP_PTR_FROM_C_OBJECT(cr)->getHistorySize();
@@ -380,6 +431,17 @@ LinphoneChatMessage *linphone_chat_room_find_message(LinphoneChatRoom *cr, const
 	return linphone_chat_message_ref(L_GET_C_BACK_PTR(cppPtr));
 }
 
+void linphone_chat_room_find_messages_async(LinphoneChatRoom *cr,
+                                            const char *message_id,
+                                            LinphoneChatRoomListCb callback,
+                                            void *user_data) {
+	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
+	shared_ptr<LinphonePrivate::AbstractChatRoom> chatRoom = L_GET_CPP_PTR_FROM_C_OBJECT(cr);
+	chatRoom->getCore()->getPrivate()->mainDb->findChatMessagesAsync(
+	    chatRoom->getConferenceId(), L_C_TO_STRING(message_id),
+	    makeAsyncResultCb<LinphonePrivate::ChatMessage>(cr, callback, user_data));
+}
+
 LinphoneChatRoomState linphone_chat_room_get_state(const LinphoneChatRoom *cr) {
 	LinphonePrivate::ChatRoomLogContextualizer logContextualizer(cr);
 	return linphone_conference_state_to_chat_room_state(
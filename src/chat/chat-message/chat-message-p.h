@@ -140,6 +140,11 @@ public:
 
 	void handleAutoDownload();
 
+	// The contents of a message are transferred at the same time, each one by its own file transfer modifier.
+	FileTransferChatMessageModifier *getIdleFileTransferChatMessageModifier();
+	bool isFileTransferInProgress() const;
+	bool isFileTransferInProgress(const std::shared_ptr<Content> &content) const;
+
 	belle_http_request_t *getHttpRequest() const;
 	void setHttpRequest(belle_http_request_t *request);
 
@@ -180,6 +185,19 @@ public:
 
 	void setChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
 
+	// Time spent in each modification step of the last received message, in microseconds.
+	struct ReceiveTimings {
+		int steps = Step::None; // Steps which were timed.
+		long long encryption = 0;
+		long long cpim = 0;
+		long long multipart = 0;
+		long long fileTransfer = 0;
+	};
+
+	const ReceiveTimings &getReceiveTimings() const {
+		return receiveTimings;
+	}
+
 	void setEncryptionPrevented(bool value) {
 		encryptionPrevented = value;
 	}
@@ -281,8 +299,12 @@ private:
 	SalCustomHeader *salCustomHeaders = nullptr;
 	int currentSendStep = Step::None;
 	int currentRecvStep = Step::None;
+	ReceiveTimings receiveTimings;
 	bool applyModifiers = true;
 	FileTransferChatMessageModifier fileTransferChatMessageModifier;
+	// Transfers of the other contents, running along the one of fileTransferChatMessageModifier. They are kept once
+	// done as they may still be in the call stack of their belle-sip callbacks.
+	std::list<std::unique_ptr<FileTransferChatMessageModifier>> parallelFileTransferChatMessageModifiers;
 
 	// Cache for returned values, used for compatibility with previous C API
 	std::string fileTransferFilePath;
@@ -410,6 +410,32 @@ void ChatMessagePrivate::setHttpRequest(belle_http_request_t *request) {
 	fileTransferChatMessageModifier.setHttpRequest(request);
 }
 
+FileTransferChatMessageModifier *ChatMessagePrivate::getIdleFileTransferChatMessageModifier() {
+	L_Q();
+
+	if (!fileTransferChatMessageModifier.isFileTransferInProgressAndValid()) return &fileTransferChatMessageModifier;
+	for (const auto &modifier : parallelFileTransferChatMessageModifiers)
+		if (!modifier->isFileTransferInProgressAndValid()) return modifier.get();
+
+	parallelFileTransferChatMessageModifiers.push_back(
+	    make_unique<FileTransferChatMessageModifier>(q->getCore()->getHttpClient().getProvider()));
+	return parallelFileTransferChatMessageModifiers.back().get();
+}
+
+bool ChatMessagePrivate::isFileTransferInProgress() const {
+	if (fileTransferChatMessageModifier.isFileTransferInProgressAndValid()) return true;
+	for (const auto &modifier : parallelFileTransferChatMessageModifiers)
+		if (modifier->isFileTransferInProgressAndValid()) return true;
+	return false;
+}
+
+bool ChatMessagePrivate::isFileTransferInProgress(const shared_ptr<Content> &content) const {
+	if (fileTransferChatMessageModifier.isTransferringContent(content)) return true;
+	for (const auto &modifier : parallelFileTransferChatMessageModifiers)
+		if (modifier->isTransferringContent(content)) return true;
+	return false;
+}
+
 // -----------------------------------------------------------------------------
 
 void ChatMessagePrivate::disableDeliveryNotificationRequiredInDatabase() {
@@ -741,6 +767,10 @@ void ChatMessagePrivate::setChatRoom(const shared_ptr<AbstractChatRoom> &cr) {
 
 // -----------------------------------------------------------------------------
 
+static long long elapsedMicroseconds(const chrono::steady_clock::time_point &start) {
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
 static void forceUtf8Content(Content &content) {
 	// TODO: Deal with other content type in the future.
 	ContentType contentType = content.getContentType();
@@ -789,11 +819,17 @@ LinphoneReason ChatMessagePrivate::receive() {
 	// Start of message modification
 	// ---------------------------------------
 
+	// Timings of the steps of a suspended message keep accumulating until it is fully received.
+	if (currentRecvStep == ChatMessagePrivate::Step::None) receiveTimings = ReceiveTimings();
+
 	if ((currentRecvStep & ChatMessagePrivate::Step::Encryption) == ChatMessagePrivate::Step::Encryption) {
 		lInfo() << "Encryption step already done, skipping";
 	} else {
 		EncryptionChatMessageModifier ecmm;
+		const auto start = chrono::steady_clock::now();
 		ChatMessageModifier::Result result = ecmm.decode(q->getSharedFromThis(), errorCode);
+		receiveTimings.encryption += elapsedMicroseconds(start);
+		receiveTimings.steps |= ChatMessagePrivate::Step::Encryption;
 		if (result == ChatMessageModifier::Result::Error) {
 			/* Unable to decrypt message */
 #ifdef HAVE_ADVANCED_IM
@@ -840,7 +876,10 @@ LinphoneReason ChatMessagePrivate::receive() {
 		if (internalContent.getContentType() == ContentType::Cpim) {
 #ifdef HAVE_ADVANCED_IM
 			CpimChatMessageModifier ccmm;
+			const auto start = chrono::steady_clock::now();
 			ccmm.decode(q->getSharedFromThis(), errorCode);
+			receiveTimings.cpim += elapsedMicroseconds(start);
+			receiveTimings.steps |= ChatMessagePrivate::Step::Cpim;
 #else
 			lWarning() << "Cpim support disabled.";
 #endif
@@ -853,7 +892,10 @@ LinphoneReason ChatMessagePrivate::receive() {
 		lInfo() << "Multipart step already done, skipping";
 	} else {
 		MultipartChatMessageModifier mcmm;
+		const auto start = chrono::steady_clock::now();
 		mcmm.decode(q->getSharedFromThis(), errorCode);
+		receiveTimings.multipart += elapsedMicroseconds(start);
+		receiveTimings.steps |= ChatMessagePrivate::Step::Multipart;
 		currentRecvStep |= ChatMessagePrivate::Step::Multipart;
 	}
 
@@ -874,7 +916,10 @@ LinphoneReason ChatMessagePrivate::receive() {
 		lInfo() << "File download step already done, skipping";
 	} else {
 		// This will check if internal content is FileTransfer and make the appropriate changes
+		const auto start = chrono::steady_clock::now();
 		loadFileTransferUrlFromBodyToContent();
+		receiveTimings.fileTransfer += elapsedMicroseconds(start);
+		receiveTimings.steps |= ChatMessagePrivate::Step::FileDownload;
 		currentRecvStep |= ChatMessagePrivate::Step::FileDownload;
 	}
 
@@ -891,6 +936,10 @@ LinphoneReason ChatMessagePrivate::receive() {
 	// End of message modification
 	// ---------------------------------------
 
+	lDebug() << "Modification steps of message [" << q << "] took (us): encryption=" << receiveTimings.encryption
+	         << ", cpim=" << receiveTimings.cpim << ", multipart=" << receiveTimings.multipart
+	         << ", file transfer=" << receiveTimings.fileTransfer;
+
 	// Remove internal content as it is not needed anymore and will confuse some old methods like getText()
 	internalContent.setBodyFromUtf8("");
 	internalContent.setContentType(ContentType(""));
@@ -1032,6 +1081,7 @@ void ChatMessagePrivate::handleAutoDownload() {
 		bool_t autoDownloadVoiceRecordings =
 		    linphone_core_is_auto_download_voice_recordings_enabled(q->getCore()->getCCore());
 		bool_t autoDownloadIcalendars = linphone_core_is_auto_download_icalendars_enabled(q->getCore()->getCCore());
+		bool downloading = false;
 		for (auto &c : contents) {
 			if (c->isFileTransfer()) {
 				auto ftc = static_pointer_cast<FileTransferContent>(c);
@@ -1044,6 +1094,8 @@ void ChatMessagePrivate::handleAutoDownload() {
 					if (downloadPath.empty()) {
 						lWarning() << "Download path is empty, won't be able to do auto download";
 						break;
+					} else if (isFileTransferInProgress(ftc)) {
+						downloading = true;
 					} else {
 						ostringstream sstream;
 						size_t randomSize = 12;
@@ -1055,12 +1107,14 @@ void ChatMessagePrivate::handleAutoDownload() {
 						lInfo() << "Automatically downloading file to " << filepath;
 						ftc->setFilePath(filepath);
 						setAutoFileTransferDownloadInProgress(true);
+						// The contents are downloaded at the same time, within the file transfer budget of the core.
 						q->downloadFile(ftc);
-						return;
+						downloading = true;
 					}
 				}
 			}
 		}
+		if (downloading) return;
 		currentRecvStep |= ChatMessagePrivate::Step::AutoFileDownload;
 	}
 
@@ -1828,19 +1882,26 @@ void ChatMessage::send() {
 
 bool ChatMessage::downloadFile(std::shared_ptr<FileTransferContent> fileTransferContent) {
 	L_D();
-	return d->fileTransferChatMessageModifier.downloadFile(getSharedFromThis(), fileTransferContent);
+	if (d->isFileTransferInProgress(fileTransferContent)) {
+		lError() << "There is already a download in progress for content [" << fileTransferContent << "]";
+		return false;
+	}
+	return d->getIdleFileTransferChatMessageModifier()->downloadFile(getSharedFromThis(), fileTransferContent);
 }
 
 bool ChatMessage::isFileTransferInProgress() const {
 	L_D();
-	return d->fileTransferChatMessageModifier.isFileTransferInProgressAndValid();
+	return d->isFileTransferInProgress();
 }
 
 void ChatMessage::cancelFileTransfer() {
 	L_D();
-	if (d->fileTransferChatMessageModifier.isFileTransferInProgressAndValid()) {
+	if (d->isFileTransferInProgress()) {
 		lWarning() << "Canceling file transfer on message [" << getSharedFromThis() << "]";
-		d->fileTransferChatMessageModifier.cancelFileTransfer();
+		if (d->fileTransferChatMessageModifier.isFileTransferInProgressAndValid())
+			d->fileTransferChatMessageModifier.cancelFileTransfer();
+		for (const auto &modifier : d->parallelFileTransferChatMessageModifiers)
+			if (modifier->isFileTransferInProgressAndValid()) modifier->cancelFileTransfer();
 		lInfo() << "File transfer on message [" << getSharedFromThis() << "] has been cancelled";
 
 		if (d->state == State::FileTransferInProgress) {
@@ -1902,6 +1963,8 @@ int ChatMessage::putCharacter(uint32_t character) {
 void ChatMessage::fileUploadEndBackgroundTask() {
 	L_D();
 	d->fileTransferChatMessageModifier.fileUploadEndBackgroundTask();
+	for (const auto &modifier : d->parallelFileTransferChatMessageModifiers)
+		modifier->fileUploadEndBackgroundTask();
 }
 
 void ChatMessage::addListener(shared_ptr<ChatMessageListener> listener) {
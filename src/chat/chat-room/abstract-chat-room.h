@@ -119,6 +119,8 @@ public:
 	virtual int getMessageHistorySize() const = 0;
 	virtual std::list<std::shared_ptr<EventLog>> getHistory(int nLast) const = 0;
 	virtual std::list<std::shared_ptr<EventLog>> getHistoryRange(int begin, int end) const = 0;
+	virtual std::list<std::shared_ptr<EventLog>> getHistoryBefore(const std::shared_ptr<const EventLog> &before,
+	                                                              int limit) const = 0;
 	virtual int getHistorySize() const = 0;
 
 	virtual void deleteFromDb() = 0;
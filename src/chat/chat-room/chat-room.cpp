@@ -626,6 +626,13 @@ list<shared_ptr<EventLog>> ChatRoom::getHistoryRange(int begin, int end) const {
 	        {MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter}));
 }
 
+list<shared_ptr<EventLog>> ChatRoom::getHistoryBefore(const shared_ptr<const EventLog> &before, int limit) const {
+	return getCore()->getPrivate()->mainDb->getHistoryBefore(
+	    getConferenceId(), before, limit,
+	    MainDb::FilterMask(
+	        {MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter}));
+}
+
 int ChatRoom::getHistorySize() const {
 	return getCore()->getPrivate()->mainDb->getHistorySize(getConferenceId());
 }
@@ -672,6 +672,17 @@ list<shared_ptr<EventLog>> ClientGroupChatRoom::getHistoryRange(int begin, int e
 	              {MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter}));
 }
 
+list<shared_ptr<EventLog>> ClientGroupChatRoom::getHistoryBefore(const shared_ptr<const EventLog> &before,
+                                                                int limit) const {
+	L_D();
+	return getCore()->getPrivate()->mainDb->getHistoryBefore(
+	    getConferenceId(), before, limit,
+	    (d->capabilities & Capabilities::OneToOne)
+	        ? MainDb::Filter::ConferenceChatMessageSecurityFilter
+	        : MainDb::FilterMask(
+	              {MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter}));
+}
+
 int ClientGroupChatRoom::getHistorySize() const {
 	L_D();
 	return getCore()->getPrivate()->mainDb->getHistorySize(
@@ -66,6 +66,8 @@ public:
 
 	std::list<std::shared_ptr<EventLog>> getHistory(int nLast) const override;
 	std::list<std::shared_ptr<EventLog>> getHistoryRange(int begin, int end) const override;
+	std::list<std::shared_ptr<EventLog>> getHistoryBefore(const std::shared_ptr<const EventLog> &before,
+	                                                      int limit) const override;
 	int getHistorySize() const override;
 
 	bool addParticipant(const std::shared_ptr<Address> &participantAddress) override;
@@ -153,6 +153,11 @@ list<shared_ptr<EventLog>> ProxyChatRoom::getHistoryRange(int begin, int end) co
 	return d->chatRoom->getHistoryRange(begin, end);
 }
 
+list<shared_ptr<EventLog>> ProxyChatRoom::getHistoryBefore(const shared_ptr<const EventLog> &before, int limit) const {
+	L_D();
+	return d->chatRoom->getHistoryBefore(before, limit);
+}
+
 int ProxyChatRoom::getHistorySize() const {
 	L_D();
 	return d->chatRoom->getHistorySize();
@@ -57,6 +57,8 @@ public:
 	int getMessageHistorySize() const override;
 	std::list<std::shared_ptr<EventLog>> getHistory(int nLast) const override;
 	std::list<std::shared_ptr<EventLog>> getHistoryRange(int begin, int end) const override;
+	std::list<std::shared_ptr<EventLog>> getHistoryBefore(const std::shared_ptr<const EventLog> &before,
+	                                                      int limit) const override;
 	int getHistorySize() const override;
 
 	void deleteFromDb() override;
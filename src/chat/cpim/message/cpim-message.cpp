@@ -74,6 +74,14 @@ bool Cpim::Message::addMessageHeader(const Header &messageHeader, const string &
 	return true;
 }
 
+void Cpim::Message::addParsedMessageHeader(shared_ptr<const Header> messageHeader, const string &ns) {
+	L_D();
+
+	auto &list = d->messageHeaders[ns];
+	if (!list) list = make_shared<Cpim::MessagePrivate::PrivHeaderList>();
+	list->push_back(std::move(messageHeader));
+}
+
 void Cpim::Message::removeMessageHeader(const Header &messageHeader, const string &ns) {
 	L_D();
 
@@ -114,6 +122,11 @@ bool Cpim::Message::addContentHeader(const Header &contentHeader) {
 	return true;
 }
 
+void Cpim::Message::addParsedContentHeader(shared_ptr<const Header> contentHeader) {
+	L_D();
+	d->contentHeaders->push_back(std::move(contentHeader));
+}
+
 void Cpim::Message::removeContentHeader(const Header &contentHeader) {
 	L_D();
 	d->contentHeaders->remove_if([&contentHeader](const shared_ptr<const Header> &header) {
@@ -133,7 +146,7 @@ shared_ptr<const Cpim::Header> Cpim::Message::getContentHeader(const string &nam
 
 // -----------------------------------------------------------------------------
 
-string Cpim::Message::getContent() const {
+const string &Cpim::Message::getContent() const {
 	L_D();
 	return d->content;
 }
@@ -144,6 +157,12 @@ bool Cpim::Message::setContent(const string &content) {
 	return true;
 }
 
+bool Cpim::Message::setContent(string &&content) {
+	L_D();
+	d->content = std::move(content);
+	return true;
+}
+
 // -----------------------------------------------------------------------------
 
 string Cpim::Message::asString() const {
@@ -32,6 +32,8 @@ namespace Cpim {
 class MessagePrivate;
 
 class LINPHONE_PUBLIC Message : public Object {
+	friend class Parser;
+
 public:
 	Message();
 
@@ -47,14 +49,19 @@ public:
 	void removeContentHeader(const Header &contentHeader);
 	std::shared_ptr<const Cpim::Header> getContentHeader(const std::string &name) const;
 
-	std::string getContent() const;
+	const std::string &getContent() const;
 	bool setContent(const std::string &content);
+	bool setContent(std::string &&content);
 
 	std::string asString() const;
 
 	static std::shared_ptr<const Message> createFromString(const std::string &str);
 
 private:
+	// Take headers built by the parser as they are, without cloning them.
+	void addParsedMessageHeader(std::shared_ptr<const Header> messageHeader, const std::string &ns);
+	void addParsedContentHeader(std::shared_ptr<const Header> contentHeader);
+
 	L_DECLARE_PRIVATE(Message);
 	L_DISABLE_COPY(Message);
 };
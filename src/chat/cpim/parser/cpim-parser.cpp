@@ -18,7 +18,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <set>
+#include <string_view>
 
 #include "bctoolbox/utils.hh"
 #include <belr/abnf.h>
@@ -561,6 +563,253 @@ private:
 };
 } // namespace Cpim
 
+// -----------------------------------------------------------------------------
+// Hand-written parser for the common case, following the rules of cpim-rules. It does not build any intermediate node
+// and only gives up (returning nullptr) on constructs it does not know, letting the grammar decide about them.
+// -----------------------------------------------------------------------------
+
+namespace {
+const set<string_view> CoreHeaderNames = {"From", "To", "cc", "DateTime", "Subject", "NS", "Require"};
+
+bool isAlpha(unsigned char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool isDigit(unsigned char c) {
+	return c >= '0' && c <= '9';
+}
+
+bool isHexDigit(unsigned char c) {
+	return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool isNameChar(unsigned char c) {
+	return isAlpha(c) || isDigit(c) || c == 0x21 || (c >= 0x23 && c <= 0x27) || c == 0x2a || c == 0x2b || c == 0x2d ||
+	       (c >= 0x5e && c <= 0x60) || c == 0x7c || c == 0x7e;
+}
+
+bool isUricChar(unsigned char c) {
+	static const string_view others = ";/?:@&=+$,[]-_.!~*'()";
+	return isAlpha(c) || isDigit(c) || others.find((char)c) != string_view::npos;
+}
+
+// Length of the UTF8-multi sequence starting the input, 0 if there is none.
+size_t getUtf8MultiLength(string_view s) {
+	const unsigned char c = (unsigned char)s.front();
+	size_t length = 0;
+	if (c >= 0xc0 && c <= 0xdf) length = 2;
+	else if (c >= 0xe0 && c <= 0xef) length = 3;
+	else if (c >= 0xf0 && c <= 0xf7) length = 4;
+	else if (c >= 0xf8 && c <= 0xfb) length = 5;
+	else if (c >= 0xfc && c <= 0xfd) length = 6;
+	if (length == 0 || s.size() < length) return 0;
+	for (size_t i = 1; i < length; ++i)
+		if (((unsigned char)s[i] & 0xc0) != 0x80) return 0;
+	return length;
+}
+
+bool isName(string_view s) {
+	return !s.empty() && all_of(s.begin(), s.end(), [](char c) { return isNameChar((unsigned char)c); });
+}
+
+bool isHeaderName(string_view s) {
+	const size_t dot = s.find('.');
+	if (dot == string_view::npos) return isName(s);
+	return isName(s.substr(0, dot)) && isName(s.substr(dot + 1));
+}
+
+bool isHeaderValue(string_view s) {
+	for (size_t i = 0; i < s.size();) {
+		const unsigned char c = (unsigned char)s[i];
+		const size_t length = (c >= 0x20 && c <= 0x7e) ? 1 : getUtf8MultiLength(s.substr(i));
+		if (length == 0) return false;
+		i += length;
+	}
+	return true;
+}
+
+// Quoted formal name without escape sequences.
+bool isSimpleString(string_view s) {
+	if (s.size() < 2 || s.front() != '"' || s.back() != '"') return false;
+	const string_view content = s.substr(1, s.size() - 2);
+	return content.find_first_of("\"\\") == string_view::npos && isHeaderValue(content);
+}
+
+// Formal-name = 1*( Token SP )
+bool isTokenFormalName(string_view s) {
+	if (s.empty() || s.back() != ' ') return false;
+	bool inToken = false;
+	for (size_t i = 0; i < s.size();) {
+		const unsigned char c = (unsigned char)s[i];
+		if (c == ' ') {
+			if (!inToken) return false;
+			inToken = false;
+			++i;
+			continue;
+		}
+		const size_t length = (isNameChar(c) || c == '.') ? 1 : getUtf8MultiLength(s.substr(i));
+		if (length == 0) return false;
+		inToken = true;
+		i += length;
+	}
+	return true;
+}
+
+// Absolute URI with an opaque part, which is what SIP and URN URIs are.
+bool isOpaqueUri(string_view s) {
+	const size_t colon = s.find(':');
+	if (colon == string_view::npos || colon == 0 || !isAlpha((unsigned char)s.front())) return false;
+	for (size_t i = 1; i < colon; ++i) {
+		const unsigned char c = (unsigned char)s[i];
+		if (!isAlpha(c) && !isDigit(c) && c != '+' && c != '-' && c != '.') return false;
+	}
+
+	const string_view part = s.substr(colon + 1);
+	if (part.empty() || part.front() == '/' || part.front() == '[' || part.front() == ']') return false;
+	for (size_t i = 0; i < part.size();) {
+		const unsigned char c = (unsigned char)part[i];
+		if (c == '%') {
+			if (i + 2 >= part.size() || !isHexDigit((unsigned char)part[i + 1]) ||
+			    !isHexDigit((unsigned char)part[i + 2]))
+				return false;
+			i += 3;
+		} else if (isUricChar(c)) ++i;
+		else return false;
+	}
+	return true;
+}
+
+bool parseDigits(string_view &s, size_t count, int &value) {
+	if (s.size() < count) return false;
+	value = 0;
+	for (size_t i = 0; i < count; ++i) {
+		if (!isDigit((unsigned char)s[i])) return false;
+		value = value * 10 + (s[i] - '0');
+	}
+	s.remove_prefix(count);
+	return true;
+}
+
+bool parseChar(string_view &s, char expected) {
+	if (s.empty() || tolower((unsigned char)s.front()) != tolower((unsigned char)expected)) return false;
+	s.remove_prefix(1);
+	return true;
+}
+
+// date-time = full-date "T" full-time
+shared_ptr<Cpim::Header> createDateTimeHeader(string_view s) {
+	tm time = {};
+	tm timeOffset = {};
+	int month = 0;
+	if (!parseDigits(s, 4, time.tm_year) || !parseChar(s, '-') || !parseDigits(s, 2, month) || !parseChar(s, '-') ||
+	    !parseDigits(s, 2, time.tm_mday) || !parseChar(s, 'T') || !parseDigits(s, 2, time.tm_hour) ||
+	    !parseChar(s, ':') || !parseDigits(s, 2, time.tm_min) || !parseChar(s, ':') || !parseDigits(s, 2, time.tm_sec))
+		return nullptr;
+	time.tm_mon = month - 1;
+
+	if (parseChar(s, '.')) {
+		if (s.empty() || !isDigit((unsigned char)s.front())) return nullptr;
+		while (!s.empty() && isDigit((unsigned char)s.front()))
+			s.remove_prefix(1);
+	}
+
+	string signOffset = "Z";
+	if (!parseChar(s, 'Z')) {
+		if (s.empty() || (s.front() != '+' && s.front() != '-')) return nullptr;
+		signOffset = string(1, s.front());
+		s.remove_prefix(1);
+		if (!parseDigits(s, 2, timeOffset.tm_hour) || !parseChar(s, ':') || !parseDigits(s, 2, timeOffset.tm_min))
+			return nullptr;
+	}
+	if (!s.empty()) return nullptr;
+
+	// Same validation as the grammar.
+	Cpim::DateTimeHeaderNode node;
+	node.setTime(time);
+	node.setTimeOffset(timeOffset);
+	node.setSignOffset(signOffset);
+	return node.createHeader();
+}
+
+// [ Formal-name ] "<" URI ">"
+shared_ptr<Cpim::Header> createContactHeader(string_view name, string_view value) {
+	const size_t lt = value.find('<');
+	if (lt == string_view::npos || value.back() != '>') return nullptr;
+	const string_view formalName = value.substr(0, lt);
+	const string_view uri = value.substr(lt + 1, value.size() - lt - 2);
+	if (!isOpaqueUri(uri)) return nullptr;
+	if (!formalName.empty() && !isSimpleString(formalName) && !isTokenFormalName(formalName)) return nullptr;
+
+	if (name == "From") return make_shared<Cpim::FromHeader>(string(uri), string(formalName));
+	if (name == "To") return make_shared<Cpim::ToHeader>(string(uri), string(formalName));
+	return make_shared<Cpim::CcHeader>(string(uri), string(formalName));
+}
+
+// [ Name-prefix SP ] "<" URI ">"
+shared_ptr<Cpim::Header> createNsHeader(string_view value) {
+	const size_t lt = value.find('<');
+	if (lt == string_view::npos || value.back() != '>') return nullptr;
+	string_view prefixName = value.substr(0, lt);
+	if (!prefixName.empty()) {
+		if (prefixName.back() != ' ') return nullptr;
+		prefixName.remove_suffix(1);
+		if (!isName(prefixName)) return nullptr;
+	}
+	const string_view uri = value.substr(lt + 1, value.size() - lt - 2);
+	if (!isOpaqueUri(uri)) return nullptr;
+	return make_shared<Cpim::NsHeader>(string(uri), string(prefixName));
+}
+
+// Header-name *( "," Header-name )
+shared_ptr<Cpim::Header> createRequireHeader(string_view value) {
+	for (string_view names = value;;) {
+		const size_t comma = names.find(',');
+		if (!isHeaderName(names.substr(0, comma))) return nullptr;
+		if (comma == string_view::npos) break;
+		names.remove_prefix(comma + 1);
+	}
+	return make_shared<Cpim::RequireHeader>(string(value));
+}
+
+shared_ptr<Cpim::Header> createCoreHeader(string_view name, string_view value) {
+	if (value.empty()) return nullptr;
+	if (name == "From" || name == "To" || name == "cc") return createContactHeader(name, value);
+	if (name == "DateTime") return createDateTimeHeader(value);
+	if (name == "NS") return createNsHeader(value);
+	if (name == "Require") return createRequireHeader(value);
+	if (name == "Subject" && isHeaderValue(value)) return make_shared<Cpim::SubjectHeader>(string(value));
+	return nullptr;
+}
+
+// Header = Header-name ":" SP Header-value, header parameters are left to the grammar.
+shared_ptr<Cpim::Header> createGenericHeader(string_view name, string_view value) {
+	if (!isHeaderName(name) || value.empty() || !isHeaderValue(value)) return nullptr;
+	return make_shared<Cpim::GenericHeader>(string(name), string(value));
+}
+
+bool splitHeaderLine(string_view line, string_view &name, string_view &value) {
+	const size_t colon = line.find(':');
+	if (colon == string_view::npos || colon + 1 >= line.size() || line[colon + 1] != ' ') return false;
+	name = line.substr(0, colon);
+	value = line.substr(colon + 2);
+	return true;
+}
+
+bool getLine(string_view &input, string_view &line) {
+	const size_t end = input.find("\r\n");
+	if (end == string_view::npos) return false;
+	line = input.substr(0, end);
+	input.remove_prefix(end + 2);
+	return true;
+}
+
+bool equalsIgnoreCase(string_view a, string_view b) {
+	return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+		       return tolower((unsigned char)x) == tolower((unsigned char)y);
+	       });
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 
 class Cpim::ParserPrivate : public ObjectPrivate {
@@ -638,6 +887,60 @@ Cpim::Parser::Parser() : Singleton(*new ParserPrivate) {
 // -----------------------------------------------------------------------------
 
 shared_ptr<Cpim::Message> Cpim::Parser::parseMessage(const string &input) {
+	shared_ptr<Message> message = parseMessageFast(input);
+	return message ? message : parseMessageWithGrammar(input);
+}
+
+shared_ptr<Cpim::Message> Cpim::Parser::parseMessageFast(const string &input) {
+	string_view remaining = input;
+	string_view line;
+	if (!getLine(remaining, line)) return nullptr;
+	if (equalsIgnoreCase(line, "Content-Type: Message/CPIM")) {
+		if (!getLine(remaining, line) || !line.empty() || !getLine(remaining, line)) return nullptr;
+	}
+
+	shared_ptr<Message> message = make_shared<Message>();
+	string_view name;
+	string_view value;
+
+	// Message headers, the namespace of a header being the prefix of its name.
+	if (line.empty()) return nullptr;
+	while (!line.empty()) {
+		if (!splitHeaderLine(line, name, value)) return nullptr;
+		shared_ptr<Header> header;
+		string_view ns;
+		if (CoreHeaderNames.count(name)) {
+			header = createCoreHeader(name, value);
+		} else {
+			if (!isHeaderName(name)) return nullptr;
+			const size_t dot = name.find('.');
+			if (dot != string_view::npos) {
+				ns = name.substr(0, dot);
+				name.remove_prefix(dot + 1);
+				if (CoreHeaderNames.count(name)) return nullptr;
+			}
+			header = createGenericHeader(name, value);
+		}
+		if (!header) return nullptr;
+		message->addParsedMessageHeader(header, string(ns));
+		if (!getLine(remaining, line)) return nullptr;
+	}
+
+	// Content headers.
+	if (!getLine(remaining, line) || line.empty()) return nullptr;
+	while (!line.empty()) {
+		if (!splitHeaderLine(line, name, value) || CoreHeaderNames.count(name)) return nullptr;
+		shared_ptr<Header> header = createGenericHeader(name, value);
+		if (!header) return nullptr;
+		message->addParsedContentHeader(header);
+		if (!getLine(remaining, line)) return nullptr;
+	}
+
+	message->setContent(string(remaining));
+	return message;
+}
+
+shared_ptr<Cpim::Message> Cpim::Parser::parseMessageWithGrammar(const string &input) {
 	L_D();
 
 	size_t parsedSize;
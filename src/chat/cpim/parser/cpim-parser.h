@@ -35,8 +35,14 @@ class Parser : public Singleton<Parser> {
 	friend class Singleton<Parser>;
 
 public:
+	// Uses a hand-written parser for the headers that are commonly found in chat messages, falls back on the CPIM
+	// grammar for anything else.
 	std::shared_ptr<Message> parseMessage(const std::string &input);
 
+	// Hand-written parser only, returns nullptr for any message that has to go through the grammar.
+	std::shared_ptr<Message> parseMessageFast(const std::string &input);
+	std::shared_ptr<Message> parseMessageWithGrammar(const std::string &input);
+
 	std::shared_ptr<Header> cloneHeader(const Header &header);
 
 private:
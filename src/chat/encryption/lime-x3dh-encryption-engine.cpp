@@ -35,6 +35,7 @@
 #include "conference/participant.h"
 #include "content/content-manager.h"
 #include "content/header/header-param.h"
+#include "core/core-p.h"
 #include "core/core.h"
 #include "event-log/conference/conference-security-event.h"
 #include "factory/factory.h"
@@ -928,7 +929,8 @@ void LimeX3dhEncryptionEngine::authenticationRejected(const char *peerDeviceId)
 
 void LimeX3dhEncryptionEngine::addSecurityEventInChatrooms(
     const std::shared_ptr<Address> &peerDeviceAddr, ConferenceSecurityEvent::SecurityEventType securityEventType) {
-	const list<shared_ptr<AbstractChatRoom>> chatRooms = getCore()->getChatRooms();
+	// Encrypted chat rooms are conference chat rooms, a client builds them at startup.
+	const list<shared_ptr<AbstractChatRoom>> chatRooms = getCore()->getPrivate()->getLoadedChatRooms();
 	for (const auto &chatRoom : chatRooms) {
 		if (chatRoom->findParticipant(peerDeviceAddr) &&
 		    (chatRoom->getCapabilities() & ChatRoom::Capabilities::Encrypted)) {
@@ -141,7 +141,7 @@ ChatMessageModifier::Result CpimChatMessageModifier::encode(const shared_ptr<Cha
 		content = message->getContents().front().get();
 	}
 
-	const string contentBody = content->getBodyAsUtf8String();
+	const string &contentBody = content->getBodyAsUtf8String();
 	if (reactionToMessageId.empty()) {
 		if (content->getContentDisposition().isValid()) {
 			cpimMessage.addContentHeader(
@@ -176,7 +176,8 @@ ChatMessageModifier::Result CpimChatMessageModifier::decode(const shared_ptr<Cha
 		return ChatMessageModifier::Result::Skipped;
 	}
 
-	const string contentBody = content->getBodyAsUtf8String();
+	// The first call copies the incoming body into the cached string of the content.
+	const string &contentBody = content->getBodyAsUtf8String();
 	const shared_ptr<const Cpim::Message> cpimMessage = Cpim::Message::createFromString(contentBody);
 	if (!cpimMessage || !cpimMessage->getMessageHeader("From") || !cpimMessage->getMessageHeader("To")) {
 		lError() << "[CPIM] Message is invalid: " << contentBody;
@@ -195,6 +196,7 @@ ChatMessageModifier::Result CpimChatMessageModifier::decode(const shared_ptr<Cha
 	auto contentDispositionHeader = cpimMessage->getContentHeader("Content-Disposition");
 	if (contentDispositionHeader)
 		newContent.setContentDisposition(ContentDisposition(contentDispositionHeader->getValue()));
+	// The body of the new content gets its own copy of the payload.
 	newContent.setBodyFromUtf8(cpimMessage->getContent());
 	newContent.setContentEncoding(content->getContentEncoding());
 
@@ -32,12 +32,13 @@
 #include "chat/encryption/encryption-engine.h"
 #include "conference/participant.h"
 #include "content/content-type.h"
-#include "core/core.h"
+#include "core/core-p.h"
 #include "logger/logger.h"
 
 #include "file-transfer-chat-message-modifier.h"
 
 #include <cstdio>
+#include <cstring>
 
 // =============================================================================
 
@@ -68,23 +69,31 @@ ChatMessageModifier::Result FileTransferChatMessageModifier::encode(const shared
                                                                     BCTBX_UNUSED(int &errorCode)) {
 	chatMessage = message;
 
+	// The message goes on once the last of its uploads is done.
+	if (message->getPrivate()->isFileTransferInProgress()) return ChatMessageModifier::Result::Suspended;
+
 	currentFileContentToTransfer = nullptr;
 	currentFileTransferContent = nullptr;
-	// For each FileContent, upload it and create a FileTransferContent
+	// Upload all the FileContents at the same time, each one is replaced by a FileTransferContent once uploaded.
+	list<FileTransferChatMessageModifier *> uploads;
 	for (auto &content : message->getContents()) {
-		if (content->isFile()) {
-			lInfo() << "Found file content [" << content << "], set it for file upload";
-			auto fileContent = static_pointer_cast<FileContent>(content);
-			currentFileContentToTransfer = fileContent;
-			break;
+		if (!content->isFile()) continue;
+
+		lInfo() << "Found file content [" << content << "], set it for file upload";
+		FileTransferChatMessageModifier *modifier = message->getPrivate()->getIdleFileTransferChatMessageModifier();
+		modifier->chatMessage = message;
+		modifier->currentFileContentToTransfer = static_pointer_cast<FileContent>(content);
+		modifier->currentFileTransferContent = nullptr;
+		/* Open a transaction with the server and send an empty request(RCS5.1 section 3.5.4.8.3.1) */
+		if (!modifier->scheduleTransfer(message, [modifier]() { return modifier->uploadFile(nullptr); })) {
+			for (auto upload : uploads)
+				upload->cancelFileTransfer();
+			return ChatMessageModifier::Result::Error;
 		}
+		uploads.push_back(modifier);
 	}
-	if (!currentFileContentToTransfer) return ChatMessageModifier::Result::Skipped;
-
-	/* Open a transaction with the server and send an empty request(RCS5.1 section 3.5.4.8.3.1) */
-	if (uploadFile(nullptr) == 0) return ChatMessageModifier::Result::Suspended;
 
-	return ChatMessageModifier::Result::Error;
+	return uploads.empty() ? ChatMessageModifier::Result::Skipped : ChatMessageModifier::Result::Suspended;
 }
 
 // ----------------------------------------------------------
@@ -107,6 +116,15 @@ void FileTransferChatMessageModifier::fileTransferOnProgress(BCTBX_UNUSED(belle_
 	shared_ptr<ChatMessage> message = chatMessage.lock();
 	if (!message) return;
 
+	if (offset > transferredBytes) {
+		shared_ptr<Core> core = transferCore.lock();
+		if (core) core->getPrivate()->addFileTransferBytes(offset - transferredBytes);
+		transferredBytes = offset;
+	}
+
+	// A resumed download only carries the remainder of the file.
+	offset += downloadResumeOffset;
+	total += downloadResumeOffset;
 	size_t percentage = offset * 100 / total;
 	if (percentage <= lastNotifiedPercentage) {
 		return;
@@ -181,20 +199,25 @@ int FileTransferChatMessageModifier::onSendBody(BCTBX_UNUSED(belle_sip_user_body
 		// Deprecated, use _linphone_chat_message_notify_file_transfer_send_chunk instead
 		_linphone_chat_message_notify_file_transfer_send(msg, content, offset, *size);
 
-		LinphoneBuffer *lb = linphone_buffer_new();
-		_linphone_chat_message_notify_file_transfer_send_chunk(msg, content, offset, *size, lb);
-		size_t lb_size = linphone_buffer_get_size(lb);
+		// The chunk buffer keeps its allocation from one chunk to the next unless the application kept it.
+		if (sendChunkBuffer && linphone_buffer_is_shared(sendChunkBuffer)) {
+			linphone_buffer_unref(sendChunkBuffer);
+			sendChunkBuffer = nullptr;
+		}
+		if (!sendChunkBuffer) sendChunkBuffer = linphone_buffer_new();
+		linphone_buffer_set_size(sendChunkBuffer, 0);
+		_linphone_chat_message_notify_file_transfer_send_chunk(msg, content, offset, *size, sendChunkBuffer);
+		size_t lb_size = linphone_buffer_get_size(sendChunkBuffer);
 		if (lb_size != 0) {
-			memcpy(buffer, linphone_buffer_get_content(lb), lb_size);
+			memcpy(buffer, linphone_buffer_get_content(sendChunkBuffer), lb_size);
 			*size = lb_size;
 		}
-		linphone_buffer_unref(lb);
 	}
 
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 	if (imee) {
 		size_t max_size = *size;
-		uint8_t *encrypted_buffer = (uint8_t *)ms_malloc0(max_size);
+		uint8_t *encrypted_buffer = getScratchBuffer(max_size);
 		retval = imee->uploadingFile(L_GET_CPP_PTR_FROM_C_OBJECT(msg), offset, buffer, size, encrypted_buffer,
 		                             currentFileTransferContent);
 		if (retval == 0) {
@@ -205,7 +228,6 @@ int FileTransferChatMessageModifier::onSendBody(BCTBX_UNUSED(belle_sip_user_body
 			}
 			memcpy(buffer, encrypted_buffer, *size);
 		}
-		ms_free(encrypted_buffer);
 	}
 
 	return retval <= 0 && *size != 0 ? BELLE_SIP_CONTINUE : BELLE_SIP_STOP;
@@ -338,11 +360,7 @@ void FileTransferChatMessageModifier::processResponseFromPostFile(const belle_ht
 		int code = belle_http_response_get_status_code(event->response);
 		if (code == 204) { // this is the reply to the first post to the server - an empty msg
 			auto bh = prepare_upload_body_handler(message);
-
-			// Save currentFileContentToTransfer pointer as it will be set to NULL in releaseHttpRequest
-			auto fileContent = currentFileContentToTransfer;
-			releaseHttpRequest();
-			currentFileContentToTransfer = fileContent;
+			dropHttpRequest();
 
 			fileUploadBeginBackgroundTask();
 			uploadFile(bh);
@@ -388,10 +406,17 @@ void FileTransferChatMessageModifier::processResponseFromPostFile(const belle_ht
 				currentFileTransferContent->setBodyFromUtf8(xml_body.c_str());
 				currentFileTransferContent = nullptr;
 
-				message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
-				                                           ChatMessage::State::FileTransferDone, ::ms_time(nullptr));
 				releaseHttpRequest();
-				message->getPrivate()->send();
+				// The message is sent once the last of the file contents uploaded at the same time is, unless the
+				// upload of another one failed.
+				ChatMessage::State state = message->getState();
+				if (!message->getPrivate()->isFileTransferInProgress() && state != ChatMessage::State::NotDelivered &&
+				    state != ChatMessage::State::FileTransferError) {
+					message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
+					                                           ChatMessage::State::FileTransferDone,
+					                                           ::ms_time(nullptr));
+					message->getPrivate()->send();
+				}
 				fileUploadEndBackgroundTask();
 			} else {
 				lWarning() << "Received empty response from server, file transfer failed";
@@ -523,7 +548,8 @@ int FileTransferChatMessageModifier::uploadFile(belle_sip_body_handler_t *bh) {
 int FileTransferChatMessageModifier::startHttpTransfer(const string &url,
                                                        const string &action,
                                                        belle_sip_body_handler_t *bh,
-                                                       belle_http_request_listener_callbacks_t *cbs) {
+                                                       belle_http_request_listener_callbacks_t *cbs,
+                                                       size_t rangeStart) {
 	belle_generic_uri_t *uri = nullptr;
 
 	shared_ptr<ChatMessage> message = chatMessage.lock();
@@ -552,6 +578,13 @@ int FileTransferChatMessageModifier::startHttpTransfer(const string &url,
 		lWarning() << "Could not create http request for uri " << url;
 		goto error;
 	}
+	if (rangeStart > 0) {
+		belle_sip_message_add_header(BELLE_SIP_MESSAGE(httpRequest),
+		                             belle_http_header_create("Range", ("bytes=" + to_string(rangeStart) + "-").c_str()));
+		if (!downloadValidator.empty())
+			belle_sip_message_add_header(BELLE_SIP_MESSAGE(httpRequest),
+			                             belle_http_header_create("If-Range", downloadValidator.c_str()));
+	}
 	if (bh) belle_sip_message_set_body_handler(BELLE_SIP_MESSAGE(httpRequest), BELLE_SIP_BODY_HANDLER(bh));
 	// keep a reference to the http request to be able to cancel it during upload
 	belle_sip_object_ref(httpRequest);
@@ -637,35 +670,45 @@ void FileTransferChatMessageModifier::onRecvBody(BCTBX_UNUSED(belle_sip_user_bod
 	if (!message) return;
 
 	int retval = -1;
+	const bool toFile = !currentFileContentToTransfer->getFilePath().empty();
+	const uint8_t *data = buffer;
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 	if (imee) {
-		uint8_t *decrypted_buffer = (uint8_t *)ms_malloc0(size);
+		uint8_t *decrypted_buffer = getScratchBuffer(size);
 		retval = imee->downloadingFile(message, offset, buffer, size, decrypted_buffer, currentFileTransferContent);
 		if (retval == 0) {
-			memcpy(buffer, decrypted_buffer, size);
+			// The file body handler writes what is left in the belle-sip buffer, the callbacks can read the
+			// decrypted data where it is.
+			if (toFile) memcpy(buffer, decrypted_buffer, size);
+			else data = decrypted_buffer;
 		}
-		ms_free(decrypted_buffer);
 	}
 
 	if (retval == 0 || retval == -1) {
-		if (currentFileContentToTransfer->getFilePath().empty()) {
+		if (!toFile) {
 			LinphoneChatMessage *msg = L_GET_C_BACK_PTR(message);
 			LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(msg);
 			LinphoneContent *content = currentFileContentToTransfer->toC();
-			LinphoneBuffer *lb = linphone_buffer_new_from_data(buffer, size);
+			LinphoneBuffer *lb = linphone_buffer_new_view(data, size);
 			// Deprecated: use list of callbacks now
 			if (linphone_chat_message_cbs_get_file_transfer_recv(cbs)) {
 				linphone_chat_message_cbs_get_file_transfer_recv(cbs)(msg, content, lb);
 			} else {
 				// Legacy: call back given by application level
 				linphone_core_notify_file_transfer_recv(message->getCore()->getCCore(), msg, content,
-				                                        (const char *)buffer, size);
+				                                        (const char *)data, size);
 			}
 			_linphone_chat_message_notify_file_transfer_recv(msg, content, lb);
-			linphone_buffer_unref(lb);
+			linphone_buffer_release_view(lb);
+		} else if (resumeFile) {
+			if (bctbx_file_write(resumeFile, data, size, (off_t)(downloadResumeOffset + offset)) != (ssize_t)size) {
+				lError() << "Couldn't append to partially downloaded file "
+				         << currentFileContentToTransfer->getFilePathSys();
+			}
 		}
 	} else {
 		lWarning() << "File transfer decrypt failed with code -" << hex << (int)(-retval);
+		downloadDecryptFailed = true;
 		message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
 		                                           ChatMessage::State::FileTransferError, ::ms_time(nullptr));
 	}
@@ -712,6 +755,7 @@ void FileTransferChatMessageModifier::onRecvEnd(BCTBX_UNUSED(belle_sip_user_body
 	if (!message) return;
 
 	shared_ptr<Core> core = message->getCore();
+	closeResumeFile();
 
 	int retval = -1;
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
@@ -736,7 +780,10 @@ void FileTransferChatMessageModifier::onRecvEnd(BCTBX_UNUSED(belle_sip_user_body
 			linphone_buffer_unref(lb);
 		}
 
-		if (message->getState() != ChatMessage::State::FileTransferError) {
+		if (downloadDecryptFailed) {
+			releaseHttpRequest();
+			currentFileTransferContent = nullptr;
+		} else {
 			// Remove the FileTransferContent from the message and store the FileContent
 			auto fileContent = currentFileContentToTransfer;
 
@@ -759,8 +806,12 @@ void FileTransferChatMessageModifier::onRecvEnd(BCTBX_UNUSED(belle_sip_user_body
 
 			releaseHttpRequest();
 
-			message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
-			                                           ChatMessage::State::FileTransferDone, ::ms_time(nullptr));
+			// The message is done once the last of its contents downloaded at the same time is.
+			if (message->getPrivate()->isFileTransferInProgress()) return;
+			if (message->getState() != ChatMessage::State::FileTransferError) {
+				message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
+				                                           ChatMessage::State::FileTransferDone, ::ms_time(nullptr));
+			}
 
 			if (message->getPrivate()->isAutoFileTransferDownloadInProgress()) {
 				message->getPrivate()->handleAutoDownload();
@@ -823,6 +874,49 @@ void FileTransferChatMessageModifier::processResponseHeadersFromGetFile(const be
 		// if not done, belle-sip will create a memory body handler, the default
 		belle_sip_message_t *response = BELLE_SIP_MESSAGE(event->response);
 
+		if (downloadResumeOffset > 0) {
+			const string filePath = currentFileContentToTransfer->getFilePathSys();
+			if (continuesPartialDownload(event->response, downloadResumeOffset)) {
+				belle_sip_header_content_length_t *content_length_hdr =
+				    BELLE_SIP_HEADER_CONTENT_LENGTH(belle_sip_message_get_header(response, "Content-Length"));
+				size_t remaining = belle_sip_header_content_length_get_content_length(content_length_hdr);
+				resumeFile = bctbx_file_open(bctbx_vfs_get_default(), filePath.c_str(), "r+");
+				if (resumeFile) {
+					lInfo() << "Resuming download of [" << filePath << "] at byte " << downloadResumeOffset << ", "
+					        << remaining << " bytes left";
+					currentFileContentToTransfer->setFileSize(downloadResumeOffset + remaining);
+					belle_sip_message_set_body_handler(
+					    response, (belle_sip_body_handler_t *)belle_sip_buffering_user_body_handler_new(
+					                  remaining, 16, _chat_message_file_transfer_on_progress, nullptr,
+					                  _chat_message_on_recv_body, nullptr, _chat_message_on_recv_end, this));
+					return;
+				}
+				lError() << "Couldn't reopen partially downloaded file " << filePath;
+			}
+			std::remove(filePath.c_str());
+			downloadResumeOffset = 0;
+			if (code != 200) {
+				// Only a part of the file is coming, drop it and download the whole file again.
+				lWarning() << "Range request not honored (code " << code << "), restarting download of [" << filePath
+				           << "]";
+				downloadRestartPending = true;
+				belle_sip_message_set_body_handler(response, (belle_sip_body_handler_t *)belle_sip_user_body_handler_new(
+				                                                 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr));
+				return;
+			}
+			lInfo() << "File [" << filePath << "] changed on the server, downloading it from the beginning";
+		}
+
+		// Validator of the downloaded version of the file, a resumed download must be of the same version.
+		belle_sip_header_t *validator = belle_sip_message_get_header(response, "ETag");
+		const char *validatorValue = validator ? belle_sip_header_get_unparsed_value(validator) : nullptr;
+		// Weak entity tags cannot be used in an If-Range.
+		if (!validatorValue || strncmp(validatorValue, "W/", 2) == 0) {
+			validator = belle_sip_message_get_header(response, "Last-Modified");
+			validatorValue = validator ? belle_sip_header_get_unparsed_value(validator) : nullptr;
+		}
+		downloadValidator = L_C_TO_STRING(validatorValue);
+
 		if (currentFileContentToTransfer) {
 			belle_sip_header_content_length_t *content_length_hdr =
 			    BELLE_SIP_HEADER_CONTENT_LENGTH(belle_sip_message_get_header(response, "Content-Length"));
@@ -873,7 +967,7 @@ void FileTransferChatMessageModifier::onDownloadFailed() {
 		lError() << "Auto download failed for message [" << message << "]";
 		message->getPrivate()->doNotRetryAutoDownload();
 		releaseHttpRequest();
-		message->getPrivate()->handleAutoDownload();
+		if (!message->getPrivate()->isFileTransferInProgress()) message->getPrivate()->handleAutoDownload();
 	} else {
 		message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
 		                                           ChatMessage::State::FileTransferError, ::ms_time(nullptr));
@@ -907,6 +1001,7 @@ static void _chat_message_process_io_error_download(void *data, const belle_sip_
 void FileTransferChatMessageModifier::processIoErrorDownload(BCTBX_UNUSED(const belle_sip_io_error_event_t *event)) {
 	shared_ptr<ChatMessage> message = chatMessage.lock();
 	lError() << "I/O Error during file download message [" << message << "]";
+	if (resumeDownload()) return;
 	onDownloadFailed();
 }
 
@@ -922,15 +1017,95 @@ void FileTransferChatMessageModifier::processResponseFromGetFile(const belle_htt
 		if (!message) return;
 
 		int code = belle_http_response_get_status_code(event->response);
-		if (code >= 400 && code < 500) {
+		if (downloadRestartPending) {
+			downloadRestartPending = false;
+			if (!restartDownload()) onDownloadFailed();
+		} else if (code >= 400 && code < 500) {
 			lWarning() << "File transfer failed with code " << code;
 			onDownloadFailed();
-		} else if (code != 200) {
+		} else if (code != 200 && code != 206) {
 			lWarning() << "Unhandled HTTP code response " << code << " for file transfer";
 		}
 	}
 }
 
+bool FileTransferChatMessageModifier::resumeDownload() {
+	shared_ptr<ChatMessage> message = chatMessage.lock();
+	if (!message || !httpRequest || !currentFileContentToTransfer || !currentFileTransferContent || downloadUrl.empty())
+		return false;
+	// Encrypted files are decrypted as a stream from their first byte, only plain files can be continued.
+	if (currentFileTransferContent->getFileKeySize() > 0) return false;
+	const string filePath = currentFileContentToTransfer->getFilePathSys();
+	if (filePath.empty()) return false;
+	int maxRetries =
+	    linphone_config_get_int(message->getCore()->getCCore()->config, "misc", "file_transfer_download_max_retries", 3);
+	if (downloadRetryCount >= maxRetries) return false;
+	if (downloadValidator.empty()) {
+		lWarning() << "Cannot resume download of [" << filePath << "]: no ETag nor Last-Modified in the response";
+		return false;
+	}
+
+	closeResumeFile();
+	int64_t received = 0;
+	bctbx_vfs_file_t *file = bctbx_file_open(bctbx_vfs_get_default(), filePath.c_str(), "r");
+	if (file) {
+		received = bctbx_file_size(file);
+		bctbx_file_close(file);
+	}
+	if (received <= 0) return false;
+
+	downloadRetryCount++;
+	lInfo() << "Download of [" << filePath << "] interrupted after " << received << " bytes, resuming (attempt "
+	        << downloadRetryCount << "/" << maxRetries << ")";
+	downloadResumeOffset = (size_t)received;
+	return sendDownloadRequest(downloadResumeOffset) == 0;
+}
+
+bool FileTransferChatMessageModifier::restartDownload() {
+	if (!httpRequest || !currentFileContentToTransfer || downloadUrl.empty()) return false;
+	closeResumeFile();
+	downloadValidator.clear();
+	downloadResumeOffset = 0;
+	return sendDownloadRequest(0) == 0;
+}
+
+int FileTransferChatMessageModifier::sendDownloadRequest(size_t rangeStart) {
+	// Drop the previous request but keep the contents being downloaded.
+	dropHttpRequest();
+	transferredBytes = 0;
+
+	belle_http_request_listener_callbacks_t cbs = {0};
+	cbs.process_response_headers = _chat_process_response_headers_from_get_file;
+	cbs.process_response = _chat_message_process_response_from_get_file;
+	cbs.process_io_error = _chat_message_process_io_error_download;
+	cbs.process_auth_requested = _chat_message_process_auth_requested_download;
+	return startHttpTransfer(downloadUrl, "GET", nullptr, &cbs, rangeStart);
+}
+
+bool FileTransferChatMessageModifier::continuesPartialDownload(belle_http_response_t *response, size_t offset) {
+	if (belle_http_response_get_status_code(response) != 206) return false;
+
+	belle_sip_message_t *message = BELLE_SIP_MESSAGE(response);
+	belle_sip_header_content_length_t *contentLength =
+	    BELLE_SIP_HEADER_CONTENT_LENGTH(belle_sip_message_get_header(message, "Content-Length"));
+	belle_sip_header_t *contentRange = belle_sip_message_get_header(message, "Content-Range");
+	const char *value = contentRange ? belle_sip_header_get_unparsed_value(contentRange) : nullptr;
+	if (!contentLength || !value) return false;
+
+	// "bytes <first>-<last>/<complete length or *>"
+	unsigned long long first = 0;
+	unsigned long long last = 0;
+	if (sscanf(value, "bytes %llu-%llu", &first, &last) != 2 || last < first) return false;
+	return first == offset && last - first + 1 == belle_sip_header_content_length_get_content_length(contentLength);
+}
+
+void FileTransferChatMessageModifier::closeResumeFile() {
+	if (resumeFile) {
+		bctbx_file_close(resumeFile);
+		resumeFile = nullptr;
+	}
+}
+
 static void createFileContentFromFileTransferContent(std::shared_ptr<FileTransferContent> &fileTransferContent) {
 	auto fileContent = FileContent::create<FileContent>();
 
@@ -948,7 +1123,7 @@ bool FileTransferChatMessageModifier::downloadFile(const shared_ptr<ChatMessage>
                                                    std::shared_ptr<FileTransferContent> &fileTransferContent) {
 	chatMessage = message;
 
-	if (httpRequest) {
+	if (httpRequest || transferPending) {
 		lError() << "There is already a download in progress.";
 		return false;
 	}
@@ -978,12 +1153,6 @@ bool FileTransferChatMessageModifier::downloadFile(const shared_ptr<ChatMessage>
 	lInfo() << "Downloading file transfer content [" << fileTransferContent
 	        << "], result will be available in file content [" << fileContent->getFilePath() << "]";
 
-	belle_http_request_listener_callbacks_t cbs = {0};
-	cbs.process_response_headers = _chat_process_response_headers_from_get_file;
-	cbs.process_response = _chat_message_process_response_from_get_file;
-	cbs.process_io_error = _chat_message_process_io_error_download;
-	cbs.process_auth_requested = _chat_message_process_auth_requested_download;
-
 	std::string url =
 	    fileTransferContent
 	        ->getFileUrl(); // File URL has been set by createFileTransferInformationsFromVndGsmaRcsFtHttpXml
@@ -995,8 +1164,13 @@ bool FileTransferChatMessageModifier::downloadFile(const shared_ptr<ChatMessage>
 		proxy.append("?target=");
 		url.insert(0, proxy);
 	}
-	int err = startHttpTransfer(url, "GET", nullptr, &cbs);
-	if (err == -1) return false;
+	downloadUrl = url;
+	downloadValidator.clear();
+	downloadResumeOffset = 0;
+	downloadRetryCount = 0;
+	downloadRestartPending = false;
+	downloadDecryptFailed = false;
+	if (!scheduleTransfer(message, [this]() { return sendDownloadRequest(0); })) return false;
 	// start the download, status is In Progress
 	message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
 	                                           ChatMessage::State::FileTransferInProgress, ::ms_time(nullptr));
@@ -1006,6 +1180,12 @@ bool FileTransferChatMessageModifier::downloadFile(const shared_ptr<ChatMessage>
 // ----------------------------------------------------------
 
 void FileTransferChatMessageModifier::cancelFileTransfer() {
+	if (transferPending) {
+		lInfo() << "Cancelling file transfer waiting for its turn";
+		releaseHttpRequest();
+		return;
+	}
+
 	if (!httpRequest) {
 		lInfo() << "No existing file transfer - nothing to cancel";
 		return;
@@ -1045,10 +1225,55 @@ void FileTransferChatMessageModifier::cancelFileTransfer() {
 }
 
 bool FileTransferChatMessageModifier::isFileTransferInProgressAndValid() const {
-	return httpRequest && !belle_http_request_is_cancelled(httpRequest);
+	return transferPending || (httpRequest && !belle_http_request_is_cancelled(httpRequest));
 }
 
-void FileTransferChatMessageModifier::releaseHttpRequest() {
+bool FileTransferChatMessageModifier::isTransferringContent(const shared_ptr<Content> &content) const {
+	return isFileTransferInProgressAndValid() &&
+	       (content == currentFileContentToTransfer || content == currentFileTransferContent);
+}
+
+bool FileTransferChatMessageModifier::scheduleTransfer(const shared_ptr<ChatMessage> &message,
+                                                       const function<int()> &start) {
+	shared_ptr<Core> core = message->getCore();
+	transferCore = core;
+	transferredBytes = 0;
+	weak_ptr<ChatMessage> weakMessage = message;
+	auto startLater = [this, weakMessage, start]() {
+		// The modifiers of a message live as long as it does.
+		shared_ptr<ChatMessage> message = weakMessage.lock();
+		if (!message) return false;
+
+		transferPending = false;
+		if (start() == 0) return true;
+		if (message->getDirection() == ChatMessage::Direction::Incoming) {
+			onDownloadFailed();
+		} else {
+			message->getPrivate()->setParticipantState(message->getChatRoom()->getMe()->getAddress(),
+			                                           ChatMessage::State::NotDelivered, ::ms_time(nullptr));
+			releaseHttpRequest();
+		}
+		return true;
+	};
+	if (!core->getPrivate()->acquireFileTransferSlot(this, startLater)) {
+		transferPending = true;
+		return true;
+	}
+
+	if (start() == 0) return true;
+	releaseTransferSlot();
+	return false;
+}
+
+void FileTransferChatMessageModifier::releaseTransferSlot() {
+	transferPending = false;
+	transferredBytes = 0;
+	shared_ptr<Core> core = transferCore.lock();
+	transferCore.reset();
+	if (core) core->getPrivate()->releaseFileTransferSlot(this);
+}
+
+void FileTransferChatMessageModifier::dropHttpRequest() {
 	if (httpRequest) {
 		belle_sip_object_unref(httpRequest);
 		httpRequest = nullptr;
@@ -1057,7 +1282,32 @@ void FileTransferChatMessageModifier::releaseHttpRequest() {
 			httpListener = nullptr;
 		}
 	}
+}
+
+void FileTransferChatMessageModifier::releaseHttpRequest() {
+	dropHttpRequest();
+	releaseTransferSlot();
 	currentFileContentToTransfer = nullptr;
+	releaseTransferBuffers();
+	closeResumeFile();
+	downloadUrl.clear();
+	downloadValidator.clear();
+	downloadResumeOffset = 0;
+	downloadRetryCount = 0;
+	downloadRestartPending = false;
+}
+
+uint8_t *FileTransferChatMessageModifier::getScratchBuffer(size_t size) {
+	if (scratchBuffer.size() < size) scratchBuffer.resize(size);
+	return scratchBuffer.data();
+}
+
+void FileTransferChatMessageModifier::releaseTransferBuffers() {
+	vector<uint8_t>().swap(scratchBuffer);
+	if (sendChunkBuffer) {
+		linphone_buffer_unref(sendChunkBuffer);
+		sendChunkBuffer = nullptr;
+	}
 }
 
 /* -------------------------------------------------------------------------------------- */
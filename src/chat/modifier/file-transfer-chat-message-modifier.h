@@ -21,7 +21,11 @@
 #ifndef _L_FILE_TRANSFER_CHAT_MESSAGE_MODIFIER_H_
 #define _L_FILE_TRANSFER_CHAT_MESSAGE_MODIFIER_H_
 
+#include <functional>
+#include <vector>
+
 #include <belle-sip/belle-sip.h>
+#include <bctoolbox/vfs.h>
 
 #include "chat-message-modifier.h"
 #include "utils/background-task.h"
@@ -31,6 +35,7 @@
 LINPHONE_BEGIN_NAMESPACE
 
 class ChatRoom;
+class Content;
 class Core;
 class FileContent;
 class FileTransferContent;
@@ -67,11 +72,17 @@ public:
 	                  std::shared_ptr<FileTransferContent> &fileTransferContent);
 	void cancelFileTransfer();
 	bool isFileTransferInProgressAndValid() const;
+	// Whether content is the one being transferred, or waiting for its turn to be.
+	bool isTransferringContent(const std::shared_ptr<Content> &content) const;
 	std::string createFakeFileTransferFromUrl(const std::string &url);
 	void fileUploadEndBackgroundTask();
 
 	void parseFileTransferXmlIntoContent(const char *xml,
 	                                     std::shared_ptr<FileTransferContent> &fileTransferContent) const;
+	// Whether the response to a Range request starting at offset carries the remainder of the file: a 206 whose
+	// Content-Range starts at offset and matches its Content-Length.
+	static bool continuesPartialDownload(belle_http_response_t *response, size_t offset);
+
 	std::string
 	dumpFileTransferContentAsXmlString(const std::shared_ptr<FileTransferContent> &parsedXmlFileTransferContent,
 	                                   const unsigned char *contentKey,
@@ -87,11 +98,25 @@ private:
 	int startHttpTransfer(const std::string &url,
 	                      const std::string &action,
 	                      belle_sip_body_handler_t *bh,
-	                      belle_http_request_listener_callbacks_t *cbs);
+	                      belle_http_request_listener_callbacks_t *cbs,
+	                      size_t rangeStart = 0);
 	void fileUploadBeginBackgroundTask();
 
+	// Runs start, which returns 0 once the transfer is started, within the core-wide file transfer budget: right away
+	// if it allows it, otherwise once the running transfers leave room for it. Returns false if the transfer failed to
+	// start right away, a transfer failing to start later is handled as a failed transfer.
+	bool scheduleTransfer(const std::shared_ptr<ChatMessage> &message, const std::function<int()> &start);
+	void releaseTransferSlot();
 	void onDownloadFailed();
+	bool resumeDownload();
+	bool restartDownload();
+	int sendDownloadRequest(size_t rangeStart);
+	void closeResumeFile();
+	// Drops the HTTP request without ending the transfer, releaseHttpRequest() ends it.
+	void dropHttpRequest();
 	void releaseHttpRequest();
+	uint8_t *getScratchBuffer(size_t size);
+	void releaseTransferBuffers();
 	belle_sip_body_handler_t *prepare_upload_body_handler(std::shared_ptr<ChatMessage> message);
 
 	std::string escapeFileName(const std::string &fileName) const;
@@ -107,6 +132,29 @@ private:
 
 	size_t lastNotifiedPercentage = 0;
 
+	// Set while the transfer waits for its turn in the file transfer budget of the core.
+	bool transferPending = false;
+	std::weak_ptr<Core> transferCore;
+	// Bytes of the transfer already accounted in the file transfer budget of the core.
+	size_t transferredBytes = 0;
+
+	// Reused from one chunk to the next for the whole transfer instead of allocating per chunk.
+	std::vector<uint8_t> scratchBuffer;
+	LinphoneBuffer *sendChunkBuffer = nullptr;
+
+	// A download interrupted by an I/O error continues with a Range request, the remainder being appended to the
+	// partially received file. The request carries an If-Range with the validator (ETag or Last-Modified) of the
+	// first response so that a file changed on the server is downloaded again from the beginning.
+	std::string downloadUrl;
+	std::string downloadValidator;
+	size_t downloadResumeOffset = 0;
+	int downloadRetryCount = 0;
+	// Set when a resumed response cannot be appended, the download is started again once it is discarded.
+	bool downloadRestartPending = false;
+	// Set when the downloaded data could not be decrypted, the message state is shared by all its transfers.
+	bool downloadDecryptFailed = false;
+	bctbx_vfs_file_t *resumeFile = nullptr;
+
 	BackgroundTask bgTask;
 };
 
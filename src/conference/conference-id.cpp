@@ -97,9 +97,9 @@ bool ConferenceId::isValid() const {
 
 size_t ConferenceId::getHash() const {
 	if (mHash == 0) {
-		const auto &pAddress = peerAddress ? peerAddress->toStringOrdered() : "sip:";
-		const auto &lAddress = localAddress ? localAddress->toStringOrdered() : "sip:";
-		mHash = hash<string>()(pAddress) ^ (hash<string>()(lAddress) << 1);
+		const size_t pHash = peerAddress ? peerAddress->getHash() : hash<string>()("sip:");
+		const size_t lHash = localAddress ? localAddress->getHash() : hash<string>()("sip:");
+		mHash = pHash ^ (lHash << 1);
 	}
 	return mHash;
 }
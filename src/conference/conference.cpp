@@ -567,6 +567,8 @@ shared_ptr<ConferenceParticipantEvent> Conference::notifyParticipantAdded(
 	event->setFullState(isFullState);
 	event->setNotifyId(lastNotify);
 
+	// Listeners may look the chat room up by its new participant.
+	getCore()->getPrivate()->updateChatRoomIndex(conferenceId);
 	for (const auto &l : confListeners) {
 		l->onParticipantAdded(event, participant);
 	}
@@ -580,6 +582,7 @@ shared_ptr<ConferenceParticipantEvent> Conference::notifyParticipantRemoved(
 	event->setFullState(isFullState);
 	event->setNotifyId(lastNotify);
 
+	getCore()->getPrivate()->updateChatRoomIndex(conferenceId);
 	for (const auto &l : confListeners) {
 		l->onParticipantRemoved(event, participant);
 	}
@@ -18,6 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <ctime>
 
 #include <bctoolbox/defs.h>
@@ -56,6 +58,15 @@ using namespace Xsd::ConferenceInfoLinphoneExtension;
 
 LocalConferenceEventHandler::LocalConferenceEventHandler(Conference *conference, ConferenceListener *listener)
     : conf(conference), confListener(listener) {
+	mEventCbs = EventCbs::create();
+	mEventCbs->setUserData(this);
+	mEventCbs->notifyResponseCb = notifyResponseCb;
+}
+
+LocalConferenceEventHandler::~LocalConferenceEventHandler() {
+	// The callbacks may outlive the handler as they are shared with the subscription events.
+	mEventCbs->setUserData(nullptr);
+	mEventCbs->notifyResponseCb = nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -67,29 +78,39 @@ void LocalConferenceEventHandler::notifyFullState(const std::shared_ptr<Content>
 
 void LocalConferenceEventHandler::notifyAllExceptDevice(const std::shared_ptr<Content> &notify,
                                                         const shared_ptr<ParticipantDevice> &exceptDevice) {
+	list<shared_ptr<ParticipantDevice>> devices;
 	for (const auto &participant : conf->getParticipants()) {
 		for (const auto &device : participant->getDevices()) {
 			if (device != exceptDevice) {
 				/* Only notify to device that are present in the conference. */
-				notifyParticipantDevice(notify, device);
+				devices.push_back(device);
 			}
 		}
 	}
+	notifyParticipantDevices(notify, devices);
 }
 
 void LocalConferenceEventHandler::notifyAllExcept(const std::shared_ptr<Content> &notify,
                                                   const shared_ptr<Participant> &exceptParticipant) {
+	list<shared_ptr<ParticipantDevice>> devices;
 	for (const auto &participant : conf->getParticipants()) {
 		if (participant != exceptParticipant) {
-			notifyParticipant(notify, participant);
+			addNotifiedDevices(participant, devices);
 		}
 	}
+	notifyParticipantDevices(notify, devices);
 }
 
 void LocalConferenceEventHandler::notifyAll(const std::shared_ptr<Content> &notify) {
+	list<shared_ptr<ParticipantDevice>> devices;
 	for (const auto &participant : conf->getParticipants()) {
-		notifyParticipant(notify, participant);
+		addNotifiedDevices(participant, devices);
 	}
+	notifyParticipantDevices(notify, devices);
+}
+
+const LocalConferenceEventHandler::NotifyFanOutStats &LocalConferenceEventHandler::getNotifyFanOutStats() const {
+	return mNotifyFanOutStats;
 }
 
 std::shared_ptr<Content> LocalConferenceEventHandler::createNotifyFullState(const shared_ptr<EventSubscribe> &ev) {
@@ -808,8 +829,6 @@ void LocalConferenceEventHandler::notifyResponseCb(LinphoneEvent *lev) {
 	auto ev = dynamic_pointer_cast<EventSubscribe>(Event::toCpp(const_cast<LinphoneEvent *>(lev))->getSharedFromThis());
 	auto cbs = ev->getCurrentCallbacks();
 	LocalConferenceEventHandler *handler = static_cast<LocalConferenceEventHandler *>(cbs->getUserData());
-	cbs->setUserData(nullptr);
-	cbs->notifyResponseCb = nullptr;
 
 	if (ev->getReason() != LinphoneReasonNone) return;
 
@@ -981,8 +1000,8 @@ string LocalConferenceEventHandler::createNotifyAvailableMediaChanged(
 	return createNotify(confInfo);
 }
 
-void LocalConferenceEventHandler::notifyParticipant(const std::shared_ptr<Content> &notify,
-                                                    const shared_ptr<Participant> &participant) {
+void LocalConferenceEventHandler::addNotifiedDevices(const shared_ptr<Participant> &participant,
+                                                     list<shared_ptr<ParticipantDevice>> &devices) {
 	for (const auto &device : participant->getDevices()) {
 		/* Only notify to device that are present in the conference. */
 		switch (device->getState()) {
@@ -992,7 +1011,7 @@ void LocalConferenceEventHandler::notifyParticipant(const std::shared_ptr<Conten
 			case ParticipantDevice::State::Present:
 			case ParticipantDevice::State::OnHold:
 			case ParticipantDevice::State::MutedByFocus:
-				notifyParticipantDevice(notify, device);
+				devices.push_back(device);
 				break;
 			case ParticipantDevice::State::Leaving:
 			case ParticipantDevice::State::Left:
@@ -1004,17 +1023,42 @@ void LocalConferenceEventHandler::notifyParticipant(const std::shared_ptr<Conten
 
 void LocalConferenceEventHandler::notifyParticipantDevice(const shared_ptr<Content> &content,
                                                           const shared_ptr<ParticipantDevice> &device) {
-	if (!device->isSubscribedToConferenceEventPackage()) return;
+	notifyParticipantDevices(content, {device});
+}
 
-	shared_ptr<EventSubscribe> ev = device->getConferenceSubscribeEvent();
-	shared_ptr<EventCbs> cbs = EventCbs::create();
-	cbs->setUserData(this);
-	cbs->notifyResponseCb = notifyResponseCb;
-	ev->addCallbacks(cbs);
+void LocalConferenceEventHandler::notifyParticipantDevices(const shared_ptr<Content> &content,
+                                                           const list<shared_ptr<ParticipantDevice>> &devices) {
+	const auto start = chrono::steady_clock::now();
 
+	// The body is serialized once in the content. Each NOTIFY gets its own body handler built from it, since a body
+	// handler keeps the progress of the transfer of its request.
 	LinphoneContent *cContent = content->isEmpty() ? nullptr : content->toC();
-	ev->notify(content);
-	linphone_core_notify_notify_sent(conf->getCore()->getCCore(), ev->toC(), cContent);
+
+	size_t notifyCount = 0;
+	for (const auto &device : devices) {
+		if (!device->isSubscribedToConferenceEventPackage()) continue;
+
+		shared_ptr<EventSubscribe> ev = device->getConferenceSubscribeEvent();
+		const auto &cbsList = ev->getCallbacksList();
+		if (find(cbsList.cbegin(), cbsList.cend(), mEventCbs) == cbsList.cend()) ev->addCallbacks(mEventCbs);
+
+		SalBodyHandler *bodyHandler =
+		    cContent ? sal_body_handler_ref(Content::createBodyHandler(*content, false)) : nullptr;
+		ev->notifyWithBodyHandler(bodyHandler);
+		if (bodyHandler) sal_body_handler_unref(bodyHandler);
+		linphone_core_notify_notify_sent(conf->getCore()->getCCore(), ev->toC(), cContent);
+		notifyCount++;
+	}
+
+	if (notifyCount == 0) return;
+
+	const auto duration = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+	mNotifyFanOutStats.fanOutCount++;
+	mNotifyFanOutStats.notifyCount += notifyCount;
+	mNotifyFanOutStats.totalDuration += duration;
+	mNotifyFanOutStats.maxDuration = max(mNotifyFanOutStats.maxDuration, duration);
+	lDebug() << "Conference [" << conf->getConferenceId() << "] NOTIFY of " << content->getSize() << " bytes sent to "
+	         << notifyCount << " device(s) in " << duration.count() << "us";
 }
 
 // -----------------------------------------------------------------------------
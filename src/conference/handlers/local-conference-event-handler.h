@@ -21,6 +21,8 @@
 #ifndef _L_LOCAL_CONFERENCE_EVENT_HANDLER_H_
 #define _L_LOCAL_CONFERENCE_EVENT_HANDLER_H_
 
+#include <chrono>
+#include <list>
 #include <memory>
 #include <string>
 
@@ -58,7 +60,16 @@ class LINPHONE_PUBLIC LocalConferenceEventHandler : public std::enable_shared_fr
 #endif
 public:
 	static Xsd::ConferenceInfo::MediaStatusType mediaDirectionToMediaStatus(LinphoneMediaDirection direction);
+	// Cumulated cost of sending the same NOTIFY to the devices of the conference.
+	struct NotifyFanOutStats {
+		unsigned long long fanOutCount = 0;
+		unsigned long long notifyCount = 0;
+		std::chrono::microseconds totalDuration{0};
+		std::chrono::microseconds maxDuration{0};
+	};
+
 	LocalConferenceEventHandler(Conference *conference, ConferenceListener *listener = nullptr);
+	virtual ~LocalConferenceEventHandler();
 
 	void publishStateChanged(const std::shared_ptr<EventPublish> &ev, LinphonePublishState state);
 
@@ -73,6 +84,7 @@ public:
 	void notifyAllExceptDevice(const std::shared_ptr<Content> &notify,
 	                           const std::shared_ptr<ParticipantDevice> &exceptDevice);
 	void notifyAll(const std::shared_ptr<Content> &notify);
+	const NotifyFanOutStats &getNotifyFanOutStats() const;
 	std::shared_ptr<Content> createNotifyFullState(const std::shared_ptr<EventSubscribe> &ev);
 	std::shared_ptr<Content> createNotifyMultipart(int notifyId);
 
@@ -226,9 +238,12 @@ private:
 	std::string createNotifyEphemeralLifetime(const long &lifetime);
 	std::string createNotifyEphemeralMode(const EventLog::Type &type);
 	std::shared_ptr<Content> makeContent(const std::string &xml);
-	void notifyParticipant(const std::shared_ptr<Content> &notify, const std::shared_ptr<Participant> &participant);
+	static void addNotifiedDevices(const std::shared_ptr<Participant> &participant,
+	                               std::list<std::shared_ptr<ParticipantDevice>> &devices);
 	void notifyParticipantDevice(const std::shared_ptr<Content> &content,
 	                             const std::shared_ptr<ParticipantDevice> &device);
+	void notifyParticipantDevices(const std::shared_ptr<Content> &content,
+	                              const std::list<std::shared_ptr<ParticipantDevice>> &devices);
 
 	std::shared_ptr<Participant> getConferenceParticipant(const std::shared_ptr<Address> &address) const;
 
@@ -246,6 +261,10 @@ private:
 
 	Xsd::XmlSchema::DateTime timeTToDateTime(const time_t &unixTime) const;
 
+	// Shared by all the subscription events NOTIFYs are sent through.
+	std::shared_ptr<EventCbs> mEventCbs;
+	NotifyFanOutStats mNotifyFanOutStats;
+
 	L_DISABLE_COPY(LocalConferenceEventHandler);
 };
 
@@ -85,6 +85,14 @@ public:
 		mKeyToPair.insert({key, std::make_pair(mKeys.begin(), std::move(value))});
 	}
 
+	void erase(const Key &key) {
+		auto it = mKeyToPair.find(key);
+		if (it == mKeyToPair.end()) return;
+
+		mKeys.erase(it->second.first);
+		mKeyToPair.erase(it);
+	}
+
 	void clear() {
 		mKeyToPair.clear();
 		mKeys.clear();
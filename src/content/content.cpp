@@ -104,8 +104,11 @@ Content::~Content() {
 	/*
 	 * Fills the body with zeros before releasing since it may contain
 	 * private data like cipher keys or decoded messages.
+	 * A body still shared with another content is left to its last owner.
 	 */
-	mBody.assign(mBody.size(), 0);
+	if (mBody && mBody.use_count() == 1) {
+		mBody->assign(mBody->size(), 0);
+	}
 	if (mBodyHandler != nullptr) sal_body_handler_unref(mBodyHandler);
 }
 
@@ -133,13 +136,13 @@ Content &Content::operator=(Content &&other) noexcept {
 }
 
 bool Content::operator==(const Content &other) const {
-	return mContentType == other.getContentType() && mBody == other.getBody() &&
+	return mContentType == other.getContentType() && getBody() == other.getBody() &&
 	       mContentDisposition == other.getContentDisposition() && mContentEncoding == other.getContentEncoding() &&
 	       mHeaders == other.getHeaders();
 }
 
 void Content::copy(const Content &other) {
-	mBody = other.getBody();
+	mBody = other.mBody;
 	mContentType = other.getContentType();
 	mContentDisposition = other.getContentDisposition();
 	mContentEncoding = other.getContentEncoding();
@@ -178,43 +181,52 @@ void Content::setContentEncoding(const string &contentEncoding) {
 }
 
 const vector<char> &Content::getBody() const {
-	return mBody;
+	static const vector<char> emptyBody;
+	return mBody ? *mBody : emptyBody;
 }
 
 string Content::getBodyAsString() const {
-	return Utils::utf8ToLocale(string(mBody.begin(), mBody.end()));
+	const vector<char> &body = getBody();
+	return Utils::utf8ToLocale(string(body.begin(), body.end()));
 }
 
 const string &Content::getBodyAsUtf8String() const {
-	mCache.buffer = string(mBody.begin(), mBody.end());
+	// The string is only rebuilt when the body changed since the previous call.
+	if (!mBody) {
+		mCache.buffer.clear();
+		mCache.bufferSource.reset();
+	} else if (mCache.bufferSource.owner_before(mBody) || mBody.owner_before(mCache.bufferSource)) {
+		mCache.buffer.assign(mBody->begin(), mBody->end());
+		mCache.bufferSource = mBody;
+	}
 	return mCache.buffer;
 }
 
 void Content::setBody(const vector<char> &body) {
-	mBody = body;
+	mBody = make_shared<vector<char>>(body);
 }
 
 void Content::setBody(vector<char> &&body) {
-	mBody = std::move(body);
+	mBody = make_shared<vector<char>>(std::move(body));
 }
 
 void Content::setBodyFromLocale(const string &body) {
 	string toUtf8 = Utils::localeToUtf8(body);
-	mBody = vector<char>(toUtf8.cbegin(), toUtf8.cend());
+	mBody = make_shared<vector<char>>(toUtf8.cbegin(), toUtf8.cend());
 }
 
 void Content::setBody(const void *buffer, size_t size) {
 	mIsDirty = true;
 
 	const char *start = static_cast<const char *>(buffer);
-	if (start != nullptr) mBody = vector<char>(start, start + size);
-	else mBody.clear();
+	if (start != nullptr) mBody = make_shared<vector<char>>(start, start + size);
+	else mBody = nullptr;
 }
 
 void Content::setBodyFromUtf8(const string &body) {
 	mIsDirty = true;
 
-	mBody = vector<char>(body.cbegin(), body.cend());
+	mBody = make_shared<vector<char>>(body.cbegin(), body.cend());
 }
 
 const std::string &Content::getName() const {
@@ -226,7 +238,7 @@ void Content::setName(const std::string &name) {
 }
 
 size_t Content::getSize() const {
-	return mBody.empty() ? mSize : mBody.size();
+	return getBody().empty() ? mSize : getBody().size();
 }
 
 void Content::setSize(size_t size) {
@@ -258,7 +270,7 @@ bool Content::isMultipart() const {
 }
 
 bool Content::isValid() const {
-	return mContentType.isValid() || (!mBody.empty());
+	return mContentType.isValid() || (!getBody().empty());
 }
 
 bool Content::isFile() const {
@@ -333,7 +345,10 @@ Variant Content::getUserData() const {
 
 SalBodyHandler *Content::getBodyHandlerFromContent(const Content &content, bool parseMultipart) {
 	if (!content.mIsDirty && content.mBodyHandler != nullptr) return sal_body_handler_ref(content.mBodyHandler);
+	return createBodyHandler(content, parseMultipart);
+}
 
+SalBodyHandler *Content::createBodyHandler(const Content &content, bool parseMultipart) {
 	SalBodyHandler *bodyHandler = nullptr;
 	ContentType contentType = content.mContentType;
 	if (contentType.isMultipart() && parseMultipart) {
@@ -364,7 +379,7 @@ SalBodyHandler *Content::getBodyHandlerFromContent(const Content &content, bool
 		bodyHandler = reinterpret_cast<SalBodyHandler *>(BELLE_SIP_BODY_HANDLER(bh));
 		bctbx_free(buffer);
 	} else {
-		bodyHandler = sal_body_handler_new_from_buffer(content.mBody.data(), content.mBody.size());
+		bodyHandler = sal_body_handler_new_from_buffer(content.getBody().data(), content.getBody().size());
 	}
 
 	for (const auto &header : content.getHeaders()) {
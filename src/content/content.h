@@ -22,6 +22,7 @@
 #define _L_CONTENT_H_
 
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "belle-sip/object++.hh"
@@ -114,13 +115,17 @@ public:
 	Variant getUserData() const;
 
 	static SalBodyHandler *getBodyHandlerFromContent(const Content &content, bool parseMultipart = true);
+	// Same as getBodyHandlerFromContent() but always builds a new body handler, even if the content has one.
+	static SalBodyHandler *createBodyHandler(const Content &content, bool parseMultipart = true);
 
 protected:
 	bool isFileEncrypted(const std::string &filePath) const;
 	const std::string exportPlainFileFromEncryptedFile(const std::string &filePath) const;
 
 private:
-	std::vector<char> mBody;
+	// The body is never modified in place, so that copies of a content (one per chat message modifier for instance)
+	// share the same buffer until one of them sets a new body. Only its last owner wipes it, see ~Content().
+	std::shared_ptr<std::vector<char>> mBody;
 	ContentType mContentType;
 	ContentDisposition mContentDisposition;
 	std::string mContentEncoding;
@@ -133,6 +138,7 @@ private:
 	struct Cache {
 		std::string name;
 		std::string buffer;
+		std::weak_ptr<std::vector<char>> bufferSource; // Body from which buffer was built.
 		std::string filePath;
 		std::string headerValue;
 	} mutable mCache;
@@ -18,7 +18,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
+#include <unordered_set>
 
 #include <bctoolbox/defs.h>
 
@@ -54,6 +57,48 @@ LINPHONE_BEGIN_NAMESPACE
 // Helpers.
 // -----------------------------------------------------------------------------
 
+// Two addresses which are equal or Address::weakEqual() have the same key. Domains are compared case insensitively
+// by Address::operator==().
+static string getWeakAddressKey(const Address &address) {
+	string domain = address.getDomain();
+	if (domain.empty()) domain = address.asStringUriOnly();
+	transform(domain.begin(), domain.end(), domain.begin(), [](unsigned char c) { return tolower(c); });
+	return address.getUsername() + "@" + domain + ":" + to_string(address.getPort());
+}
+
+static string
+getOneToOneChatRoomKey(const Address &localAddress, const Address &remoteAddress, bool conference, bool encrypted) {
+	return getWeakAddressKey(localAddress) + "\n" + getWeakAddressKey(remoteAddress) + "\n" +
+	       (conference ? "conference" : "basic") + (encrypted ? "-encrypted" : "");
+}
+
+// Basic chat rooms are keyed by their peer address and conference ones by their participant. The key is empty if
+// the chat room is not one to one or if its participant is not known yet.
+static string getOneToOneChatRoomKey(const AbstractChatRoom &chatRoom) {
+	ChatRoom::CapabilitiesMask capabilities = chatRoom.getCapabilities();
+	if (!(capabilities & ChatRoom::Capabilities::OneToOne)) return string();
+
+	const bool encrypted = bool(capabilities & ChatRoom::Capabilities::Encrypted);
+	if (capabilities & ChatRoom::Capabilities::Basic)
+		return getOneToOneChatRoomKey(*chatRoom.getLocalAddress(), *chatRoom.getPeerAddress(), false, encrypted);
+
+	if (!(capabilities & ChatRoom::Capabilities::Conference) || chatRoom.getParticipants().empty()) return string();
+	return getOneToOneChatRoomKey(*chatRoom.getLocalAddress(), *chatRoom.getParticipants().front()->getAddress(), true,
+	                              encrypted);
+}
+
+static void eraseIndexEntry(unordered_multimap<string, shared_ptr<AbstractChatRoom>> &index,
+                            const string &key,
+                            const AbstractChatRoom *chatRoom) {
+	auto range = index.equal_range(key);
+	for (auto it = range.first; it != range.second; it++) {
+		if (it->second.get() == chatRoom) {
+			index.erase(it);
+			return;
+		}
+	}
+}
+
 /*
  * Returns the best local address to talk with peer address.
  * If peerAddress is not defined, returns the local address of the default proxy config.
@@ -233,11 +278,18 @@ shared_ptr<AbstractChatRoom>
 CorePrivate::searchChatRoom(const shared_ptr<ChatRoomParams> &params,
                             const std::shared_ptr<const Address> &localAddress,
                             const std::shared_ptr<const Address> &remoteAddress,
-                            const std::list<std::shared_ptr<Address>> &participants) const {
+                            const std::list<std::shared_ptr<Address>> &participants) {
 	const auto localAddressWithoutGruu =
 	    (localAddress && localAddress->isValid()) ? localAddress->getUriWithoutGruu() : Address();
 	const auto remoteAddressWithoutGruu =
 	    (remoteAddress && remoteAddress->isValid()) ? remoteAddress->getUriWithoutGruu() : Address();
+	loadDeferredChatRooms([&](const MainDb::ChatRoomDescriptor &descriptor) {
+		const ConferenceId &conferenceId = descriptor.conferenceId;
+		return (!localAddressWithoutGruu.isValid() ||
+		        localAddressWithoutGruu == conferenceId.getLocalAddress()->getUriWithoutGruu()) &&
+		       (!remoteAddressWithoutGruu.isValid() ||
+		        remoteAddressWithoutGruu == conferenceId.getPeerAddress()->getUriWithoutGruu());
+	});
 	for (auto it = chatRoomsById.begin(); it != chatRoomsById.end(); it++) {
 		const auto &chatRoom = it->second;
 		if (params) {
@@ -429,8 +481,78 @@ void CorePrivate::insertChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
 		if (linphone_core_get_global_state(getCCore()) != LinphoneGlobalStartup) {
 			lInfo() << "Insert chat room " << conferenceId << " to core map";
 		}
-		chatRoomsById[conferenceId] = chatRoom;
+		mapChatRoom(conferenceId, chatRoom);
+	}
+}
+
+void CorePrivate::mapChatRoom(const ConferenceId &conferenceId, const shared_ptr<AbstractChatRoom> &chatRoom) {
+	auto it = chatRoomsById.find(conferenceId);
+	if (it == chatRoomsById.end()) {
+		chatRoomsById.emplace(conferenceId, chatRoom);
+	} else if (it->second != chatRoom) {
+		unindexChatRoom(it->second);
+		it->second = chatRoom;
+	}
+	indexChatRoom(chatRoom);
+}
+
+void CorePrivate::unmapChatRoom(const ConferenceId &conferenceId) {
+	auto it = chatRoomsById.find(conferenceId);
+	if (it == chatRoomsById.end()) return;
+	unindexChatRoom(it->second);
+	chatRoomsById.erase(it);
+}
+
+void CorePrivate::clearChatRooms() {
+	chatRoomsById.clear();
+	chatRoomsByPeer.clear();
+	oneToOneChatRooms.clear();
+	chatRoomIndexKeys.clear();
+	pendingOneToOneChatRooms.clear();
+}
+
+void CorePrivate::indexChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
+	// The keys are computed again, the chat room may have been replaced or have changed its conference id.
+	unindexChatRoom(chatRoom);
+
+	ChatRoomIndexKeys &keys = chatRoomIndexKeys[chatRoom.get()];
+	keys.peerKey = getWeakAddressKey(*chatRoom->getPeerAddress());
+	chatRoomsByPeer.emplace(keys.peerKey, chatRoom);
+
+	keys.oneToOneKey = getOneToOneChatRoomKey(*chatRoom);
+	if (!keys.oneToOneKey.empty()) oneToOneChatRooms.emplace(keys.oneToOneKey, chatRoom);
+	else if ((chatRoom->getCapabilities() & ChatRoom::Capabilities::OneToOne) &&
+	         (chatRoom->getCapabilities() & ChatRoom::Capabilities::Conference))
+		pendingOneToOneChatRooms.insert(chatRoom);
+}
+
+void CorePrivate::unindexChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
+	auto it = chatRoomIndexKeys.find(chatRoom.get());
+	if (it == chatRoomIndexKeys.end()) return;
+	eraseIndexEntry(chatRoomsByPeer, it->second.peerKey, chatRoom.get());
+	if (!it->second.oneToOneKey.empty()) eraseIndexEntry(oneToOneChatRooms, it->second.oneToOneKey, chatRoom.get());
+	chatRoomIndexKeys.erase(it);
+	pendingOneToOneChatRooms.erase(chatRoom);
+}
+
+void CorePrivate::updateChatRoomIndex(const ConferenceId &conferenceId) {
+	auto it = chatRoomsById.find(conferenceId);
+	if (it == chatRoomsById.end()) return;
+	const shared_ptr<AbstractChatRoom> chatRoom = it->second;
+	auto keysIt = chatRoomIndexKeys.find(chatRoom.get());
+	if (keysIt == chatRoomIndexKeys.end() || keysIt->second.oneToOneKey == getOneToOneChatRoomKey(*chatRoom)) return;
+	indexChatRoom(chatRoom);
+}
+
+void CorePrivate::indexPendingOneToOneChatRooms() {
+	if (pendingOneToOneChatRooms.empty()) return;
+
+	vector<shared_ptr<AbstractChatRoom>> chatRooms;
+	for (const auto &chatRoom : pendingOneToOneChatRooms) {
+		if (!chatRoom->getParticipants().empty()) chatRooms.push_back(chatRoom);
 	}
+	for (const auto &chatRoom : chatRooms)
+		indexChatRoom(chatRoom);
 }
 
 void CorePrivate::insertChatRoomWithDb(const shared_ptr<AbstractChatRoom> &chatRoom, unsigned int notifyId) {
@@ -439,110 +561,231 @@ void CorePrivate::insertChatRoomWithDb(const shared_ptr<AbstractChatRoom> &chatR
 }
 
 void CorePrivate::loadChatRooms() {
-	chatRoomsById.clear();
+	clearChatRooms();
+	deferredChatRooms.clear();
 #ifdef HAVE_ADVANCED_IM
 	if (remoteListEventHandler) remoteListEventHandler->clearHandlers();
 #endif
 	if (!mainDb->isInitialized()) return;
-	for (auto &chatRoom : mainDb->getChatRooms()) {
+	if (!linphone_config_get_bool(linphone_core_get_config(getCCore()), "misc", "lazy_chat_rooms_loading", FALSE) ||
+	    !loadChatRoomDescriptors()) {
+		for (auto &chatRoom : mainDb->getChatRooms()) {
+			insertChatRoom(chatRoom);
+			insertParticipantDevices(chatRoom);
+		}
+	}
+	sendDeliveryNotifications();
+}
+
+// Only keep descriptors of the chat rooms, they are built the first time they are looked up.
+bool CorePrivate::loadChatRoomDescriptors() {
+	bool serverMode = linphone_core_conference_server_enabled(getCCore());
+	unordered_set<ConferenceId, ConferenceId::WeakHash, ConferenceId::WeakEqual> conferenceIds;
+	list<ConferenceId> eagerChatRooms;
+	for (auto &descriptor : mainDb->getChatRoomDescriptors()) {
+		if (!conferenceIds.insert(descriptor.conferenceId).second) {
+			// Such chat rooms are merged by MainDb::getChatRooms(), the next start will be lazy.
+			lInfo() << "Duplicated chat room " << descriptor.conferenceId << ", loading all chat rooms";
+			deferredChatRooms.clear();
+			return false;
+		}
+
+		// Client group chat rooms must exist to be resubscribed to their conference.
+		if (!serverMode && (descriptor.capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)))
+			eagerChatRooms.push_back(descriptor.conferenceId);
+		else deferredChatRooms.emplace(descriptor.conferenceId, std::move(descriptor));
+	}
+
+	for (const auto &conferenceId : eagerChatRooms) {
+		shared_ptr<AbstractChatRoom> chatRoom = mainDb->getChatRoom(conferenceId);
+		if (!chatRoom) continue;
 		insertChatRoom(chatRoom);
+		insertParticipantDevices(chatRoom);
+	}
+	lInfo() << "Loaded " << chatRoomsById.size() << " chat rooms, " << deferredChatRooms.size() << " deferred";
+	return true;
+}
 
-		// TODO FIXME: Remove later when devices for friends will be notified through presence
-		for (const auto &p : chatRoom->getParticipants()) {
-			auto devices = mainDb->getDevices(p->getAddress());
-			if (devices.empty()) {
-				for (const auto &d : p->getDevices()) {
-					auto gruu = d->getAddress();
-					auto name = d->getName();
-					lDebug() << "[Friend] Inserting existing device with name [" << name << "] and address ["
-					         << gruu->asStringUriOnly() << "]";
-					mainDb->insertDevice(gruu, name);
-				}
+void CorePrivate::insertParticipantDevices(const shared_ptr<AbstractChatRoom> &chatRoom) {
+	// TODO FIXME: Remove later when devices for friends will be notified through presence
+	for (const auto &p : chatRoom->getParticipants()) {
+		auto devices = mainDb->getDevices(p->getAddress());
+		if (devices.empty()) {
+			for (const auto &d : p->getDevices()) {
+				auto gruu = d->getAddress();
+				auto name = d->getName();
+				lDebug() << "[Friend] Inserting existing device with name [" << name << "] and address ["
+				         << gruu->asStringUriOnly() << "]";
+				mainDb->insertDevice(gruu, name);
 			}
 		}
 	}
-	sendDeliveryNotifications();
 }
 
+shared_ptr<AbstractChatRoom> CorePrivate::loadDeferredChatRoom(const ConferenceId &conferenceId) {
+	auto it = deferredChatRooms.find(conferenceId);
+	if (it == deferredChatRooms.end()) return nullptr;
+	deferredChatRooms.erase(it);
+
+	shared_ptr<AbstractChatRoom> chatRoom = mainDb->getChatRoom(conferenceId);
+	if (!chatRoom) return nullptr;
+
+	lDebug() << "Loading deferred chat room " << conferenceId;
+	insertChatRoom(chatRoom);
+	insertParticipantDevices(chatRoom);
+	return chatRoom;
+}
+
+void CorePrivate::loadDeferredChatRooms(const function<bool(const MainDb::ChatRoomDescriptor &)> &filter) {
+	list<ConferenceId> conferenceIds;
+	for (const auto &[conferenceId, descriptor] : deferredChatRooms) {
+		if (!filter || filter(descriptor)) conferenceIds.push_back(conferenceId);
+	}
+	for (const auto &conferenceId : conferenceIds)
+		loadDeferredChatRoom(conferenceId);
+}
+
+void CorePrivate::loadImportedChatRooms() {
+	if (!mainDb->isInitialized()) return;
+
+	// Chat rooms merged with a duplicate when they were loaded are not loaded twice.
+	unordered_set<ConferenceId, ConferenceId::WeakHash, ConferenceId::WeakEqual> conferenceIds;
+	for (const auto &[conferenceId, chatRoom] : chatRoomsById)
+		conferenceIds.insert(conferenceId);
+
+	const bool serverMode = linphone_core_conference_server_enabled(getCCore());
+	const bool lazy =
+	    linphone_config_get_bool(linphone_core_get_config(getCCore()), "misc", "lazy_chat_rooms_loading", FALSE);
+	for (auto &descriptor : mainDb->getChatRoomDescriptors()) {
+		auto it = chatRoomsById.find(descriptor.conferenceId);
+		if (it != chatRoomsById.end()) {
+			// Messages may have been added to it.
+			AbstractChatRoomPrivate *dChatRoom = it->second->getPrivate();
+			dChatRoom->setLastUpdateTime(descriptor.lastUpdateTime);
+			dChatRoom->setIsEmpty(descriptor.isEmpty);
+			continue;
+		}
+		auto deferredIt = deferredChatRooms.find(descriptor.conferenceId);
+		if (deferredIt != deferredChatRooms.end()) {
+			deferredIt->second = std::move(descriptor);
+			continue;
+		}
+		if (!conferenceIds.insert(descriptor.conferenceId).second) continue;
+
+		// Same rule as loadChatRoomDescriptors().
+		const bool isConference =
+		    !!(descriptor.capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference));
+		if (lazy && (serverMode || !isConference)) {
+			deferredChatRooms.emplace(descriptor.conferenceId, std::move(descriptor));
+			continue;
+		}
+		shared_ptr<AbstractChatRoom> chatRoom = mainDb->getChatRoom(descriptor.conferenceId);
+		if (!chatRoom) continue;
+		insertChatRoom(chatRoom);
+		insertParticipantDevices(chatRoom);
+	}
+}
+
+namespace {
+// Heap ordering putting the message which expires first at the front.
+struct EphemeralMessageExpiresLater {
+	bool operator()(const shared_ptr<ChatMessage> &lhs, const shared_ptr<ChatMessage> &rhs) const {
+		return lhs->getEphemeralExpireTime() > rhs->getEphemeralExpireTime();
+	}
+};
+} // namespace
+
 void CorePrivate::handleEphemeralMessages(time_t currentTime) {
+	// All the messages expired since the previous run are deleted at once.
+	list<shared_ptr<ChatMessage>> expiredMessages;
+	while (!ephemeralMessages.empty() && currentTime > ephemeralMessages.front()->getEphemeralExpireTime()) {
+		pop_heap(ephemeralMessages.begin(), ephemeralMessages.end(), EphemeralMessageExpiresLater());
+		expiredMessages.push_back(ephemeralMessages.back());
+		ephemeralMessages.pop_back();
+	}
+	if (!expiredMessages.empty()) deleteEphemeralMessages(expiredMessages);
+
 	if (!ephemeralMessages.empty()) {
-		shared_ptr<ChatMessage> msg = ephemeralMessages.front();
-		time_t expireTime = msg->getEphemeralExpireTime();
-		if (currentTime > expireTime) {
-			shared_ptr<LinphonePrivate::EventLog> event =
-			    LinphonePrivate::MainDb::getEvent(mainDb, msg->getStorageId());
-			shared_ptr<AbstractChatRoom> chatRoom = msg->getChatRoom();
-			if (chatRoom && event) {
-				LinphonePrivate::EventLog::deleteFromDatabase(event);
-				lInfo() << "[Ephemeral] Message deleted from database";
-
-				// Notify ephemeral message deleted to message if exists.
-				LinphoneChatMessage *message = L_GET_C_BACK_PTR(msg.get());
-				if (message) {
-					LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(message);
-					if (cbs && linphone_chat_message_cbs_get_ephemeral_message_deleted(cbs)) {
-						linphone_chat_message_cbs_get_ephemeral_message_deleted(cbs)(message);
-					}
-					_linphone_chat_message_notify_ephemeral_message_deleted(message);
-				}
+		startEphemeralMessageTimer(ephemeralMessages.front()->getEphemeralExpireTime());
+	} else if (!ephemeralMessagesLoaded || ephemeralMessagesHorizon != numeric_limits<time_t>::max()) {
+		// Some messages are still only in database.
+		initEphemeralMessages();
+	}
+}
 
-				// Notify ephemeral message deleted to chat room & core.
-				LinphoneChatRoom *cr = L_GET_C_BACK_PTR(chatRoom);
-				_linphone_chat_room_notify_ephemeral_message_deleted(cr, L_GET_C_BACK_PTR(event));
-				linphone_core_notify_chat_room_ephemeral_message_deleted(linphone_chat_room_get_core(cr), cr);
+void CorePrivate::deleteEphemeralMessages(const list<shared_ptr<ChatMessage>> &messages) {
+	L_Q();
+	list<pair<shared_ptr<ChatMessage>, shared_ptr<EventLog>>> deletedMessages;
+	list<shared_ptr<const EventLog>> events;
+	for (const auto &msg : messages) {
+		shared_ptr<EventLog> event = MainDb::getEvent(mainDb, msg->getStorageId());
+		// Messages are removed from the heap even when their chat room is gone.
+		if (!msg->getChatRoom() || !event) continue;
+		deletedMessages.emplace_back(msg, event);
+		events.push_back(event);
+	}
+	if (events.empty()) return;
+
+	mainDb->deleteEvents(events);
+	lInfo() << "[Ephemeral] " << events.size() << " message(s) deleted from database";
+
+	list<shared_ptr<AbstractChatRoom>> chatRooms;
+	unordered_set<const AbstractChatRoom *> notifiedChatRooms;
+	for (const auto &[msg, event] : deletedMessages) {
+		// Notify ephemeral message deleted to message if exists.
+		LinphoneChatMessage *message = L_GET_C_BACK_PTR(msg.get());
+		if (message) {
+			LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(message);
+			if (cbs && linphone_chat_message_cbs_get_ephemeral_message_deleted(cbs)) {
+				linphone_chat_message_cbs_get_ephemeral_message_deleted(cbs)(message);
 			}
-
-			// Delete message from this list even when chatroom is gone.
-			ephemeralMessages.pop_front();
-			handleEphemeralMessages(currentTime);
-		} else {
-			startEphemeralMessageTimer(expireTime);
+			_linphone_chat_message_notify_ephemeral_message_deleted(message);
 		}
-	} else {
-		initEphemeralMessages();
+
+		// Notify ephemeral message deleted to chat room.
+		shared_ptr<AbstractChatRoom> chatRoom = msg->getChatRoom();
+		if (!chatRoom) continue;
+		_linphone_chat_room_notify_ephemeral_message_deleted(L_GET_C_BACK_PTR(chatRoom), L_GET_C_BACK_PTR(event));
+		if (notifiedChatRooms.insert(chatRoom.get()).second) chatRooms.push_back(chatRoom);
 	}
+
+	// The core is notified once per chat room.
+	for (const auto &chatRoom : chatRooms)
+		linphone_core_notify_chat_room_ephemeral_message_deleted(q->getCCore(), L_GET_C_BACK_PTR(chatRoom));
 }
 
 void CorePrivate::initEphemeralMessages() {
 	L_Q();
 	if (mainDb && mainDb->isInitialized()) {
-		ephemeralMessages.clear();
-		ephemeralMessages = mainDb->getEphemeralMessages();
+		bool truncated = false;
+		list<shared_ptr<ChatMessage>> messages = mainDb->getEphemeralMessages(&truncated);
+		ephemeralMessages.assign(messages.begin(), messages.end());
+		make_heap(ephemeralMessages.begin(), ephemeralMessages.end(), EphemeralMessageExpiresLater());
+		ephemeralMessagesLoaded = true;
+		// When truncated, the messages expiring after the last one loaded are only in database.
+		ephemeralMessagesHorizon = (truncated && !messages.empty()) ? messages.back()->getEphemeralExpireTime()
+		                                                            : numeric_limits<time_t>::max();
 		if (!ephemeralMessages.empty()) {
 			lInfo() << "[Ephemeral] list initiated on core " << linphone_core_get_identity(q->getCCore());
-			shared_ptr<ChatMessage> msg = ephemeralMessages.front();
-			startEphemeralMessageTimer(msg->getEphemeralExpireTime());
+			startEphemeralMessageTimer(ephemeralMessages.front()->getEphemeralExpireTime());
 		}
 	}
 }
 
 void CorePrivate::updateEphemeralMessages(const shared_ptr<ChatMessage> &message) {
-	if (ephemeralMessages.empty()) {
-		// Can not determine this message will expire most quickly, so init this list.
+	if (!ephemeralMessagesLoaded) {
+		// The message is already in database, it is loaded along with the others.
 		initEphemeralMessages();
-	} else {
-		shared_ptr<ChatMessage> lastmsg = ephemeralMessages.back();
-		if (lastmsg->getEphemeralLifetime() < message->getEphemeralLifetime()) {
-			// The last message of this list will expire more quickly than this message, can not determine this message
-			// will expire most quickly in the remaining messages.
-			return;
-		}
-		for (std::list<shared_ptr<ChatMessage>>::iterator it = ephemeralMessages.begin(); it != ephemeralMessages.end();
-		     ++it) {
-			shared_ptr<ChatMessage> msg = *it;
-			if (msg->getEphemeralExpireTime() > message->getEphemeralExpireTime()) {
-				// This message will expire more quickly than the last message of this list, add it.
-				if (it == ephemeralMessages.begin()) {
-					ephemeralMessages.push_front(message);
-					startEphemeralMessageTimer(message->getEphemeralExpireTime());
-				} else {
-					it = --it;
-					ephemeralMessages.insert(it, message);
-				}
-				return;
-			}
-		}
+		return;
 	}
+	// Otherwise it is loaded from database once the messages expiring before it are deleted.
+	if (message->getEphemeralExpireTime() > ephemeralMessagesHorizon) return;
+
+	bool expiresFirst =
+	    ephemeralMessages.empty() || EphemeralMessageExpiresLater()(ephemeralMessages.front(), message);
+	ephemeralMessages.push_back(message);
+	push_heap(ephemeralMessages.begin(), ephemeralMessages.end(), EphemeralMessageExpiresLater());
+	if (expiresFirst) startEphemeralMessageTimer(message->getEphemeralExpireTime());
 }
 
 void CorePrivate::sendDeliveryNotifications() {
@@ -562,11 +805,11 @@ void CorePrivate::replaceChatRoom(const shared_ptr<AbstractChatRoom> &replacedCh
 	const ConferenceId &newConferenceId = newChatRoom->getConferenceId();
 
 	if (replacedChatRoom->getCapabilities() & ChatRoom::Capabilities::Proxy) {
-		chatRoomsById.erase(replacedConferenceId);
-		chatRoomsById[newConferenceId] = replacedChatRoom;
+		unmapChatRoom(replacedConferenceId);
+		mapChatRoom(newConferenceId, replacedChatRoom);
 	} else {
-		chatRoomsById.erase(replacedConferenceId);
-		chatRoomsById[newConferenceId] = newChatRoom;
+		unmapChatRoom(replacedConferenceId);
+		mapChatRoom(newConferenceId, newChatRoom);
 	}
 }
 
@@ -577,11 +820,17 @@ void CorePrivate::replaceChatRoom(const shared_ptr<AbstractChatRoom> &replacedCh
 shared_ptr<AbstractChatRoom>
 CorePrivate::findExhumableOneToOneChatRoom(const std::shared_ptr<Address> &localAddress,
                                            const std::shared_ptr<Address> &participantAddress,
-                                           bool encrypted) const {
+                                           bool encrypted) {
 #ifdef HAVE_ADVANCED_IM
 	lInfo() << "Looking for exhumable 1-1 chat room with local address [" << localAddress->toString()
 	        << "] and participant [" << participantAddress->toString() << "]";
 
+	loadDeferredChatRooms([&](const MainDb::ChatRoomDescriptor &descriptor) {
+		ChatRoom::CapabilitiesMask capabilities(descriptor.capabilities);
+		return capabilities & ChatRoom::Capabilities::Conference && capabilities & ChatRoom::Capabilities::OneToOne &&
+		       encrypted == bool(capabilities & ChatRoom::Capabilities::Encrypted) &&
+		       localAddress->weakEqual(*descriptor.conferenceId.getLocalAddress());
+	});
 	for (auto it = chatRoomsById.begin(); it != chatRoomsById.end(); it++) {
 		const auto &chatRoom = it->second;
 		const std::shared_ptr<Address> &curLocalAddress = chatRoom->getLocalAddress();
@@ -650,8 +899,8 @@ void CorePrivate::updateChatRoomConferenceId(const shared_ptr<AbstractChatRoom>
 	const ConferenceId &newConferenceId = chatRoom->getConferenceId();
 	lInfo() << "Chat room [" << oldConferenceId << "] has been exhumed into [" << newConferenceId << "]";
 
-	chatRoomsById.erase(oldConferenceId);
-	chatRoomsById[newConferenceId] = chatRoom;
+	unmapChatRoom(oldConferenceId);
+	mapChatRoom(newConferenceId, chatRoom);
 
 	mainDb->updateChatRoomConferenceId(oldConferenceId, newConferenceId);
 #endif
@@ -690,47 +939,105 @@ const std::shared_ptr<Address> Core::getConferenceFactoryAddress(BCTBX_UNUSED(co
 
 // -----------------------------------------------------------------------------
 
-list<shared_ptr<AbstractChatRoom>> Core::getChatRooms() const {
-	L_D();
-
-	LinphoneCore *lc = getCCore();
-	LinphoneConfig *config = linphone_core_get_config(lc);
-	bool hideEmptyChatRooms = !!linphone_config_get_int(config, "misc", "hide_empty_chat_rooms", 1);
-	bool hideChatRoomsFromRemovedProxyConfig =
-	    !!linphone_config_get_int(config, "misc", "hide_chat_rooms_from_removed_proxies", 1);
+namespace {
+// Tells which chat rooms are listed, the configuration and the account identities are read once per listing.
+class ChatRoomListFilter {
+public:
+	explicit ChatRoomListFilter(const Core &core) {
+		LinphoneConfig *config = linphone_core_get_config(core.getCCore());
+		mHideEmptyChatRooms = !!linphone_config_get_int(config, "misc", "hide_empty_chat_rooms", 1);
+		mHideChatRoomsFromRemovedProxyConfig =
+		    !!linphone_config_get_int(config, "misc", "hide_chat_rooms_from_removed_proxies", 1);
+		if (!mHideChatRoomsFromRemovedProxyConfig) return;
+
+		for (const auto &account : core.getAccounts()) {
+			const auto &identityAddress = account->getAccountParams()->getIdentityAddress();
+			if (identityAddress) mIdentityAddresses.emplace(getWeakAddressKey(*identityAddress), identityAddress);
+		}
+	}
 
-	list<shared_ptr<AbstractChatRoom>> rooms;
+	bool isListed(const std::shared_ptr<Address> &localAddress,
+	              AbstractChatRoom::CapabilitiesMask capabilities,
+	              bool isEmpty) const {
+		if (mHideEmptyChatRooms && isEmpty && (capabilities & LinphoneChatRoomCapabilitiesOneToOne)) return false;
 
-	for (auto it = d->chatRoomsById.begin(); it != d->chatRoomsById.end(); it++) {
-		const auto &chatRoom = it->second;
-		if (hideEmptyChatRooms) {
-			if (chatRoom->isEmpty() && (chatRoom->getCapabilities() & LinphoneChatRoomCapabilitiesOneToOne)) {
-				continue;
+		if (mHideChatRoomsFromRemovedProxyConfig) {
+			auto range = mIdentityAddresses.equal_range(getWeakAddressKey(*localAddress));
+			for (auto it = range.first; it != range.second; it++) {
+				if (it->second->weakEqual(*localAddress)) return true;
 			}
+			return false;
 		}
 
-		if (hideChatRoomsFromRemovedProxyConfig) {
-			bool found = false;
-			for (const auto &account : getAccounts()) {
-				auto localAddress = account->getAccountParams()->getIdentityAddress();
-				if (localAddress->weakEqual(*chatRoom->getLocalAddress())) {
-					found = true;
-					break;
-				}
-			}
-			if (!found) {
-				continue;
-			}
-		}
+		return true;
+	}
+
+private:
+	bool mHideEmptyChatRooms = true;
+	bool mHideChatRoomsFromRemovedProxyConfig = true;
+	unordered_multimap<string, shared_ptr<Address>> mIdentityAddresses;
+};
+} // namespace
+
+list<shared_ptr<AbstractChatRoom>> CorePrivate::getLoadedChatRooms() const {
+	L_Q();
 
-		rooms.push_front(chatRoom);
+	const ChatRoomListFilter filter(*q);
+
+	list<shared_ptr<AbstractChatRoom>> rooms;
+
+	for (auto it = chatRoomsById.begin(); it != chatRoomsById.end(); it++) {
+		const auto &chatRoom = it->second;
+		if (filter.isListed(chatRoom->getLocalAddress(), chatRoom->getCapabilities(), chatRoom->isEmpty()))
+			rooms.push_front(chatRoom);
 	}
 
 	rooms.sort(compare_chat_room);
 	return rooms;
 }
 
-shared_ptr<AbstractChatRoom> Core::findChatRoom(const ConferenceId &conferenceId, bool logIfNotFound) const {
+list<shared_ptr<AbstractChatRoom>> Core::getChatRooms() {
+	L_D();
+	d->loadDeferredChatRooms();
+	return d->getLoadedChatRooms();
+}
+
+list<shared_ptr<AbstractChatRoom>> Core::getChatRoomsRange(int begin, int end) {
+	L_D();
+
+	const ChatRoomListFilter filter(*this);
+
+	// Built and deferred chat rooms are sorted together, only the requested ones are built.
+	struct Entry {
+		time_t lastUpdateTime;
+		ConferenceId conferenceId;
+		shared_ptr<AbstractChatRoom> chatRoom;
+	};
+	vector<Entry> entries;
+	entries.reserve(d->chatRoomsById.size() + d->deferredChatRooms.size());
+	for (const auto &[conferenceId, chatRoom] : d->chatRoomsById) {
+		if (filter.isListed(chatRoom->getLocalAddress(), chatRoom->getCapabilities(), chatRoom->isEmpty()))
+			entries.push_back({chatRoom->getLastUpdateTime(), conferenceId, chatRoom});
+	}
+	for (const auto &[conferenceId, descriptor] : d->deferredChatRooms) {
+		if (filter.isListed(conferenceId.getLocalAddress(), descriptor.capabilities, descriptor.isEmpty))
+			entries.push_back({descriptor.lastUpdateTime, conferenceId, nullptr});
+	}
+	stable_sort(entries.begin(), entries.end(),
+	            [](const Entry &a, const Entry &b) { return a.lastUpdateTime > b.lastUpdateTime; });
+
+	list<shared_ptr<AbstractChatRoom>> rooms;
+	size_t first = static_cast<size_t>(max(begin, 0));
+	size_t last = end < 0 ? entries.size() : min(static_cast<size_t>(end), entries.size());
+	for (size_t i = first; i < last; i++) {
+		shared_ptr<AbstractChatRoom> chatRoom =
+		    entries[i].chatRoom ? entries[i].chatRoom : d->loadDeferredChatRoom(entries[i].conferenceId);
+		if (chatRoom) rooms.push_back(chatRoom);
+	}
+	return rooms;
+}
+
+shared_ptr<AbstractChatRoom> Core::findChatRoom(const ConferenceId &conferenceId, bool logIfNotFound) {
 	L_D();
 	auto it = d->chatRoomsById.find(conferenceId);
 	if (it != d->chatRoomsById.cend()) {
@@ -738,6 +1045,9 @@ shared_ptr<AbstractChatRoom> Core::findChatRoom(const ConferenceId &conferenceId
 		return it->second;
 	}
 
+	shared_ptr<AbstractChatRoom> deferredChatRoom = d->loadDeferredChatRoom(conferenceId);
+	if (deferredChatRoom) return deferredChatRoom;
+
 	auto alreadyExhumedOneToOne = d->findExumedChatRoomFromPreviousConferenceId(conferenceId);
 	if (alreadyExhumedOneToOne) {
 		lWarning() << "Found conference id as already exhumed chat room with new conference ID "
@@ -750,11 +1060,16 @@ shared_ptr<AbstractChatRoom> Core::findChatRoom(const ConferenceId &conferenceId
 	return nullptr;
 }
 
-list<shared_ptr<AbstractChatRoom>> Core::findChatRooms(const std::shared_ptr<Address> &peerAddress) const {
+list<shared_ptr<AbstractChatRoom>> Core::findChatRooms(const std::shared_ptr<Address> &peerAddress) {
 	L_D();
 
+	d->loadDeferredChatRooms([&](const MainDb::ChatRoomDescriptor &descriptor) {
+		return *descriptor.conferenceId.getPeerAddress() == *peerAddress;
+	});
+
 	list<shared_ptr<AbstractChatRoom>> output;
-	for (auto it = d->chatRoomsById.begin(); it != d->chatRoomsById.end(); it++) {
+	auto range = d->chatRoomsByPeer.equal_range(getWeakAddressKey(*peerAddress));
+	for (auto it = range.first; it != range.second; it++) {
 		const auto &chatRoom = it->second;
 		if (*chatRoom->getPeerAddress() == *peerAddress) {
 			output.push_front(chatRoom);
@@ -768,33 +1083,56 @@ shared_ptr<AbstractChatRoom> Core::findOneToOneChatRoom(const std::shared_ptr<co
                                                         const std::shared_ptr<Address> &participantAddress,
                                                         bool basicOnly,
                                                         bool conferenceOnly,
-                                                        bool encrypted) const {
+                                                        bool encrypted) {
 	L_D();
-	for (auto it = d->chatRoomsById.begin(); it != d->chatRoomsById.end(); it++) {
-		const auto &chatRoom = it->second;
-		const std::shared_ptr<Address> &curLocalAddress = chatRoom->getLocalAddress();
-		ChatRoom::CapabilitiesMask capabilities = chatRoom->getCapabilities();
+	d->loadDeferredChatRooms([&](const MainDb::ChatRoomDescriptor &descriptor) {
+		ChatRoom::CapabilitiesMask capabilities(descriptor.capabilities);
+		if (!(capabilities & ChatRoom::Capabilities::OneToOne) ||
+		    encrypted != bool(capabilities & ChatRoom::Capabilities::Encrypted) ||
+		    !localAddress->weakEqual(*descriptor.conferenceId.getLocalAddress()))
+			return false;
+		// The participant of a deferred one to one conference chat room is not known yet.
+		return !(capabilities & ChatRoom::Capabilities::Basic) ||
+		       participantAddress->weakEqual(*descriptor.conferenceId.getPeerAddress());
+	});
+	d->indexPendingOneToOneChatRooms();
+
+	auto findIndexedChatRoom = [&](bool conference) -> shared_ptr<AbstractChatRoom> {
+		const string key = getOneToOneChatRoomKey(*localAddress, *participantAddress, conference, encrypted);
+		auto range = d->oneToOneChatRooms.equal_range(key);
+		for (auto it = range.first; it != range.second; it++) {
+			const auto &chatRoom = it->second;
+			const std::shared_ptr<Address> &curLocalAddress = chatRoom->getLocalAddress();
+			ChatRoom::CapabilitiesMask capabilities = chatRoom->getCapabilities();
 
-		// We are looking for a one to one chatroom
-		// Do not return a group chat room that everyone except one person has left
-		if (!(capabilities & ChatRoom::Capabilities::OneToOne)) continue;
+			// We are looking for a one to one chatroom
+			// Do not return a group chat room that everyone except one person has left
+			if (!(capabilities & ChatRoom::Capabilities::OneToOne)) continue;
 
-		if (encrypted != bool(capabilities & ChatRoom::Capabilities::Encrypted)) continue;
+			if (encrypted != bool(capabilities & ChatRoom::Capabilities::Encrypted)) continue;
 
-		// One to one client group chat room
-		// The only participant's address must match the participantAddress argument
-		if (!basicOnly && (capabilities & ChatRoom::Capabilities::Conference) && !chatRoom->getParticipants().empty() &&
-		    localAddress->weakEqual(*curLocalAddress) &&
-		    participantAddress->weakEqual(*chatRoom->getParticipants().front()->getAddress()))
-			return chatRoom;
+			if (!localAddress->weakEqual(*curLocalAddress)) continue;
 
-		// One to one basic chat room (addresses without gruu)
-		// The peer address must match the participantAddress argument
-		if (!conferenceOnly && (capabilities & ChatRoom::Capabilities::Basic) &&
-		    localAddress->weakEqual(*curLocalAddress) && participantAddress->weakEqual(*chatRoom->getPeerAddress()))
-			return chatRoom;
-	}
-	return nullptr;
+			// One to one client group chat room
+			// The only participant's address must match the participantAddress argument
+			if (conference && (capabilities & ChatRoom::Capabilities::Conference) &&
+			    !chatRoom->getParticipants().empty() &&
+			    participantAddress->weakEqual(*chatRoom->getParticipants().front()->getAddress()))
+				return chatRoom;
+
+			// One to one basic chat room (addresses without gruu)
+			// The peer address must match the participantAddress argument
+			if (!conference && (capabilities & ChatRoom::Capabilities::Basic) &&
+			    participantAddress->weakEqual(*chatRoom->getPeerAddress()))
+				return chatRoom;
+		}
+		return nullptr;
+	};
+
+	shared_ptr<AbstractChatRoom> chatRoom;
+	if (!basicOnly) chatRoom = findIndexedChatRoom(true);
+	if (!chatRoom && !conferenceOnly) chatRoom = findIndexedChatRoom(false);
+	return chatRoom;
 }
 
 shared_ptr<AbstractChatRoom> Core::getOrCreateBasicChatRoom(const ConferenceId &conferenceId) {
@@ -858,9 +1196,8 @@ void Core::deleteChatRoom(const shared_ptr<const AbstractChatRoom> &chatRoom) {
 	lInfo() << "Trying to delete chat room with conference ID " << conferenceId << ".";
 
 	d->noCreatedClientGroupChatRooms.erase(chatRoom.get());
-	auto chatRoomsByIdIt = d->chatRoomsById.find(conferenceId);
-	if (chatRoomsByIdIt != d->chatRoomsById.end()) {
-		d->chatRoomsById.erase(chatRoomsByIdIt);
+	if (d->chatRoomsById.find(conferenceId) != d->chatRoomsById.end()) {
+		d->unmapChatRoom(conferenceId);
 		if (d->mainDb->isInitialized()) d->mainDb->deleteChatRoom(conferenceId);
 	} else {
 		lError() << "Unable to delete chat room with conference ID " << conferenceId << " because it cannot be found.";
@@ -901,6 +1238,68 @@ void CorePrivate::stopChatMessagesAggregationTimer() {
 	chatMessagesAggregationBackgroundTask.stop();
 }
 
+// -----------------------------------------------------------------------------
+
+bool CorePrivate::canStartFileTransfer() {
+	L_Q();
+
+	if (runningFileTransfers.empty()) return true;
+	LinphoneConfig *config = linphone_core_get_config(q->getCCore());
+	int maxTransfers = linphone_config_get_int(config, "misc", "max_parallel_file_transfers", 4);
+	if (maxTransfers > 0 && runningFileTransfers.size() >= (size_t)maxTransfers) return false;
+
+	int maxBandwidth = linphone_config_get_int(config, "misc", "file_transfer_max_bandwidth", 0);
+	if (maxBandwidth <= 0) return true;
+	// belle-sip cannot slow down a running transfer, the bandwidth is shared by not starting more transfers while the
+	// running ones use it up.
+	addFileTransferBytes(0);
+	return fileTransferRate * 8 < (size_t)maxBandwidth * 1000;
+}
+
+bool CorePrivate::acquireFileTransferSlot(const void *owner, const function<bool()> &start) {
+	if (pendingFileTransfers.empty() && canStartFileTransfer()) {
+		runningFileTransfers.push_back(owner);
+		return true;
+	}
+	lInfo() << "File transfer [" << owner << "] waits for " << runningFileTransfers.size()
+	        << " running transfers to leave room for it";
+	pendingFileTransfers.push_back({owner, start});
+	return false;
+}
+
+void CorePrivate::releaseFileTransferSlot(const void *owner) {
+	auto it = find(runningFileTransfers.begin(), runningFileTransfers.end(), owner);
+	if (it != runningFileTransfers.end()) {
+		runningFileTransfers.erase(it);
+		startPendingFileTransfers();
+		return;
+	}
+	pendingFileTransfers.remove_if([owner](const PendingFileTransfer &transfer) { return transfer.owner == owner; });
+}
+
+void CorePrivate::addFileTransferBytes(size_t bytes) {
+	uint64_t now = bctbx_get_cur_time_ms();
+	if (fileTransferWindowStart == 0) fileTransferWindowStart = now;
+	fileTransferWindowBytes += bytes;
+	uint64_t elapsed = now - fileTransferWindowStart;
+	if (elapsed < 1000) return;
+
+	fileTransferRate = (size_t)(fileTransferWindowBytes * 1000 / elapsed);
+	fileTransferWindowStart = now;
+	fileTransferWindowBytes = 0;
+	if (bytes > 0) startPendingFileTransfers();
+}
+
+void CorePrivate::startPendingFileTransfers() {
+	while (!pendingFileTransfers.empty() && canStartFileTransfer()) {
+		PendingFileTransfer transfer = pendingFileTransfers.front();
+		pendingFileTransfers.pop_front();
+		runningFileTransfers.push_back(transfer.owner);
+		lInfo() << "Starting file transfer [" << transfer.owner << "]";
+		if (!transfer.start()) releaseFileTransferSlot(transfer.owner);
+	}
+}
+
 bool Core::isCurrentlyAggregatingChatMessages() {
 	L_D();
 
@@ -21,7 +21,10 @@
 #ifndef _L_CORE_P_H_
 #define _L_CORE_P_H_
 
+#include <functional>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "linphone/utils/utils.h"
 
@@ -96,11 +99,27 @@ public:
 	bool setInputAudioDevice(const std::shared_ptr<AudioDevice> &audioDevice);
 
 	void loadChatRooms();
+	bool loadChatRoomDescriptors();
+	void insertParticipantDevices(const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	// Build chat rooms that were kept as descriptors by lazy loading, they are moved to chatRoomsById.
+	std::shared_ptr<AbstractChatRoom> loadDeferredChatRoom(const ConferenceId &conferenceId);
+	void loadDeferredChatRooms(const std::function<bool(const MainDb::ChatRoomDescriptor &)> &filter = nullptr);
+	// Listed chat rooms among the built ones, the deferred ones are left aside.
+	std::list<std::shared_ptr<AbstractChatRoom>> getLoadedChatRooms() const;
+	// Add the chat rooms imported into the database and refresh the loaded ones.
+	void loadImportedChatRooms();
 	void handleEphemeralMessages(time_t currentTime);
 	void initEphemeralMessages();
 	void updateEphemeralMessages(const std::shared_ptr<ChatMessage> &message);
+	void deleteEphemeralMessages(const std::list<std::shared_ptr<ChatMessage>> &messages);
 	void sendDeliveryNotifications();
 	void insertChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	// Update chatRoomsById and its indexes.
+	void mapChatRoom(const ConferenceId &conferenceId, const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	void unmapChatRoom(const ConferenceId &conferenceId);
+	void clearChatRooms();
+	// Index the one to one conference chat rooms which got their participant since they were mapped.
+	void indexPendingOneToOneChatRooms();
 	void insertChatRoomWithDb(const std::shared_ptr<AbstractChatRoom> &chatRoom, unsigned int notifyId = 0);
 	std::shared_ptr<AbstractChatRoom> createBasicChatRoom(const ConferenceId &conferenceId,
 	                                                      AbstractChatRoom::CapabilitiesMask capabilities,
@@ -147,7 +166,7 @@ public:
 	std::shared_ptr<AbstractChatRoom> searchChatRoom(const std::shared_ptr<ChatRoomParams> &params,
 	                                                 const std::shared_ptr<const Address> &localAddr,
 	                                                 const std::shared_ptr<const Address> &remoteAddr,
-	                                                 const std::list<std::shared_ptr<Address>> &participants) const;
+	                                                 const std::list<std::shared_ptr<Address>> &participants);
 
 	std::shared_ptr<const Address> getDefaultLocalAddress(const std::shared_ptr<Address> peerAddress,
 	                                                      bool withGruu) const;
@@ -160,11 +179,19 @@ public:
 	void updateChatRoomConferenceId(const std::shared_ptr<AbstractChatRoom> &chatRoom, ConferenceId newConferenceId);
 	std::shared_ptr<AbstractChatRoom> findExhumableOneToOneChatRoom(const std::shared_ptr<Address> &localAddress,
 	                                                                const std::shared_ptr<Address> &participantAddress,
-	                                                                bool encrypted) const;
+	                                                                bool encrypted);
 	std::shared_ptr<AbstractChatRoom> findExumedChatRoomFromPreviousConferenceId(const ConferenceId conferenceId) const;
 
 	void stopChatMessagesAggregationTimer();
 
+	// Budget shared by the HTTP file transfers of all the chat messages, see [misc] max_parallel_file_transfers and
+	// file_transfer_max_bandwidth (kbit/s). Returns true if the transfer of owner may start right away, otherwise start
+	// is called once the running transfers leave room for it, and returns false if the transfer is not wanted anymore.
+	bool acquireFileTransferSlot(const void *owner, const std::function<bool()> &start);
+	// To be called once the transfer of owner is over, whether it was started or is still waiting.
+	void releaseFileTransferSlot(const void *owner);
+	void addFileTransferBytes(size_t bytes);
+
 	// Cancel task scheduled on the main loop
 	void doLater(const std::function<void()> &something);
 	belle_sip_main_loop_t *getMainLoop();
@@ -206,7 +233,25 @@ private:
 	std::list<std::shared_ptr<Call>> calls;
 	std::shared_ptr<Call> currentCall;
 
+	void indexChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	void unindexChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	// To be called when the participants of a conference changed, the one to one key of its chat room may be stale.
+	void updateChatRoomIndex(const ConferenceId &conferenceId);
+
 	std::unordered_map<ConferenceId, std::shared_ptr<AbstractChatRoom>> chatRoomsById;
+	// Indexes of chatRoomsById by peer address and by (local address, remote address, capability class) of the one
+	// to one chat rooms. Keys are built from the weak address keys, candidates are checked by the lookups.
+	struct ChatRoomIndexKeys {
+		std::string peerKey;
+		std::string oneToOneKey; // Empty if the chat room is not indexed as one to one.
+	};
+	std::unordered_multimap<std::string, std::shared_ptr<AbstractChatRoom>> chatRoomsByPeer;
+	std::unordered_multimap<std::string, std::shared_ptr<AbstractChatRoom>> oneToOneChatRooms;
+	std::unordered_map<const AbstractChatRoom *, ChatRoomIndexKeys> chatRoomIndexKeys;
+	// One to one conference chat rooms which had no participant yet when they were indexed.
+	std::unordered_set<std::shared_ptr<AbstractChatRoom>> pendingOneToOneChatRooms;
+	// Chat rooms of the database not built yet, see [misc] lazy_chat_rooms_loading.
+	std::unordered_map<ConferenceId, MainDb::ChatRoomDescriptor> deferredChatRooms;
 
 	std::unique_ptr<EncryptionEngine> imee;
 
@@ -219,12 +264,29 @@ private:
 	std::unordered_map<const AbstractChatRoom *, std::shared_ptr<const AbstractChatRoom>> noCreatedClientGroupChatRooms;
 	AuthStack authStack;
 
-	std::list<std::shared_ptr<ChatMessage>> ephemeralMessages;
+	// Min-heap on the expire time of the messages, it holds the ones expiring up to ephemeralMessagesHorizon. Later
+	// ones are only in database and loaded once the heap is empty.
+	std::vector<std::shared_ptr<ChatMessage>> ephemeralMessages;
+	time_t ephemeralMessagesHorizon = 0;
+	bool ephemeralMessagesLoaded = false;
 	belle_sip_source_t *ephemeralTimer = nullptr;
 
 	belle_sip_source_t *chatMessagesAggregationTimer = nullptr;
 	BackgroundTask chatMessagesAggregationBackgroundTask{"Chat messages aggregation"};
 
+	bool canStartFileTransfer();
+	void startPendingFileTransfers();
+	struct PendingFileTransfer {
+		const void *owner;
+		std::function<bool()> start;
+	};
+	std::list<const void *> runningFileTransfers;
+	std::list<PendingFileTransfer> pendingFileTransfers;
+	// Throughput of the running file transfers, measured over windows of at least one second.
+	uint64_t fileTransferWindowStart = 0;
+	size_t fileTransferWindowBytes = 0;
+	size_t fileTransferRate = 0; // In bytes per second.
+
 	BackgroundTask pushReceivedBackgroundTask{"Push received background task"};
 	std::string lastPushReceivedCallId = "";
 
@@ -195,6 +195,15 @@ void CorePrivate::init() {
 				lWarning() << "Opening database took " << duration << " ms !";
 			}
 
+			if (linphone_config_get_bool(linphone_core_get_config(lc), "storage", "write_behind_enabled", FALSE)) {
+				int flushInterval =
+				    linphone_config_get_int(linphone_core_get_config(lc), "storage", "write_behind_flush_interval", 200);
+				int maxPendingOperations =
+				    linphone_config_get_int(linphone_core_get_config(lc), "storage", "write_behind_max_operations", 100);
+				mainDb->enableWriteBehind(true, static_cast<unsigned int>(std::max(flushInterval, 1)),
+				                          static_cast<unsigned int>(std::max(maxPendingOperations, 1)));
+			}
+
 			loadChatRooms();
 			linphone_core_friends_storage_resync_friends_lists(lc); // Load friends from mainDB if any
 		} else lWarning() << "Database explicitely not requested, this Core is built with no database support.";
@@ -348,6 +357,7 @@ void CorePrivate::shutdown() {
 
 	stopEphemeralMessageTimer();
 	ephemeralMessages.clear();
+	ephemeralMessagesLoaded = false;
 
 	stopChatMessagesAggregationTimer();
 
@@ -380,7 +390,11 @@ void CorePrivate::uninit() {
 		imee.reset();
 	}
 
-	const list<shared_ptr<AbstractChatRoom>> chatRooms = q->getChatRooms();
+	// Chat rooms that were never built have nothing pending.
+	deferredChatRooms.clear();
+	// File transfers still waiting for their turn are not started anymore.
+	pendingFileTransfers.clear();
+	const list<shared_ptr<AbstractChatRoom>> chatRooms = getLoadedChatRooms();
 	shared_ptr<ChatRoom> cr;
 	for (const auto &chatRoom : chatRooms) {
 		cr = dynamic_pointer_cast<ChatRoom>(chatRoom);
@@ -404,7 +418,7 @@ void CorePrivate::uninit() {
 		}
 	}
 
-	chatRoomsById.clear();
+	clearChatRooms();
 
 	for (const auto &audioVideoConference : q->audioVideoConferenceById) {
 		// Terminate audio video conferences just before core is stopped
@@ -439,6 +453,9 @@ void CorePrivate::uninit() {
 
 void CorePrivate::disconnectMainDb() {
 	if (mainDb != nullptr) {
+		mainDb->cancelAsyncReads();
+		// Commit the pending writes, if any, before closing the database.
+		mainDb->enableWriteBehind(false);
 		mainDb->disconnect();
 	}
 }
@@ -1534,6 +1551,10 @@ int Core::getUnreadChatMessageCount(const std::shared_ptr<Address> &localAddress
 			}
 		}
 	}
+	for (const auto &[conferenceId, descriptor] : d->deferredChatRooms) {
+		if (localAddress->weakEqual(*conferenceId.getLocalAddress()) && !descriptor.isMuted)
+			count += descriptor.unreadMessageCount;
+	}
 	return count;
 }
 
@@ -1552,6 +1573,13 @@ int Core::getUnreadChatMessageCountFromActiveLocals() const {
 			}
 		}
 	}
+	for (const auto &[conferenceId, descriptor] : d->deferredChatRooms) {
+		for (const auto &account : getAccounts()) {
+			auto identityAddress = account->getAccountParams()->getIdentityAddress();
+			if (identityAddress->weakEqual(*conferenceId.getLocalAddress()) && !descriptor.isMuted)
+				count += descriptor.unreadMessageCount;
+		}
+	}
 	return count;
 }
 
@@ -190,16 +190,19 @@ public:
 	// ChatRoom.
 	// ---------------------------------------------------------------------------
 
-	std::list<std::shared_ptr<AbstractChatRoom>> getChatRooms() const;
+	// Builds the chat rooms deferred by lazy loading.
+	std::list<std::shared_ptr<AbstractChatRoom>> getChatRooms();
+	// Same chat rooms as getChatRooms(), only the ones in [begin, end[ are built. end < 0 means until the last one.
+	std::list<std::shared_ptr<AbstractChatRoom>> getChatRoomsRange(int begin, int end);
 
-	std::shared_ptr<AbstractChatRoom> findChatRoom(const ConferenceId &conferenceId, bool logIfNotFound = true) const;
-	std::list<std::shared_ptr<AbstractChatRoom>> findChatRooms(const std::shared_ptr<Address> &peerAddress) const;
+	std::shared_ptr<AbstractChatRoom> findChatRoom(const ConferenceId &conferenceId, bool logIfNotFound = true);
+	std::list<std::shared_ptr<AbstractChatRoom>> findChatRooms(const std::shared_ptr<Address> &peerAddress);
 
 	std::shared_ptr<AbstractChatRoom> findOneToOneChatRoom(const std::shared_ptr<const Address> &localAddress,
 	                                                       const std::shared_ptr<Address> &participantAddress,
 	                                                       bool basicOnly,
 	                                                       bool conferenceOnly,
-	                                                       bool encrypted) const;
+	                                                       bool encrypted);
 
 	std::shared_ptr<AbstractChatRoom> createClientGroupChatRoom(const std::string &subject, bool fallback = true);
 	std::shared_ptr<AbstractChatRoom> createClientGroupChatRoom(const std::string &subject,
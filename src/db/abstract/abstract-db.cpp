@@ -141,6 +141,8 @@ bool AbstractDb::forceReconnect() {
 		for (int i = 0; i < retryCount; ++i) {
 			try {
 				lInfo() << "Reconnect... Try: " << i;
+				// Prepared statements are bound to the closed connection.
+				d->dbSession.clearStatementCache();
 				d->dbSession.getBackendSession()->reconnect(); // Equivalent to close and connect.
 				d->safeInit();
 				lInfo() << "Database reconnection successful!";
@@ -180,6 +182,42 @@ bool AbstractDb::isInitialized() const {
 	return d->initialized;
 }
 
+unsigned long long AbstractDb::getStatementCacheHits() const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->dbSession ? d->dbSession.getStatementCacheHits() : 0;
+#else
+	return 0;
+#endif
+}
+
+unsigned long long AbstractDb::getStatementCacheMisses() const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->dbSession ? d->dbSession.getStatementCacheMisses() : 0;
+#else
+	return 0;
+#endif
+}
+
+bool AbstractDb::writeAheadLogEnabled() const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->dbSession && d->dbSession.writeAheadLogEnabled();
+#else
+	return false;
+#endif
+}
+
+shared_ptr<soci::session> AbstractDb::acquireReadSession() const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->dbSession ? d->dbSession.acquireReadSession() : nullptr;
+#else
+	return nullptr;
+#endif
+}
+
 std::ostream &operator<<(std::ostream &os, AbstractDb::Backend b) {
 	switch (b) {
 		case AbstractDb::Mysql:
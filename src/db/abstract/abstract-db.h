@@ -26,6 +26,10 @@
 
 // =============================================================================
 
+namespace soci {
+class session;
+}
+
 LINPHONE_BEGIN_NAMESPACE
 
 class AbstractDbPrivate;
@@ -55,6 +59,15 @@ public:
 	virtual bool import(Backend backend, const std::string &parameters);
 
 	bool isInitialized() const;
+
+	// Counters of the prepared statements cache of the current session.
+	unsigned long long getStatementCacheHits() const;
+	unsigned long long getStatementCacheMisses() const;
+
+	// Write-ahead log and read-only connections of the current session, see DbSession.
+	bool writeAheadLogEnabled() const;
+	std::shared_ptr<soci::session> acquireReadSession() const;
+
 	/* This function is to initialize soci backends when used with static linking. */
 	static void registerBackend(Backend backend);
 
@@ -37,21 +37,38 @@ LINPHONE_BEGIN_NAMESPACE
 
 class SmartTransaction {
 public:
-	SmartTransaction(soci::session *session, const char *name) : mSession(session), mName(name), mIsCommitted(false) {
-		lDebug() << "Start transaction " << this << " in MainDb::" << mName << ".";
-		mSession->begin();
+	// A transaction started while another one (or a write-behind batch) is running is nested in it using a savepoint.
+	// A write which is not part of the write-behind batch commits the batch with it, it must not be lost if the
+	// batch is aborted later.
+	SmartTransaction(MainDbPrivate *mainDb, const char *name)
+	    : mMainDb(mainDb), mSession(mainDb->dbSession.getBackendSession()), mName(name), mIsCommitted(false),
+	      mIsNested(mainDb->transactionDepth > 0 || mainDb->writeBehind.transactionOpen),
+	      mIsBatched(mainDb->transactionDepth == 0 && mainDb->writeBehind.operationStarting),
+	      mUncommittedSipAddressCount(mainDb->getUncommittedSipAddressCount()),
+	      mSavepointName("main_db_transaction_" + std::to_string(mainDb->transactionDepth)) {
+		if (mIsBatched) mMainDb->writeBehind.operationStarting = false;
+		lDebug() << "Start transaction " << this << " in MainDb::" << mName << (mIsNested ? " (nested)." : ".");
+		if (mIsNested) *mSession << "SAVEPOINT " << mSavepointName;
+		else mSession->begin();
+		mMainDb->transactionDepth++;
 	}
 
 	~SmartTransaction() {
+		mMainDb->transactionDepth--;
 		if (!mIsCommitted) {
 			lDebug() << "Rollback transaction " << this << " in MainDb::" << mName << ".";
 			try {
-				mSession->rollback();
+				if (mIsNested) {
+					*mSession << "ROLLBACK TO SAVEPOINT " << mSavepointName;
+					*mSession << "RELEASE SAVEPOINT " << mSavepointName;
+				} else mSession->rollback();
 			} catch (std::runtime_error &e) {
 				lError() << "Error during rollback transaction " << this << " in MainDb::" << mName
 				         << ". Error : " << e.what();
 			}
+			mMainDb->rollbackInternedSipAddresses(mUncommittedSipAddressCount);
 		}
+		if (mMainDb->transactionDepth == 0 && mMainDb->writeBehind.flushRequested) mMainDb->flushWriteBehindBatch();
 	}
 
 	void commit() {
@@ -62,13 +79,27 @@ public:
 
 		lDebug() << "Commit transaction " << this << " in MainDb::" << mName << ".";
 		mIsCommitted = true;
-		mSession->commit();
+		if (mIsNested) {
+			*mSession << "RELEASE SAVEPOINT " << mSavepointName;
+			if (mMainDb->transactionDepth == 1 && !mIsBatched && mMainDb->writeBehind.transactionOpen)
+				mMainDb->writeBehind.flushRequested = true;
+		} else {
+			mSession->commit();
+			mMainDb->commitInternedSipAddresses();
+		}
 	}
 
 private:
+	MainDbPrivate *mMainDb;
 	soci::session *mSession;
 	const char *mName;
 	bool mIsCommitted;
+	bool mIsNested;
+	bool mIsBatched;
+	// Sip addresses written by the enclosing transactions, kept if this one is rolled back.
+	const size_t mUncommittedSipAddressCount;
+	// Savepoint names must be unique per level: MySQL replaces a savepoint of the same name.
+	const std::string mSavepointName;
 
 	L_DISABLE_COPY(SmartTransaction);
 };
@@ -96,18 +127,22 @@ public:
 	DbTransaction(DbTransactionInfo &info, Function &&function) : mFunction(std::move(function)) {
 		MainDb *mainDb = info.mainDb;
 		const char *name = info.name;
-		soci::session *session = mainDb->getPrivate()->dbSession.getBackendSession();
+		MainDbPrivate *d = mainDb->getPrivate();
 
 		try {
-			SmartTransaction tr(session, name);
+			SmartTransaction tr(d, name);
 			mResult = exec<InternalReturnType>(tr);
 		} catch (const soci::soci_error &e) {
 			lWarning() << "Caught exception in MainDb::" << name << "(" << e.what() << ").";
 			soci::soci_error::error_category category = e.get_error_category();
+			if (category == soci::soci_error::connection_error || category == soci::soci_error::unknown) {
+				// A reconnection loses the pending writes of the write-behind batch.
+				d->abortWriteBehindBatch();
+			}
 			if ((category == soci::soci_error::connection_error || category == soci::soci_error::unknown) &&
 			    mainDb->forceReconnect()) {
 				try {
-					SmartTransaction tr(session, name);
+					SmartTransaction tr(d, name);
 					mResult = exec<InternalReturnType>(tr);
 				} catch (const std::exception &e) {
 					lError() << "Unable to execute query after reconnect in MainDb::" << name << "(" << e.what()
@@ -143,6 +143,34 @@ constexpr const char *select[SelectCount] = {
 			SELECT value
 			FROM sip_address
 			WHERE id = :1
+		)",
+
+    /* SelectContentTypeId */ R"(
+			SELECT id
+			FROM content_type
+			WHERE value = :1
+		)",
+
+    /* SelectChatMessageParticipantState */ R"(
+			SELECT state
+			FROM chat_message_participant
+			WHERE event_id = :1 AND participant_sip_address_id = :2
+		)",
+
+    /* SelectChatRooms */ R"(
+			SELECT chat_room.id, peer_sip_address.value, local_sip_address.value, creation_time, last_update_time, capabilities, subject, last_notify_id, flags, last_message_id, ephemeral_enabled, ephemeral_messages_lifetime, unread_message_count, muted
+			FROM chat_room
+			JOIN sip_address AS peer_sip_address ON peer_sip_address.id = peer_sip_address_id
+			JOIN sip_address AS local_sip_address ON local_sip_address.id = local_sip_address_id
+		)",
+
+    /* SelectChatRoomDescriptors */ R"(
+			SELECT peer_sip_address.value, local_sip_address.value, last_update_time, capabilities, last_message_id, unread_message_count, muted
+			FROM chat_room
+			JOIN sip_address AS peer_sip_address ON peer_sip_address.id = peer_sip_address_id
+			JOIN sip_address AS local_sip_address ON local_sip_address.id = local_sip_address_id
+			ORDER BY last_update_time DESC
+			LIMIT :1 OFFSET :2
 		)"};
 
 // ---------------------------------------------------------------------------
@@ -154,6 +182,72 @@ constexpr AbstractStatement insert[InsertCount] = {
 			INSERT INTO one_to_one_chat_room (
 				chat_room_id, participant_a_sip_address_id, participant_b_sip_address_id
 			) VALUES (:1, :2, :3)
+		)",
+
+    /* InsertSipAddress */ R"(
+			INSERT INTO sip_address (value, display_name) VALUES (:1, :2)
+		)",
+
+    /* InsertContentType */ R"(
+			INSERT INTO content_type (value) VALUES (:1)
+		)",
+
+    /* InsertEvent */ R"(
+			INSERT INTO event (type, creation_time) VALUES (:1, :2)
+		)",
+
+    /* InsertConferenceEvent */ R"(
+			INSERT INTO conference_event (event_id, chat_room_id) VALUES (:1, :2)
+		)",
+
+    /* InsertConferenceChatMessageEvent */ R"(
+			INSERT INTO conference_chat_message_event (
+				event_id, from_sip_address_id, to_sip_address_id,
+				time, state, direction, imdn_message_id, is_secured,
+				delivery_notification_required, display_notification_required,
+				marked_as_read, forward_info, call_id, reply_message_id, reply_sender_address_id
+			) VALUES (:1, :2, :3, :4, :5, :6, :7, :8, :9, :10, :11, :12, :13, :14, :15)
+		)",
+
+    /* InsertChatMessageContent */ R"(
+			INSERT INTO chat_message_content (event_id, content_type_id, body, body_encoding_type)
+			VALUES (:1, :2, :3, 1)
+		)",
+
+    /* InsertChatMessageFileContent */ R"(
+			INSERT INTO chat_message_file_content (chat_message_content_id, name, size, path, duration)
+			VALUES (:1, :2, :3, :4, :5)
+		)",
+
+    /* InsertChatMessageContentAppData */ R"(
+			INSERT INTO chat_message_content_app_data (chat_message_content_id, name, data) VALUES (:1, :2, :3)
+		)",
+
+    /* InsertChatMessageParticipant */ R"(
+			INSERT INTO chat_message_participant (event_id, participant_sip_address_id, state, state_change_time)
+			VALUES (:1, :2, :3, :4)
+		)"};
+
+// ---------------------------------------------------------------------------
+// Update statements.
+// ---------------------------------------------------------------------------
+
+constexpr const char *update[UpdateCount] = {
+    /* UpdateSipAddressDisplayName */ R"(
+			UPDATE sip_address SET display_name = :1 WHERE id = :2
+		)",
+
+    /* UpdateChatRoomLastMessageId */ R"(
+			UPDATE chat_room SET last_message_id = :1, unread_message_count = unread_message_count + :2 WHERE id = :3
+		)",
+
+    /* UpdateChatRoomUnreadMessageCount */ R"(
+			UPDATE chat_room SET unread_message_count = unread_message_count + :1 WHERE id = :2
+		)",
+
+    /* UpdateChatMessageParticipantState */ R"(
+			UPDATE chat_message_participant SET state = :1, state_change_time = :2
+			WHERE event_id = :3 AND participant_sip_address_id = :4
 		)"};
 
 // ---------------------------------------------------------------------------
@@ -167,6 +261,10 @@ const char *get(Select selectStmt) {
 const char *get(Insert insertStmt, AbstractDb::Backend backend) {
 	return insertStmt >= Insert::InsertCount ? nullptr : insert[insertStmt].get(backend);
 }
+
+const char *get(Update updateStmt) {
+	return updateStmt >= Update::UpdateCount ? nullptr : update[updateStmt];
+}
 } // namespace Statements
 
 LINPHONE_END_NAMESPACE
@@ -40,13 +40,60 @@ enum Select {
 	SelectConferenceInfoOrganizerId,
 	SelectConferenceCall,
 	SelectSipAddressFromId,
+	SelectContentTypeId,
+	SelectChatMessageParticipantState,
+	SelectChatRooms,
+	SelectChatRoomDescriptors,
 	SelectCount
 };
 
-enum Insert { InsertOneToOneChatRoom, InsertCount };
+enum Insert {
+	InsertOneToOneChatRoom,
+	InsertSipAddress,
+	InsertContentType,
+	InsertEvent,
+	InsertConferenceEvent,
+	InsertConferenceChatMessageEvent,
+	InsertChatMessageContent,
+	InsertChatMessageFileContent,
+	InsertChatMessageContentAppData,
+	InsertChatMessageParticipant,
+	InsertCount
+};
+
+enum Update {
+	UpdateSipAddressDisplayName,
+	UpdateChatRoomLastMessageId,
+	UpdateChatRoomUnreadMessageCount,
+	UpdateChatMessageParticipantState,
+	UpdateCount
+};
+
+// Queries built at runtime from a fixed set of variants (e.g. one per filter mask).
+enum Query { QueryChatMessagesByImdnMessageId, QueryHistory, QueryHistoryBefore, QueryCount };
 
 const char *get(Select selectStmt);
 const char *get(Insert insertStmt, AbstractDb::Backend backend);
+const char *get(Update updateStmt);
+
+// Identifiers of the statements in the prepared statements cache of a DbSession.
+constexpr int MaxQueryVariants = 64;
+
+constexpr int getCacheId(Select selectStmt) {
+	return selectStmt;
+}
+
+constexpr int getCacheId(Insert insertStmt) {
+	return SelectCount + insertStmt;
+}
+
+constexpr int getCacheId(Update updateStmt) {
+	return SelectCount + InsertCount + updateStmt;
+}
+
+constexpr int getCacheId(Query query, int variant = 0) {
+	return SelectCount + InsertCount + UpdateCount + query * MaxQueryVariants + variant;
+}
 } // namespace Statements
 
 LINPHONE_END_NAMESPACE
@@ -21,7 +21,15 @@
 #ifndef _L_MAIN_DB_P_H_
 #define _L_MAIN_DB_P_H_
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+#include <belle-sip/types.h>
 
 #include "linphone/utils/utils.h"
 
@@ -39,12 +47,88 @@ class Content;
 
 class MainDbPrivate : public AbstractDbPrivate {
 public:
+	~MainDbPrivate();
+
 	mutable std::unordered_map<long long, std::weak_ptr<EventLog>> storageIdToEvent;
 	mutable std::unordered_map<long long, std::weak_ptr<ChatMessage>> storageIdToChatMessage;
 	mutable std::unordered_map<long long, ConferenceId> storageIdToConferenceId;
 	mutable std::unordered_map<long long, std::weak_ptr<CallLog>> storageIdToCallLog;
 	mutable std::unordered_map<long long, std::weak_ptr<ConferenceInfo>> storageIdToConferenceInfo;
 
+	// Number of running SmartTransaction, the inner ones use savepoints.
+	unsigned int transactionDepth = 0;
+
+	// ---------------------------------------------------------------------------
+	// Write-behind API.
+	// ---------------------------------------------------------------------------
+
+	struct WriteBehindBatch {
+		bool enabled = false;
+		bool transactionOpen = false;
+		// Set between openWriteBehindBatch() and the transaction of the operation which is batched.
+		bool operationStarting = false;
+		// Another write was committed into the batch, it is flushed once the outermost transaction ends.
+		bool flushRequested = false;
+		unsigned int flushInterval = 0;
+		unsigned int maxPendingOperations = 0;
+		unsigned int pendingOperations = 0;
+		belle_sip_source_t *timer = nullptr;
+		std::list<std::weak_ptr<EventLog>> insertedEvents;
+		std::list<MainDb::WriteCompletionCb> completionCbs;
+	} writeBehind;
+
+	void openWriteBehindBatch();
+	void queueWriteBehindOperation(bool success,
+	                               const std::shared_ptr<EventLog> &insertedEvent,
+	                               const MainDb::WriteCompletionCb &onCompleted);
+	void flushWriteBehindBatch();
+	void abortWriteBehindBatch();
+
+	// ---------------------------------------------------------------------------
+	// Asynchronous reads.
+	// ---------------------------------------------------------------------------
+
+#ifdef HAVE_DB_STORAGE
+	// A rowset reuses the same row for each fetch and soci rows can be neither copied nor moved.
+	using Rows = std::vector<std::unique_ptr<soci::row>>;
+	using RowsReader = std::function<void(soci::session &session, Rows &rows)>;
+	using RowsHandler = std::function<void(const Rows &rows)>;
+
+	struct AsyncReader {
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<std::function<void(soci::session &session)>> tasks; // Protected by mutex.
+		bool stopping = false;                                          // Protected by mutex.
+		std::shared_ptr<soci::session> session; // Read-only session used by the worker thread.
+		// Core thread only.
+		unsigned long long lastRequestId = 0;
+		std::unordered_map<unsigned long long, RowsHandler> handlers;
+	};
+	// The results posted to the core thread are dropped once the reader is gone.
+	std::shared_ptr<AsyncReader> asyncReader;
+
+	// Runs reader on the DB worker thread, then handler with the fetched rows on the core thread.
+	void readAsync(const RowsReader &reader, const RowsHandler &handler);
+	void stopAsyncReader();
+
+	static void appendRows(soci::rowset<soci::row> &rowset, Rows &rows);
+#endif
+
+	// ---------------------------------------------------------------------------
+	// Sip addresses interning.
+	// ---------------------------------------------------------------------------
+
+	// Called when the outermost transaction is committed, or when a transaction is rolled back with the number of
+	// uncommitted addresses at its start.
+	void commitInternedSipAddresses() const;
+	void rollbackInternedSipAddresses(size_t uncommittedCount = 0) const;
+	size_t getUncommittedSipAddressCount() const {
+		return uncommittedSipAddresses.size();
+	}
+	// Id of a normalized sip address if it is interned, -1 otherwise. The database is not queried.
+	long long getInternedSipAddressId(const std::string &sipAddress) const;
+
 private:
 	// ---------------------------------------------------------------------------
 	// Misc helpers.
@@ -111,6 +195,8 @@ private:
 	long long selectConferenceInfoParticipantId(long long conferenceInfoId, long long participantSipAddressId) const;
 	long long selectConferenceCallId(const std::string &callId);
 
+	void updateChatRoomUnreadMessageCount(long long chatRoomId);
+
 	void deleteContents(long long chatMessageId);
 	void deleteChatRoomParticipant(long long chatRoomId, long long participantSipAddressId);
 	void deleteChatRoomParticipantDevice(long long participantId, long long participantDeviceSipAddressId);
@@ -166,6 +252,9 @@ private:
 
 	std::shared_ptr<EventLog>
 	selectConferenceSubjectEvent(const ConferenceId &conferenceId, EventLog::Type type, const soci::row &row) const;
+
+	std::shared_ptr<AbstractChatRoom>
+	selectChatRoom(const soci::row &row, const ConferenceId &conferenceId, bool serverMode) const;
 #endif
 
 	long long insertEvent(const std::shared_ptr<EventLog> &eventLog);
@@ -258,6 +347,23 @@ private:
 
 	mutable LruCache<ConferenceId, int> unreadChatMessageCountCache;
 
+	struct InternedSipAddress {
+		long long storageId = -1;
+		std::string displayName;
+		bool displayNameKnown = false;
+	};
+
+	// Normalized sip address (see Address::toStringUriOnlyOrdered()) to its row in the sip_address table.
+	mutable LruCache<std::string, InternedSipAddress> sipAddressCache;
+	// Addresses written by the running transaction, forgotten if it is rolled back.
+	mutable std::vector<std::string> uncommittedSipAddresses;
+
+	// `written` is set when the row has been inserted or updated by the running transaction.
+	void internSipAddress(const std::string &sipAddress,
+	                      long long storageId,
+	                      const std::string *displayName,
+	                      bool written) const;
+
 	L_DECLARE_PUBLIC(MainDb);
 };
 
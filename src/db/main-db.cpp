@@ -29,6 +29,8 @@
 #endif
 
 #include <ctime>
+#include <limits>
+#include <unordered_set>
 
 #include <bctoolbox/defs.h>
 
@@ -76,12 +78,21 @@ LINPHONE_BEGIN_NAMESPACE
 
 #ifdef HAVE_DB_STORAGE
 namespace {
-constexpr unsigned int ModuleVersionEvents = makeVersion(1, 0, 31);
+constexpr unsigned int ModuleVersionEvents = makeVersion(1, 0, 33);
 constexpr unsigned int ModuleVersionFriends = makeVersion(1, 0, 1);
 constexpr unsigned int ModuleVersionLegacyFriendsImport = makeVersion(1, 0, 0);
 constexpr unsigned int ModuleVersionLegacyHistoryImport = makeVersion(1, 0, 0);
 constexpr unsigned int ModuleVersionLegacyCallLogsImport = makeVersion(1, 0, 0);
 
+// Counts the unread chat messages of the chat rooms from scratch.
+constexpr char RecountUnreadMessageCountQuery[] =
+    "UPDATE chat_room SET unread_message_count = ("
+    "  SELECT count(*) FROM conference_event, conference_chat_message_event"
+    "  WHERE conference_event.chat_room_id = chat_room.id"
+    "  AND conference_chat_message_event.event_id = conference_event.event_id"
+    "  AND conference_chat_message_event.marked_as_read = 0"
+    ")";
+
 constexpr int LegacyFriendListColId = 0;
 constexpr int LegacyFriendListColName = 1;
 constexpr int LegacyFriendListColRlsUri = 2;
@@ -155,6 +166,58 @@ static T getValueFromRow(const soci::row &row, int index, bool &isNull) {
 	}
 	return row.get<T>(size_t(index));
 }
+
+template <typename T>
+static void copyColumn(const soci::row &row, size_t index, soci::row &copy) {
+	const soci::indicator indicator = row.get_indicator(index);
+	copy.add_holder(new T(indicator == soci::i_null ? T() : row.get<T>(index)), new soci::indicator(indicator));
+}
+
+// Deep copy of a fetched row. The holders must have the exact type soci uses for the column data type.
+static unique_ptr<soci::row> copyRow(const soci::row &row) {
+	auto copy = makeUnique<soci::row>();
+	for (size_t i = 0; i < row.size(); ++i) {
+		const soci::column_properties &properties = row.get_properties(i);
+		copy->add_properties(properties);
+		switch (properties.get_data_type()) {
+			case soci::dt_string:
+				copyColumn<string>(row, i, *copy);
+				break;
+			case soci::dt_date:
+				copyColumn<tm>(row, i, *copy);
+				break;
+			case soci::dt_double:
+				copyColumn<double>(row, i, *copy);
+				break;
+			case soci::dt_integer:
+				copyColumn<int>(row, i, *copy);
+				break;
+			case soci::dt_long_long:
+				copyColumn<long long>(row, i, *copy);
+				break;
+			case soci::dt_unsigned_long_long:
+				copyColumn<unsigned long long>(row, i, *copy);
+				break;
+			default:
+				throw soci::soci_error("Unable to copy column `" + properties.get_name() + "`: unsupported type.");
+		}
+	}
+	return copy;
+}
+
+// Value of an integer column, whatever the integer type used by the backend.
+static long long getIntegerFromRow(const soci::row &row, size_t index) {
+	switch (row.get_properties(index).get_data_type()) {
+		case soci::dt_integer:
+			return row.get<int>(index);
+		case soci::dt_long_long:
+			return row.get<long long>(index);
+		case soci::dt_unsigned_long_long:
+			return static_cast<long long>(row.get<unsigned long long>(index));
+		default:
+			throw soci::soci_error("Column `" + row.get_properties(index).get_name() + "` is not an integer.");
+	}
+}
 #endif
 
 // -----------------------------------------------------------------------------
@@ -306,25 +369,34 @@ MainDbPrivate::findAudioVideoConference(const ConferenceId &conferenceId) const
 
 long long MainDbPrivate::insertSipAddress(BCTBX_UNUSED(const std::shared_ptr<Address> &address)) {
 #ifdef HAVE_DB_STORAGE
+	L_Q();
+
 	// This is a hack, because all addresses don't print their parameters in the same order.
 	const string sipAddress = address->toStringUriOnlyOrdered();
 	const string displayName = address->getDisplayName();
 
-	long long sipAddressId = selectSipAddressId(sipAddress);
+	const InternedSipAddress *interned = sipAddressCache[sipAddress];
+	if (interned && (displayName.empty() || (interned->displayNameKnown && interned->displayName == displayName)))
+		return interned->storageId;
+
+	long long sipAddressId = interned ? interned->storageId : selectSipAddressId(sipAddress);
 	if (sipAddressId < 0) {
 		lInfo() << "Insert new sip address in database: `" << sipAddress << "`.";
 		soci::indicator displayNameInd = displayName.empty() ? soci::i_null : soci::i_ok;
 
-		*dbSession.getBackendSession()
-		    << "INSERT INTO sip_address (value, display_name) VALUES (:sipAddress, :displayName)",
-		    soci::use(sipAddress), soci::use(displayName, displayNameInd);
+		dbSession.executeCached(Statements::getCacheId(Statements::InsertSipAddress),
+		                        Statements::get(Statements::InsertSipAddress, q->getBackend()), soci::use(sipAddress),
+		                        soci::use(displayName, displayNameInd));
 
-		return dbSession.getLastInsertId();
+		sipAddressId = dbSession.getLastInsertId();
+		internSipAddress(sipAddress, sipAddressId, &displayName, true);
 	} else if (sipAddressId >= 0 && !displayName.empty()) {
 		lInfo() << "Updating sip address display name in database: `" << sipAddress << "`.";
 
-		*dbSession.getBackendSession() << "UPDATE sip_address SET display_name = :displayName WHERE id = :id",
-		    soci::use(displayName), soci::use(sipAddressId);
+		dbSession.executeCached(Statements::getCacheId(Statements::UpdateSipAddressDisplayName),
+		                        Statements::get(Statements::UpdateSipAddressDisplayName), soci::use(displayName),
+		                        soci::use(sipAddressId));
+		internSipAddress(sipAddress, sipAddressId, &displayName, true);
 	}
 
 	return sipAddressId;
@@ -335,13 +407,14 @@ long long MainDbPrivate::insertSipAddress(BCTBX_UNUSED(const std::shared_ptr<Add
 
 void MainDbPrivate::insertContent(long long chatMessageId, const Content &content) {
 #ifdef HAVE_DB_STORAGE
-	soci::session *session = dbSession.getBackendSession();
+	L_Q();
+	const AbstractDb::Backend backend = q->getBackend();
 
 	const long long &contentTypeId = insertContentType(content.getContentType().getMediaType());
 	const string &body = content.getBodyAsUtf8String();
-	*session << "INSERT INTO chat_message_content (event_id, content_type_id, body, body_encoding_type) VALUES"
-	            " (:chatMessageId, :contentTypeId, :body, 1)",
-	    soci::use(chatMessageId), soci::use(contentTypeId), soci::use(body);
+	dbSession.executeCached(Statements::getCacheId(Statements::InsertChatMessageContent),
+	                        Statements::get(Statements::InsertChatMessageContent, backend), soci::use(chatMessageId),
+	                        soci::use(contentTypeId), soci::use(body));
 
 	const long long &chatMessageContentId = dbSession.getLastInsertId();
 	if (content.isFile()) {
@@ -350,30 +423,34 @@ void MainDbPrivate::insertContent(long long chatMessageId, const Content &conten
 		const size_t &size = fileContent.getFileSize();
 		const string &path = fileContent.getFilePath();
 		int duration = fileContent.getFileDuration();
-		*session << "INSERT INTO chat_message_file_content (chat_message_content_id, name, size, path, duration) VALUES"
-		            " (:chatMessageContentId, :name, :size, :path, :duration)",
-		    soci::use(chatMessageContentId), soci::use(name), soci::use(size), soci::use(path), soci::use(duration);
+		dbSession.executeCached(Statements::getCacheId(Statements::InsertChatMessageFileContent),
+		                        Statements::get(Statements::InsertChatMessageFileContent, backend),
+		                        soci::use(chatMessageContentId), soci::use(name), soci::use(size), soci::use(path),
+		                        soci::use(duration));
 	}
 
 	for (const auto &property : content.getProperties()) {
-		*session << "INSERT INTO chat_message_content_app_data (chat_message_content_id, name, data) VALUES"
-		            " (:chatMessageContentId, :name, :data)",
-		    soci::use(chatMessageContentId), soci::use(property.first), soci::use(property.second.getValue<string>());
+		const string &data = property.second.getValue<string>();
+		dbSession.executeCached(Statements::getCacheId(Statements::InsertChatMessageContentAppData),
+		                        Statements::get(Statements::InsertChatMessageContentAppData, backend),
+		                        soci::use(chatMessageContentId), soci::use(property.first), soci::use(data));
 	}
 #endif
 }
 
 long long MainDbPrivate::insertContentType(const string &contentType) {
 #ifdef HAVE_DB_STORAGE
-	soci::session *session = dbSession.getBackendSession();
+	L_Q();
 
 	long long contentTypeId;
-	*session << "SELECT id FROM content_type WHERE value = :contentType", soci::use(contentType),
-	    soci::into(contentTypeId);
-	if (session->got_data()) return contentTypeId;
+	if (dbSession.executeCached(Statements::getCacheId(Statements::SelectContentTypeId),
+	                            Statements::get(Statements::SelectContentTypeId), soci::use(contentType),
+	                            soci::into(contentTypeId)))
+		return contentTypeId;
 
 	lInfo() << "Insert new content type in database: `" << contentType << "`.";
-	*session << "INSERT INTO content_type (value) VALUES (:contentType)", soci::use(contentType);
+	dbSession.executeCached(Statements::getCacheId(Statements::InsertContentType),
+	                        Statements::get(Statements::InsertContentType, q->getBackend()), soci::use(contentType));
 	return dbSession.getLastInsertId();
 #else
 	return -1;
@@ -564,11 +641,10 @@ void MainDbPrivate::insertChatMessageParticipant(long long chatMessageId,
 	L_Q();
 	if (q->isInitialized()) {
 		auto stateChangeTm = dbSession.getTimeWithSociIndicator(stateChangeTime);
-		*dbSession.getBackendSession()
-		    << "INSERT INTO chat_message_participant (event_id, participant_sip_address_id, state, state_change_time)"
-		       " VALUES (:chatMessageId, :sipAddressId, :state, :stateChangeTm)",
-		    soci::use(chatMessageId), soci::use(sipAddressId), soci::use(state),
-		    soci::use(stateChangeTm.first, stateChangeTm.second);
+		dbSession.executeCached(Statements::getCacheId(Statements::InsertChatMessageParticipant),
+		                        Statements::get(Statements::InsertChatMessageParticipant, q->getBackend()),
+		                        soci::use(chatMessageId), soci::use(sipAddressId), soci::use(state),
+		                        soci::use(stateChangeTm.first, stateChangeTm.second));
 	}
 #endif
 }
@@ -999,12 +1075,17 @@ long long MainDbPrivate::selectSipAddressId(const std::shared_ptr<Address> &addr
 
 long long MainDbPrivate::selectSipAddressId(const string &sipAddress) const {
 #ifdef HAVE_DB_STORAGE
-	long long sipAddressId;
+	const InternedSipAddress *interned = sipAddressCache[sipAddress];
+	if (interned) return interned->storageId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectSipAddressId), soci::use(sipAddress), soci::into(sipAddressId);
+	long long sipAddressId;
+	if (!dbSession.executeCached(Statements::getCacheId(Statements::SelectSipAddressId),
+	                             Statements::get(Statements::SelectSipAddressId), soci::use(sipAddress),
+	                             soci::into(sipAddressId)))
+		return -1;
 
-	return session->got_data() ? sipAddressId : -1;
+	internSipAddress(sipAddress, sipAddressId, nullptr, false);
+	return sipAddressId;
 #else
 	return -1;
 #endif
@@ -1014,10 +1095,11 @@ std::string MainDbPrivate::selectSipAddressFromId(long long sipAddressId) const
 #ifdef HAVE_DB_STORAGE
 	std::string sipAddress;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectSipAddressFromId), soci::use(sipAddressId), soci::into(sipAddress);
-
-	return session->got_data() ? sipAddress : std::string();
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectSipAddressFromId),
+	                               Statements::get(Statements::SelectSipAddressFromId), soci::use(sipAddressId),
+	                               soci::into(sipAddress))
+	           ? sipAddress
+	           : std::string();
 #else
 	return std::string();
 #endif
@@ -1027,11 +1109,11 @@ long long MainDbPrivate::selectChatRoomId(long long peerSipAddressId, long long
 #ifdef HAVE_DB_STORAGE
 	long long chatRoomId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectChatRoomId), soci::use(peerSipAddressId),
-	    soci::use(localSipAddressId), soci::into(chatRoomId);
-
-	return session->got_data() ? chatRoomId : -1;
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectChatRoomId),
+	                               Statements::get(Statements::SelectChatRoomId), soci::use(peerSipAddressId),
+	                               soci::use(localSipAddressId), soci::into(chatRoomId))
+	           ? chatRoomId
+	           : -1;
 #else
 	return -1;
 #endif
@@ -1082,11 +1164,11 @@ long long MainDbPrivate::selectChatRoomParticipantId(long long chatRoomId, long
 #ifdef HAVE_DB_STORAGE
 	long long chatRoomParticipantId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectChatRoomParticipantId), soci::use(chatRoomId),
-	    soci::use(participantSipAddressId), soci::into(chatRoomParticipantId);
-
-	return session->got_data() ? chatRoomParticipantId : -1;
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectChatRoomParticipantId),
+	                               Statements::get(Statements::SelectChatRoomParticipantId), soci::use(chatRoomId),
+	                               soci::use(participantSipAddressId), soci::into(chatRoomParticipantId))
+	           ? chatRoomParticipantId
+	           : -1;
 #else
 	return -1;
 #endif
@@ -1099,12 +1181,12 @@ MainDbPrivate::selectOneToOneChatRoomId(long long sipAddressIdA, long long sipAd
 	const int encryptedCapability = int(ChatRoom::Capabilities::Encrypted);
 	const int expectedCapabilities = encrypted ? encryptedCapability : 0;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectOneToOneChatRoomId), soci::use(sipAddressIdA, "1"),
-	    soci::use(sipAddressIdB, "2"), soci::use(encryptedCapability, "3"), soci::use(expectedCapabilities, "4"),
-	    soci::into(chatRoomId);
-
-	return session->got_data() ? chatRoomId : -1;
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectOneToOneChatRoomId),
+	                               Statements::get(Statements::SelectOneToOneChatRoomId), soci::use(sipAddressIdA, "1"),
+	                               soci::use(sipAddressIdB, "2"), soci::use(encryptedCapability, "3"),
+	                               soci::use(expectedCapabilities, "4"), soci::into(chatRoomId))
+	           ? chatRoomId
+	           : -1;
 #else
 	return -1;
 #endif
@@ -1114,11 +1196,11 @@ long long MainDbPrivate::selectConferenceInfoId(long long uriSipAddressId) {
 #ifdef HAVE_DB_STORAGE
 	long long conferenceInfoId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectConferenceInfoId), soci::use(uriSipAddressId),
-	    soci::into(conferenceInfoId);
-
-	return session->got_data() ? conferenceInfoId : -1;
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectConferenceInfoId),
+	                               Statements::get(Statements::SelectConferenceInfoId), soci::use(uriSipAddressId),
+	                               soci::into(conferenceInfoId))
+	           ? conferenceInfoId
+	           : -1;
 #else
 	return -1;
 #endif
@@ -1129,11 +1211,12 @@ long long MainDbPrivate::selectConferenceInfoParticipantId(long long conferenceI
 #ifdef HAVE_DB_STORAGE
 	long long conferenceInfoParticipantId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectConferenceInfoParticipantId), soci::use(conferenceInfoId),
-	    soci::use(participantSipAddressId), soci::into(conferenceInfoParticipantId);
-
-	return session->got_data() ? conferenceInfoParticipantId : -1;
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectConferenceInfoParticipantId),
+	                               Statements::get(Statements::SelectConferenceInfoParticipantId),
+	                               soci::use(conferenceInfoId), soci::use(participantSipAddressId),
+	                               soci::into(conferenceInfoParticipantId))
+	           ? conferenceInfoParticipantId
+	           : -1;
 #else
 	return -1;
 #endif
@@ -1143,10 +1226,11 @@ long long MainDbPrivate::selectConferenceCallId(const std::string &callId) {
 #ifdef HAVE_DB_STORAGE
 	long long conferenceCallId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectConferenceCall), soci::use(callId), soci::into(conferenceCallId);
-
-	return session->got_data() ? conferenceCallId : -1;
+	return dbSession.executeCached(Statements::getCacheId(Statements::SelectConferenceCall),
+	                               Statements::get(Statements::SelectConferenceCall), soci::use(callId),
+	                               soci::into(conferenceCallId))
+	           ? conferenceCallId
+	           : -1;
 #else
 	return -1;
 #endif
@@ -1154,6 +1238,13 @@ long long MainDbPrivate::selectConferenceCallId(const std::string &callId) {
 
 // -----------------------------------------------------------------------------
 
+void MainDbPrivate::updateChatRoomUnreadMessageCount(BCTBX_UNUSED(long long chatRoomId)) {
+#ifdef HAVE_DB_STORAGE
+	*dbSession.getBackendSession() << RecountUnreadMessageCountQuery << " WHERE id = :chatRoomId",
+	    soci::use(chatRoomId);
+#endif
+}
+
 void MainDbPrivate::deleteContents(long long chatMessageId) {
 #ifdef HAVE_DB_STORAGE
 	*dbSession.getBackendSession() << "DELETE FROM chat_message_content WHERE event_id = :chatMessageId",
@@ -1397,10 +1488,13 @@ shared_ptr<EventLog> MainDbPrivate::selectConferenceSubjectEvent(const Conferenc
 
 long long MainDbPrivate::insertEvent(const shared_ptr<EventLog> &eventLog) {
 #ifdef HAVE_DB_STORAGE
+	L_Q();
+
 	const int &type = int(eventLog->getType());
 	auto creationTime = dbSession.getTimeWithSociIndicator(eventLog->getCreationTime());
-	*dbSession.getBackendSession() << "INSERT INTO event (type, creation_time) VALUES (:type, :creationTime)",
-	    soci::use(type), soci::use(creationTime.first, creationTime.second);
+	dbSession.executeCached(Statements::getCacheId(Statements::InsertEvent),
+	                        Statements::get(Statements::InsertEvent, q->getBackend()), soci::use(type),
+	                        soci::use(creationTime.first, creationTime.second));
 
 	return dbSession.getLastInsertId();
 #else
@@ -1420,12 +1514,14 @@ long long MainDbPrivate::insertConferenceEvent(const shared_ptr<EventLog> &event
 		// Otherwise it's an error.
 		lError() << "Unable to find chat room storage id of: " << conferenceId << ".";
 	} else {
+		L_Q();
+
 		eventId = insertEvent(eventLog);
 
 		soci::session *session = dbSession.getBackendSession();
-		*session << "INSERT INTO conference_event (event_id, chat_room_id)"
-		            " VALUES (:eventId, :chatRoomId)",
-		    soci::use(eventId), soci::use(curChatRoomId);
+		dbSession.executeCached(Statements::getCacheId(Statements::InsertConferenceEvent),
+		                        Statements::get(Statements::InsertConferenceEvent, q->getBackend()), soci::use(eventId),
+		                        soci::use(curChatRoomId));
 
 		if (eventLog->getType() == EventLog::Type::ConferenceTerminated)
 			*session << "UPDATE chat_room SET flags = 1, last_notify_id = 0 WHERE id = :chatRoomId",
@@ -1520,23 +1616,14 @@ long long MainDbPrivate::insertConferenceChatMessageEvent(const shared_ptr<Event
 	}
 	const long long &replyToSipAddressId = sipAddressId;
 
-	*dbSession.getBackendSession()
-	    << "INSERT INTO conference_chat_message_event ("
-	       "  event_id, from_sip_address_id, to_sip_address_id,"
-	       "  time, state, direction, imdn_message_id, is_secured,"
-	       "  delivery_notification_required, display_notification_required,"
-	       "  marked_as_read, forward_info, call_id, reply_message_id, reply_sender_address_id"
-	       ") VALUES ("
-	       "  :eventId, :localSipaddressId, :remoteSipaddressId,"
-	       "  :time, :state, :direction, :imdnMessageId, :isSecured,"
-	       "  :deliveryNotificationRequired, :displayNotificationRequired,"
-	       "  :markedAsRead, :forwardInfo, :callId, :replyMessageId, :replyToSipAddressId"
-	       ")",
-	    soci::use(eventId), soci::use(fromSipAddressId), soci::use(toSipAddressId),
-	    soci::use(messageTime.first, messageTime.second), soci::use(state), soci::use(direction),
-	    soci::use(imdnMessageId), soci::use(isSecured), soci::use(deliveryNotificationRequired),
-	    soci::use(displayNotificationRequired), soci::use(markedAsRead), soci::use(forwardInfo), soci::use(callId),
-	    soci::use(replyMessageId), soci::use(replyToSipAddressId);
+	L_Q();
+	dbSession.executeCached(
+	    Statements::getCacheId(Statements::InsertConferenceChatMessageEvent),
+	    Statements::get(Statements::InsertConferenceChatMessageEvent, q->getBackend()), soci::use(eventId),
+	    soci::use(fromSipAddressId), soci::use(toSipAddressId), soci::use(messageTime.first, messageTime.second),
+	    soci::use(state), soci::use(direction), soci::use(imdnMessageId), soci::use(isSecured),
+	    soci::use(deliveryNotificationRequired), soci::use(displayNotificationRequired), soci::use(markedAsRead),
+	    soci::use(forwardInfo), soci::use(callId), soci::use(replyMessageId), soci::use(replyToSipAddressId));
 
 	if (isEphemeral) {
 		long ephemeralLifetime = chatMessage->getEphemeralLifetime();
@@ -1559,8 +1646,10 @@ long long MainDbPrivate::insertConferenceChatMessageEvent(const shared_ptr<Event
 	}
 
 	const long long &dbChatRoomId = selectChatRoomId(chatRoom->getConferenceId());
-	*dbSession.getBackendSession() << "UPDATE chat_room SET last_message_id = :1 WHERE id = :2", soci::use(eventId),
-	    soci::use(dbChatRoomId);
+	const int unreadMessageCountDelta = markedAsRead ? 0 : 1;
+	dbSession.executeCached(Statements::getCacheId(Statements::UpdateChatRoomLastMessageId),
+	                        Statements::get(Statements::UpdateChatRoomLastMessageId), soci::use(eventId),
+	                        soci::use(unreadMessageCountDelta), soci::use(dbChatRoomId));
 
 	if (direction == int(ChatMessage::Direction::Incoming) && !markedAsRead) {
 		int *count = unreadChatMessageCountCache[chatRoom->getConferenceId()];
@@ -1659,6 +1748,14 @@ void MainDbPrivate::updateConferenceChatMessageEvent(const shared_ptr<EventLog>
 		*session << "UPDATE conference_chat_message_event SET state = :state, imdn_message_id = :imdnMessageId, "
 		            "marked_as_read = :markedAsRead WHERE event_id = :eventId",
 		    soci::use(stateInt), soci::use(imdnMessageId), soci::use(markedAsReadInt), soci::use(eventId);
+
+		if (markedAsRead != dbMarkedAsRead) {
+			const long long &dbChatRoomId = selectChatRoomId(chatRoom->getConferenceId());
+			const int unreadMessageCountDelta = markedAsRead ? -1 : 1;
+			dbSession.executeCached(Statements::getCacheId(Statements::UpdateChatRoomUnreadMessageCount),
+			                        Statements::get(Statements::UpdateChatRoomUnreadMessageCount),
+			                        soci::use(unreadMessageCountDelta), soci::use(dbChatRoomId));
+		}
 	}
 
 	// 4. Update contents.
@@ -1939,14 +2036,14 @@ void MainDbPrivate::setChatMessageParticipantState(const shared_ptr<EventLog> &e
 	const long long &eventId = dEventKey->storageId;
 	auto participantAddressWithoutGruu = Address::create(participantAddress->getUriWithoutGruu());
 	long long participantSipAddressId = selectSipAddressId(participantAddressWithoutGruu);
-	long long nbEntries;
-	*dbSession.getBackendSession() << "SELECT count(*) FROM chat_message_participant WHERE event_id = :eventId AND "
-	                                  "participant_sip_address_id = :participantSipAddressId",
-	    soci::into(nbEntries), soci::use(eventId), soci::use(participantSipAddressId);
+	int intState;
+	bool found = dbSession.executeCached(Statements::getCacheId(Statements::SelectChatMessageParticipantState),
+	                                     Statements::get(Statements::SelectChatMessageParticipantState),
+	                                     soci::use(eventId), soci::use(participantSipAddressId), soci::into(intState));
 
 	int stateInt = int(state);
 
-	if (nbEntries == 0) {
+	if (!found) {
 		if (participantSipAddressId <= 0) {
 			// If the address is not found in the DB, add it
 			participantSipAddressId = insertSipAddress(participantAddressWithoutGruu);
@@ -1957,10 +2054,6 @@ void MainDbPrivate::setChatMessageParticipantState(const shared_ptr<EventLog> &e
 		/* setChatMessageParticipantState can be called by updateConferenceChatMessageEvent, which try to update
 		 participant state by message state. However, we can not change state Displayed/DeliveredToUser to
 		 Delivered/NotDelivered. */
-		int intState;
-		*dbSession.getBackendSession() << "SELECT state FROM chat_message_participant WHERE event_id = :eventId AND "
-		                                  "participant_sip_address_id = :participantSipAddressId",
-		    soci::into(intState), soci::use(eventId), soci::use(participantSipAddressId);
 		ChatMessage::State dbState = ChatMessage::State(intState);
 
 		if (int(state) < intState &&
@@ -1970,12 +2063,10 @@ void MainDbPrivate::setChatMessageParticipantState(const shared_ptr<EventLog> &e
 		}
 
 		auto stateChangeTm = dbSession.getTimeWithSociIndicator(stateChangeTime);
-		*dbSession.getBackendSession()
-		    << "UPDATE chat_message_participant SET state = :state,"
-		       " state_change_time = :stateChangeTm"
-		       " WHERE event_id = :eventId AND participant_sip_address_id = :participantSipAddressId",
-		    soci::use(stateInt), soci::use(stateChangeTm.first, stateChangeTm.second), soci::use(eventId),
-		    soci::use(participantSipAddressId);
+		dbSession.executeCached(Statements::getCacheId(Statements::UpdateChatMessageParticipantState),
+		                        Statements::get(Statements::UpdateChatMessageParticipantState), soci::use(stateInt),
+		                        soci::use(stateChangeTm.first, stateChangeTm.second), soci::use(eventId),
+		                        soci::use(participantSipAddressId));
 	}
 #endif
 }
@@ -2424,6 +2515,257 @@ void MainDbPrivate::invalidConferenceEventsFromQuery(const string &query, long l
 #endif
 }
 
+// -----------------------------------------------------------------------------
+// Sip addresses interning.
+// -----------------------------------------------------------------------------
+
+void MainDbPrivate::internSipAddress(const string &sipAddress,
+                                     long long storageId,
+                                     const string *displayName,
+                                     bool written) const {
+	InternedSipAddress interned;
+	const InternedSipAddress *previous = sipAddressCache[sipAddress];
+	if (previous) interned = *previous;
+
+	interned.storageId = storageId;
+	if (displayName) {
+		interned.displayName = *displayName;
+		interned.displayNameKnown = true;
+	}
+	sipAddressCache.insert(sipAddress, std::move(interned));
+	// A selected row was committed by someone else, it survives a rollback.
+	if (written) uncommittedSipAddresses.push_back(sipAddress);
+}
+
+long long MainDbPrivate::getInternedSipAddressId(const string &sipAddress) const {
+	const InternedSipAddress *interned = sipAddressCache[sipAddress];
+	return interned ? interned->storageId : -1;
+}
+
+void MainDbPrivate::commitInternedSipAddresses() const {
+	uncommittedSipAddresses.clear();
+}
+
+void MainDbPrivate::rollbackInternedSipAddresses(size_t uncommittedCount) const {
+	// Only the addresses written since the start of the rolled back transaction (or savepoint) are undone.
+	if (uncommittedCount >= uncommittedSipAddresses.size()) return;
+	for (auto it = uncommittedSipAddresses.cbegin() + ptrdiff_t(uncommittedCount); it != uncommittedSipAddresses.cend();
+	     ++it)
+		sipAddressCache.erase(*it);
+	uncommittedSipAddresses.resize(uncommittedCount);
+}
+
+// -----------------------------------------------------------------------------
+// Write-behind API.
+// -----------------------------------------------------------------------------
+
+void MainDbPrivate::openWriteBehindBatch() {
+#ifdef HAVE_DB_STORAGE
+	if (!writeBehind.enabled) return;
+
+	if (!writeBehind.transactionOpen) {
+		try {
+			dbSession.getBackendSession()->begin();
+			writeBehind.transactionOpen = true;
+		} catch (const exception &e) {
+			lError() << "Unable to open write-behind batch: " << e.what();
+			return;
+		}
+	}
+	writeBehind.operationStarting = true;
+#endif
+}
+
+void MainDbPrivate::queueWriteBehindOperation(bool success,
+                                              const shared_ptr<EventLog> &insertedEvent,
+                                              const MainDb::WriteCompletionCb &onCompleted) {
+#ifdef HAVE_DB_STORAGE
+	writeBehind.operationStarting = false;
+	if (!writeBehind.transactionOpen || !success) {
+		if (onCompleted) onCompleted(success);
+		return;
+	}
+
+	if (insertedEvent) writeBehind.insertedEvents.push_back(insertedEvent);
+	if (onCompleted) writeBehind.completionCbs.push_back(onCompleted);
+
+	if (++writeBehind.pendingOperations >= writeBehind.maxPendingOperations) flushWriteBehindBatch();
+#endif
+}
+
+void MainDbPrivate::flushWriteBehindBatch() {
+#ifdef HAVE_DB_STORAGE
+	writeBehind.flushRequested = false;
+	if (!writeBehind.transactionOpen) return;
+
+	lDebug() << "Commit write-behind batch of " << writeBehind.pendingOperations << " operation(s).";
+	try {
+		dbSession.getBackendSession()->commit();
+	} catch (const exception &e) {
+		lError() << "Unable to commit write-behind batch: " << e.what();
+		abortWriteBehindBatch();
+		return;
+	}
+
+	writeBehind.transactionOpen = false;
+	commitInternedSipAddresses();
+	writeBehind.pendingOperations = 0;
+	writeBehind.insertedEvents.clear();
+	list<MainDb::WriteCompletionCb> completionCbs;
+	completionCbs.swap(writeBehind.completionCbs);
+	for (const auto &cb : completionCbs)
+		cb(true);
+#endif
+}
+
+void MainDbPrivate::abortWriteBehindBatch() {
+#ifdef HAVE_DB_STORAGE
+	if (!writeBehind.transactionOpen) return;
+
+	// The other writes commit the batch with them, only batched operations are lost here.
+	lWarning() << "Aborting write-behind batch of " << writeBehind.pendingOperations << " operation(s).";
+	writeBehind.transactionOpen = false;
+	writeBehind.operationStarting = false;
+	writeBehind.flushRequested = false;
+	try {
+		dbSession.getBackendSession()->rollback();
+	} catch (const exception &e) {
+		lError() << "Error during rollback of write-behind batch: " << e.what();
+	}
+
+	// The rows of the inserted events do not exist anymore.
+	for (const auto &weakEvent : writeBehind.insertedEvents) {
+		shared_ptr<EventLog> eventLog = weakEvent.lock();
+		if (!eventLog || !eventLog->getPrivate()->dbKey.isValid()) continue;
+
+		long long storageId = static_cast<MainDbKey &>(eventLog->getPrivate()->dbKey).getPrivate()->storageId;
+		storageIdToEvent.erase(storageId);
+		if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
+			storageIdToChatMessage.erase(storageId);
+			static_pointer_cast<ConferenceChatMessageEvent>(eventLog)->getChatMessage()->getPrivate()->resetStorageId();
+		}
+		eventLog->getPrivate()->resetStorageId();
+	}
+	unreadChatMessageCountCache.clear();
+	rollbackInternedSipAddresses();
+
+	list<MainDb::WriteCompletionCb> completionCbs;
+	completionCbs.swap(writeBehind.completionCbs);
+	writeBehind.insertedEvents.clear();
+	writeBehind.pendingOperations = 0;
+	for (const auto &cb : completionCbs)
+		cb(false);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Asynchronous reads.
+// -----------------------------------------------------------------------------
+
+MainDbPrivate::~MainDbPrivate() {
+#ifdef HAVE_DB_STORAGE
+	stopAsyncReader();
+#endif
+}
+
+#ifdef HAVE_DB_STORAGE
+static void runAsyncReader(MainDbPrivate::AsyncReader *asyncReader) {
+	for (;;) {
+		function<void(soci::session &)> task;
+		{
+			unique_lock<mutex> lock(asyncReader->mutex);
+			asyncReader->condition.wait(lock,
+			                            [asyncReader] { return asyncReader->stopping || !asyncReader->tasks.empty(); });
+			if (asyncReader->stopping) return;
+			task = std::move(asyncReader->tasks.front());
+			asyncReader->tasks.pop_front();
+		}
+		task(*asyncReader->session);
+	}
+}
+
+void MainDbPrivate::readAsync(const RowsReader &reader, const RowsHandler &handler) {
+	L_Q();
+
+	// The read-only sessions only see the committed writes.
+	q->flushPendingWrites();
+
+	if (!asyncReader) asyncReader = make_shared<AsyncReader>();
+	if (!asyncReader->session) asyncReader->session = q->acquireReadSession();
+
+	// The handler stays on the core thread, the worker thread only gets the reader and the rows.
+	const unsigned long long requestId = ++asyncReader->lastRequestId;
+	asyncReader->handlers[requestId] = handler;
+	auto rows = make_shared<Rows>();
+	weak_ptr<AsyncReader> weakAsyncReader(asyncReader);
+	auto complete = [this, weakAsyncReader, requestId, rows]() {
+		shared_ptr<AsyncReader> currentAsyncReader = weakAsyncReader.lock();
+		if (!currentAsyncReader) return;
+		auto it = currentAsyncReader->handlers.find(requestId);
+		if (it == currentAsyncReader->handlers.end()) return;
+		RowsHandler pendingHandler = std::move(it->second);
+		currentAsyncReader->handlers.erase(it);
+		if (!dbSession) return;
+		try {
+			pendingHandler(*rows);
+		} catch (const exception &e) {
+			lError() << "Unable to handle the result of an asynchronous read: " << e.what();
+		}
+	};
+
+	// The worker is stopped before the core, it does not need to hold a reference on it.
+	Core *core = q->getCore().get();
+	if (!asyncReader->session) {
+		// No write-ahead log or no read-only session left: the query is delayed but runs on the core thread.
+		core->doLater([this, weakAsyncReader, rows, reader, complete]() {
+			if (weakAsyncReader.expired() || !dbSession) return;
+			try {
+				reader(*dbSession.getBackendSession(), *rows);
+			} catch (const exception &e) {
+				lError() << "Asynchronous read failed: " << e.what();
+				rows->clear();
+			}
+			complete();
+		});
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(asyncReader->mutex);
+		asyncReader->tasks.push_back([core, rows, reader, complete](soci::session &session) {
+			try {
+				reader(session, *rows);
+			} catch (const exception &e) {
+				lError() << "Asynchronous read failed: " << e.what();
+				rows->clear();
+			}
+			core->doLater(complete);
+		});
+	}
+	if (!asyncReader->thread.joinable()) asyncReader->thread = thread(runAsyncReader, asyncReader.get());
+	else asyncReader->condition.notify_one();
+}
+
+void MainDbPrivate::stopAsyncReader() {
+	if (!asyncReader) return;
+
+	{
+		lock_guard<mutex> lock(asyncReader->mutex);
+		asyncReader->stopping = true;
+		asyncReader->tasks.clear();
+	}
+	asyncReader->condition.notify_one();
+	if (asyncReader->thread.joinable()) asyncReader->thread.join();
+	asyncReader->handlers.clear();
+	asyncReader = nullptr;
+}
+
+void MainDbPrivate::appendRows(soci::rowset<soci::row> &rowset, Rows &rows) {
+	for (const auto &row : rowset)
+		rows.push_back(copyRow(row));
+}
+#endif
+
 // -----------------------------------------------------------------------------
 // Versions.
 // -----------------------------------------------------------------------------
@@ -2915,6 +3257,26 @@ void MainDbPrivate::updateSchema() {
 		}
 	}
 
+	if (eventsDbVersion < makeVersion(1, 0, 32)) {
+		// Unread chat messages are counted once here, then the counter is maintained by the insert, update, delete
+		// and mark as read paths.
+		*session << "ALTER TABLE chat_room ADD COLUMN unread_message_count INT NOT NULL DEFAULT 0";
+		*session << RecountUnreadMessageCountQuery;
+	}
+
+	if (eventsDbVersion < makeVersion(1, 0, 33)) {
+		// Lookups by call id, conference start time and uri, call log addresses and chat message contents.
+		// The call id of the chat messages is a VARCHAR(255): only its first 191 characters are indexed on mysql.
+		*session << "CREATE INDEX chat_message_call_id_index ON conference_chat_message_event (" +
+		                string(backend == MainDb::Backend::Mysql ? "call_id(191)" : "call_id") + ")";
+		*session << "CREATE INDEX chat_message_content_event_index ON chat_message_content (event_id)";
+		*session << "CREATE INDEX conference_info_start_time_index ON conference_info (start_time)";
+		*session << "CREATE INDEX conference_info_uri_index ON conference_info (uri_sip_address_id)";
+		*session << "CREATE INDEX conference_call_from_index ON conference_call (from_sip_address_id, direction)";
+		*session << "CREATE INDEX conference_call_to_index ON conference_call (to_sip_address_id, direction)";
+		*session << "CREATE INDEX conference_call_call_id_index ON conference_call (call_id)";
+	}
+
 	// /!\ Warning : if varchar columns < 255 were to be indexed, their size must be set back to 191 = max indexable
 	// (KEY or UNIQUE) varchar size for mysql < 5.7 with charset utf8mb4 (both here and in column creation)
 
@@ -3324,6 +3686,19 @@ void MainDb::init() {
 
 	initCleanup();
 
+	// The journal mode cannot be changed within a transaction. Once the database uses a write-ahead log, the reads of
+	// the read-only sessions no longer wait for the writes of the main one.
+	// The wal-index is only shared within a process, so the database of a shared core keeps the rollback journal.
+	if (backend == Sqlite3) {
+		LinphoneConfig *config = linphone_core_get_config(getCore()->getCCore());
+		const bool sharedCore = !string(linphone_config_get_string(config, "shared_core", "app_group_id", "")).empty();
+		const bool walEnabled = !sharedCore && linphone_config_get_bool(config, "storage", "wal_enabled", FALSE);
+		if (d->dbSession.enableWriteAheadLog(walEnabled)) {
+			int readSessions = linphone_config_get_int(config, "storage", "read_sessions", 2);
+			d->dbSession.setReadSessionPoolSize(static_cast<size_t>(max(readSessions, 0)));
+		}
+	}
+
 	session->begin();
 
 	try {
@@ -4111,21 +4486,23 @@ void MainDb::initCleanup() {
 #endif
 }
 
-bool MainDb::addEvent(const shared_ptr<EventLog> &eventLog) {
+bool MainDb::addEvent(const shared_ptr<EventLog> &eventLog, const WriteCompletionCb &onCompleted) {
 #ifdef HAVE_DB_STORAGE
 	if (!isInitialized()) {
 		lWarning() << "Database has not been initialized";
+		if (onCompleted) onCompleted(false);
 		return false;
 	}
 
 	if (eventLog->getPrivate()->dbKey.isValid()) {
 		lWarning() << "Unable to add an event twice!!!";
+		if (onCompleted) onCompleted(false);
 		return false;
 	}
 
-	return L_DB_TRANSACTION {
-		L_D();
-
+	L_D();
+	d->openWriteBehindBatch();
+	bool result = L_DB_TRANSACTION {
 		long long eventId = -1;
 
 		EventLog::Type type = eventLog->getType();
@@ -4204,21 +4581,25 @@ bool MainDb::addEvent(const shared_ptr<EventLog> &eventLog) {
 		lError() << "MainDb::addEvent() of type " << type << " failed.";
 		return false;
 	};
+	d->queueWriteBehindOperation(result, eventLog, onCompleted);
+	return result;
 #else
+	if (onCompleted) onCompleted(false);
 	return false;
 #endif
 }
 
-bool MainDb::updateEvent(const shared_ptr<EventLog> &eventLog) {
+bool MainDb::updateEvent(const shared_ptr<EventLog> &eventLog, const WriteCompletionCb &onCompleted) {
 #ifdef HAVE_DB_STORAGE
 	if (!eventLog->getPrivate()->dbKey.isValid()) {
 		lWarning() << "Unable to update an event that wasn't inserted yet!!!";
+		if (onCompleted) onCompleted(false);
 		return false;
 	}
 
-	return L_DB_TRANSACTION {
-		L_D();
-
+	L_D();
+	d->openWriteBehindBatch();
+	bool result = L_DB_TRANSACTION {
 		switch (eventLog->getType()) {
 			case EventLog::Type::None:
 				return false;
@@ -4260,7 +4641,10 @@ bool MainDb::updateEvent(const shared_ptr<EventLog> &eventLog) {
 
 		return true;
 	};
+	d->queueWriteBehindOperation(result, nullptr, onCompleted);
+	return result;
 #else
+	if (onCompleted) onCompleted(false);
 	return false;
 #endif
 }
@@ -4277,40 +4661,73 @@ bool MainDb::deleteEvent(const shared_ptr<const EventLog> &eventLog) {
 	shared_ptr<Core> core = dEventKey->core.lock();
 	L_ASSERT(core);
 
-	MainDb &mainDb = *core->getPrivate()->mainDb.get();
+	return core->getPrivate()->mainDb->deleteEvents({eventLog});
+#else
+	return false;
+#endif
+}
 
-	return L_DB_TRANSACTION_C(&mainDb) {
-		MainDbPrivate *const d = mainDb.getPrivate();
+bool MainDb::deleteEvents(const list<shared_ptr<const EventLog>> &eventLogs) {
+#ifdef HAVE_DB_STORAGE
+	return L_DB_TRANSACTION {
+		L_D();
 		soci::session *session = d->dbSession.getBackendSession();
-		*session << "DELETE FROM event WHERE id = :id", soci::use(dEventKey->storageId);
 
-		if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
-			shared_ptr<ChatMessage> chatMessage(
-			    static_pointer_cast<const ConferenceChatMessageEvent>(eventLog)->getChatMessage());
-			shared_ptr<AbstractChatRoom> chatRoom(chatMessage->getChatRoom());
-			const long long &dbChatRoomId = d->selectChatRoomId(chatRoom->getConferenceId());
+		long long storageId;
+		soci::statement updateUnreadCount =
+		    (session->prepare << "UPDATE chat_room SET unread_message_count = unread_message_count - 1"
+		                         " WHERE id = (SELECT chat_room_id FROM conference_event WHERE event_id = :1)"
+		                         " AND EXISTS ("
+		                         "  SELECT 1 FROM conference_chat_message_event WHERE event_id = :2 AND marked_as_read = 0"
+		                         ")",
+		     soci::use(storageId), soci::use(storageId));
+		soci::statement deleteEvent = (session->prepare << "DELETE FROM event WHERE id = :id", soci::use(storageId));
+
+		list<shared_ptr<const EventLog>> deletedEventLogs;
+		unordered_set<long long> dbChatRoomIds;
+		for (const auto &eventLog : eventLogs) {
+			const EventLogPrivate *dEventLog = eventLog->getPrivate();
+			if (!dEventLog->dbKey.isValid()) {
+				lWarning() << "Unable to delete invalid event.";
+				continue;
+			}
+			storageId = static_cast<MainDbKey &>(dEventLog->dbKey).getPrivate()->storageId;
+			updateUnreadCount.execute(true);
+			deleteEvent.execute(true);
+
+			if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
+				shared_ptr<ChatMessage> chatMessage(
+				    static_pointer_cast<const ConferenceChatMessageEvent>(eventLog)->getChatMessage());
+				dbChatRoomIds.insert(d->selectChatRoomId(chatMessage->getChatRoom()->getConferenceId()));
+				// Delete chat message from cache as the event is deleted
+				chatMessage->getPrivate()->resetStorageId();
+			}
+			deletedEventLogs.push_back(eventLog);
+		}
+
+		// The last message of each chat room is updated once for all its deleted events.
+		for (const long long &dbChatRoomId : dbChatRoomIds) {
 			*session << "UPDATE chat_room SET last_message_id = IFNULL((SELECT id FROM conference_event_simple_view "
 			            "WHERE chat_room_id = chat_room.id AND type = "
 			         << mapEventFilterToSql(ConferenceChatMessageFilter)
 			         << " ORDER BY id DESC LIMIT 1), 0) WHERE id = :1",
 			    soci::use(dbChatRoomId);
-			// Delete chat message from cache as the event is deleted
-			ChatMessagePrivate *dChatMessage = chatMessage->getPrivate();
-			dChatMessage->resetStorageId();
 		}
 
 		tr.commit();
 
-		// Reset storage ID as event is not valid anymore
-		const_cast<EventLogPrivate *>(dEventLog)->resetStorageId();
-
-		if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
-			shared_ptr<ChatMessage> chatMessage(
-			    static_pointer_cast<const ConferenceChatMessageEvent>(eventLog)->getChatMessage());
-			if (chatMessage->getDirection() == ChatMessage::Direction::Incoming &&
-			    !chatMessage->getPrivate()->isMarkedAsRead()) {
-				int *count = d->unreadChatMessageCountCache[chatMessage->getChatRoom()->getConferenceId()];
-				if (count) --*count;
+		for (const auto &eventLog : deletedEventLogs) {
+			// Reset storage ID as event is not valid anymore
+			const_cast<EventLogPrivate *>(eventLog->getPrivate())->resetStorageId();
+
+			if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
+				shared_ptr<ChatMessage> chatMessage(
+				    static_pointer_cast<const ConferenceChatMessageEvent>(eventLog)->getChatMessage());
+				if (chatMessage->getDirection() == ChatMessage::Direction::Incoming &&
+				    !chatMessage->getPrivate()->isMarkedAsRead()) {
+					int *count = d->unreadChatMessageCountCache[chatMessage->getChatRoom()->getConferenceId()];
+					if (count) --*count;
+				}
 			}
 		}
 
@@ -4462,13 +4879,8 @@ int MainDb::getUnreadChatMessageCount(const ConferenceId &conferenceId) const {
 		if (count) return *count;
 	}
 
-	string query = "SELECT COUNT(*) FROM conference_chat_message_event WHERE";
-	if (conferenceId.isValid())
-		query += " event_id IN ("
-		         "  SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId"
-		         ") AND";
-
-	query += " marked_as_read = 0 ";
+	string query = "SELECT COALESCE(SUM(unread_message_count), 0) FROM chat_room";
+	if (conferenceId.isValid()) query += " WHERE id = :chatRoomId";
 
 	/*
 	DurationLogger durationLogger(
@@ -4519,6 +4931,8 @@ void MainDb::markChatMessagesAsRead(const ConferenceId &conferenceId) const {
 
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
 		*d->dbSession.getBackendSession() << query, soci::use(dbChatRoomId);
+		*d->dbSession.getBackendSession() << "UPDATE chat_room SET unread_message_count = 0 WHERE id = :chatRoomId",
+		    soci::use(dbChatRoomId);
 
 		tr.commit();
 		d->unreadChatMessageCountCache.insert(conferenceId, 0);
@@ -4607,7 +5021,7 @@ list<shared_ptr<ChatMessage>> MainDb::getUnreadChatMessages(const ConferenceId &
 #endif
 }
 
-list<shared_ptr<ChatMessage>> MainDb::getEphemeralMessages() const {
+list<shared_ptr<ChatMessage>> MainDb::getEphemeralMessages(bool *truncated) const {
 #ifdef HAVE_DB_STORAGE
 	// Keep chat_room_id at the end of the query !!!
 	string query =
@@ -4633,6 +5047,7 @@ list<shared_ptr<ChatMessage>> MainDb::getEphemeralMessages() const {
 	return L_DB_TRANSACTION {
 		L_D();
 		list<shared_ptr<ChatMessage>> chatMessages;
+		size_t rowCount = 0;
 		auto epoch = d->dbSession.getTimeWithSociIndicator(0);
 		soci::rowset<soci::row> rows =
 		    getBackend() == MainDb::Backend::Sqlite3
@@ -4640,6 +5055,7 @@ list<shared_ptr<ChatMessage>> MainDb::getEphemeralMessages() const {
 		           soci::use(EPHEMERAL_MESSAGE_TASKS_MAX_NB))
 		        : (d->dbSession.getBackendSession()->prepare << query, soci::use(epoch.first));
 		for (const auto &row : rows) {
+			rowCount++;
 			const long long &dbChatRoomId = d->dbSession.resolveId(row, (int)row.size() - 1);
 			ConferenceId conferenceId = d->getConferenceIdFromCache(dbChatRoomId);
 			if (!conferenceId.isValid()) {
@@ -4658,9 +5074,12 @@ list<shared_ptr<ChatMessage>> MainDb::getEphemeralMessages() const {
 				}
 			}
 		}
+		if (truncated)
+			*truncated = getBackend() == MainDb::Backend::Sqlite3 && rowCount >= EPHEMERAL_MESSAGE_TASKS_MAX_NB;
 		return chatMessages;
 	};
 #else
+	if (truncated) *truncated = false;
 	return list<shared_ptr<ChatMessage>>();
 #endif
 }
@@ -4748,50 +5167,61 @@ ChatMessage::State MainDb::getChatMessageParticipantState(const shared_ptr<Event
 void MainDb::setChatMessageParticipantState(const shared_ptr<EventLog> &eventLog,
                                             const std::shared_ptr<Address> &participantAddress,
                                             ChatMessage::State state,
-                                            time_t stateChangeTime) {
+                                            time_t stateChangeTime,
+                                            const WriteCompletionCb &onCompleted) {
 #ifdef HAVE_DB_STORAGE
-	L_DB_TRANSACTION {
-		L_D();
+	L_D();
+	d->openWriteBehindBatch();
+	bool result = L_DB_TRANSACTION {
 		d->setChatMessageParticipantState(eventLog, participantAddress, state, stateChangeTime);
 		tr.commit();
 	};
+	d->queueWriteBehindOperation(result, nullptr, onCompleted);
+#else
+	if (onCompleted) onCompleted(false);
 #endif
 }
 
+#ifdef HAVE_DB_STORAGE
+static const char *const MediaContentsQuery =
+    "SELECT name, path, size, content_type.value, conference_chat_message_event.time "
+    " FROM chat_message_file_content "
+    " JOIN chat_message_content ON chat_message_content.id = chat_message_file_content.chat_message_content_id "
+    " JOIN content_type ON content_type.id = chat_message_content.content_type_id "
+    " JOIN conference_chat_message_event ON conference_chat_message_event.event_id = chat_message_content.event_id "
+    " JOIN conference_event ON conference_event.event_id = chat_message_content.event_id AND "
+    " conference_event.chat_room_id = :chatRoomId "
+    " WHERE content_type.value LIKE 'video/%' OR content_type.value LIKE 'image/%' OR content_type.value LIKE "
+    "'audio/%' "
+    " ORDER BY chat_message_content.event_id DESC";
+
+static shared_ptr<Content> selectMediaContent(const DbSession &dbSession, const soci::row &row) {
+	string name = row.get<string>(0);
+	string path = row.get<string>(1);
+	int size = row.get<int>(2);
+	ContentType contentType(row.get<string>(3));
+	time_t creation = dbSession.getTime(row, 4);
+
+	auto fileContent = FileContent::create<FileContent>();
+	fileContent->setFileName(name);
+	fileContent->setFileSize(size_t(size));
+	fileContent->setFilePath(path);
+	fileContent->setContentType(contentType);
+	fileContent->setCreationTimestamp(creation);
+	return fileContent;
+}
+#endif
+
 list<shared_ptr<Content>> MainDb::getMediaContents(const ConferenceId &conferenceId) const {
 	list<shared_ptr<Content>> result = list<shared_ptr<Content>>();
 #ifdef HAVE_DB_STORAGE
-	static const string query =
-	    "SELECT name, path, size, content_type.value, conference_chat_message_event.time "
-	    " FROM chat_message_file_content "
-	    " JOIN chat_message_content ON chat_message_content.id = chat_message_file_content.chat_message_content_id "
-	    " JOIN content_type ON content_type.id = chat_message_content.content_type_id "
-	    " JOIN conference_chat_message_event ON conference_chat_message_event.event_id = chat_message_content.event_id "
-	    " JOIN conference_event ON conference_event.event_id = chat_message_content.event_id AND "
-	    " conference_event.chat_room_id = :chatRoomId "
-	    " WHERE content_type.value LIKE 'video/%' OR content_type.value LIKE 'image/%' OR content_type.value LIKE "
-	    "'audio/%' "
-	    " ORDER BY chat_message_content.event_id DESC";
 	return L_DB_TRANSACTION {
 		L_D();
 		const long long &chatRoomId = d->selectChatRoomId(conferenceId);
-		soci::rowset<soci::row> rows = (d->dbSession.getBackendSession()->prepare << query, soci::use(chatRoomId));
-		for (const auto &row : rows) {
-			string name = row.get<string>(0);
-			string path = row.get<string>(1);
-			int size = row.get<int>(2);
-			ContentType contentType(row.get<string>(3));
-			time_t creation = d->dbSession.getTime(row, 4);
-
-			auto fileContent = FileContent::create<FileContent>();
-			fileContent->setFileName(name);
-			fileContent->setFileSize(size_t(size));
-			fileContent->setFilePath(path);
-			fileContent->setContentType(contentType);
-			fileContent->setCreationTimestamp(creation);
-
-			result.push_back(fileContent);
-		}
+		soci::rowset<soci::row> rows =
+		    (d->dbSession.getBackendSession()->prepare << MediaContentsQuery, soci::use(chatRoomId));
+		for (const auto &row : rows)
+			result.push_back(selectMediaContent(d->dbSession, row));
 		return result;
 	};
 #else
@@ -4799,6 +5229,29 @@ list<shared_ptr<Content>> MainDb::getMediaContents(const ConferenceId &conferenc
 #endif
 }
 
+void MainDb::getMediaContentsAsync(const ConferenceId &conferenceId, const AsyncResultCb<Content> &onResult) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	const long long chatRoomId = L_DB_TRANSACTION {
+		return d->selectChatRoomId(conferenceId);
+	};
+	d->readAsync(
+	    [chatRoomId](soci::session &session, MainDbPrivate::Rows &rows) {
+		    soci::rowset<soci::row> rowset = (session.prepare << MediaContentsQuery, soci::use(chatRoomId));
+		    MainDbPrivate::appendRows(rowset, rows);
+	    },
+	    [d, onResult](const MainDbPrivate::Rows &rows) {
+		    list<shared_ptr<Content>> result;
+		    for (const auto &row : rows)
+			    result.push_back(selectMediaContent(d->dbSession, *row));
+		    onResult(result);
+	    });
+#else
+	getCore()->doLater([onResult]() { onResult(list<shared_ptr<Content>>()); });
+#endif
+}
+
 list<shared_ptr<Content>> MainDb::getDocumentContents(const ConferenceId &conferenceId) const {
 	list<shared_ptr<Content>> result = list<shared_ptr<Content>>();
 #ifdef HAVE_DB_STORAGE
@@ -4905,7 +5358,6 @@ shared_ptr<ChatMessage> MainDb::getLastChatMessage(const ConferenceId &conferenc
 list<shared_ptr<ChatMessage>> MainDb::findChatMessages(const ConferenceId &conferenceId,
                                                        const string &imdnMessageId) const {
 #ifdef HAVE_DB_STORAGE
-	// TODO: Optimize.
 	static const string query =
 	    Statements::get(Statements::SelectConferenceEvents) + string(" AND imdn_message_id = :imdnMessageId");
 
@@ -4923,15 +5375,16 @@ list<shared_ptr<ChatMessage>> MainDb::findChatMessages(const ConferenceId &confe
 		if (!chatRoom) return chatMessages;
 
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
-		soci::rowset<soci::row> rows =
-		    (d->dbSession.getBackendSession()->prepare << query, soci::use(dbChatRoomId), soci::use(imdnMessageId));
-		for (const auto &row : rows) {
-			shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
-			if (event) {
-				L_ASSERT(event->getType() == EventLog::Type::ConferenceChatMessage);
-				chatMessages.push_back(static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage());
-			}
-		}
+		d->dbSession.forEachCached(
+		    Statements::getCacheId(Statements::QueryChatMessagesByImdnMessageId), query,
+		    [&](const soci::row &row) {
+			    shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
+			    if (event) {
+				    L_ASSERT(event->getType() == EventLog::Type::ConferenceChatMessage);
+				    chatMessages.push_back(static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage());
+			    }
+		    },
+		    soci::use(dbChatRoomId), soci::use(imdnMessageId));
 
 		return chatMessages;
 	};
@@ -4940,6 +5393,55 @@ list<shared_ptr<ChatMessage>> MainDb::findChatMessages(const ConferenceId &confe
 #endif
 }
 
+void MainDb::findChatMessagesAsync(const ConferenceId &conferenceId,
+                                   const string &imdnMessageId,
+                                   const AsyncResultCb<ChatMessage> &onResult) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	static const string query =
+	    Statements::get(Statements::SelectConferenceEvents) + string(" AND imdn_message_id = :imdnMessageId");
+
+	const long long dbChatRoomId = L_DB_TRANSACTION {
+		return d->findChatRoom(conferenceId) ? d->selectChatRoomId(conferenceId) : -1;
+	};
+	if (dbChatRoomId < 0) {
+		getCore()->doLater([onResult]() { onResult(list<shared_ptr<ChatMessage>>()); });
+		return;
+	}
+
+	d->readAsync(
+	    [dbChatRoomId, imdnMessageId](soci::session &session, MainDbPrivate::Rows &rows) {
+		    soci::rowset<soci::row> rowset =
+		        (session.prepare << query, soci::use(dbChatRoomId), soci::use(imdnMessageId));
+		    MainDbPrivate::appendRows(rowset, rows);
+	    },
+	    [this, conferenceId, onResult](const MainDbPrivate::Rows &rows) {
+		    list<shared_ptr<ChatMessage>> chatMessages = L_DB_TRANSACTION {
+			    L_D();
+
+			    list<shared_ptr<ChatMessage>> chatMessages;
+			    shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
+			    if (!chatRoom) return chatMessages;
+
+			    for (const auto &row : rows) {
+				    shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, *row);
+				    if (event) {
+					    L_ASSERT(event->getType() == EventLog::Type::ConferenceChatMessage);
+					    chatMessages.push_back(
+					        static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage());
+				    }
+			    }
+			    tr.commit();
+			    return chatMessages;
+		    };
+		    onResult(chatMessages);
+	    });
+#else
+	getCore()->doLater([onResult]() { onResult(list<shared_ptr<ChatMessage>>()); });
+#endif
+}
+
 list<shared_ptr<ChatMessage>> MainDb::findChatMessages(const ConferenceId &conferenceId,
                                                        const list<string> &imdnMessageIds) const {
 #ifdef HAVE_DB_STORAGE
@@ -5105,6 +5607,18 @@ list<shared_ptr<ChatMessage>> MainDb::findChatMessagesToBeNotifiedAsDelivered()
 #endif
 }
 
+#ifdef HAVE_DB_STORAGE
+// The query only depends on the mask, limit and offset are bound so that the statement can be cached.
+static string buildHistoryRangeQuery(MainDb::FilterMask mask) {
+	return Statements::get(Statements::SelectConferenceEvents) +
+	       buildSqlEventFilter({MainDb::ConferenceCallFilter, MainDb::ConferenceChatMessageFilter,
+	                            MainDb::ConferenceInfoFilter, MainDb::ConferenceInfoNoDeviceFilter,
+	                            MainDb::ConferenceChatMessageSecurityFilter},
+	                           mask, "AND") +
+	       " ORDER BY event_id DESC LIMIT :limit OFFSET :offset";
+}
+#endif
+
 list<shared_ptr<EventLog>> MainDb::getHistory(const ConferenceId &conferenceId, int nLast, FilterMask mask) const {
 #ifdef HAVE_DB_STORAGE
 	return getHistoryRange(conferenceId, 0, nLast, mask);
@@ -5116,8 +5630,6 @@ list<shared_ptr<EventLog>> MainDb::getHistory(const ConferenceId &conferenceId,
 list<shared_ptr<EventLog>>
 MainDb::getHistoryRange(const ConferenceId &conferenceId, int begin, int end, FilterMask mask) const {
 #ifdef HAVE_DB_STORAGE
-	L_D();
-
 	if (begin < 0) begin = 0;
 
 	list<shared_ptr<EventLog>> events;
@@ -5126,16 +5638,10 @@ MainDb::getHistoryRange(const ConferenceId &conferenceId, int begin, int end, Fi
 		return events;
 	}
 
-	string query = Statements::get(Statements::SelectConferenceEvents) +
-	               buildSqlEventFilter({ConferenceCallFilter, ConferenceChatMessageFilter, ConferenceInfoFilter,
-	                                    ConferenceInfoNoDeviceFilter, ConferenceChatMessageSecurityFilter},
-	                                   mask, "AND");
-	query += " ORDER BY event_id DESC";
-
-	if (end > 0) query += " LIMIT " + Utils::toString(end - begin);
-	else query += " LIMIT " + d->dbSession.noLimitValue();
-
-	if (begin > 0) query += " OFFSET " + Utils::toString(begin);
+	const string query = buildHistoryRangeQuery(mask);
+	const long long limit =
+	    end > 0 ? end - begin : (getBackend() == Mysql ? numeric_limits<long long>::max() : (long long)-1);
+	const long long offset = begin;
 
 	/*
 	DurationLogger durationLogger(
@@ -5152,12 +5658,125 @@ MainDb::getHistoryRange(const ConferenceId &conferenceId, int begin, int end, Fi
 		if (!chatRoom) return events;
 
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
-		soci::rowset<soci::row> rows = (d->dbSession.getBackendSession()->prepare << query, soci::use(dbChatRoomId));
-		for (const auto &row : rows) {
-			shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
-			if (event) events.push_front(event);
+		d->dbSession.forEachCached(
+		    Statements::getCacheId(Statements::QueryHistory, static_cast<int>(mask)), query,
+		    [&](const soci::row &row) {
+			    shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
+			    if (event) events.push_front(event);
+		    },
+		    soci::use(dbChatRoomId), soci::use(limit), soci::use(offset));
+
+		return events;
+	};
+#else
+	return list<shared_ptr<EventLog>>();
+#endif
+}
+
+void MainDb::getHistoryRangeAsync(
+    const ConferenceId &conferenceId, int begin, int end, FilterMask mask, const AsyncResultCb<EventLog> &onResult) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (begin < 0) begin = 0;
+	if (end > 0 && begin > end) {
+		lWarning() << "Unable to get history. Invalid range.";
+		getCore()->doLater([onResult]() { onResult(list<shared_ptr<EventLog>>()); });
+		return;
+	}
+
+	const string query = buildHistoryRangeQuery(mask);
+	const long long limit =
+	    end > 0 ? end - begin : (getBackend() == Mysql ? numeric_limits<long long>::max() : (long long)-1);
+	const long long offset = begin;
+
+	const long long dbChatRoomId = L_DB_TRANSACTION {
+		return d->findChatRoom(conferenceId) ? d->selectChatRoomId(conferenceId) : -1;
+	};
+	if (dbChatRoomId < 0) {
+		getCore()->doLater([onResult]() { onResult(list<shared_ptr<EventLog>>()); });
+		return;
+	}
+
+	d->readAsync(
+	    [query, dbChatRoomId, limit, offset](soci::session &session, MainDbPrivate::Rows &rows) {
+		    soci::rowset<soci::row> rowset =
+		        (session.prepare << query, soci::use(dbChatRoomId), soci::use(limit), soci::use(offset));
+		    MainDbPrivate::appendRows(rowset, rows);
+	    },
+	    [this, conferenceId, onResult](const MainDbPrivate::Rows &rows) {
+		    list<shared_ptr<EventLog>> events = L_DB_TRANSACTION {
+			    L_D();
+
+			    list<shared_ptr<EventLog>> events;
+			    shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
+			    if (!chatRoom) return events;
+
+			    for (const auto &row : rows) {
+				    shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, *row);
+				    if (event) events.push_front(event);
+			    }
+			    tr.commit();
+			    return events;
+		    };
+		    onResult(events);
+	    });
+#else
+	getCore()->doLater([onResult]() { onResult(list<shared_ptr<EventLog>>()); });
+#endif
+}
+
+list<shared_ptr<EventLog>> MainDb::getHistoryBefore(const ConferenceId &conferenceId,
+                                                    const shared_ptr<const EventLog> &before,
+                                                    int limit,
+                                                    FilterMask mask) const {
+#ifdef HAVE_DB_STORAGE
+	list<shared_ptr<EventLog>> events;
+	if (limit <= 0) return events;
+
+	long long beforeId = numeric_limits<long long>::max();
+	if (before) {
+		const EventLogPrivate *dEventLog = before->getPrivate();
+		if (!dEventLog->dbKey.isValid()) {
+			lWarning() << "Unable to get history before an event which is not stored in database.";
+			return events;
+		}
+		beforeId = static_cast<const MainDbKey &>(dEventLog->dbKey).getPrivate()->storageId;
+	}
+
+	// Seek on event_id instead of skipping rows with OFFSET, the cost of a page does not depend on its depth.
+	const string query = Statements::get(Statements::SelectConferenceEvents) +
+	                     buildSqlEventFilter({ConferenceCallFilter, ConferenceChatMessageFilter, ConferenceInfoFilter,
+	                                          ConferenceInfoNoDeviceFilter, ConferenceChatMessageSecurityFilter},
+	                                         mask, "AND") +
+	                     " AND conference_event_view.id < :beforeId ORDER BY event_id DESC LIMIT :limit";
+	const long long dbLimit = limit;
+
+	return L_DB_TRANSACTION {
+		L_D();
+
+		shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
+		if (!chatRoom) return events;
+
+		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
+		if (before) {
+			long long beforeChatRoomId = -1;
+			*d->dbSession.getBackendSession() << "SELECT chat_room_id FROM conference_event WHERE event_id = :eventId",
+			    soci::use(beforeId), soci::into(beforeChatRoomId);
+			if (beforeChatRoomId != dbChatRoomId) {
+				lWarning() << "Unable to get history of " << conferenceId << " before an event of another chat room.";
+				return events;
+			}
 		}
 
+		d->dbSession.forEachCached(
+		    Statements::getCacheId(Statements::QueryHistoryBefore, static_cast<int>(mask)), query,
+		    [&](const soci::row &row) {
+			    shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
+			    if (event) events.push_front(event);
+		    },
+		    soci::use(dbChatRoomId), soci::use(beforeId), soci::use(dbLimit));
+
 		return events;
 	};
 #else
@@ -5213,6 +5832,7 @@ void MainDb::cleanHistory(const ConferenceId &conferenceId, FilterMask mask) {
 		d->invalidConferenceEventsFromQuery(query, dbChatRoomId);
 		*d->dbSession.getBackendSession() << "DELETE FROM event WHERE id IN (" + query + ")", soci::use(dbChatRoomId);
 		*d->dbSession.getBackendSession() << query2, soci::use(dbChatRoomId);
+		d->updateChatRoomUnreadMessageCount(dbChatRoomId);
 		tr.commit();
 
 		if (!mask || (mask & ConferenceChatMessageFilter)) d->unreadChatMessageCountCache.insert(conferenceId, 0);
@@ -5479,6 +6099,7 @@ shared_ptr<AbstractChatRoom> MainDb::mergeChatRooms(const shared_ptr<AbstractCha
 	            "AND conference_event.chat_room_id = :chatRoomId AND event.creation_time < :creationTime)",
 	    soci::use(dbChatRoomToAddId), soci::use(dbChatRoomToRemoveId),
 	    soci::use(creationTimeToDeleteSoci.first, creationTimeToDeleteSoci.second);
+	d->updateChatRoomUnreadMessageCount(dbChatRoomToAddId);
 	if (dbChatRoomToRemoveId != -1) {
 		lInfo() << "Deleting chatroom with ID " << dbChatRoomToRemoveId << " (conference id: " << conferenceIdToRemove
 		        << ")";
@@ -5490,24 +6111,152 @@ shared_ptr<AbstractChatRoom> MainDb::mergeChatRooms(const shared_ptr<AbstractCha
 #endif
 }
 
+#ifdef HAVE_DB_STORAGE
+shared_ptr<AbstractChatRoom> MainDbPrivate::selectChatRoom(const soci::row &row,
+                                                           const ConferenceId &conferenceId,
+                                                           BCTBX_UNUSED(bool serverMode)) const {
+	L_Q();
+
+	shared_ptr<Core> core = q->getCore();
+	shared_ptr<AbstractChatRoom> chatRoom;
+
+	const long long &dbChatRoomId = dbSession.resolveId(row, 0);
+	cache(conferenceId, dbChatRoomId);
+	unreadChatMessageCountCache.insert(conferenceId, row.get<int>(12, 0));
+
+	time_t creationTime = dbSession.getTime(row, 3);
+	time_t lastUpdateTime = dbSession.getTime(row, 4);
+	int capabilities = row.get<int>(5);
+	string subject = row.get<string>(6, "");
+	const long long &lastMessageId = dbSession.resolveId(row, 9);
+	bool muted = !!row.get<int>(13);
+
+	shared_ptr<ChatRoomParams> params = ChatRoomParams::fromCapabilities(capabilities);
+	if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic)) {
+		chatRoom = core->getPrivate()->createBasicChatRoom(conferenceId, capabilities, params);
+		chatRoom->setUtf8Subject(subject);
+	} else if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)) {
+#ifdef HAVE_ADVANCED_IM
+		soci::session *session = dbSession.getBackendSession();
+		list<shared_ptr<Participant>> participants;
+
+		static const string query = "SELECT chat_room_participant.id, sip_address.value, is_admin"
+		                            " FROM sip_address, chat_room, chat_room_participant"
+		                            " WHERE chat_room.id = :chatRoomId"
+		                            " AND sip_address.id = chat_room_participant.participant_sip_address_id"
+		                            " AND chat_room_participant.chat_room_id = chat_room.id";
+
+		// Fetch participants.
+		unsigned int lastNotifyId = dbSession.getUnsignedInt(row, 7, 0);
+		soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
+		shared_ptr<Participant> me;
+		for (const auto &row : rows) {
+			shared_ptr<Participant> participant =
+			    Participant::create(Address::create(row.get<string>(1), true));
+			participant->setAdmin(!!row.get<int>(2));
+
+			// Fetch devices.
+			{
+				const long long &participantId = dbSession.resolveId(row, 0);
+				static const string query = "SELECT sip_address.value, state, name, joining_time, "
+				                            "joining_method FROM chat_room_participant_device, sip_address"
+				                            " WHERE chat_room_participant_id = :participantId"
+				                            " AND participant_device_sip_address_id = sip_address.id";
+
+				soci::rowset<soci::row> rows = (session->prepare << query, soci::use(participantId));
+				for (const auto &row : rows) {
+					shared_ptr<ParticipantDevice> device = participant->addDevice(
+					    Address::create(row.get<string>(0), true), row.get<string>(2, ""));
+					device->setState(ParticipantDevice::State(static_cast<unsigned int>(row.get<int>(1, 0))),
+					                 false);
+					device->setJoiningMethod(
+					    ParticipantDevice::JoiningMethod(static_cast<unsigned int>(row.get<int>(4, 0))));
+					time_t joiningTime = dbSession.getTime(row, 3);
+					device->setTimeOfJoining(joiningTime);
+				}
+			}
+
+			if (participant->getAddress()->weakEqual(*conferenceId.getLocalAddress())) {
+				me = participant;
+			} else {
+				participants.push_back(participant);
+			}
+		}
+
+		Conference *conference = nullptr;
+		if (!serverMode) {
+			bool hasBeenLeft = !!row.get<int>(8, 0);
+			if (!me) {
+				lError() << "Unable to find me in: (peer=" +
+				                conferenceId.getPeerAddress()->toStringUriOnlyOrdered() +
+				                ", local=" + conferenceId.getLocalAddress()->toStringUriOnlyOrdered() + ").";
+				return nullptr;
+			}
+			shared_ptr<ClientGroupChatRoom> clientGroupChatRoom(new ClientGroupChatRoom(
+			    core, conferenceId, me, capabilities, params, Utils::utf8ToLocale(subject),
+			    std::move(participants), lastNotifyId, hasBeenLeft));
+			chatRoom = clientGroupChatRoom;
+			conference = clientGroupChatRoom->getConference().get();
+			chatRoom->setState(ConferenceInterface::State::Instantiated);
+			chatRoom->enableEphemeral(!!row.get<int>(10, 0), false);
+			chatRoom->setEphemeralLifetime((long)row.get<double>(11), false);
+			chatRoom->setState(hasBeenLeft ? ConferenceInterface::State::Terminated
+			                               : ConferenceInterface::State::Created);
+
+			if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::OneToOne)) {
+				// TODO: load previous IDs if any
+				static const string query =
+				    "SELECT sip_address.value FROM one_to_one_chat_room_previous_conference_id, sip_address"
+				    " WHERE chat_room_id = :chatRoomId"
+				    " AND sip_address_id = sip_address.id";
+				soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
+				for (const auto &row : rows) {
+					ConferenceId previousId =
+					    ConferenceId(Address::create(row.get<string>(0), true), conferenceId.getLocalAddress());
+					if (previousId != conferenceId) {
+						lInfo() << "Keeping around previous chat room ID [" << previousId
+						        << "] in case BYE is received for exhumed chat room [" << conferenceId << "]";
+						clientGroupChatRoom->getPrivate()->addConferenceIdToPreviousList(previousId);
+					}
+				}
+			}
+
+		} else {
+			auto serverGroupChatRoom =
+			    std::make_shared<ServerGroupChatRoom>(core, conferenceId.getPeerAddress(), capabilities, params,
+			                                          subject, std::move(participants), lastNotifyId);
+			chatRoom = serverGroupChatRoom;
+			conference = serverGroupChatRoom->getConference().get();
+			chatRoom->setState(ConferenceInterface::State::Instantiated);
+			chatRoom->setState(ConferenceInterface::State::Created);
+		}
+		for (auto participant : chatRoom->getParticipants())
+			participant->setConference(conference);
+#else
+		lWarning() << "Advanced IM such as group chat is disabled!";
+#endif
+	}
+
+	if (!chatRoom) return nullptr; // Not fetched.
+
+	AbstractChatRoomPrivate *dChatRoom = chatRoom->getPrivate();
+	dChatRoom->setCreationTime(creationTime);
+	dChatRoom->setLastUpdateTime(lastUpdateTime);
+	dChatRoom->setIsEmpty(lastMessageId == 0);
+	dChatRoom->setIsMuted(muted);
+
+	bctbx_debug("Found chat room in DB: (peer=[%s] local=[%s])",
+	            conferenceId.getPeerAddress()->toStringUriOnlyOrdered().c_str(),
+	            conferenceId.getLocalAddress()->toStringUriOnlyOrdered().c_str());
+
+	return chatRoom;
+}
+#endif
+
 list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 #ifdef HAVE_DB_STORAGE
 	static const string query =
-	    "SELECT chat_room.id, peer_sip_address.value, local_sip_address.value,"
-	    " creation_time, last_update_time, capabilities, subject, last_notify_id, flags, last_message_id,"
-	    " ephemeral_enabled, ephemeral_messages_lifetime,"
-	    " unread_messages_count.message_count, muted"
-	    " FROM chat_room"
-	    " LEFT JOIN (SELECT conference_event.chat_room_id, count(*) as message_count"
-	    " FROM conference_chat_message_event, conference_event"
-	    " WHERE conference_chat_message_event.event_id=conference_event.event_id AND "
-	    "conference_chat_message_event.marked_as_read = 0"
-	    " GROUP BY conference_event.chat_room_id) AS unread_messages_count"
-	    " ON unread_messages_count.chat_room_id = chat_room.id"
-	    " , sip_address AS peer_sip_address, sip_address AS local_sip_address"
-	    " WHERE chat_room.peer_sip_address_id = peer_sip_address.id AND chat_room.local_sip_address_id = "
-	    "local_sip_address.id"
-	    " ORDER BY last_update_time DESC";
+	    Statements::get(Statements::SelectChatRooms) + string(" ORDER BY last_update_time DESC");
 
 	DurationLogger durationLogger("Get chat rooms.");
 
@@ -5522,21 +6271,9 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 		soci::session *session = d->dbSession.getBackendSession();
 
 		soci::rowset<soci::row> rows = (session->prepare << query);
-		// SOCI uses a hack for sqlite3:
-		// "sqlite3 type system does not have a date or time field.  Also it does not reliably id other data types.
-		// It has a tendency to see everything as text.
-		// sqlite3_column_decltype returns the text that is used in the create table statement"
-		// The data type on the count can be a string (as of SOCI 4.0.0) but as it is a "hack", we have to work with
-		// both types (integer and string)
-		soci::data_type unreadMessageCountType;
-		bool typeHasBeenSet = false;
 		d->unreadChatMessageCountCache.clear();
 
 		for (const auto &row : rows) {
-			if (!typeHasBeenSet) {
-				unreadMessageCountType = row.get_properties(12).get_data_type();
-				typeHasBeenSet = true;
-			}
 			ConferenceId conferenceId(Address(row.get<string>(1), true), Address(row.get<string>(2), true));
 
 			shared_ptr<AbstractChatRoom> chatRoom = core->findChatRoom(conferenceId, false);
@@ -5545,151 +6282,90 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 				continue;
 			}
 
-			const long long &dbChatRoomId = d->dbSession.resolveId(row, 0);
-			d->cache(conferenceId, dbChatRoomId);
-			int unreadMessagesCount = 0;
-			if (unreadMessageCountType == soci::dt_string) unreadMessagesCount = std::stoi(row.get<string>(12, "0"));
-			else unreadMessagesCount = row.get<int>(12, 0);
-			d->unreadChatMessageCountCache.insert(conferenceId, unreadMessagesCount);
-
-			time_t creationTime = d->dbSession.getTime(row, 3);
-			time_t lastUpdateTime = d->dbSession.getTime(row, 4);
-			int capabilities = row.get<int>(5);
-			string subject = row.get<string>(6, "");
-			const long long &lastMessageId = d->dbSession.resolveId(row, 9);
-			bool muted = !!row.get<int>(13);
-
-			shared_ptr<ChatRoomParams> params = ChatRoomParams::fromCapabilities(capabilities);
-			if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic)) {
-				chatRoom = core->getPrivate()->createBasicChatRoom(conferenceId, capabilities, params);
-				chatRoom->setUtf8Subject(subject);
-			} else if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)) {
-#ifdef HAVE_ADVANCED_IM
-				list<shared_ptr<Participant>> participants;
+			chatRoom = d->selectChatRoom(row, conferenceId, serverMode);
+			if (chatRoom) addChatroomToList(chatRoomsMap, chatRoom);
+		}
 
-				static const string query = "SELECT chat_room_participant.id, sip_address.value, is_admin"
-				                            " FROM sip_address, chat_room, chat_room_participant"
-				                            " WHERE chat_room.id = :chatRoomId"
-				                            " AND sip_address.id = chat_room_participant.participant_sip_address_id"
-				                            " AND chat_room_participant.chat_room_id = chat_room.id";
+		tr.commit();
 
-				// Fetch participants.
-				unsigned int lastNotifyId = d->dbSession.getUnsignedInt(row, 7, 0);
-				soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
-				shared_ptr<Participant> me;
-				for (const auto &row : rows) {
-					shared_ptr<Participant> participant =
-					    Participant::create(Address::create(row.get<string>(1), true));
-					participant->setAdmin(!!row.get<int>(2));
-
-					// Fetch devices.
-					{
-						const long long &participantId = d->dbSession.resolveId(row, 0);
-						static const string query = "SELECT sip_address.value, state, name, joining_time, "
-						                            "joining_method FROM chat_room_participant_device, sip_address"
-						                            " WHERE chat_room_participant_id = :participantId"
-						                            " AND participant_device_sip_address_id = sip_address.id";
-
-						soci::rowset<soci::row> rows = (session->prepare << query, soci::use(participantId));
-						for (const auto &row : rows) {
-							shared_ptr<ParticipantDevice> device = participant->addDevice(
-							    Address::create(row.get<string>(0), true), row.get<string>(2, ""));
-							device->setState(ParticipantDevice::State(static_cast<unsigned int>(row.get<int>(1, 0))),
-							                 false);
-							device->setJoiningMethod(
-							    ParticipantDevice::JoiningMethod(static_cast<unsigned int>(row.get<int>(4, 0))));
-							time_t joiningTime = d->dbSession.getTime(row, 3);
-							device->setTimeOfJoining(joiningTime);
-						}
-					}
+		std::list<std::shared_ptr<AbstractChatRoom>> chatRooms;
+		for (const auto &[conferenceId, chatRoom] : chatRoomsMap) {
+			chatRooms.push_back(chatRoom);
+		}
 
-					if (participant->getAddress()->weakEqual(*conferenceId.getLocalAddress())) {
-						me = participant;
-					} else {
-						participants.push_back(participant);
-					}
-				}
+		return chatRooms;
+	};
+#else
+	return list<shared_ptr<AbstractChatRoom>>();
+#endif
+}
 
-				Conference *conference = nullptr;
-				if (!serverMode) {
-					bool hasBeenLeft = !!row.get<int>(8, 0);
-					if (!me) {
-						lError() << "Unable to find me in: (peer=" +
-						                conferenceId.getPeerAddress()->toStringUriOnlyOrdered() +
-						                ", local=" + conferenceId.getLocalAddress()->toStringUriOnlyOrdered() + ").";
-						continue;
-					}
-					shared_ptr<ClientGroupChatRoom> clientGroupChatRoom(new ClientGroupChatRoom(
-					    core, conferenceId, me, capabilities, params, Utils::utf8ToLocale(subject),
-					    std::move(participants), lastNotifyId, hasBeenLeft));
-					chatRoom = clientGroupChatRoom;
-					conference = clientGroupChatRoom->getConference().get();
-					chatRoom->setState(ConferenceInterface::State::Instantiated);
-					chatRoom->enableEphemeral(!!row.get<int>(10, 0), false);
-					chatRoom->setEphemeralLifetime((long)row.get<double>(11), false);
-					chatRoom->setState(hasBeenLeft ? ConferenceInterface::State::Terminated
-					                               : ConferenceInterface::State::Created);
-
-					if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::OneToOne)) {
-						// TODO: load previous IDs if any
-						static const string query =
-						    "SELECT sip_address.value FROM one_to_one_chat_room_previous_conference_id, sip_address"
-						    " WHERE chat_room_id = :chatRoomId"
-						    " AND sip_address_id = sip_address.id";
-						soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
-						for (const auto &row : rows) {
-							ConferenceId previousId =
-							    ConferenceId(Address::create(row.get<string>(0), true), conferenceId.getLocalAddress());
-							if (previousId != conferenceId) {
-								lInfo() << "Keeping around previous chat room ID [" << previousId
-								        << "] in case BYE is received for exhumed chat room [" << conferenceId << "]";
-								clientGroupChatRoom->getPrivate()->addConferenceIdToPreviousList(previousId);
-							}
-						}
-					}
+shared_ptr<AbstractChatRoom> MainDb::getChatRoom(BCTBX_UNUSED(const ConferenceId &conferenceId)) const {
+#ifdef HAVE_DB_STORAGE
+	static const string query = Statements::get(Statements::SelectChatRooms) + string(" WHERE chat_room.id = :1");
 
-				} else {
-					auto serverGroupChatRoom =
-					    std::make_shared<ServerGroupChatRoom>(core, conferenceId.getPeerAddress(), capabilities, params,
-					                                          subject, std::move(participants), lastNotifyId);
-					chatRoom = serverGroupChatRoom;
-					conference = serverGroupChatRoom->getConference().get();
-					chatRoom->setState(ConferenceInterface::State::Instantiated);
-					chatRoom->setState(ConferenceInterface::State::Created);
-				}
-				for (auto participant : chatRoom->getParticipants())
-					participant->setConference(conference);
+	return L_DB_TRANSACTION {
+		L_D();
+
+		shared_ptr<AbstractChatRoom> chatRoom;
+		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
+		if (dbChatRoomId < 0) return chatRoom;
+
+		bool serverMode = linphone_core_conference_server_enabled(getCore()->getCCore());
+		d->dbSession.forEachCached(
+		    Statements::getCacheId(Statements::SelectChatRooms), query,
+		    [&](const soci::row &row) {
+			    chatRoom = d->selectChatRoom(
+			        row, ConferenceId(Address(row.get<string>(1), true), Address(row.get<string>(2), true)),
+			        serverMode);
+		    },
+		    soci::use(dbChatRoomId));
+
+		tr.commit();
+
+		return chatRoom;
+	};
 #else
-				lWarning() << "Advanced IM such as group chat is disabled!";
+	return nullptr;
 #endif
-			}
+}
 
-			if (!chatRoom) continue; // Not fetched.
+list<MainDb::ChatRoomDescriptor> MainDb::getChatRoomDescriptors(BCTBX_UNUSED(int offset),
+                                                                 BCTBX_UNUSED(int limit)) const {
+#ifdef HAVE_DB_STORAGE
+	const long long dbLimit =
+	    limit >= 0 ? limit : (getBackend() == Mysql ? numeric_limits<long long>::max() : (long long)-1);
+	const long long dbOffset = offset;
 
-			AbstractChatRoomPrivate *dChatRoom = chatRoom->getPrivate();
-			dChatRoom->setCreationTime(creationTime);
-			dChatRoom->setLastUpdateTime(lastUpdateTime);
-			dChatRoom->setIsEmpty(lastMessageId == 0);
-			dChatRoom->setIsMuted(muted);
+	DurationLogger durationLogger("Get chat room descriptors.");
 
-			bctbx_debug("Found chat room in DB: (peer=[%s] local=[%s])",
-			            conferenceId.getPeerAddress()->toStringUriOnlyOrdered().c_str(),
-			            conferenceId.getLocalAddress()->toStringUriOnlyOrdered().c_str());
+	return L_DB_TRANSACTION {
+		L_D();
 
-			addChatroomToList(chatRoomsMap, chatRoom);
-		}
+		list<ChatRoomDescriptor> descriptors;
+		d->dbSession.forEachCached(
+		    Statements::getCacheId(Statements::SelectChatRoomDescriptors),
+		    Statements::get(Statements::SelectChatRoomDescriptors),
+		    [&](const soci::row &row) {
+			    ChatRoomDescriptor descriptor;
+			    descriptor.conferenceId =
+			        ConferenceId(Address(row.get<string>(0), true), Address(row.get<string>(1), true));
+			    descriptor.lastUpdateTime = d->dbSession.getTime(row, 2);
+			    descriptor.capabilities = row.get<int>(3);
+			    descriptor.isEmpty = d->dbSession.resolveId(row, 4) == 0;
+			    descriptor.unreadMessageCount = row.get<int>(5, 0);
+			    descriptor.isMuted = !!row.get<int>(6);
+			    d->unreadChatMessageCountCache.insert(descriptor.conferenceId, descriptor.unreadMessageCount);
+			    descriptors.push_back(std::move(descriptor));
+		    },
+		    soci::use(dbLimit), soci::use(dbOffset));
 
 		tr.commit();
 
-		std::list<std::shared_ptr<AbstractChatRoom>> chatRooms;
-		for (const auto &[conferenceId, chatRoom] : chatRoomsMap) {
-			chatRooms.push_back(chatRoom);
-		}
-
-		return chatRooms;
+		return descriptors;
 	};
 #else
-	return list<shared_ptr<AbstractChatRoom>>();
+	return list<ChatRoomDescriptor>();
 #endif
 }
 
@@ -6060,8 +6736,8 @@ void MainDb::deleteChatRoomParticipantDevice(const shared_ptr<AbstractChatRoom>
 
 // -----------------------------------------------------------------------------
 
-std::list<std::shared_ptr<ConferenceInfo>> MainDb::getConferenceInfos(time_t afterThisTime) {
 #ifdef HAVE_DB_STORAGE
+static string buildConferenceInfosQuery(time_t afterThisTime) {
 	string query = "SELECT conference_info.id, organizer_sip_address.value, uri_sip_address.value,"
 	               " start_time, duration, subject, description, state, ics_sequence, ics_uid, security_level"
 	               " FROM conference_info, sip_address AS organizer_sip_address, sip_address AS uri_sip_address"
@@ -6069,6 +6745,13 @@ std::list<std::shared_ptr<ConferenceInfo>> MainDb::getConferenceInfos(time_t aft
 	               "conference_info.uri_sip_address_id = uri_sip_address.id";
 	if (afterThisTime > -1) query += " AND start_time >= :startTime";
 	query += " ORDER BY start_time";
+	return query;
+}
+#endif
+
+std::list<std::shared_ptr<ConferenceInfo>> MainDb::getConferenceInfos(time_t afterThisTime) {
+#ifdef HAVE_DB_STORAGE
+	const string query = buildConferenceInfosQuery(afterThisTime);
 
 	DurationLogger durationLogger("Get conference infos.");
 
@@ -6106,6 +6789,41 @@ std::list<std::shared_ptr<ConferenceInfo>> MainDb::getConferenceInfos(time_t aft
 #endif
 }
 
+void MainDb::getConferenceInfosAsync(time_t afterThisTime, const AsyncResultCb<ConferenceInfo> &onResult) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	const string query = buildConferenceInfosQuery(afterThisTime);
+	const auto startTime = d->dbSession.getTimeWithSociIndicator(afterThisTime);
+	d->readAsync(
+	    [query, afterThisTime, startTime](soci::session &session, MainDbPrivate::Rows &rows) {
+		    // We cannot create an empty rowset so each "if" will make one
+		    if (afterThisTime > -1) {
+			    auto time = startTime; // soci needs a mutable indicator.
+			    soci::rowset<soci::row> rowset = (session.prepare << query, soci::use(time.first, time.second));
+			    MainDbPrivate::appendRows(rowset, rows);
+		    } else {
+			    soci::rowset<soci::row> rowset = (session.prepare << query);
+			    MainDbPrivate::appendRows(rowset, rows);
+		    }
+	    },
+	    [this, onResult](const MainDbPrivate::Rows &rows) {
+		    list<shared_ptr<ConferenceInfo>> conferenceInfos = L_DB_TRANSACTION {
+			    L_D();
+
+			    list<shared_ptr<ConferenceInfo>> conferenceInfos;
+			    for (const auto &row : rows)
+				    conferenceInfos.push_back(d->selectConferenceInfo(*row));
+			    tr.commit();
+			    return conferenceInfos;
+		    };
+		    onResult(conferenceInfos);
+	    });
+#else
+	getCore()->doLater([onResult]() { onResult(list<shared_ptr<ConferenceInfo>>()); });
+#endif
+}
+
 std::list<std::shared_ptr<ConferenceInfo>>
 MainDb::getConferenceInfosForLocalAddress(const std::shared_ptr<Address> &localAddress) {
 #ifdef HAVE_DB_STORAGE
@@ -6319,9 +7037,8 @@ std::shared_ptr<CallLog> MainDb::getCallLog(const std::string &callId, int limit
 	return nullptr;
 }
 
-std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(int limit) {
 #ifdef HAVE_DB_STORAGE
-	if (limit == 0) return list<shared_ptr<CallLog>>();
+static string buildCallHistoryQuery(int limit) {
 	string query = "SELECT conference_call.id, from_sip_address.value, from_sip_address.display_name, "
 	               "to_sip_address.value, to_sip_address.display_name,"
 	               "  direction, duration, start_time, connected_time, status, video_enabled, quality, call_id, "
@@ -6332,6 +7049,14 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(int limit) {
 	               " ORDER BY conference_call.id DESC";
 
 	if (limit > 0) query += " LIMIT " + to_string(limit);
+	return query;
+}
+#endif
+
+std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(int limit) {
+#ifdef HAVE_DB_STORAGE
+	if (limit == 0) return list<shared_ptr<CallLog>>();
+	const string query = buildCallHistoryQuery(limit);
 
 	DurationLogger durationLogger("Get call history.");
 
@@ -6357,9 +7082,43 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(int limit) {
 #endif
 }
 
+void MainDb::getCallHistoryAsync(int limit, const AsyncResultCb<CallLog> &onResult) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (limit == 0) {
+		getCore()->doLater([onResult]() { onResult(list<shared_ptr<CallLog>>()); });
+		return;
+	}
+
+	const string query = buildCallHistoryQuery(limit);
+	d->readAsync(
+	    [query](soci::session &session, MainDbPrivate::Rows &rows) {
+		    soci::rowset<soci::row> rowset = (session.prepare << query);
+		    MainDbPrivate::appendRows(rowset, rows);
+	    },
+	    [this, onResult](const MainDbPrivate::Rows &rows) {
+		    list<shared_ptr<CallLog>> clList = L_DB_TRANSACTION {
+			    L_D();
+
+			    list<shared_ptr<CallLog>> clList;
+			    for (const auto &row : rows)
+				    clList.push_back(d->selectCallLog(*row));
+			    tr.commit();
+			    return clList;
+		    };
+		    onResult(clList);
+	    });
+#else
+	getCore()->doLater([onResult]() { onResult(list<shared_ptr<CallLog>>()); });
+#endif
+}
+
 std::list<std::shared_ptr<CallLog>> MainDb::getCallHistoryForLocalAddress(const std::shared_ptr<Address> &localAddress,
                                                                           int limit) {
 #ifdef HAVE_DB_STORAGE
+	const string localSipAddressIds =
+	    "SELECT id FROM sip_address WHERE value LIKE '%%" + localAddress->toStringUriOnlyOrdered() + "%%'";
 	string query = "SELECT conference_call.id, from_sip_address.value, from_sip_address.display_name, "
 	               "to_sip_address.value, to_sip_address.display_name,"
 	               "  direction, duration, start_time, connected_time, status, video_enabled, quality, call_id, "
@@ -6367,12 +7126,13 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistoryForLocalAddress(const
 	               " FROM conference_call, sip_address AS from_sip_address, sip_address AS to_sip_address"
 	               " WHERE conference_call.from_sip_address_id = from_sip_address.id AND "
 	               "conference_call.to_sip_address_id = to_sip_address.id"
-	               "  AND ((from_sip_address.value LIKE '%%" +
-	               localAddress->toStringUriOnlyOrdered() +
-	               "%%' AND direction = 0) OR" // 0 == outgoing
-	               "  (to_sip_address.value LIKE '%%" +
-	               localAddress->toStringUriOnlyOrdered() +
-	               "%%' AND direction = 1))" // 1 == incoming
+	               // The addresses are matched first so that the calls are searched by address and direction.
+	               "  AND ((conference_call.from_sip_address_id IN (" +
+	               localSipAddressIds +
+	               ") AND direction = 0) OR" // 0 == outgoing
+	               "  (conference_call.to_sip_address_id IN (" +
+	               localSipAddressIds +
+	               ") AND direction = 1))" // 1 == incoming
 	               " ORDER BY conference_call.id DESC";
 
 	if (limit > 0) query += " LIMIT " + to_string(limit);
@@ -6750,6 +7510,869 @@ std::list<std::shared_ptr<FriendDevice>> MainDb::getDevices(BCTBX_UNUSED(const s
 
 // -----------------------------------------------------------------------------
 
+void MainDb::cancelAsyncReads() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	d->stopAsyncReader();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
+void MainDb::enableWriteBehind(bool enable, unsigned int flushInterval, unsigned int maxPendingOperations) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (d->writeBehind.timer) {
+		getCore()->destroyTimer(d->writeBehind.timer);
+		d->writeBehind.timer = nullptr;
+	}
+	flushPendingWrites();
+
+	d->writeBehind.enabled = enable;
+	d->writeBehind.flushInterval = flushInterval > 0 ? flushInterval : 1;
+	d->writeBehind.maxPendingOperations = maxPendingOperations > 0 ? maxPendingOperations : 1;
+	if (!enable) return;
+
+	lInfo() << "Enable MainDb write-behind mode: flush every " << d->writeBehind.flushInterval << " ms or "
+	        << d->writeBehind.maxPendingOperations << " operations.";
+	d->writeBehind.timer = getCore()->createTimer(
+	    [this]() {
+		    flushPendingWrites();
+		    return true;
+	    },
+	    d->writeBehind.flushInterval, "MainDb write-behind flush");
+#endif
+}
+
+bool MainDb::writeBehindEnabled() const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->writeBehind.enabled;
+#else
+	return false;
+#endif
+}
+
+void MainDb::flushPendingWrites() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	d->flushWriteBehindBatch();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Bulk transfer.
+// -----------------------------------------------------------------------------
+
+#ifdef HAVE_DB_STORAGE
+namespace {
+// Maximum number of parameters of a statement: default limit of sqlite3 before 3.32.
+constexpr size_t MaxBulkParameters = 999;
+
+struct BulkReference {
+	const char *column;
+	const char *table;
+	// An unresolved optional reference is set to NULL, otherwise the row is dropped.
+	bool optional;
+};
+
+struct BulkTable {
+	const char *name;
+	int entities;
+	// Primary key (at most two columns), the rows are read in its order.
+	vector<const char *> keyColumns;
+	// Own id of the rows, shifted past the ids of the destination. Null if the primary key is a reference.
+	const char *idColumn;
+	// Columns identifying a row of the destination to reuse instead of inserting a copy.
+	vector<const char *> naturalKey;
+	vector<BulkReference> references;
+	vector<const char *> excludedColumns;
+	const char *filter;
+	bool ignoreConflicts;
+	// Natural key of the rows having a NULL in `naturalKey`, it starts with the same column.
+	vector<const char *> fallbackKey = {};
+};
+
+// Tables are listed after the tables they reference.
+const vector<BulkTable> BulkTables = {
+    {"sip_address", MainDb::BulkAllEntities, {"id"}, "id", {"value"}, {}, {}, nullptr, false},
+    {"content_type", MainDb::BulkChatEvents, {"id"}, "id", {"value"}, {}, {}, nullptr, false},
+
+    // Chat events.
+    {"chat_room",
+     MainDb::BulkChatEvents,
+     {"id"},
+     "id",
+     {"peer_sip_address_id", "local_sip_address_id"},
+     {{"peer_sip_address_id", "sip_address", false}, {"local_sip_address_id", "sip_address", false}},
+     {"last_message_id"},
+     nullptr,
+     false},
+    {"one_to_one_chat_room",
+     MainDb::BulkChatEvents,
+     {"chat_room_id"},
+     nullptr,
+     {},
+     {{"chat_room_id", "chat_room", false},
+      {"participant_a_sip_address_id", "sip_address", false},
+      {"participant_b_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     true},
+    {"one_to_one_chat_room_previous_conference_id",
+     MainDb::BulkChatEvents,
+     {"id"},
+     "id",
+     {"sip_address_id", "chat_room_id"},
+     {{"sip_address_id", "sip_address", false}, {"chat_room_id", "chat_room", false}},
+     {},
+     nullptr,
+     false},
+    {"chat_room_participant",
+     MainDb::BulkChatEvents,
+     {"id"},
+     "id",
+     {"chat_room_id", "participant_sip_address_id"},
+     {{"chat_room_id", "chat_room", false}, {"participant_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     false},
+    {"chat_room_participant_device",
+     MainDb::BulkChatEvents,
+     {"chat_room_participant_id", "participant_device_sip_address_id"},
+     nullptr,
+     {},
+     {{"chat_room_participant_id", "chat_room_participant", false},
+      {"participant_device_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     true},
+    {"event",
+     MainDb::BulkChatEvents,
+     {"id"},
+     "id",
+     {},
+     {},
+     {},
+     "id IN (SELECT event_id FROM conference_event)",
+     false},
+    {"conference_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "event", false}, {"chat_room_id", "chat_room", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_notified_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_event", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_participant_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_notified_event", false}, {"participant_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_participant_device_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_participant_event", false}, {"device_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_security_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_event", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_subject_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_notified_event", false}},
+     {},
+     nullptr,
+     false},
+    {"chat_message_ephemeral_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_event", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_ephemeral_message_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_event", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_chat_message_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_event", false},
+      {"from_sip_address_id", "sip_address", false},
+      {"to_sip_address_id", "sip_address", false},
+      {"reply_sender_address_id", "sip_address", true}},
+     {},
+     nullptr,
+     false},
+    {"chat_message_participant",
+     MainDb::BulkChatEvents,
+     {"event_id", "participant_sip_address_id"},
+     nullptr,
+     {},
+     {{"event_id", "conference_chat_message_event", false}, {"participant_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     true},
+    {"chat_message_content",
+     MainDb::BulkChatEvents,
+     {"id"},
+     "id",
+     {},
+     {{"event_id", "conference_chat_message_event", false}, {"content_type_id", "content_type", false}},
+     {},
+     nullptr,
+     false},
+    {"chat_message_file_content",
+     MainDb::BulkChatEvents,
+     {"chat_message_content_id"},
+     nullptr,
+     {},
+     {{"chat_message_content_id", "chat_message_content", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_chat_message_reaction_event",
+     MainDb::BulkChatEvents,
+     {"event_id"},
+     "event_id",
+     {},
+     {{"from_sip_address_id", "sip_address", false}, {"to_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     true},
+
+    // Conference infos.
+    {"conference_info",
+     MainDb::BulkConferenceInfos,
+     {"id"},
+     "id",
+     {"uri_sip_address_id"},
+     {{"organizer_sip_address_id", "sip_address", false}, {"uri_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_info_participant",
+     MainDb::BulkConferenceInfos,
+     {"id"},
+     "id",
+     {"conference_info_id", "participant_sip_address_id", "is_organizer"},
+     {{"conference_info_id", "conference_info", false}, {"participant_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     false},
+    {"conference_info_organizer",
+     MainDb::BulkConferenceInfos,
+     {"id"},
+     "id",
+     {},
+     {{"conference_info_id", "conference_info", false}, {"organizer_sip_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     true},
+    {"conference_info_participant_params",
+     MainDb::BulkConferenceInfos,
+     {"id"},
+     "id",
+     {},
+     {{"conference_info_participant_id", "conference_info_participant", false}},
+     {},
+     nullptr,
+     true},
+
+    // Call logs.
+    {"conference_call",
+     MainDb::BulkCallLogs,
+     {"id"},
+     "id",
+     {},
+     {{"from_sip_address_id", "sip_address", false},
+      {"to_sip_address_id", "sip_address", false},
+      {"conference_info_id", "conference_info", true}},
+     {},
+     nullptr,
+     false},
+    {"event",
+     MainDb::BulkCallLogs,
+     {"id"},
+     "id",
+     {},
+     {},
+     {},
+     "id IN (SELECT event_id FROM conference_call_event)",
+     false},
+    {"conference_call_event",
+     MainDb::BulkCallLogs,
+     {"event_id"},
+     nullptr,
+     {},
+     {{"event_id", "event", false}, {"conference_call_id", "conference_call", false}},
+     {},
+     nullptr,
+     false},
+
+    // Friends.
+    {"friends_list", MainDb::BulkFriends, {"id"}, "id", {"name"}, {}, {}, nullptr, false},
+    {"friend",
+     MainDb::BulkFriends,
+     {"id"},
+     "id",
+     {"friends_list_id", "sip_address_id"},
+     {{"sip_address_id", "sip_address", true}, {"friends_list_id", "friends_list", false}},
+     {},
+     nullptr,
+     false,
+     // Friends without SIP address, e.g. with phone numbers only.
+     {"friends_list_id", "v_card"}},
+    {"friend_devices",
+     MainDb::BulkFriends,
+     {"device_id"},
+     "device_id",
+     {},
+     {{"sip_address_id", "sip_address", false}, {"device_address_id", "sip_address", false}},
+     {},
+     nullptr,
+     true}};
+
+// Copies the rows of the bulk tables between two databases having the same schema. The ids of the copied rows are
+// shifted past the ids of the destination, or resolved by natural key, and the references are remapped accordingly.
+class BulkTransfer {
+public:
+	BulkTransfer(soci::session &from, soci::session &to, size_t batchSize, const MainDb::BulkProgressCb &onProgress)
+	    : mFrom(from), mTo(to), mBatchSize(max<size_t>(batchSize, 1)), mOnProgress(onProgress) {
+		mInsertIgnore = mTo.get_backend_name() == "mysql" ? "INSERT IGNORE INTO " : "INSERT OR IGNORE INTO ";
+	}
+
+	void run(MainDb::BulkEntityMask entities) {
+		for (const auto &table : BulkTables)
+			if (entities & table.entities) transferTable(table);
+
+		if (!entities.isSet(MainDb::BulkChatEvents)) return;
+
+		// Derived from the events, which may have been added to existing chat rooms.
+		soci::transaction tr(mTo);
+		mTo << "UPDATE chat_room SET last_message_id = IFNULL((SELECT id FROM conference_event_simple_view WHERE "
+		       "chat_room_id = chat_room.id AND type = "
+		    << mapEventFilterToSql(MainDb::ConferenceChatMessageFilter) << " ORDER BY id DESC LIMIT 1), 0)";
+		mTo << "UPDATE chat_room SET last_update_time = ("
+		       "  SELECT MAX(creation_time) FROM event, conference_event"
+		       "  WHERE event.id = conference_event.event_id AND conference_event.chat_room_id = chat_room.id"
+		       ") WHERE last_update_time < ("
+		       "  SELECT MAX(creation_time) FROM event, conference_event"
+		       "  WHERE event.id = conference_event.event_id AND conference_event.chat_room_id = chat_room.id"
+		       ")";
+		mTo << RecountUnreadMessageCountQuery;
+		tr.commit();
+	}
+
+private:
+	using Rows = vector<unique_ptr<soci::row>>;
+
+	struct Column {
+		string name;
+		size_t index = 0;   // In the source rows.
+		int reference = -1; // In BulkTable::references.
+		bool isId = false;
+		bool isInserted = true;
+	};
+
+	struct Row {
+		const soci::row *source = nullptr;
+		long long id = 0; // Own id or primary key reference, in the source database.
+		vector<long long> references;
+		vector<bool> nullReferences;
+		string naturalKey;
+	};
+
+	struct TableState {
+		bool natural = false;
+		long long idOffset = 0;
+		// Table referenced by the primary key, for the tables without own id.
+		const char *keyReference = nullptr;
+		unordered_map<long long, long long> naturalIds;
+		unordered_set<long long> droppedIds;
+	};
+
+	// Values bound to a statement, they must live until it is executed.
+	struct Bindings {
+		deque<string> strings;
+		deque<long long> integers;
+		deque<double> doubles;
+		deque<tm> dates;
+		deque<soci::indicator> indicators;
+	};
+
+	void transferTable(const BulkTable &table) {
+		auto result = mTables.emplace(table.name, TableState());
+		TableState &state = result.first->second;
+		if (result.second) {
+			state.natural = !table.naturalKey.empty();
+			if (table.idColumn && !state.natural)
+				mTo << "SELECT COALESCE(MAX(" << table.idColumn << "), 0) FROM " << table.name,
+				    soci::into(state.idOffset);
+			for (const auto &reference : table.references)
+				if (!table.idColumn && table.keyColumns[0] == string(reference.column))
+					state.keyReference = reference.table;
+		}
+
+		mColumns.clear();
+		mInsertStatement.reset();
+
+		vector<long long> lastKey;
+		unsigned long long rowCount = 0;
+		for (;;) {
+			const Rows rows = readBatch(table, lastKey);
+			if (rows.empty()) break;
+			if (mColumns.empty()) describeColumns(table, state, *rows.front());
+
+			lastKey.clear();
+			for (size_t index : mKeyIndexes)
+				lastKey.push_back(getIntegerFromRow(*rows.back(), index));
+
+			soci::transaction tr(mTo);
+			writeBatch(table, state, rows);
+			tr.commit();
+
+			rowCount += rows.size();
+			if (mOnProgress) mOnProgress(table.name, rowCount);
+			if (rows.size() < mBatchSize) break;
+		}
+	}
+
+	Rows readBatch(const BulkTable &table, const vector<long long> &lastKey) {
+		string conditions = table.filter ? table.filter : "";
+		if (!lastKey.empty()) {
+			const string key = table.keyColumns[0];
+			string keyCondition = key + " > " + to_string(lastKey[0]);
+			if (table.keyColumns.size() > 1)
+				keyCondition = "(" + keyCondition + " OR (" + key + " = " + to_string(lastKey[0]) + " AND " +
+				               table.keyColumns[1] + " > " + to_string(lastKey[1]) + "))";
+			conditions = conditions.empty() ? keyCondition : "(" + conditions + ") AND " + keyCondition;
+		}
+
+		string query = string("SELECT * FROM ") + table.name;
+		if (!conditions.empty()) query += " WHERE " + conditions;
+		query += " ORDER BY " + Utils::join(table.keyColumns, ", ") + " LIMIT " + to_string(mBatchSize);
+
+		Rows rows;
+		soci::rowset<soci::row> rowset = mFrom.prepare << query;
+		for (const auto &row : rowset)
+			rows.push_back(copyRow(row));
+		return rows;
+	}
+
+	void describeColumns(const BulkTable &table, const TableState &state, const soci::row &row) {
+		auto findColumn = [this, &table](const string &name) {
+			for (size_t i = 0; i < mColumns.size(); ++i)
+				if (mColumns[i].name == name) return i;
+			throw soci::soci_error("Missing column `" + name + "` in table `" + table.name + "`.");
+		};
+
+		for (size_t i = 0; i < row.size(); ++i) {
+			Column column;
+			column.name = row.get_properties(i).get_name();
+			column.index = i;
+			column.isId = table.idColumn && column.name == table.idColumn;
+			for (size_t j = 0; j < table.references.size(); ++j)
+				if (column.name == table.references[j].column) column.reference = int(j);
+			column.isInserted =
+			    !(column.isId && state.natural) &&
+			    find(table.excludedColumns.cbegin(), table.excludedColumns.cend(), column.name) ==
+			        table.excludedColumns.cend();
+			mColumns.push_back(column);
+		}
+
+		mKeyIndexes.clear();
+		for (const char *name : table.keyColumns)
+			mKeyIndexes.push_back(mColumns[findColumn(name)].index);
+		mIdIndex = table.idColumn ? mColumns[findColumn(table.idColumn)].index : mKeyIndexes[0];
+		mReferenceIndexes.clear();
+		for (const auto &reference : table.references)
+			mReferenceIndexes.push_back(mColumns[findColumn(reference.column)].index);
+		mNaturalKeyColumns.clear();
+		for (const char *name : table.naturalKey)
+			mNaturalKeyColumns.push_back(findColumn(name));
+		mFallbackKeyColumns.clear();
+		for (const char *name : table.fallbackKey)
+			mFallbackKeyColumns.push_back(findColumn(name));
+		mInsertedColumns.clear();
+		for (size_t i = 0; i < mColumns.size(); ++i)
+			if (mColumns[i].isInserted) mInsertedColumns.push_back(i);
+		mIdOffset = state.idOffset;
+	}
+
+	void writeBatch(const BulkTable &table, TableState &state, const Rows &sources) {
+		vector<Row> rows;
+		rows.reserve(sources.size());
+		for (const auto &source : sources) {
+			Row row;
+			row.source = source.get();
+			if (mapRow(table, row)) rows.push_back(std::move(row));
+			else state.droppedIds.insert(row.id);
+		}
+
+		vector<const Row *> insertedRows;
+		if (!state.natural) {
+			for (const auto &row : rows)
+				insertedRows.push_back(&row);
+			insertRows(table, insertedRows);
+			return;
+		}
+
+		// Reuse the existing rows and insert the others once.
+		unordered_map<string, long long> ids = findNaturalIds(table, rows);
+		unordered_set<string> missingKeys;
+		for (const auto &row : rows)
+			if (ids.find(row.naturalKey) == ids.end() && missingKeys.insert(row.naturalKey).second)
+				insertedRows.push_back(&row);
+		if (!insertedRows.empty()) {
+			insertRows(table, insertedRows);
+			ids = findNaturalIds(table, rows);
+		}
+		for (const auto &row : rows) {
+			auto it = ids.find(row.naturalKey);
+			if (it != ids.end()) state.naturalIds[row.id] = it->second;
+		}
+	}
+
+	bool mapRow(const BulkTable &table, Row &row) const {
+		const soci::row &source = *row.source;
+		row.id = getIntegerFromRow(source, mIdIndex);
+
+		row.references.assign(table.references.size(), 0);
+		row.nullReferences.assign(table.references.size(), false);
+		for (size_t i = 0; i < table.references.size(); ++i) {
+			const size_t index = mReferenceIndexes[i];
+			if (source.get_indicator(index) == soci::i_null) {
+				row.nullReferences[i] = true;
+				continue;
+			}
+			// 0 stands for no reference in some columns.
+			const long long id = getIntegerFromRow(source, index);
+			if (id == 0 || mapId(table.references[i].table, id, row.references[i])) continue;
+			if (!table.references[i].optional) return false;
+			row.nullReferences[i] = true;
+		}
+
+		row.naturalKey.clear();
+		return mNaturalKeyColumns.empty() || makeNaturalKey(mNaturalKeyColumns, 'n', row) ||
+		       makeNaturalKey(mFallbackKeyColumns, 'f', row);
+	}
+
+	// The keys are prefixed by a tag so that natural and fallback keys never match each other.
+	bool makeNaturalKey(const vector<size_t> &columnIndexes, char tag, Row &row) const {
+		if (columnIndexes.empty()) return false;
+
+		string key(1, tag);
+		for (size_t columnIndex : columnIndexes) {
+			const Column &column = mColumns[columnIndex];
+			if (column.reference >= 0) {
+				if (row.nullReferences[size_t(column.reference)]) return false;
+				key += to_string(row.references[size_t(column.reference)]);
+			} else {
+				if (row.source->get_indicator(column.index) == soci::i_null) return false;
+				key += getNaturalKeyPart(*row.source, column.index);
+			}
+			key += '\0';
+		}
+		row.naturalKey = std::move(key);
+		return true;
+	}
+
+	// Key of a row of the destination, made of the columns [begin, begin + count) of `result`.
+	static bool makeDestinationKey(const soci::row &result, size_t begin, size_t count, char tag, string &key) {
+		if (count == 0) return false;
+
+		key.assign(1, tag);
+		for (size_t i = begin; i < begin + count; ++i) {
+			if (result.get_indicator(i) == soci::i_null) return false;
+			key += getNaturalKeyPart(result, i) + '\0';
+		}
+		return true;
+	}
+
+	bool mapId(const string &tableName, long long id, long long &mappedId) const {
+		auto it = mTables.find(tableName);
+		if (it == mTables.end()) return false;
+
+		const TableState &state = it->second;
+		if (state.droppedIds.find(id) != state.droppedIds.end()) return false;
+		if (state.natural) {
+			auto idIt = state.naturalIds.find(id);
+			if (idIt == state.naturalIds.end()) return false;
+			mappedId = idIt->second;
+			return true;
+		}
+		if (state.keyReference) return mapId(state.keyReference, id, mappedId);
+		mappedId = id + state.idOffset;
+		return true;
+	}
+
+	static string getNaturalKeyPart(const soci::row &row, size_t index) {
+		return row.get_properties(index).get_data_type() == soci::dt_string ? row.get<string>(index)
+		                                                                     : to_string(getIntegerFromRow(row, index));
+	}
+
+	// Ids of the destination rows matching the natural keys of `rows`. The candidates are selected by the first
+	// column of the natural key, then matched on the whole key.
+	unordered_map<string, long long> findNaturalIds(const BulkTable &table, const vector<Row> &rows) {
+		const Column &firstColumn = mColumns[mNaturalKeyColumns[0]];
+		vector<const Row *> lookups;
+		unordered_set<string> firstParts;
+		for (const auto &row : rows)
+			if (firstParts.insert(row.naturalKey.substr(1, row.naturalKey.find('\0') - 1)).second)
+				lookups.push_back(&row);
+
+		string selectedColumns = table.idColumn;
+		for (const char *name : table.naturalKey)
+			selectedColumns += string(", ") + name;
+		for (const char *name : table.fallbackKey)
+			selectedColumns += string(", ") + name;
+
+		unordered_map<string, long long> ids;
+		for (size_t begin = 0; begin < lookups.size(); begin += MaxBulkParameters) {
+			const size_t count = min(MaxBulkParameters, lookups.size() - begin);
+			string query = "SELECT " + selectedColumns + " FROM " + table.name + " WHERE " + firstColumn.name + " IN (";
+			for (size_t i = 0; i < count; ++i)
+				query += (i ? ", :p" : ":p") + to_string(i);
+			query += ")";
+
+			soci::row result;
+			Bindings bindings;
+			soci::statement statement(mTo);
+			statement.alloc();
+			statement.prepare(query);
+			statement.exchange(soci::into(result));
+			for (size_t i = begin; i < begin + count; ++i)
+				bindValue(statement, bindings, firstColumn, *lookups[i]);
+			statement.define_and_bind();
+			if (statement.execute(true)) {
+				const size_t naturalCount = table.naturalKey.size();
+				do {
+					string key;
+					if (makeDestinationKey(result, 1, naturalCount, 'n', key))
+						ids[key] = getIntegerFromRow(result, 0);
+					if (makeDestinationKey(result, 1 + naturalCount, table.fallbackKey.size(), 'f', key))
+						ids[key] = getIntegerFromRow(result, 0);
+				} while (statement.fetch());
+			}
+		}
+		return ids;
+	}
+
+	void insertRows(const BulkTable &table, const vector<const Row *> &rows) {
+		const size_t chunkSize = max<size_t>(1, MaxBulkParameters / mInsertedColumns.size());
+		for (size_t begin = 0; begin < rows.size(); begin += chunkSize) {
+			const size_t count = min(chunkSize, rows.size() - begin);
+
+			// The full size statement is prepared once per table.
+			unique_ptr<soci::statement> lastStatement;
+			soci::statement *statement;
+			if (count == chunkSize) {
+				if (!mInsertStatement) mInsertStatement = prepareInsert(table, count);
+				statement = mInsertStatement.get();
+			} else {
+				lastStatement = prepareInsert(table, count);
+				statement = lastStatement.get();
+			}
+
+			Bindings bindings;
+			for (size_t i = begin; i < begin + count; ++i)
+				for (size_t columnIndex : mInsertedColumns)
+					bindValue(*statement, bindings, mColumns[columnIndex], *rows[i]);
+			statement->define_and_bind();
+			statement->execute(true);
+			statement->bind_clean_up();
+		}
+	}
+
+	unique_ptr<soci::statement> prepareInsert(const BulkTable &table, size_t rowCount) const {
+		const bool ignoreConflicts = table.ignoreConflicts || !table.naturalKey.empty();
+		string query = (ignoreConflicts ? mInsertIgnore : string("INSERT INTO ")) + table.name + " (";
+		for (size_t i = 0; i < mInsertedColumns.size(); ++i)
+			query += (i ? ", " : "") + mColumns[mInsertedColumns[i]].name;
+		query += ") VALUES ";
+
+		size_t parameter = 0;
+		for (size_t i = 0; i < rowCount; ++i) {
+			query += i ? ", (" : "(";
+			for (size_t j = 0; j < mInsertedColumns.size(); ++j)
+				query += (j ? ", :p" : ":p") + to_string(parameter++);
+			query += ")";
+		}
+
+		auto statement = makeUnique<soci::statement>(mTo);
+		statement->alloc();
+		statement->prepare(query);
+		return statement;
+	}
+
+	void bindValue(soci::statement &statement, Bindings &bindings, const Column &column, const Row &row) const {
+		bindings.indicators.push_back(soci::i_ok);
+		soci::indicator &indicator = bindings.indicators.back();
+
+		if (column.isId || column.reference >= 0) {
+			if (column.isId) bindings.integers.push_back(row.id + mIdOffset);
+			else {
+				bindings.integers.push_back(row.references[size_t(column.reference)]);
+				if (row.nullReferences[size_t(column.reference)]) indicator = soci::i_null;
+			}
+			statement.exchange(soci::use(bindings.integers.back(), indicator));
+			return;
+		}
+
+		const soci::row &source = *row.source;
+		const bool isNull = source.get_indicator(column.index) == soci::i_null;
+		if (isNull) indicator = soci::i_null;
+		switch (source.get_properties(column.index).get_data_type()) {
+			case soci::dt_string:
+				bindings.strings.push_back(isNull ? string() : source.get<string>(column.index));
+				statement.exchange(soci::use(bindings.strings.back(), indicator));
+				break;
+			case soci::dt_date:
+				bindings.dates.push_back(isNull ? tm() : source.get<tm>(column.index));
+				statement.exchange(soci::use(bindings.dates.back(), indicator));
+				break;
+			case soci::dt_double:
+				bindings.doubles.push_back(isNull ? 0. : source.get<double>(column.index));
+				statement.exchange(soci::use(bindings.doubles.back(), indicator));
+				break;
+			default:
+				bindings.integers.push_back(isNull ? 0 : getIntegerFromRow(source, column.index));
+				statement.exchange(soci::use(bindings.integers.back(), indicator));
+				break;
+		}
+	}
+
+	soci::session &mFrom;
+	soci::session &mTo;
+	const size_t mBatchSize;
+	const MainDb::BulkProgressCb mOnProgress;
+	string mInsertIgnore;
+
+	unordered_map<string, TableState> mTables;
+
+	// Current table.
+	vector<Column> mColumns;
+	vector<size_t> mKeyIndexes;
+	size_t mIdIndex = 0;
+	vector<size_t> mReferenceIndexes;
+	vector<size_t> mNaturalKeyColumns;
+	vector<size_t> mFallbackKeyColumns;
+	vector<size_t> mInsertedColumns;
+	long long mIdOffset = 0;
+	unique_ptr<soci::statement> mInsertStatement;
+};
+} // namespace
+
+static bool bulkTransfer(soci::session &from,
+                         soci::session &to,
+                         MainDb::BulkEntityMask entities,
+                         const MainDb::BulkProgressCb &onProgress,
+                         size_t batchSize) {
+	try {
+		BulkTransfer(from, to, batchSize, onProgress).run(entities);
+	} catch (const exception &e) {
+		lError() << "Bulk transfer failed: " << e.what();
+		return false;
+	}
+	return true;
+}
+#endif
+
+bool MainDb::bulkImport(Backend backend,
+                        const string &parameters,
+                        BulkEntityMask entities,
+                        const BulkProgressCb &onProgress,
+                        size_t batchSize) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (!isInitialized()) return false;
+
+	MainDb other(getCore());
+	if (!other.connect(backend, parameters)) {
+		lWarning() << "Unable to connect to: `" << parameters << "`.";
+		return false;
+	}
+
+	flushPendingWrites();
+	if (!bulkTransfer(*other.getPrivate()->dbSession.getBackendSession(), *d->dbSession.getBackendSession(),
+	                  entities, onProgress, batchSize))
+		return false;
+
+	if (entities.isSet(BulkChatEvents)) {
+		d->unreadChatMessageCountCache.clear();
+		getCore()->getPrivate()->loadImportedChatRooms();
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool MainDb::bulkExport(Backend backend,
+                        const string &parameters,
+                        BulkEntityMask entities,
+                        const BulkProgressCb &onProgress,
+                        size_t batchSize) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (!isInitialized()) return false;
+
+	MainDb other(getCore());
+	if (!other.connect(backend, parameters)) {
+		lWarning() << "Unable to connect to: `" << parameters << "`.";
+		return false;
+	}
+
+	flushPendingWrites();
+	return bulkTransfer(*d->dbSession.getBackendSession(), *other.getPrivate()->dbSession.getBackendSession(),
+	                    entities, onProgress, batchSize);
+#else
+	return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
 bool MainDb::import(Backend, const string &parameters) {
 #ifdef HAVE_DB_STORAGE
 	L_D();
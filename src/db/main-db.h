@@ -71,6 +71,22 @@ public:
 
 	typedef EnumMask<Filter> FilterMask;
 
+	enum BulkEntity {
+		BulkChatEvents = 1 << 0,
+		BulkCallLogs = 1 << 1,
+		BulkConferenceInfos = 1 << 2,
+		BulkFriends = 1 << 3,
+		BulkAllEntities = BulkChatEvents | BulkCallLogs | BulkConferenceInfos | BulkFriends
+	};
+
+	typedef EnumMask<BulkEntity> BulkEntityMask;
+
+	// Called after each committed batch with the table being transferred and its number of rows processed so far.
+	using BulkProgressCb = std::function<void(const std::string &table, unsigned long long rowCount)>;
+
+	// Called once the write has been committed to the database (true) or dropped (false).
+	using WriteCompletionCb = std::function<void(bool success)>;
+
 	struct ParticipantState {
 		ParticipantState(const std::shared_ptr<Address> &address, ChatMessage::State state, time_t timestamp)
 		    : address(address), state(state), timestamp(timestamp) {
@@ -81,15 +97,27 @@ public:
 		time_t timestamp = 0;
 	};
 
+	// Lightweight view of a chat room, enough to list chat rooms without building them.
+	struct ChatRoomDescriptor {
+		ConferenceId conferenceId;
+		time_t lastUpdateTime = 0;
+		int capabilities = 0;
+		int unreadMessageCount = 0;
+		bool isEmpty = true;
+		bool isMuted = false;
+	};
+
 	MainDb(const std::shared_ptr<Core> &core);
 
 	// ---------------------------------------------------------------------------
 	// Generic.
 	// ---------------------------------------------------------------------------
 
-	bool addEvent(const std::shared_ptr<EventLog> &eventLog);
-	bool updateEvent(const std::shared_ptr<EventLog> &eventLog);
+	bool addEvent(const std::shared_ptr<EventLog> &eventLog, const WriteCompletionCb &onCompleted = nullptr);
+	bool updateEvent(const std::shared_ptr<EventLog> &eventLog, const WriteCompletionCb &onCompleted = nullptr);
 	static bool deleteEvent(const std::shared_ptr<const EventLog> &eventLog);
+	// Deletes the events in a single transaction.
+	bool deleteEvents(const std::list<std::shared_ptr<const EventLog>> &eventLogs);
 	int getEventCount(FilterMask mask = NoFilter) const;
 
 	static std::shared_ptr<EventLog> getEventFromKey(const MainDbKey &dbKey);
@@ -126,9 +154,11 @@ public:
 	void setChatMessageParticipantState(const std::shared_ptr<EventLog> &eventLog,
 	                                    const std::shared_ptr<Address> &participantAddress,
 	                                    ChatMessage::State state,
-	                                    time_t stateChangeTime);
+	                                    time_t stateChangeTime,
+	                                    const WriteCompletionCb &onCompleted = nullptr);
 
-	std::list<std::shared_ptr<ChatMessage>> getEphemeralMessages() const;
+	// The earliest ephemeral messages to expire. truncated is set when more of them remain in database.
+	std::list<std::shared_ptr<ChatMessage>> getEphemeralMessages(bool *truncated = nullptr) const;
 
 	bool isChatRoomEmpty(const ConferenceId &conferenceId) const;
 	std::shared_ptr<ChatMessage> getLastChatMessage(const ConferenceId &conferenceId) const;
@@ -154,6 +184,11 @@ public:
 	getHistory(const ConferenceId &conferenceId, int nLast, FilterMask mask = NoFilter) const;
 	std::list<std::shared_ptr<EventLog>>
 	getHistoryRange(const ConferenceId &conferenceId, int begin, int end, FilterMask mask = NoFilter) const;
+	// Keyset pagination: returns up to limit events older than before (or the most recent ones if before is null).
+	std::list<std::shared_ptr<EventLog>> getHistoryBefore(const ConferenceId &conferenceId,
+	                                                      const std::shared_ptr<const EventLog> &before,
+	                                                      int limit,
+	                                                      FilterMask mask = NoFilter) const;
 
 	int getHistorySize(const ConferenceId &conferenceId, FilterMask mask = NoFilter) const;
 
@@ -177,6 +212,9 @@ public:
 	// ---------------------------------------------------------------------------
 
 	std::list<std::shared_ptr<AbstractChatRoom>> getChatRooms() const;
+	std::shared_ptr<AbstractChatRoom> getChatRoom(const ConferenceId &conferenceId) const;
+	// Most recently updated first. A negative limit returns all the chat rooms after offset.
+	std::list<ChatRoomDescriptor> getChatRoomDescriptors(int offset = 0, int limit = -1) const;
 	void insertChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom, unsigned int notifyId = 0);
 	void deleteChatRoom(const ConferenceId &conferenceId);
 	void updateNotifyId(const std::shared_ptr<AbstractChatRoom> &chatRoom, const unsigned int lastNotify);
@@ -259,6 +297,73 @@ public:
 	void removeDevice(const std::shared_ptr<Address> &addressWithGruu);
 	std::list<std::shared_ptr<FriendDevice>> getDevices(const std::shared_ptr<Address> &address);
 
+	// ---------------------------------------------------------------------------
+	// Asynchronous reads.
+	// ---------------------------------------------------------------------------
+
+	/*
+	 * Asynchronous variants of the getters of the same name. The query runs on a DB worker thread with a read-only
+	 * session (see AbstractDb::acquireReadSession()) after the pending writes are committed. The fetched rows are
+	 * turned into objects and `onResult` is called on the core thread, never from the calling function. `onResult`
+	 * is not called if the asynchronous reads are cancelled first.
+	 * Without read-only session (no write-ahead log), the query is delayed but runs on the core thread.
+	 */
+	template <typename T>
+	using AsyncResultCb = std::function<void(const std::list<std::shared_ptr<T>> &result)>;
+
+	void getHistoryRangeAsync(const ConferenceId &conferenceId,
+	                          int begin,
+	                          int end,
+	                          FilterMask mask,
+	                          const AsyncResultCb<EventLog> &onResult);
+	void findChatMessagesAsync(const ConferenceId &conferenceId,
+	                           const std::string &imdnMessageId,
+	                           const AsyncResultCb<ChatMessage> &onResult);
+	void getMediaContentsAsync(const ConferenceId &conferenceId, const AsyncResultCb<Content> &onResult);
+	void getConferenceInfosAsync(time_t afterThisTime, const AsyncResultCb<ConferenceInfo> &onResult);
+	void getCallHistoryAsync(int limit, const AsyncResultCb<CallLog> &onResult);
+
+	// Drops the pending asynchronous reads and stops the DB worker thread. Must be called before the core stops.
+	void cancelAsyncReads();
+
+	// ---------------------------------------------------------------------------
+	// Write-behind.
+	// ---------------------------------------------------------------------------
+
+	/*
+	 * When enabled, writes are grouped in a single transaction which is committed every `flushInterval`
+	 * milliseconds or as soon as `maxPendingOperations` event writes are pending, whichever comes first.
+	 * Reads are done on the same connection and therefore see the pending writes.
+	 * Disabling the write-behind mode commits the pending writes.
+	 */
+	void enableWriteBehind(bool enable, unsigned int flushInterval = 200, unsigned int maxPendingOperations = 100);
+	bool writeBehindEnabled() const;
+	void flushPendingWrites();
+
+	// ---------------------------------------------------------------------------
+	// Bulk transfer.
+	// ---------------------------------------------------------------------------
+
+	/*
+	 * Copy the selected entities from (import) or to (export) another database. The rows are read by batches of
+	 * `batchSize` in primary key order and written with multi-row inserts, one transaction per batch. The schema of
+	 * the other database is created or upgraded first.
+	 * Rows are appended, except the sip addresses, content types, chat rooms and their participants, conference
+	 * infos (by uri) and their participants, friends lists (by name) and friends which are reused when they already
+	 * exist. Binary application data and encryption data are not transferred.
+	 * If a batch fails, the transfer stops and the batches already committed are kept.
+	 */
+	bool bulkImport(Backend backend,
+	                const std::string &parameters,
+	                BulkEntityMask entities = BulkAllEntities,
+	                const BulkProgressCb &onProgress = nullptr,
+	                size_t batchSize = 10000);
+	bool bulkExport(Backend backend,
+	                const std::string &parameters,
+	                BulkEntityMask entities = BulkAllEntities,
+	                const BulkProgressCb &onProgress = nullptr,
+	                size_t batchSize = 10000);
+
 	// ---------------------------------------------------------------------------
 	// Other.
 	// ---------------------------------------------------------------------------
@@ -18,8 +18,15 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <mutex>
+#include <unordered_map>
+
+#include <soci/sqlite3/soci-sqlite3.h>
+
 #include "linphone/utils/utils.h"
 
+#include "bctoolbox/vfs.h"
+
 #include "db-session.h"
 #include "logger/logger.h"
 #include "sqlite3_bctbx_vfs.h"
@@ -30,11 +37,37 @@ using namespace std;
 
 LINPHONE_BEGIN_NAMESPACE
 
+// Negative identifiers are reserved to the statements of the session itself.
+static constexpr int LastInsertIdStatementId = -1;
+
 class DbSessionPrivate {
 public:
+	struct CachedStatement {
+		std::unique_ptr<soci::statement> statement;
+		bool inUse = false;
+	};
+
+	// Idle read-only connections. Shared with the lent connections so that they can be given back (or closed) after
+	// the session is gone.
+	struct ReadSessionPool {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<soci::session>> idleSessions;
+		size_t openedSessions = 0;
+		size_t maxSessions = 0;
+	};
+
 	enum class Backend { None, Mysql, Sqlite3 } backend = Backend::None;
 
+	std::string uri;
+	bool writeAheadLogEnabled = false;
+	std::shared_ptr<ReadSessionPool> readSessionPool = std::make_shared<ReadSessionPool>();
+
 	std::unique_ptr<soci::session> backendSession;
+
+	// Must be declared after the backend session: the statements are destroyed before it.
+	mutable std::unordered_map<int, CachedStatement> cachedStatements;
+	mutable unsigned long long statementCacheHits = 0;
+	mutable unsigned long long statementCacheMisses = 0;
 };
 
 DbSession::DbSession() : mPrivate(new DbSessionPrivate) {
@@ -59,10 +92,11 @@ DbSession::DbSession(const string &uri) : DbSession() {
 				}
 			}
 			uriArgs.append(" vfs=").append(BCTBX_SQLITE3_VFS);
-			d->backendSession = makeUnique<soci::session>(uriArgs);
+			d->uri = uriArgs;
 		} else {
-			d->backendSession = makeUnique<soci::session>(uri);
+			d->uri = uri;
 		}
+		d->backendSession = makeUnique<soci::session>(d->uri);
 		d->backend = !uri.find("mysql") ? DbSessionPrivate::Backend::Mysql : DbSessionPrivate::Backend::Sqlite3;
 	} catch (const exception &e) {
 		lWarning() << "Unable to build db session with uri: " << e.what();
@@ -215,9 +249,7 @@ long long DbSession::getLastInsertId() const {
 			break;
 	}
 
-	if (!sql.empty()) {
-		*d->backendSession << sql, soci::into(id);
-	}
+	if (!sql.empty()) executeCached(LastInsertIdStatementId, sql, soci::into(id));
 
 	return id;
 }
@@ -237,6 +269,87 @@ void DbSession::enableForeignKeys(bool status) {
 	}
 }
 
+bool DbSession::enableWriteAheadLog(bool status) {
+	L_D();
+
+	if (d->backend != DbSessionPrivate::Backend::Sqlite3) return false;
+
+	string journalMode;
+	if (status) *d->backendSession << "PRAGMA journal_mode = WAL", soci::into(journalMode);
+	else {
+		*d->backendSession << "PRAGMA journal_mode", soci::into(journalMode);
+		if (Utils::stringToLower(journalMode) == "wal")
+			*d->backendSession << "PRAGMA journal_mode = DELETE", soci::into(journalMode);
+	}
+	d->writeAheadLogEnabled = Utils::stringToLower(journalMode) == "wal";
+	if (d->writeAheadLogEnabled != status)
+		lWarning() << "Unable to " << (status ? "enable" : "disable")
+		           << " write-ahead log, journal mode is: " << journalMode;
+	return d->writeAheadLogEnabled;
+}
+
+bool DbSession::writeAheadLogEnabled() const {
+	L_D();
+	return d->writeAheadLogEnabled;
+}
+
+void DbSession::setReadSessionPoolSize(size_t size) {
+	L_D();
+
+	lock_guard<mutex> lock(d->readSessionPool->mutex);
+	d->readSessionPool->maxSessions = size;
+	while (d->readSessionPool->idleSessions.size() > size) {
+		d->readSessionPool->idleSessions.pop_back();
+		d->readSessionPool->openedSessions--;
+	}
+}
+
+shared_ptr<soci::session> DbSession::acquireReadSession() const {
+	L_D();
+
+	if (!d->writeAheadLogEnabled) return nullptr;
+
+	// Each connection of the encrypted VFS keeps its own view of the file sizes, they cannot see the frames appended
+	// to the write-ahead log by another connection.
+	if (bctbx_vfs_get_default() != bctbx_vfs_get_standard()) return nullptr;
+
+	shared_ptr<DbSessionPrivate::ReadSessionPool> pool = d->readSessionPool;
+	unique_ptr<soci::session> session;
+	{
+		lock_guard<mutex> lock(pool->mutex);
+		if (!pool->idleSessions.empty()) {
+			session = std::move(pool->idleSessions.back());
+			pool->idleSessions.pop_back();
+		} else if (pool->openedSessions < pool->maxSessions) {
+			pool->openedSessions++;
+		} else {
+			return nullptr;
+		}
+	}
+
+	if (!session) {
+		try {
+			session = makeUnique<soci::session>(d->uri);
+			*session << "PRAGMA query_only = ON";
+		} catch (const exception &e) {
+			lWarning() << "Unable to open read-only db session: " << e.what();
+			lock_guard<mutex> lock(pool->mutex);
+			pool->openedSessions--;
+			return nullptr;
+		}
+	}
+
+	weak_ptr<DbSessionPrivate::ReadSessionPool> weakPool = pool;
+	return shared_ptr<soci::session>(session.release(), [weakPool](soci::session *released) {
+		unique_ptr<soci::session> owned(released);
+		shared_ptr<DbSessionPrivate::ReadSessionPool> pool = weakPool.lock();
+		if (!pool) return;
+		lock_guard<mutex> lock(pool->mutex);
+		if (pool->idleSessions.size() < pool->maxSessions) pool->idleSessions.push_back(std::move(owned));
+		else pool->openedSessions--;
+	});
+}
+
 bool DbSession::checkTableExists(const string &table) const {
 	L_D();
 
@@ -328,4 +441,77 @@ pair<tm, soci::indicator> DbSession::getTimeWithSociIndicator(time_t t) const {
 	return dataInDb;
 }
 
+// -----------------------------------------------------------------------------
+
+unsigned long long DbSession::getStatementCacheHits() const {
+	L_D();
+	return d->statementCacheHits;
+}
+
+unsigned long long DbSession::getStatementCacheMisses() const {
+	L_D();
+	return d->statementCacheMisses;
+}
+
+void DbSession::clearStatementCache() {
+	L_D();
+	d->cachedStatements.clear();
+}
+
+DbSession::StatementGuard::StatementGuard(const DbSession &dbSession, int id, const string &sql)
+    : mDbSession(dbSession), mId(id), mUncaughtExceptions(uncaught_exceptions()) {
+	const DbSessionPrivate *d = dbSession.getPrivate();
+	soci::session *session = d->backendSession.get();
+
+	auto it = d->cachedStatements.find(id);
+	if (it != d->cachedStatements.end()) {
+		if (!it->second.inUse) {
+			d->statementCacheHits++;
+			it->second.inUse = true;
+			mStatement = it->second.statement.get();
+			return;
+		}
+	} else {
+		d->statementCacheMisses++;
+		auto statement = makeUnique<soci::statement>(*session);
+		statement->alloc();
+		statement->prepare(sql);
+		DbSessionPrivate::CachedStatement &cachedStatement = d->cachedStatements[id];
+		cachedStatement.statement = std::move(statement);
+		cachedStatement.inUse = true;
+		mStatement = cachedStatement.statement.get();
+		return;
+	}
+
+	mOneShotStatement = makeUnique<soci::statement>(*session);
+	mOneShotStatement->alloc();
+	mOneShotStatement->prepare(sql);
+	mStatement = mOneShotStatement.get();
+}
+
+DbSession::StatementGuard::~StatementGuard() {
+	const DbSessionPrivate *d = mDbSession.getPrivate();
+
+	try {
+		mStatement->bind_clean_up();
+	} catch (const exception &e) {
+		lWarning() << "Unable to clean up bindings of statement " << mId << ": " << e.what();
+	}
+
+	if (mOneShotStatement) return;
+
+	// A Sqlite3 statement stays active (and keeps its read lock) until it is stepped to the end or reset.
+	if (d->backend == DbSessionPrivate::Backend::Sqlite3) {
+		auto backend = static_cast<soci::sqlite3_statement_backend *>(mStatement->get_backend());
+		if (backend && backend->stmt_) sqlite3_reset(backend->stmt_);
+	}
+
+	auto it = d->cachedStatements.find(mId);
+	if (it == d->cachedStatements.end()) return;
+
+	// A failed execution may leave the statement in an unknown state, prepare it again next time.
+	if (uncaught_exceptions() > mUncaughtExceptions) d->cachedStatements.erase(it);
+	else it->second.inUse = false;
+}
+
 LINPHONE_END_NAMESPACE
@@ -21,6 +21,10 @@
 #ifndef _L_DB_SESSION_H_
 #define _L_DB_SESSION_H_
 
+#include <exception>
+#include <functional>
+#include <memory>
+
 #include <soci/soci.h>
 
 #include "linphone/utils/general.h"
@@ -57,6 +61,30 @@ public:
 
 	void enableForeignKeys(bool status);
 
+	/*
+	 * Switch a sqlite3 database to the write-ahead log journal mode, so that readers no longer wait for the writer,
+	 * or back to the rollback journal. The journal mode is stored in the database file.
+	 * Must be called outside of a transaction. Returns true if the database uses the write-ahead log.
+	 */
+	bool enableWriteAheadLog(bool status);
+	bool writeAheadLogEnabled() const;
+
+	// ---------------------------------------------------------------------------
+	// Read-only sessions pool.
+	// ---------------------------------------------------------------------------
+
+	/*
+	 * Read-only connections to the same database, to run queries (from another thread for instance) beside the
+	 * writes of this session. Up to `size` connections are opened, on demand.
+	 */
+	void setReadSessionPoolSize(size_t size);
+
+	/*
+	 * Lend a read-only connection, given back to the pool when the last reference is released. Returns nullptr if the
+	 * write-ahead log is not enabled or if all the connections of the pool are in use.
+	 */
+	std::shared_ptr<soci::session> acquireReadSession() const;
+
 	bool checkTableExists(const std::string &table) const;
 
 	long long resolveId(const soci::row &row, int col) const;
@@ -66,7 +94,71 @@ public:
 
 	unsigned int getUnsignedInt(const soci::row &row, std::size_t col, const unsigned int def = 0) const;
 
+	// ---------------------------------------------------------------------------
+	// Prepared statements cache.
+	// ---------------------------------------------------------------------------
+
+	/*
+	 * Execute the statement identified by `id`. `sql` is only prepared the first time, the prepared statement is
+	 * kept and reused by the next calls. The soci::use() and soci::into() `elements` are bound for this execution.
+	 * Returns true if a row was fetched.
+	 */
+	template <typename... Elements>
+	bool executeCached(int id, const std::string &sql, Elements &&...elements) const {
+		StatementGuard guard(*this, id, sql);
+		soci::statement &statement = guard.get();
+		(statement.exchange(std::forward<Elements>(elements)), ...);
+		statement.define_and_bind();
+		return statement.execute(true);
+	}
+
+	/*
+	 * Same as executeCached() but for queries returning several rows, `onRow` is called for each of them.
+	 */
+	template <typename... Elements>
+	void forEachCached(int id,
+	                   const std::string &sql,
+	                   const std::function<void(const soci::row &)> &onRow,
+	                   Elements &&...elements) const {
+		soci::row row;
+		StatementGuard guard(*this, id, sql);
+		soci::statement &statement = guard.get();
+		statement.exchange(soci::into(row));
+		(statement.exchange(std::forward<Elements>(elements)), ...);
+		statement.define_and_bind();
+		if (statement.execute(true)) {
+			do {
+				onRow(row);
+			} while (statement.fetch());
+		}
+	}
+
+	unsigned long long getStatementCacheHits() const;
+	unsigned long long getStatementCacheMisses() const;
+	void clearStatementCache();
+
 private:
+	// Lends a cached statement for one execution. If the cached statement is already in use (re-entrant call while
+	// iterating on its rows), a one-shot statement is used instead.
+	class StatementGuard {
+	public:
+		StatementGuard(const DbSession &dbSession, int id, const std::string &sql);
+		~StatementGuard();
+
+		soci::statement &get() {
+			return *mStatement;
+		}
+
+	private:
+		const DbSession &mDbSession;
+		int mId;
+		soci::statement *mStatement = nullptr;
+		std::unique_ptr<soci::statement> mOneShotStatement;
+		int mUncaughtExceptions;
+
+		L_DISABLE_COPY(StatementGuard);
+	};
+
 	DbSessionPrivate *mPrivate;
 
 	L_DECLARE_PRIVATE(DbSession);
@@ -65,6 +65,8 @@ public:
 	LinphoneStatus deny(LinphoneReason reason) override;
 
 	LinphoneStatus notify(const std::shared_ptr<const Content> &body);
+	// Sends a NOTIFY whose body handler was already built. The request takes its own reference to it.
+	LinphoneStatus notifyWithBodyHandler(SalBodyHandler *bodyHandler);
 	void notifyNotifyResponse();
 
 	LinphoneSubscriptionState getState() const;
@@ -80,6 +82,8 @@ public:
 	void terminate() override;
 
 private:
+	bool canNotify() const;
+
 	LinphoneSubscriptionDir mDir = LinphoneSubscriptionInvalidDir;
 	LinphoneSubscriptionState mSubscriptionState = LinphoneSubscriptionNone;
 
@@ -256,7 +256,7 @@ std::shared_ptr<Friend> FriendList::findFriendByRefKey(const std::string &refKey
 
 std::shared_ptr<Friend> FriendList::findFriendByUri(const std::string &uri) const {
 	const auto it = mFriendsMapByUri.find(uri);
-	return (it == mFriendsMapByUri.cend()) ? nullptr : it->second;
+	return (it == mFriendsMapByUri.cend()) ? nullptr : it->second.front();
 }
 
 std::list<std::shared_ptr<Friend>>
@@ -267,12 +267,15 @@ FriendList::findFriendsByAddress(const std::shared_ptr<const Address> &address)
 	return result;
 }
 
+std::list<std::shared_ptr<Friend>> FriendList::findFriendsBySearchFilter(const std::string &filter) const {
+	if (filter.empty()) return mFriends;
+	return mSearchIndex.findCandidates(filter);
+}
+
 std::list<std::shared_ptr<Friend>> FriendList::findFriendsByUri(const std::string &uri) const {
-	std::list<std::shared_ptr<Friend>> result;
-	for (auto [it, rangeEnd] = mFriendsMapByUri.equal_range(uri); it != rangeEnd; it++) {
-		result.push_back(it->second);
-	}
-	return result;
+	const auto it = mFriendsMapByUri.find(uri);
+	if (it == mFriendsMapByUri.cend()) return std::list<std::shared_ptr<Friend>>();
+	return std::list<std::shared_ptr<Friend>>(it->second.cbegin(), it->second.cend());
 }
 
 LinphoneStatus FriendList::importFriendsFromVcard4Buffer(const std::string &vcardBuffer) {
@@ -523,16 +526,14 @@ std::string FriendList::createResourceListXml() const {
 		err = xmlTextWriterStartElement(writer, (const xmlChar *)"list");
 	}
 
-	std::string previousEntry;
-	for (const auto &entry : mFriendsMapByUri) {
-		// Map is sorted, prevent duplicates
-		if (previousEntry.empty() || (previousEntry != entry.first)) {
-			if (err >= 0) err = xmlTextWriterStartElement(writer, (const xmlChar *)"entry");
-			if (err >= 0)
-				err = xmlTextWriterWriteAttribute(writer, (const xmlChar *)"uri", (const xmlChar *)entry.first.c_str());
-			if (err >= 0) err = xmlTextWriterEndElement(writer); // Close the "entry" element.
-		}
-		previousEntry = entry.first;
+	// Keep the entries sorted so that the body does not depend on the map internal order
+	std::set<std::string> uris;
+	for (const auto &entry : mFriendsMapByUri)
+		uris.insert(entry.first);
+	for (const auto &uri : uris) {
+		if (err >= 0) err = xmlTextWriterStartElement(writer, (const xmlChar *)"entry");
+		if (err >= 0) err = xmlTextWriterWriteAttribute(writer, (const xmlChar *)"uri", (const xmlChar *)uri.c_str());
+		if (err >= 0) err = xmlTextWriterEndElement(writer); // Close the "entry" element.
 	}
 
 	if (err >= 0) err = xmlTextWriterEndElement(writer); // Close the "list" element.
@@ -574,9 +575,46 @@ std::shared_ptr<Friend> FriendList::findFriendByOutSubscribe(SalOp *op) const {
 
 std::shared_ptr<Friend> FriendList::findFriendByPhoneNumber(const std::shared_ptr<Account> &account,
                                                             const std::string &normalizedPhoneNumber) const {
-	const auto it = std::find_if(mFriends.cbegin(), mFriends.cend(),
-	                             [&](const auto &f) { return f->hasPhoneNumber(account, normalizedPhoneNumber); });
-	return (it == mFriends.cend()) ? nullptr : *it;
+	if (normalizedPhoneNumber.empty()) return nullptr;
+	const auto &friends = getFriendsMapByPhoneNumber(account);
+	const auto it = friends.find(normalizedPhoneNumber);
+	return (it == friends.cend()) ? nullptr : it->second;
+}
+
+// Phone numbers normalization only depends on these account parameters.
+static std::string getPhoneNumbersMapKey(const std::shared_ptr<Account> &account) {
+	const LinphoneAccountParams *params = account ? linphone_account_get_params(account->toC()) : nullptr;
+	if (!params) return std::string();
+	return L_C_TO_STRING(linphone_account_params_get_international_prefix(params)) + "|" +
+	       (linphone_account_params_dial_escape_plus_enabled(params) ? "1" : "0");
+}
+
+static void addPhoneNumbersToMap(const std::shared_ptr<Account> &account,
+                                 const std::shared_ptr<Friend> &lf,
+                                 std::unordered_map<std::string, std::shared_ptr<Friend>> &friends,
+                                 bool replace) {
+	for (const auto &phoneNumber : lf->getPhoneNumbers()) {
+		char *normalizedPhoneNumber =
+		    linphone_account_normalize_phone_number(account ? account->toC() : nullptr, L_STRING_TO_C(phoneNumber));
+		if (!normalizedPhoneNumber) continue;
+		if (replace) friends[normalizedPhoneNumber] = lf;
+		else friends.emplace(normalizedPhoneNumber, lf);
+		bctbx_free(normalizedPhoneNumber);
+	}
+}
+
+const std::unordered_map<std::string, std::shared_ptr<Friend>> &
+FriendList::getFriendsMapByPhoneNumber(const std::shared_ptr<Account> &account) const {
+	const std::string key = getPhoneNumbersMapKey(account);
+	auto it = mFriendsMapsByPhoneNumber.find(key);
+	if (it != mFriendsMapsByPhoneNumber.end()) return it->second.friends;
+
+	PhoneNumbersMap &map = mFriendsMapsByPhoneNumber[key];
+	map.account = account;
+	// The first friend of the list having a phone number wins, as when looking for it linearly.
+	for (const auto &lf : mFriends)
+		addPhoneNumbersToMap(account, lf, map.friends, false);
+	return map.friends;
 }
 
 std::shared_ptr<Address> FriendList::getRlsAddressWithCoreFallback() const {
@@ -609,6 +647,15 @@ LinphoneFriendListStatus FriendList::importFriend(const std::shared_ptr<Friend>
 	lf->mFriendList = this;
 	mFriends.push_front(lf);
 	lf->addAddressesAndNumbersIntoMaps(getSharedFromThis());
+	mSearchIndex.invalidate(lf);
+	// The imported friend is the first of the list, its phone numbers take precedence.
+	for (auto it = mFriendsMapsByPhoneNumber.begin(); it != mFriendsMapsByPhoneNumber.end();) {
+		const std::shared_ptr<Account> account = it->second.account.lock();
+		if (account && getPhoneNumbersMapKey(account) == it->first) {
+			addPhoneNumbersToMap(account, lf, it->second.friends, true);
+			it++;
+		} else it = mFriendsMapsByPhoneNumber.erase(it);
+	}
 	if (synchronize) {
 		mDirtyFriendsToUpdate.push_front(lf);
 		mBctbxDirtyFriendsToUpdate = bctbx_list_prepend(mBctbxDirtyFriendsToUpdate, lf->toC());
@@ -637,6 +684,13 @@ void FriendList::invalidateFriendsMaps() {
 	mFriendsMapByUri.clear();
 	for (const auto &f : mFriends)
 		f->addAddressesAndNumbersIntoMaps(getSharedFromThis());
+	invalidatePhoneNumbersMaps();
+	// Normalized phone numbers depend on the default account too.
+	mSearchIndex.invalidateAll(mFriends);
+}
+
+void FriendList::invalidatePhoneNumbersMaps() {
+	mFriendsMapsByPhoneNumber.clear();
 }
 
 void FriendList::invalidateSubscriptions() {
@@ -778,8 +832,8 @@ void FriendList::parseMultipartRelatedBody(const std::shared_ptr<const Content>
 							if (addr->hasUriParam("gr")) addr->removeUriParam("gr");
 							uri = addr->asStringUriOnly();
 
-							const auto [first, last] = mFriendsMapByUri.equal_range(uri);
-							if (first == last) {
+							const auto mapIt = mFriendsMapByUri.find(uri);
+							if (mapIt == mFriendsMapByUri.cend()) {
 								if (mBodylessSubscription) {
 									std::shared_ptr<Friend> lf = Friend::create(getCore(), uri);
 									addFriend(lf);
@@ -789,16 +843,14 @@ void FriendList::parseMultipartRelatedBody(const std::shared_ptr<const Content>
 									listFriendsPresenceReceived.insert(lf);
 								}
 							} else {
-								// Save the equal_range iterators for looping because mFriendsMapByUri might
-								// change during the loop, leading to wrong presence notifications
-								std::list<std::multimap<std::string, std::shared_ptr<Friend>>::iterator> its;
-								for (auto it = first; it != last; it++)
-									its.push_back(it);
-								for (const auto &it : its) {
-									it->second->presenceReceived(
+								// Copy the friends for looping because mFriendsMapByUri might change during the
+								// loop, leading to wrong presence notifications
+								const std::vector<std::shared_ptr<Friend>> friends = mapIt->second;
+								for (const auto &f : friends) {
+									f->presenceReceived(
 									    getSharedFromThis(), uri,
 									    PresenceModel::toCpp((LinphonePresenceModel *)presence)->getSharedFromThis());
-									listFriendsPresenceReceived.insert(it->second);
+									listFriendsPresenceReceived.insert(f);
 								}
 							}
 
@@ -858,22 +910,17 @@ void FriendList::deleteFriend(const std::shared_ptr<Friend> &lf, bool removeFrom
 
 	std::list<std::string> phoneNumbers = lf->getPhoneNumbers();
 	for (const auto &phoneNumber : phoneNumbers) {
-		const std::string uri = lf->phoneNumberToSipUri(phoneNumber);
-		if (!uri.empty()) {
-			const auto mapIt = mFriendsMapByUri.find(uri);
-			if (mapIt != mFriendsMapByUri.cend()) mFriendsMapByUri.erase(mapIt);
-		}
+		lf->removeFriendFromListMapIfAlreadyInIt(lf->phoneNumberToSipUri(phoneNumber));
 	}
+	// Another friend of the list may share a phone number with the removed one.
+	if (!phoneNumbers.empty()) invalidatePhoneNumbersMaps();
 
 	std::list<std::shared_ptr<Address>> addresses = lf->getAddresses();
 	for (const auto &address : addresses) {
-		const std::string uri = address->asStringUriOnly();
-		if (!uri.empty()) {
-			const auto mapIt = mFriendsMapByUri.find(uri);
-			if (mapIt != mFriendsMapByUri.cend()) mFriendsMapByUri.erase(mapIt);
-		}
+		lf->removeFriendFromListMapIfAlreadyInIt(address->asStringUriOnly());
 	}
 
+	mSearchIndex.remove(lf.get());
 	lf->mFriendList = nullptr;
 }
 
@@ -984,6 +1031,8 @@ void FriendList::sendListSubscriptionWithoutBody(const std::shared_ptr<Address>
 
 void FriendList::setFriends(const std::list<std::shared_ptr<Friend>> &friends) {
 	mFriends = friends;
+	invalidatePhoneNumbersMaps();
+	mSearchIndex.invalidateAll(mFriends);
 }
 
 void FriendList::syncBctbxFriends() const {
@@ -1078,6 +1127,9 @@ void FriendList::carddavUpdated(const CardDAVContext *context,
 	auto it = std::find_if(context->mFriendList->mFriends.begin(), context->mFriendList->mFriends.end(),
 	                       [&](const auto &elem) { return elem == oldFriend; });
 	if (it != context->mFriendList->mFriends.end()) *it = newFriend;
+	context->mFriendList->invalidatePhoneNumbersMaps();
+	context->mFriendList->mSearchIndex.remove(oldFriend.get());
+	context->mFriendList->mSearchIndex.invalidate(newFriend);
 	newFriend->saveInDb();
 	LINPHONE_HYBRID_OBJECT_INVOKE_CBS(FriendList, context->mFriendList, linphone_friend_list_cbs_get_contact_updated,
 	                                  newFriend->toC(), oldFriend->toC());
@@ -21,7 +21,11 @@
 #ifndef _L_FRIEND_LIST_H_
 #define _L_FRIEND_LIST_H_
 
+#include <unordered_map>
+#include <vector>
+
 #include "c-wrapper/c-wrapper.h"
+#include "search/friend-search-index.h"
 
 // =============================================================================
 
@@ -115,6 +119,8 @@ public:
 	std::shared_ptr<Friend> findFriendByRefKey(const std::string &refKey) const;
 	std::shared_ptr<Friend> findFriendByUri(const std::string &uri) const;
 	std::list<std::shared_ptr<Friend>> findFriendsByAddress(const std::shared_ptr<const Address> &address) const;
+	// Friends which may match a MagicSearch filter, all of them if the filter is empty.
+	std::list<std::shared_ptr<Friend>> findFriendsBySearchFilter(const std::string &filter) const;
 	std::list<std::shared_ptr<Friend>> findFriendsByUri(const std::string &uri) const;
 	LinphoneStatus importFriendsFromVcard4Buffer(const std::string &vcardBuffer);
 	LinphoneStatus importFriendsFromVcard4File(const std::string &vcardFile);
@@ -134,11 +140,14 @@ private:
 	std::shared_ptr<Friend> findFriendByOutSubscribe(SalOp *op) const;
 	std::shared_ptr<Friend> findFriendByPhoneNumber(const std::shared_ptr<Account> &account,
 	                                                const std::string &normalizedPhoneNumber) const;
+	const std::unordered_map<std::string, std::shared_ptr<Friend>> &
+	getFriendsMapByPhoneNumber(const std::shared_ptr<Account> &account) const;
 	std::shared_ptr<Address> getRlsAddressWithCoreFallback() const;
 	bool hasSubscribeInactive() const;
 	LinphoneFriendListStatus importFriend(const std::shared_ptr<Friend> &lf, bool synchronize);
 	LinphoneStatus importFriendsFromVcard4(const std::list<std::shared_ptr<Vcard>> &vcards);
 	void invalidateFriendsMaps();
+	void invalidatePhoneNumbersMaps();
 	void invalidateSubscriptions();
 	void notifyPresenceReceived(const std::shared_ptr<const Content> &content);
 	void parseMultipartRelatedBody(const std::shared_ptr<const Content> &content, const std::string &firstPartBody);
@@ -172,8 +181,17 @@ private:
 	std::shared_ptr<Address> mRlsAddr;
 	std::list<std::shared_ptr<Friend>> mFriends;
 	mutable bctbx_list_t *mBctbxFriends = nullptr; // This field must be kept in sync with mFriends
-	std::map<std::string, std::shared_ptr<Friend>> mFriendsMapByRefKey;
-	std::multimap<std::string, std::shared_ptr<Friend>> mFriendsMapByUri;
+	struct PhoneNumbersMap {
+		std::weak_ptr<Account> account; // Any account with the dial plan settings of the key of this map.
+		std::unordered_map<std::string, std::shared_ptr<Friend>> friends;
+	};
+
+	std::unordered_map<std::string, std::shared_ptr<Friend>> mFriendsMapByRefKey;
+	// Friends sharing a URI are kept in the order they were added.
+	std::unordered_map<std::string, std::vector<std::shared_ptr<Friend>>> mFriendsMapByUri;
+	// Built on demand, one map for each dial plan settings used to normalize phone numbers.
+	mutable std::unordered_map<std::string, PhoneNumbersMap> mFriendsMapsByPhoneNumber;
+	mutable FriendSearchIndex mSearchIndex;
 	std::array<unsigned char, 16> *mContentDigest = nullptr;
 	int mExpectedNotificationVersion;
 	long long mStorageId = -1;
@@ -73,7 +73,7 @@ Friend::Friend(std::shared_ptr<Core> core, const std::shared_ptr<Vcard> &vcard)
 
 Friend::~Friend() {
 	releaseOps();
-	clearPresenceModels();
+	mPresenceModels.clear();
 	if (mInfo) buddy_info_free(mInfo);
 	if (mBctbxAddresses) bctbx_list_free(mBctbxAddresses);
 }
@@ -114,6 +114,7 @@ LinphoneStatus Friend::setAddress(const std::shared_ptr<const Address> &address)
 	} else {
 		mUri = newAddress->getSharedFromThis();
 	}
+	invalidateSearchIndex();
 
 	return 0;
 }
@@ -144,6 +145,7 @@ LinphoneStatus Friend::setName(const std::string &name) {
 		}
 		mUri->setDisplayName(name);
 	}
+	invalidateSearchIndex();
 	return 0;
 }
 
@@ -154,6 +156,7 @@ void Friend::setNativeUri(const std::string &nativeUri) {
 void Friend::setOrganization(const std::string &organization) {
 	if (linphone_core_vcard_supported() && mVcard) {
 		mVcard->setOrganization(organization);
+		invalidateSearchIndex();
 	}
 }
 
@@ -194,6 +197,7 @@ void Friend::setVcard(const std::shared_ptr<Vcard> &vcard) {
 	}
 
 	mVcard = vcard;
+	invalidateSearchIndex(true);
 	if (mFriendList) saveInDb();
 }
 
@@ -522,6 +526,7 @@ void Friend::addAddress(const std::shared_ptr<const Address> &address) {
 		if (mVcard) mVcard->addSipAddress(uri);
 	} else if (!mUri) mUri = newAddr;
 	newAddr->unref();
+	invalidateSearchIndex();
 }
 
 void Friend::addPhoneNumber(const std::string &phoneNumber) {
@@ -534,6 +539,7 @@ void Friend::addPhoneNumber(const std::string &phoneNumber) {
 		if (!mVcard) createVcard(phoneNumber);
 		if (mVcard) mVcard->addPhoneNumber(phoneNumber);
 	}
+	invalidateSearchIndex(true);
 }
 
 void Friend::addPhoneNumberWithLabel(const std::shared_ptr<const FriendPhoneNumber> &phoneNumber) {
@@ -545,6 +551,7 @@ void Friend::addPhoneNumberWithLabel(const std::shared_ptr<const FriendPhoneNumb
 		if (!mVcard) createVcard(phone);
 		if (mVcard) mVcard->addPhoneNumberWithLabel(phoneNumber);
 	}
+	invalidateSearchIndex(true);
 }
 
 bool Friend::createVcard(const std::string &name) {
@@ -580,6 +587,7 @@ void Friend::done() {
 			}
 		}
 	}
+	invalidateSearchIndex(true);
 	apply();
 	if (mFriendList) saveInDb();
 }
@@ -694,6 +702,7 @@ void Friend::removeAddress(const std::shared_ptr<const Address> &address) {
 	if (linphone_core_vcard_supported() && mVcard) {
 		mVcard->removeSipAddress(uri);
 	}
+	invalidateSearchIndex();
 }
 
 void Friend::removePhoneNumber(const std::string &phoneNumber) {
@@ -703,6 +712,7 @@ void Friend::removePhoneNumber(const std::string &phoneNumber) {
 	if (linphone_core_vcard_supported() && mVcard) {
 		mVcard->removePhoneNumber(phoneNumber);
 	}
+	invalidateSearchIndex(true);
 }
 
 void Friend::removePhoneNumberWithLabel(const std::shared_ptr<const FriendPhoneNumber> &phoneNumber) {
@@ -715,6 +725,7 @@ void Friend::removePhoneNumberWithLabel(const std::shared_ptr<const FriendPhoneN
 	if (linphone_core_vcard_supported() && mVcard) {
 		mVcard->removePhoneNumberWithLabel(phoneNumber);
 	}
+	invalidateSearchIndex(true);
 }
 
 bool Friend::subscribesEnabled() const {
@@ -739,13 +750,9 @@ void Friend::addAddressesAndNumbersIntoMaps(const std::shared_ptr<FriendList> &l
 
 void Friend::addFriendToListMapIfNotInItYet(const std::string &uri) {
 	if (!mFriendList || uri.empty()) return;
-	bool found = false;
-	for (auto [it, rangeEnd] = mFriendList->mFriendsMapByUri.equal_range(uri); it != rangeEnd; it++) {
-		if (it->second == getSharedFromThis()) found = true;
-	}
-	if (!found) {
-		mFriendList->mFriendsMapByUri.insert({uri, getSharedFromThis()});
-	}
+	auto &friends = mFriendList->mFriendsMapByUri[uri];
+	const std::shared_ptr<Friend> lf = getSharedFromThis();
+	if (std::find(friends.cbegin(), friends.cend(), lf) == friends.cend()) friends.push_back(lf);
 }
 
 void Friend::addIncomingSubscription(SalOp *op) {
@@ -764,6 +771,8 @@ void Friend::addPresenceModelForUriOrTel(const std::string &uriOrTel, const std:
 	} else {
 		it->second = model;
 	}
+	// The presence contact of a phone number is searchable.
+	invalidateSearchIndex();
 }
 
 void Friend::apply() {
@@ -810,6 +819,7 @@ void Friend::apply() {
 
 void Friend::clearPresenceModels() {
 	mPresenceModels.clear();
+	invalidateSearchIndex();
 }
 
 void Friend::closeIncomingSubscriptions() {
@@ -954,13 +964,10 @@ void Friend::presenceReceived(const std::shared_ptr<FriendList> list,
 		sipAddress->clean(); // To get rid of ;user=phone at the end
 
 		const std::string &sipUri = sipAddress->asStringUriOnly();
-		bool foundFriendWithSipUri = false;
-		for (auto [it, rangeEnd] = list->mFriendsMapByUri.equal_range(sipUri); it != rangeEnd; it++) {
-			if (it->second == getSharedFromThis()) foundFriendWithSipUri = true;
-		}
-		if (!foundFriendWithSipUri) {
-			list->mFriendsMapByUri.insert({sipUri, getSharedFromThis()});
-		}
+		auto &friends = list->mFriendsMapByUri[sipUri];
+		const bool foundFriendWithSipUri =
+		    std::find(friends.cbegin(), friends.cend(), getSharedFromThis()) != friends.cend();
+		if (!foundFriendWithSipUri) friends.push_back(getSharedFromThis());
 
 		setPresenceModelForUriOrTel(phoneNumber, model);
 		if (!foundFriendWithSipUri) {
@@ -997,11 +1004,17 @@ void Friend::removeFromDb() {
 
 void Friend::removeFriendFromListMapIfAlreadyInIt(const std::string &uri) {
 	if (!mFriendList || uri.empty()) return;
-	for (auto [it, rangeEnd] = mFriendList->mFriendsMapByUri.equal_range(uri); it != rangeEnd;) {
-		if (it->second == getSharedFromThis()) {
-			it = mFriendList->mFriendsMapByUri.erase(it);
-		} else it++;
-	}
+	const auto mapIt = mFriendList->mFriendsMapByUri.find(uri);
+	if (mapIt == mFriendList->mFriendsMapByUri.end()) return;
+	auto &friends = mapIt->second;
+	friends.erase(std::remove(friends.begin(), friends.end(), getSharedFromThis()), friends.end());
+	if (friends.empty()) mFriendList->mFriendsMapByUri.erase(mapIt);
+}
+
+void Friend::invalidateSearchIndex(bool phoneNumbersChanged) {
+	if (!mFriendList) return;
+	mFriendList->mSearchIndex.invalidate(getSharedFromThis());
+	if (phoneNumbersChanged) mFriendList->invalidatePhoneNumbersMaps();
 }
 
 void Friend::removeIncomingSubscription(SalOp *op) {
@@ -162,6 +162,7 @@ private:
 	void closeSubscriptions();
 	void doSubscribe();
 	bool hasPhoneNumber(const std::shared_ptr<Account> &account, const std::string &searchedPhoneNumber) const;
+	void invalidateSearchIndex(bool phoneNumbersChanged = false);
 	void invalidateSubscription();
 	void notify(const std::shared_ptr<PresenceModel> &presence);
 	const std::string &phoneNumberToSipUri(const std::string &phoneNumber) const;
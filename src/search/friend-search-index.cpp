@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2010-2022 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "account/account.h"
+#include "address/address.h"
+#include "core/core.h"
+#include "friend-search-index.h"
+#include "friend/friend.h"
+#include "linphone/core.h"
+#include "vcard/vcard.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+void FriendSearchIndex::invalidate(const shared_ptr<Friend> &f) {
+	auto it = mEntries.find(f.get());
+	if (it == mEntries.end()) {
+		it = mEntries.emplace(f.get(), Entry()).first;
+		it->second.order = mNextOrder++;
+	}
+	it->second.lFriend = f;
+	mDirty.insert(f.get());
+}
+
+void FriendSearchIndex::invalidateAll(const list<shared_ptr<Friend>> &friends) {
+	clear();
+	// The front of a friend list is its most recently added friend.
+	for (auto it = friends.crbegin(); it != friends.crend(); ++it)
+		invalidate(*it);
+}
+
+void FriendSearchIndex::remove(const Friend *f) {
+	auto it = mEntries.find(f);
+	if (it == mEntries.end()) return;
+	unindexEntry(it->second);
+	mEntries.erase(it);
+	mDirty.erase(f);
+}
+
+void FriendSearchIndex::clear() {
+	mEntries.clear();
+	mDirty.clear();
+	mPostings.clear();
+	mLivePostings = 0;
+	mStalePostings = 0;
+}
+
+list<shared_ptr<Friend>> FriendSearchIndex::findCandidates(const string &filter) {
+	flush();
+
+	string filterLC = filter;
+	transform(filterLC.begin(), filterLC.end(), filterLC.begin(), [](unsigned char c) { return tolower(c); });
+
+	// Short filters are grams themselves, longer ones are looked up by their least common trigram.
+	const vector<const Friend *> *posting = nullptr;
+	const size_t gramLength = min(filterLC.size(), MaxGramLength);
+	for (size_t i = 0; i + gramLength <= filterLC.size(); ++i) {
+		auto it = mPostings.find(filterLC.substr(i, gramLength));
+		if (it == mPostings.end()) return list<shared_ptr<Friend>>();
+		if (!posting || it->second.size() < posting->size()) posting = &it->second;
+	}
+
+	vector<const Entry *> matches;
+	if (posting) {
+		unordered_set<const Friend *> seen;
+		for (const Friend *key : *posting) {
+			if (!seen.insert(key).second) continue;
+			auto it = mEntries.find(key);
+			if (it != mEntries.end() && it->second.text.find(filterLC) != string::npos) matches.push_back(&it->second);
+		}
+	}
+	sort(matches.begin(), matches.end(), [](const Entry *a, const Entry *b) { return a->order > b->order; });
+
+	list<shared_ptr<Friend>> candidates;
+	for (const Entry *entry : matches)
+		candidates.push_back(entry->lFriend);
+	return candidates;
+}
+
+// -----------------------------------------------------------------------------
+
+string FriendSearchIndex::computeText(const shared_ptr<Friend> &f) {
+	string text;
+	auto append = [&text](const string &field) {
+		if (field.empty()) return;
+		if (!text.empty()) text += '\n';
+		text += field;
+	};
+
+	if (linphone_core_vcard_supported() && f->getVcard()) {
+		append(f->getVcard()->getFullName());
+		append(f->getVcard()->getOrganization());
+	}
+
+	for (const auto &address : f->getAddresses()) {
+		append(address->getUsername());
+		append(address->getDisplayName());
+	}
+
+	const auto &account = f->getCore()->getDefaultAccount();
+	for (const auto &phoneNumber : f->getPhoneNumbers()) {
+		append(phoneNumber);
+		if (account) {
+			char *normalized = linphone_account_normalize_phone_number(account->toC(), phoneNumber.c_str());
+			if (normalized) {
+				append(normalized);
+				bctbx_free(normalized);
+			}
+		}
+		const LinphonePresenceModel *presence =
+		    linphone_friend_get_presence_model_for_uri_or_tel(f->toC(), phoneNumber.c_str());
+		char *contact = presence ? linphone_presence_model_get_contact(presence) : nullptr;
+		if (contact) {
+			append(contact);
+			bctbx_free(contact);
+		}
+	}
+
+	transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return tolower(c); });
+	return text;
+}
+
+unordered_set<string> FriendSearchIndex::computeGrams(const string &text) {
+	unordered_set<string> grams;
+	for (size_t i = 0; i < text.size(); ++i) {
+		for (size_t length = 1; length <= MaxGramLength && i + length <= text.size(); ++length) {
+			if (text[i + length - 1] == '\n') break;
+			grams.insert(text.substr(i, length));
+		}
+	}
+	return grams;
+}
+
+void FriendSearchIndex::indexEntry(const Friend *key, Entry &entry) {
+	unindexEntry(entry);
+	entry.text = computeText(entry.lFriend);
+	const unordered_set<string> grams = computeGrams(entry.text);
+	for (const auto &gram : grams)
+		mPostings[gram].push_back(key);
+	entry.gramCount = grams.size();
+	entry.indexed = true;
+	mLivePostings += entry.gramCount;
+}
+
+void FriendSearchIndex::unindexEntry(Entry &entry) {
+	if (!entry.indexed) return;
+	mLivePostings -= entry.gramCount;
+	mStalePostings += entry.gramCount;
+	entry.gramCount = 0;
+	entry.indexed = false;
+}
+
+void FriendSearchIndex::flush() {
+	for (const Friend *key : mDirty) {
+		auto it = mEntries.find(key);
+		if (it != mEntries.end()) indexEntry(key, it->second);
+	}
+	mDirty.clear();
+	if (mStalePostings > mLivePostings) compact();
+}
+
+void FriendSearchIndex::compact() {
+	mPostings.clear();
+	mLivePostings = 0;
+	mStalePostings = 0;
+	for (auto &[key, entry] : mEntries) {
+		const unordered_set<string> grams = computeGrams(entry.text);
+		for (const auto &gram : grams)
+			mPostings[gram].push_back(key);
+		mLivePostings += grams.size();
+	}
+}
+
+LINPHONE_END_NAMESPACE
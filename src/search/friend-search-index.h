@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2010-2022 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_FRIEND_SEARCH_INDEX_H_
+#define _L_FRIEND_SEARCH_INDEX_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+class Friend;
+
+// N-gram index of the fields of the friends of a list that MagicSearch matches a filter against: vCard name and
+// organization, SIP usernames and display names, phone numbers (raw and normalized) and their presence contacts.
+// Friends are (re)indexed lazily, at the first search following their invalidation.
+class FriendSearchIndex {
+public:
+	void invalidate(const std::shared_ptr<Friend> &f);
+	void invalidateAll(const std::list<std::shared_ptr<Friend>> &friends);
+	void remove(const Friend *f);
+	void clear();
+
+	// Returns the friends which may match the filter, in the order of the list. The caller still has to compute
+	// the weight of each of them, the index only prunes the friends that cannot match.
+	std::list<std::shared_ptr<Friend>> findCandidates(const std::string &filter);
+
+private:
+	struct Entry {
+		std::shared_ptr<Friend> lFriend;
+		std::string text; // Lower case searchable fields, separated by '\n'.
+		unsigned long long order = 0;
+		size_t gramCount = 0;
+		bool indexed = false;
+	};
+
+	static constexpr size_t MaxGramLength = 3;
+
+	static std::string computeText(const std::shared_ptr<Friend> &f);
+	static std::unordered_set<std::string> computeGrams(const std::string &text);
+
+	void indexEntry(const Friend *key, Entry &entry);
+	void unindexEntry(Entry &entry);
+	void flush();
+	void compact();
+
+	std::unordered_map<const Friend *, Entry> mEntries;
+	std::unordered_set<const Friend *> mDirty;
+	// Postings may reference entries which were removed or reindexed since, they are checked against the entry text.
+	std::unordered_map<std::string, std::vector<const Friend *>> mPostings;
+	size_t mLivePostings = 0;
+	size_t mStalePostings = 0;
+	unsigned long long mNextOrder = 0;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_FRIEND_SEARCH_INDEX_H_
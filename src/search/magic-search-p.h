@@ -24,10 +24,19 @@
 #include "magic-search.h"
 #include "object/object-p.h"
 #include "search-async-data.h"
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 LINPHONE_BEGIN_NAMESPACE
 
+// Address gathered from the call logs, chat rooms or conferences info.
+struct MagicSearchCandidate {
+	std::shared_ptr<Address> address;
+	std::string key;             // Equal for weakly equal addresses.
+	bool matchAnyDomain = false; // Basic chat rooms peers are listed whatever the domain when there is no filter.
+};
+
 class MagicSearchPrivate : public ObjectPrivate {
 private:
 	unsigned int mMaxWeight;
@@ -43,6 +52,10 @@ private:
 	belle_sip_source_t *mIteration;
 
 	std::shared_ptr<std::list<std::shared_ptr<SearchResult>>> mCacheResult;
+
+	// Candidates of each source, kept between keystrokes as long as the filter is refined.
+	mutable std::unordered_map<int, std::vector<MagicSearchCandidate>> mCandidates;
+	mutable std::string mCandidatesFilter;
 	SearchAsyncData mAsyncData;
 
 	L_DECLARE_PUBLIC(MagicSearch);
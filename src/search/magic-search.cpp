@@ -19,11 +19,13 @@
  */
 
 #include <algorithm>
+#include <unordered_set>
 
 #include "bctoolbox/defs.h"
 #include <bctoolbox/list.h>
 
 #include "../ldap/ldap.h"
+#include "address/address.h"
 #include "c-wrapper/c-wrapper.h"
 #include "c-wrapper/internal/c-tools.h"
 #include "friend/friend-list.h"
@@ -133,6 +135,8 @@ void MagicSearch::resetSearchCache() {
 	if (d->mCacheResult) {
 		d->mCacheResult = nullptr;
 	}
+	d->mCandidates.clear();
+	d->mCandidatesFilter.clear();
 }
 
 #ifdef LDAP_ENABLED
@@ -232,7 +236,7 @@ list<std::shared_ptr<SearchResult>> MagicSearch::getContactListFromFilter(const
 	if (d->mAutoResetCache) resetSearchCache();
 	if (getSearchCache() != nullptr && !filter.empty()) {
 		resultList = continueSearch(filter, withDomain);
-		resetSearchCache();
+		setSearchCache(nullptr);
 	} else {
 		resultList = beginNewSearch(filter, withDomain, sourceFlags);
 	}
@@ -247,7 +251,7 @@ bool MagicSearch::getContactListFromFilterStartAsync(const SearchRequest &reques
 	std::shared_ptr<list<std::shared_ptr<SearchResult>>> returnList = nullptr;
 	if (getSearchCache() != nullptr && !request.getFilter().empty()) {
 		returnList = continueSearch(request.getFilter(), request.getWithDomain());
-		resetSearchCache();
+		setSearchCache(nullptr);
 	} else {
 		beginNewSearchAsync(request, asyncData);
 	}
@@ -388,178 +392,146 @@ void MagicSearch::setSearchCache(std::shared_ptr<list<std::shared_ptr<SearchResu
 	if (d->mCacheResult != cache) d->mCacheResult = cache;
 }
 
-static bool findAddress(const list<std::shared_ptr<SearchResult>> &list, const LinphoneAddress *addr) {
-	for (auto r : list) {
-		if (r->getAddress()) {
-			if (linphone_address_weak_equal(r->getAddress(), addr)) {
-				return true;
-			}
-		}
+// Two addresses have the same key if and only if linphone_address_weak_equal() is true.
+static string getAddressKey(const LinphoneAddress *lAddress) {
+	const char *domain = linphone_address_get_domain(lAddress);
+	if (!domain) {
+		char *uri = linphone_address_as_string_uri_only(lAddress);
+		string key = uri ? uri : "";
+		bctbx_free(uri);
+		transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return tolower(c); });
+		return key;
 	}
-	return false;
+	const char *username = linphone_address_get_username(lAddress);
+	return string("sip:") + (username ? string(username) + "@" : string()) + domain + ":" +
+	       to_string(linphone_address_get_port(lAddress));
 }
 
-list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromCallLog(
-    const string &filter, const string &withDomain, const list<std::shared_ptr<SearchResult>> &currentList) const {
-	list<std::shared_ptr<SearchResult>> resultList;
-	const bctbx_list_t *callLog = linphone_core_get_call_logs(this->getCore()->getCCore());
-
-	// For all call log or when we reach the search limit
-	for (const bctbx_list_t *f = callLog; f != nullptr; f = bctbx_list_next(f)) {
-		LinphoneCallLog *log = static_cast<LinphoneCallLog *>(f->data);
-		if (!linphone_call_log_was_conference(log)) {
-			const LinphoneAddress *addr = (linphone_call_log_get_dir(log) == LinphoneCallDir::LinphoneCallIncoming)
-			                                  ? linphone_call_log_get_from_address(log)
-			                                  : linphone_call_log_get_to_address(log);
-			if (addr && linphone_call_log_get_status(log) != LinphoneCallAborted) {
-				if (filter.empty() && withDomain.empty()) {
-					if (findAddress(currentList, addr)) continue;
-					resultList.push_back(
-					    SearchResult::create((unsigned int)0, addr, "", nullptr, LinphoneMagicSearchSourceCallLogs));
-				} else {
-					unsigned int weight = searchInAddress(addr, filter, withDomain);
-					if (weight > getMinWeight()) {
-						if (findAddress(currentList, addr)) continue;
-						resultList.push_back(
-						    SearchResult::create(weight, addr, "", nullptr, LinphoneMagicSearchSourceCallLogs));
-					}
-				}
-			}
-		}
+void MagicSearch::indexResults(const list<std::shared_ptr<SearchResult>> &results, AddressIndex &index) {
+	for (const auto &r : results) {
+		if (r->getAddress()) index.emplace(getAddressKey(r->getAddress()), r);
 	}
+}
 
-	lInfo() << "[Magic Search] Found " << resultList.size() << " results in call logs";
-	return resultList;
+static void addCandidate(vector<MagicSearchCandidate> &candidates,
+                         unordered_set<string> &keys,
+                         const LinphoneAddress *addr,
+                         bool matchAnyDomain = false) {
+	MagicSearchCandidate candidate;
+	candidate.key = getAddressKey(addr);
+	// Same address with the same display name gives the same result, keep it once.
+	const char *displayName = linphone_address_get_display_name(addr);
+	if (!keys.insert(candidate.key + "\n" + (displayName ? displayName : "") + (matchAnyDomain ? "*" : "")).second)
+		return;
+	candidate.address = Address::toCpp(addr)->clone()->toSharedPtr();
+	candidate.matchAnyDomain = matchAnyDomain;
+	candidates.push_back(std::move(candidate));
 }
 
-list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromGroupChatRoomParticipants(
-    const string &filter, const string &withDomain, const list<std::shared_ptr<SearchResult>> &currentList) const {
-	list<std::shared_ptr<SearchResult>> resultList;
-	const bctbx_list_t *chatRooms = linphone_core_get_chat_rooms(this->getCore()->getCCore());
+void MagicSearch::updateCandidatesCache(const string &filter) const {
+	L_D();
+	// Until resetSearchCache(), typing more characters keeps the candidates, any other change gathers them again.
+	if (filter.compare(0, d->mCandidatesFilter.size(), d->mCandidatesFilter) != 0) d->mCandidates.clear();
+	d->mCandidatesFilter = filter;
+}
 
-	// For all call log or when we reach the search limit
-	for (const bctbx_list_t *f = chatRooms; f != nullptr; f = bctbx_list_next(f)) {
-		LinphoneChatRoom *room = static_cast<LinphoneChatRoom *>(f->data);
-		if (linphone_chat_room_get_capabilities(room) & LinphoneChatRoomCapabilitiesConference) {
-			bctbx_list_t *participants = linphone_chat_room_get_participants(room);
-			for (const bctbx_list_t *p = participants; p != nullptr; p = bctbx_list_next(p)) {
-				LinphoneParticipant *participant = static_cast<LinphoneParticipant *>(p->data);
-				const LinphoneAddress *addr = linphone_address_clone(linphone_participant_get_address(participant));
-				if (filter.empty() && withDomain.empty()) {
-					if (findAddress(currentList, addr)) {
-						linphone_address_unref(const_cast<LinphoneAddress *>(addr));
-						continue;
-					}
-					resultList.push_back(
-					    SearchResult::create((unsigned int)0, addr, "", nullptr, LinphoneMagicSearchSourceChatRooms));
-				} else {
-					unsigned int weight = searchInAddress(addr, filter, withDomain);
-					if (weight > getMinWeight()) {
-						if (findAddress(currentList, addr)) {
-							linphone_address_unref(const_cast<LinphoneAddress *>(addr));
-							continue;
-						}
-						resultList.push_back(
-						    SearchResult::create(weight, addr, "", nullptr, LinphoneMagicSearchSourceChatRooms));
-					}
-				}
-				if (addr) {
-					linphone_address_unref(const_cast<LinphoneAddress *>(addr));
-				}
+const vector<MagicSearchCandidate> &MagicSearch::getCandidates(int source) const {
+	L_D();
+	auto it = d->mCandidates.find(source);
+	if (it != d->mCandidates.end()) return it->second;
+
+	vector<MagicSearchCandidate> &candidates = d->mCandidates[source];
+	unordered_set<string> keys;
+	LinphoneCore *lc = this->getCore()->getCCore();
+	if (source == LinphoneMagicSearchSourceCallLogs) {
+		for (const bctbx_list_t *f = linphone_core_get_call_logs(lc); f != nullptr; f = bctbx_list_next(f)) {
+			LinphoneCallLog *log = static_cast<LinphoneCallLog *>(f->data);
+			if (!linphone_call_log_was_conference(log)) {
+				const LinphoneAddress *addr = (linphone_call_log_get_dir(log) == LinphoneCallDir::LinphoneCallIncoming)
+				                                  ? linphone_call_log_get_from_address(log)
+				                                  : linphone_call_log_get_to_address(log);
+				if (addr && linphone_call_log_get_status(log) != LinphoneCallAborted)
+					addCandidate(candidates, keys, addr);
 			}
-			bctbx_list_free_with_data(participants, (bctbx_list_free_func)linphone_participant_unref);
-		} else if (linphone_chat_room_get_capabilities(room) & LinphoneChatRoomCapabilitiesBasic) {
-			const LinphoneAddress *peerAddress =
-			    linphone_chat_room_get_peer_address(room); // Can return NULL if getPeerAddress() is not valid
-			if (peerAddress) {
-				LinphoneAddress *addr = linphone_address_clone(peerAddress);
-				if (filter.empty()) {
-					if (findAddress(currentList, addr)) {
-						linphone_address_unref(addr);
-						continue;
-					}
-					resultList.push_back(
-					    SearchResult::create((unsigned int)0, addr, "", nullptr, LinphoneMagicSearchSourceChatRooms));
-				} else {
-					unsigned int weight = searchInAddress(addr, filter, withDomain);
-					if (weight > getMinWeight()) {
-						if (findAddress(currentList, addr)) {
-							linphone_address_unref(addr);
-							continue;
-						}
-						resultList.push_back(
-						    SearchResult::create(weight, addr, "", nullptr, LinphoneMagicSearchSourceChatRooms));
-					}
+		}
+	} else if (source == LinphoneMagicSearchSourceChatRooms) {
+		for (const bctbx_list_t *f = linphone_core_get_chat_rooms(lc); f != nullptr; f = bctbx_list_next(f)) {
+			LinphoneChatRoom *room = static_cast<LinphoneChatRoom *>(f->data);
+			if (linphone_chat_room_get_capabilities(room) & LinphoneChatRoomCapabilitiesConference) {
+				bctbx_list_t *participants = linphone_chat_room_get_participants(room);
+				for (const bctbx_list_t *p = participants; p != nullptr; p = bctbx_list_next(p)) {
+					LinphoneParticipant *participant = static_cast<LinphoneParticipant *>(p->data);
+					const LinphoneAddress *addr = linphone_participant_get_address(participant);
+					if (addr) addCandidate(candidates, keys, addr);
 				}
-				linphone_address_unref(addr);
+				bctbx_list_free_with_data(participants, (bctbx_list_free_func)linphone_participant_unref);
+			} else if (linphone_chat_room_get_capabilities(room) & LinphoneChatRoomCapabilitiesBasic) {
+				const LinphoneAddress *peerAddress =
+				    linphone_chat_room_get_peer_address(room); // Can return NULL if getPeerAddress() is not valid
+				if (peerAddress) addCandidate(candidates, keys, peerAddress, true);
+			}
+		}
+	} else if (source == LinphoneMagicSearchSourceConferencesInfo) {
+		for (const bctbx_list_t *f = linphone_core_get_conference_information_list(lc); f != nullptr;
+		     f = bctbx_list_next(f)) {
+			LinphoneConferenceInfo *info = static_cast<LinphoneConferenceInfo *>(f->data);
+			const LinphoneAddress *organizer = linphone_conference_info_get_organizer(info);
+			if (organizer) addCandidate(candidates, keys, organizer);
+
+			const bctbx_list_t *participants = linphone_conference_info_get_participant_infos(info);
+			for (const bctbx_list_t *p = participants; p != nullptr; p = bctbx_list_next(p)) {
+				LinphoneParticipantInfo *participantInfo = static_cast<LinphoneParticipantInfo *>(p->data);
+				const LinphoneAddress *addr = linphone_participant_info_get_address(participantInfo);
+				if (addr) addCandidate(candidates, keys, addr);
 			}
 		}
 	}
-
-	lInfo() << "[Magic Search] Found " << resultList.size() << " results in chat rooms";
-	return resultList;
+	return candidates;
 }
 
-list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromConferencesInfo(
-    const string &filter, const string &withDomain, const list<std::shared_ptr<SearchResult>> &currentList) const {
+list<std::shared_ptr<SearchResult>> MagicSearch::searchInCandidates(const vector<MagicSearchCandidate> &candidates,
+                                                                    const string &filter,
+                                                                    const string &withDomain,
+                                                                    const AddressIndex &currentAddresses,
+                                                                    int source) const {
 	list<std::shared_ptr<SearchResult>> resultList;
-
-	const bctbx_list_t *conferencesInfo = linphone_core_get_conference_information_list(this->getCore()->getCCore());
-	for (const bctbx_list_t *f = conferencesInfo; f != nullptr; f = bctbx_list_next(f)) {
-		LinphoneConferenceInfo *info = static_cast<LinphoneConferenceInfo *>(f->data);
-		const LinphoneAddress *organizer = linphone_conference_info_get_organizer(info);
-		if (organizer) {
-			LinphoneAddress *addr = linphone_address_clone(organizer);
-			if (filter.empty() && withDomain.empty()) {
-				if (findAddress(currentList, addr)) {
-					linphone_address_unref(addr);
-					continue;
-				}
-				resultList.push_back(
-				    SearchResult::create((unsigned int)0, addr, "", nullptr, LinphoneMagicSearchSourceConferencesInfo));
-			} else {
-				unsigned int weight = searchInAddress(addr, filter, withDomain);
-				if (weight > getMinWeight()) {
-					if (findAddress(currentList, addr)) {
-						linphone_address_unref(addr);
-						continue;
-					}
-					resultList.push_back(
-					    SearchResult::create(weight, addr, "", nullptr, LinphoneMagicSearchSourceConferencesInfo));
-				}
-			}
-			linphone_address_unref(addr);
-		}
-
-		const bctbx_list_t *participants = linphone_conference_info_get_participant_infos(info);
-		for (const bctbx_list_t *p = participants; p != nullptr; p = bctbx_list_next(p)) {
-			LinphoneParticipantInfo *participantInfo = static_cast<LinphoneParticipantInfo *>(p->data);
-			const LinphoneAddress *addr =
-			    linphone_address_clone(linphone_participant_info_get_address(participantInfo));
-			if (filter.empty() && withDomain.empty()) {
-				if (findAddress(currentList, addr)) {
-					linphone_address_unref(const_cast<LinphoneAddress *>(addr));
-					continue;
-				}
-				resultList.push_back(
-				    SearchResult::create((unsigned int)0, addr, "", nullptr, LinphoneMagicSearchSourceConferencesInfo));
-			} else {
-				unsigned int weight = searchInAddress(addr, filter, withDomain);
-				if (weight > getMinWeight()) {
-					if (findAddress(currentList, addr)) {
-						linphone_address_unref(const_cast<LinphoneAddress *>(addr));
-						continue;
-					}
-					resultList.push_back(
-					    SearchResult::create(weight, addr, "", nullptr, LinphoneMagicSearchSourceConferencesInfo));
-				}
-			}
-			if (addr) {
-				linphone_address_unref(const_cast<LinphoneAddress *>(addr));
-			}
+	for (const auto &candidate : candidates) {
+		const LinphoneAddress *addr = candidate.address->toC();
+		unsigned int weight = 0;
+		if (!filter.empty() || (!withDomain.empty() && !candidate.matchAnyDomain)) {
+			weight = searchInAddress(addr, filter, withDomain);
+			if (weight <= getMinWeight()) continue;
 		}
+		if (currentAddresses.find(candidate.key) != currentAddresses.end()) continue;
+		resultList.push_back(SearchResult::create(weight, addr, "", nullptr, source));
 	}
+	return resultList;
+}
+
+list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromCallLog(const string &filter,
+                                                                       const string &withDomain,
+                                                                       const AddressIndex &currentAddresses) const {
+	list<std::shared_ptr<SearchResult>> resultList =
+	    searchInCandidates(getCandidates(LinphoneMagicSearchSourceCallLogs), filter, withDomain, currentAddresses,
+	                       LinphoneMagicSearchSourceCallLogs);
+	lInfo() << "[Magic Search] Found " << resultList.size() << " results in call logs";
+	return resultList;
+}
+
+list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromGroupChatRoomParticipants(
+    const string &filter, const string &withDomain, const AddressIndex &currentAddresses) const {
+	list<std::shared_ptr<SearchResult>> resultList =
+	    searchInCandidates(getCandidates(LinphoneMagicSearchSourceChatRooms), filter, withDomain, currentAddresses,
+	                       LinphoneMagicSearchSourceChatRooms);
+	lInfo() << "[Magic Search] Found " << resultList.size() << " results in chat rooms";
+	return resultList;
+}
 
+list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromConferencesInfo(
+    const string &filter, const string &withDomain, const AddressIndex &currentAddresses) const {
+	list<std::shared_ptr<SearchResult>> resultList =
+	    searchInCandidates(getCandidates(LinphoneMagicSearchSourceConferencesInfo), filter, withDomain,
+	                       currentAddresses, LinphoneMagicSearchSourceConferencesInfo);
 	lInfo() << "[Magic Search] Found " << resultList.size() << " results in conferences info";
 	return resultList;
 }
@@ -633,6 +605,7 @@ std::list<list<std::shared_ptr<SearchResult>>> MagicSearch::getAddressFromLDAPSe
 // in results
 void MagicSearch::beginNewSearchAsync(const SearchRequest &request, SearchAsyncData *asyncData) const {
 	asyncData->clear();
+	updateCandidatesCache(request.getFilter());
 	asyncData->setSearchRequest(request);
 	bool checkFriends =
 	    (request.getSourceFlags() & LinphoneMagicSearchSourceFriends) == LinphoneMagicSearchSourceFriends;
@@ -643,8 +616,9 @@ void MagicSearch::beginNewSearchAsync(const SearchRequest &request, SearchAsyncD
 		list<std::shared_ptr<SearchResult>> friendsList;
 		for (const bctbx_list_t *fl = friend_lists; fl != nullptr; fl = bctbx_list_next(fl)) {
 			LinphoneFriendList *fList = static_cast<LinphoneFriendList *>(fl->data);
-			// For all friends or when we reach the search limit
-			const std::list<std::shared_ptr<Friend>> friends = FriendList::toCpp(fList)->getFriends();
+			// Only the friends which may match the filter according to the list index are weighted
+			const std::list<std::shared_ptr<Friend>> friends =
+			    FriendList::toCpp(fList)->findFriendsBySearchFilter(request.getFilter());
 			for (const auto &lFriend : friends) {
 				if (checkFriends || lFriend->getStarred()) {
 					list<std::shared_ptr<SearchResult>> fResults =
@@ -662,22 +636,22 @@ void MagicSearch::beginNewSearchAsync(const SearchRequest &request, SearchAsyncD
 		getAddressFromLDAPServerStartAsync(request.getFilter(), request.getWithDomain(), asyncData);
 #endif
 	if ((request.getSourceFlags() & LinphoneMagicSearchSourceCallLogs) == LinphoneMagicSearchSourceCallLogs)
-		asyncData->createResult(
-		    getAddressFromCallLog(request.getFilter(), request.getWithDomain(), list<std::shared_ptr<SearchResult>>()));
+		asyncData->createResult(getAddressFromCallLog(request.getFilter(), request.getWithDomain(), AddressIndex()));
 	if ((request.getSourceFlags() & LinphoneMagicSearchSourceChatRooms) == LinphoneMagicSearchSourceChatRooms)
-		asyncData->createResult(getAddressFromGroupChatRoomParticipants(request.getFilter(), request.getWithDomain(),
-		                                                                list<std::shared_ptr<SearchResult>>()));
+		asyncData->createResult(
+		    getAddressFromGroupChatRoomParticipants(request.getFilter(), request.getWithDomain(), AddressIndex()));
 	if ((request.getSourceFlags() & LinphoneMagicSearchSourceConferencesInfo) ==
 	    LinphoneMagicSearchSourceConferencesInfo)
-		asyncData->createResult(getAddressFromConferencesInfo(request.getFilter(), request.getWithDomain(),
-		                                                      list<std::shared_ptr<SearchResult>>()));
+		asyncData->createResult(
+		    getAddressFromConferencesInfo(request.getFilter(), request.getWithDomain(), AddressIndex()));
 }
 
 void MagicSearch::mergeResults(const SearchRequest &request, SearchAsyncData *asyncData) {
 	std::shared_ptr<list<std::shared_ptr<SearchResult>>> resultList =
 	    std::make_shared<list<std::shared_ptr<SearchResult>>>();
+	AddressIndex resultIndex;
 	for (auto it = asyncData->mProviderResults.begin(); it != asyncData->mProviderResults.end(); ++it) {
-		addResultsToResultsList(*it, *resultList, request.getFilter(), request.getWithDomain());
+		addResultsToResultsList(*it, *resultList, resultIndex);
 	}
 	asyncData->setSearchResults(resultList);
 }
@@ -688,6 +662,9 @@ MagicSearch::beginNewSearch(const string &filter, const string &withDomain, int
 	list<list<std::shared_ptr<SearchResult>>> multiClResults;
 	std::shared_ptr<list<std::shared_ptr<SearchResult>>> resultList =
 	    std::make_shared<list<std::shared_ptr<SearchResult>>>();
+	AddressIndex resultIndex;
+
+	updateCandidatesCache(filter);
 
 	bool checkFriends = (sourceFlags & LinphoneMagicSearchSourceFriends) == LinphoneMagicSearchSourceFriends;
 	bool checkFavoriteFriends =
@@ -696,8 +673,9 @@ MagicSearch::beginNewSearch(const string &filter, const string &withDomain, int
 		const bctbx_list_t *friend_lists = linphone_core_get_friends_lists(this->getCore()->getCCore());
 		for (const bctbx_list_t *fl = friend_lists; fl != nullptr; fl = bctbx_list_next(fl)) {
 			LinphoneFriendList *fList = static_cast<LinphoneFriendList *>(fl->data);
-			// For all friends or when we reach the search limit
-			const std::list<std::shared_ptr<Friend>> friends = FriendList::toCpp(fList)->getFriends();
+			// Only the friends which may match the filter according to the list index are weighted
+			const std::list<std::shared_ptr<Friend>> friends =
+			    FriendList::toCpp(fList)->findFriendsBySearchFilter(filter);
 			for (const auto &lFriend : friends) {
 				if (checkFriends || lFriend->getStarred()) {
 					list<std::shared_ptr<SearchResult>> fResults = searchInFriend(lFriend->toC(), filter, withDomain);
@@ -705,25 +683,29 @@ MagicSearch::beginNewSearch(const string &filter, const string &withDomain, int
 				}
 			}
 		}
+		indexResults(*resultList, resultIndex);
 	}
 #ifdef LDAP_ENABLED
 	if ((sourceFlags & LinphoneMagicSearchSourceLdapServers) == LinphoneMagicSearchSourceLdapServers &&
 	    linphone_core_is_network_reachable(this->getCore()->getCCore())) {
 		multiClResults = getAddressFromLDAPServer(filter, withDomain);
 		for (auto it = multiClResults.begin(); it != multiClResults.end(); ++it)
-			addResultsToResultsList(*it, *resultList, filter, withDomain);
+			addResultsToResultsList(*it, *resultList, resultIndex);
 	}
 #endif
 	if ((sourceFlags & LinphoneMagicSearchSourceCallLogs) == LinphoneMagicSearchSourceCallLogs) {
-		clResults = getAddressFromCallLog(filter, withDomain, *resultList);
+		clResults = getAddressFromCallLog(filter, withDomain, resultIndex);
+		indexResults(clResults, resultIndex);
 		addResultsToResultsList(clResults, *resultList);
 	}
 	if ((sourceFlags & LinphoneMagicSearchSourceChatRooms) == LinphoneMagicSearchSourceChatRooms) {
-		crResults = getAddressFromGroupChatRoomParticipants(filter, withDomain, *resultList);
+		crResults = getAddressFromGroupChatRoomParticipants(filter, withDomain, resultIndex);
+		indexResults(crResults, resultIndex);
 		addResultsToResultsList(crResults, *resultList);
 	}
 	if ((sourceFlags & LinphoneMagicSearchSourceConferencesInfo) == LinphoneMagicSearchSourceConferencesInfo) {
-		crResults = getAddressFromConferencesInfo(filter, withDomain, *resultList);
+		crResults = getAddressFromConferencesInfo(filter, withDomain, resultIndex);
+		indexResults(crResults, resultIndex);
 		addResultsToResultsList(crResults, *resultList);
 	}
 
@@ -964,19 +946,17 @@ void MagicSearch::addResultsToResultsList(std::list<std::shared_ptr<SearchResult
 
 void MagicSearch::addResultsToResultsList(std::list<std::shared_ptr<SearchResult>> &results,
                                           std::list<std::shared_ptr<SearchResult>> &srL,
-                                          BCTBX_UNUSED(const std::string filter),
-                                          BCTBX_UNUSED(const std::string &withDomain)) const {
+                                          AddressIndex &srLIndex) const {
 	auto itResult = results.begin();
 	while (itResult != results.end()) { // Merge addresses that are already in srL
 		const LinphoneAddress *addr = (*itResult)->getAddress();
-		auto srLAddress = std::find_if(srL.begin(), srL.end(), [addr](const std::shared_ptr<SearchResult> &r) {
-			return r->getAddress() && linphone_address_weak_equal(r->getAddress(), addr);
-		});
-		if (srLAddress != srL.end()) {
-			(*srLAddress)->merge(*itResult);
+		auto srLAddress = addr ? srLIndex.find(getAddressKey(addr)) : srLIndex.end();
+		if (srLAddress != srLIndex.end()) {
+			srLAddress->second->merge(*itResult);
 			itResult = results.erase(itResult);
 		} else ++itResult;
 	}
+	indexResults(results, srLIndex);
 	if (!results.empty()) {
 		srL.splice(srL.end(), results);
 	}
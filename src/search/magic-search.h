@@ -25,6 +25,8 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "core/core-accessor.h"
 #include "core/core.h"
@@ -34,6 +36,7 @@
 LINPHONE_BEGIN_NAMESPACE
 
 class MagicSearchPrivate;
+struct MagicSearchCandidate;
 class SearchAsyncData;
 
 class LINPHONE_PUBLIC MagicSearch : public CoreAccessor, public Object {
@@ -110,7 +113,7 @@ public:
 	void setLimitedSearch(const bool limited);
 
 	/**
-	 * Reset the cache to begin a new search
+	 * Reset the cache to begin a new search, call logs, chat rooms and conferences info are gathered again
 	 **/
 	void resetSearchCache();
 
@@ -164,6 +167,9 @@ public:
 	void setAutoResetCache(const bool_t &enable);
 
 private:
+	// Results indexed by a key which is equal for weakly equal addresses.
+	using AddressIndex = std::unordered_map<std::string, std::shared_ptr<SearchResult>>;
+
 	/**
 	 * @return the cache of precedent result
 	 * @private
@@ -181,40 +187,38 @@ private:
 	 * Get all addresses from call log
 	 * @param[in] filter word we search
 	 * @param[in] withDomain domain which we want to search only
-	 * @param[in] currentList current list where we will check if address already exist
+	 * @param[in] currentAddresses addresses already found, which are skipped
 	 * @return all addresses from call log which match in a SearchResult list
 	 * @private
 	 **/
-	std::list<std::shared_ptr<SearchResult>>
-	getAddressFromCallLog(const std::string &filter,
-	                      const std::string &withDomain,
-	                      const std::list<std::shared_ptr<SearchResult>> &currentList) const;
+	std::list<std::shared_ptr<SearchResult>> getAddressFromCallLog(const std::string &filter,
+	                                                               const std::string &withDomain,
+	                                                               const AddressIndex &currentAddresses) const;
 
 	/**
 	 * Get all addresses from chat rooms participants
 	 * @param[in] filter word we search
 	 * @param[in] withDomain domain which we want to search only
-	 * @param[in] currentList current list where we will check if address already exist
+	 * @param[in] currentAddresses addresses already found, which are skipped
 	 * @return all address from chat rooms participants which match in a SearchResult list
 	 * @private
 	 **/
 	std::list<std::shared_ptr<SearchResult>>
 	getAddressFromGroupChatRoomParticipants(const std::string &filter,
 	                                        const std::string &withDomain,
-	                                        const std::list<std::shared_ptr<SearchResult>> &currentList) const;
+	                                        const AddressIndex &currentAddresses) const;
 
 	/**
 	 * Get all addresses from conferences info participants & organizer
 	 * @param[in] filter word we search
 	 * @param[in] withDomain domain which we want to search only
-	 * @param[in] currentList current list where we will check if address already exist
+	 * @param[in] currentAddresses addresses already found, which are skipped
 	 * @return all addresses from conferences info organizer and participants which match in a SearchResult list
 	 * @private
 	 **/
-	std::list<std::shared_ptr<SearchResult>>
-	getAddressFromConferencesInfo(const std::string &filter,
-	                              const std::string &withDomain,
-	                              const std::list<std::shared_ptr<SearchResult>> &currentList) const;
+	std::list<std::shared_ptr<SearchResult>> getAddressFromConferencesInfo(const std::string &filter,
+	                                                                       const std::string &withDomain,
+	                                                                       const AddressIndex &currentAddresses) const;
 
 #ifdef LDAP_ENABLED
 	/**
@@ -298,6 +302,23 @@ private:
 	void addResultsToResultsList(std::list<std::shared_ptr<SearchResult>> &results,
 	                             std::list<std::shared_ptr<SearchResult>> &srL) const;
 
+	/**
+	 * Return the candidates of a source, gathering them again only if the filter is not a refinement of the previous
+	 * one.
+	 * @param[in] source #LinphoneMagicSearchSource of the candidates
+	 * @private
+	 **/
+	const std::vector<MagicSearchCandidate> &getCandidates(int source) const;
+	void updateCandidatesCache(const std::string &filter) const;
+
+	std::list<std::shared_ptr<SearchResult>> searchInCandidates(const std::vector<MagicSearchCandidate> &candidates,
+	                                                            const std::string &filter,
+	                                                            const std::string &withDomain,
+	                                                            const AddressIndex &currentAddresses,
+	                                                            int source) const;
+
+	static void indexResults(const std::list<std::shared_ptr<SearchResult>> &results, AddressIndex &index);
+
 	void uniqueItemsList(std::shared_ptr<std::list<std::shared_ptr<SearchResult>>> list) const;
 	void uniqueFriendsInList(std::shared_ptr<std::list<std::shared_ptr<SearchResult>>> list) const;
 
@@ -362,13 +383,11 @@ private:
 	 * is usefull to prioritize results based to the order of providers.
 	 * @param results List of #SearchResult to add.
 	 * @param srL List of #SearchResult to modify.
-	 * @param filter word we search.
-	 * @param withDomain domain which we want to search only.
+	 * @param srLIndex Index of srL, updated with the added results.
 	 */
 	void addResultsToResultsList(std::list<std::shared_ptr<SearchResult>> &results,
 	                             std::list<std::shared_ptr<SearchResult>> &srL,
-	                             const std::string filter,
-	                             const std::string &withDomain) const;
+	                             AddressIndex &srLIndex) const;
 
 	int mState;
 	/**
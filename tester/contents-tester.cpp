@@ -680,12 +680,40 @@ static void content_public_api(void) {
 	linphone_content_unref(content);
 }
 
+static void content_shared_body(void) {
+	Content content;
+	content.setContentType(ContentType::PlainText);
+	content.setBodyFromUtf8("Hello shared body");
+
+	// Copies share the body buffer until one of them is given a new body.
+	Content copy(content);
+	BC_ASSERT_PTR_EQUAL(copy.getBody().data(), content.getBody().data());
+	BC_ASSERT_TRUE(copy == content);
+
+	const string &utf8Body = copy.getBodyAsUtf8String();
+	BC_ASSERT_STRING_EQUAL(utf8Body.c_str(), "Hello shared body");
+	BC_ASSERT_PTR_EQUAL(copy.getBodyAsUtf8String().data(), utf8Body.data());
+
+	copy.setBodyFromUtf8("Another body");
+	BC_ASSERT_STRING_EQUAL(copy.getBodyAsUtf8String().c_str(), "Another body");
+	BC_ASSERT_STRING_EQUAL(content.getBodyAsUtf8String().c_str(), "Hello shared body");
+	BC_ASSERT_EQUAL(content.getSize(), strlen("Hello shared body"), size_t, "%zu");
+
+	Content moved(std::move(copy));
+	BC_ASSERT_STRING_EQUAL(moved.getBodyAsUtf8String().c_str(), "Another body");
+
+	content.setBody(nullptr, 0);
+	BC_ASSERT_TRUE(content.getBody().empty());
+	BC_ASSERT_STRING_EQUAL(content.getBodyAsUtf8String().c_str(), "");
+}
+
 test_t contents_tests[] = {TEST_NO_TAG("Multipart to list", multipart_to_list),
                            TEST_NO_TAG("Multipart parsing", multipart_parsing),
                            TEST_NO_TAG("List to multipart", list_to_multipart),
                            TEST_NO_TAG("Content type parsing", content_type_parsing),
                            TEST_NO_TAG("Content header parsing", content_header_parsing),
-                           TEST_NO_TAG("Content C public API", content_public_api)};
+                           TEST_NO_TAG("Content C public API", content_public_api),
+                           TEST_NO_TAG("Content shared body", content_shared_body)};
 
 test_suite_t contents_test_suite = {"Contents",
                                     nullptr,
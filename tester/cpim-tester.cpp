@@ -22,9 +22,11 @@
 
 #include "address/address.h"
 #include "belr/grammarbuilder.h"
+#include "chat/chat-message/chat-message-p.h"
 #include "chat/chat-message/chat-message.h"
 #include "chat/chat-room/basic-chat-room.h"
 #include "chat/cpim/cpim.h"
+#include "chat/cpim/parser/cpim-parser.h"
 #include "content/content-type.h"
 #include "content/content.h"
 #include "core/core.h"
@@ -34,6 +36,8 @@
 #include "liblinphone_tester.h"
 #include "tester_utils.h"
 
+#include <chrono>
+
 // =============================================================================
 
 using namespace std;
@@ -238,6 +242,132 @@ static void build_message() {
 	BC_ASSERT_STRING_EQUAL(strMessage.c_str(), expectedMessage.c_str());
 }
 
+// Messages as sent by linphone, which the hand-written parser must handle, and unusual ones left to the grammar.
+static const list<pair<string, bool>> cpimCorpus = {
+    {"From: <sip:marie@sip.example.org>\r\n"
+     "To: <sip:pauline@sip.example.org>\r\n"
+     "DateTime: 2023-06-21T09:12:45Z\r\n"
+     "NS: imdn <urn:ietf:params:imdn>\r\n"
+     "imdn.Message-ID: hBTTSRmMYPFx\r\n"
+     "imdn.Disposition-Notification: positive-delivery, display\r\n"
+     "\r\n"
+     "Content-Type: text/plain;charset=UTF-8\r\n"
+     "Content-Length: 13\r\n"
+     "\r\n"
+     "Hello Pauline",
+     true},
+    {"From: \"Marie Durand\"<sip:marie@sip.example.org;gr=urn:uuid:5a5d6c1e-2a1e-00d4-91b4-4f3a6c22e0a1>\r\n"
+     "To: \"Chat room\"<sip:chatroom-ab12@conf.example.org>\r\n"
+     "DateTime: 2023-11-03T17:01:02+02:00\r\n"
+     "NS: linphone <tag:linphone.org,2020:params:groupchat>\r\n"
+     "linphone.Ephemeral-Time: 86400\r\n"
+     "linphone.Replying-To-Message-ID: 2kN3oF9a\r\n"
+     "linphone.Replying-To-Sender: sip:pauline@sip.example.org\r\n"
+     "NS: imdn <urn:ietf:params:imdn>\r\n"
+     "imdn.Message-ID: Qw8zT5Pq\r\n"
+     "imdn.Disposition-Notification: positive-delivery, negative-delivery, display\r\n"
+     "\r\n"
+     "Content-Type: text/plain\r\n"
+     "Content-Length: 15\r\n"
+     "\r\n"
+     "Ça va très bien",
+     true},
+    {"Content-Type: Message/CPIM\r\n"
+     "\r\n"
+     "From: Depressed Donkey <im:eeyore@100akerwood.com>\r\n"
+     "To: <im:piglet@100akerwood.com>\r\n"
+     "Require: MyFeatures.VitalMessageOption,imdn.Message-ID\r\n"
+     "Subject: the weather will be fine today\r\n"
+     "\r\n"
+     "Content-Type: application/vnd.gsma.rcs-ft-http+xml\r\n"
+     "Content-Disposition: Reaction\r\n"
+     "\r\n",
+     true},
+    {"From: \"MR SANDERS\"<im:piglet@100akerwood.com>\r\n"
+     "Subject:;lang=fr beau temps prevu pour aujourd'hui\r\n"
+     "\r\n"
+     "Content-Type: text/xml; charset=utf-8\r\n"
+     "\r\n"
+     "<body/>",
+     false},
+    {"From: \"MR SANDERS\"<im:piglet@100akerwood.com>\r\n"
+     "Test:;aaa=bbb;yes=no CheckMe\r\n"
+     "\r\n"
+     "Content-Type: text/xml; charset=utf-8\r\n"
+     "\r\n",
+     false},
+    {"From: \"MR \\\"SANDERS\\\"\"<im:piglet@100akerwood.com>\r\n"
+     "\r\n"
+     "Content-Type: text/plain\r\n"
+     "\r\n",
+     false},
+    {"From: <http://www.example.org/piglet>\r\n"
+     "\r\n"
+     "Content-Type: text/plain\r\n"
+     "\r\n",
+     false}};
+
+static void fast_parser_matches_grammar() {
+	Cpim::Parser *parser = Cpim::Parser::getInstance();
+	for (const auto &entry : cpimCorpus) {
+		shared_ptr<Cpim::Message> fastMessage = parser->parseMessageFast(entry.first);
+		shared_ptr<Cpim::Message> grammarMessage = parser->parseMessageWithGrammar(entry.first);
+		BC_ASSERT_EQUAL(fastMessage != nullptr, entry.second, bool, "%d");
+		if (!fastMessage) continue;
+		if (!BC_ASSERT_PTR_NOT_NULL(grammarMessage)) continue;
+
+		const string fastStr = fastMessage->asString();
+		const string grammarStr = grammarMessage->asString();
+		BC_ASSERT_STRING_EQUAL(fastStr.c_str(), grammarStr.c_str());
+		for (const char *ns : {"", "imdn", "linphone"}) {
+			auto fastHeaders = fastMessage->getMessageHeaders(ns);
+			auto grammarHeaders = grammarMessage->getMessageHeaders(ns);
+			BC_ASSERT_EQUAL(fastHeaders ? (int)fastHeaders->size() : 0, grammarHeaders ? (int)grammarHeaders->size() : 0,
+			                int, "%d");
+		}
+		auto fastFrom = static_pointer_cast<const Cpim::FromHeader>(fastMessage->getMessageHeader("From"));
+		auto grammarFrom = static_pointer_cast<const Cpim::FromHeader>(grammarMessage->getMessageHeader("From"));
+		if (BC_ASSERT_PTR_NOT_NULL(fastFrom) && BC_ASSERT_PTR_NOT_NULL(grammarFrom)) {
+			const string fastName = fastFrom->getFormalName();
+			const string grammarName = grammarFrom->getFormalName();
+			BC_ASSERT_STRING_EQUAL(fastName.c_str(), grammarName.c_str());
+		}
+		const string fastContent = fastMessage->getContent();
+		const string grammarContent = grammarMessage->getContent();
+		BC_ASSERT_STRING_EQUAL(fastContent.c_str(), grammarContent.c_str());
+	}
+
+	// Both parsers reject the same broken messages.
+	BC_ASSERT_PTR_NULL(parser->parseMessage("From: <sip:marie@sip.example.org>\r\n\r\n"));
+	BC_ASSERT_PTR_NULL(parser->parseMessage("DateTime: 2023-02-30T09:12:45Z\r\n\r\nContent-Type: text/plain\r\n\r\n"));
+}
+
+static void fast_parser_benchmark() {
+	const int iterations = 1000;
+	Cpim::Parser *parser = Cpim::Parser::getInstance();
+	for (const auto &entry : cpimCorpus) {
+		if (!entry.second) continue;
+		// Only the timings are reported, they depend on the machine running the tests.
+		int fastFailures = 0;
+		uint64_t start = bctbx_get_cur_time_ms();
+		for (int i = 0; i < iterations; ++i)
+			if (!parser->parseMessageFast(entry.first)) fastFailures++;
+		uint64_t fastTime = bctbx_get_cur_time_ms() - start;
+
+		int grammarFailures = 0;
+		start = bctbx_get_cur_time_ms();
+		for (int i = 0; i < iterations; ++i)
+			if (!parser->parseMessageWithGrammar(entry.first)) grammarFailures++;
+		uint64_t grammarTime = bctbx_get_cur_time_ms() - start;
+
+		BC_ASSERT_EQUAL(fastFailures, 0, int, "%d");
+		BC_ASSERT_EQUAL(grammarFailures, 0, int, "%d");
+		ms_message("Parsed %d CPIM messages of %d bytes in %llu ms with the fast parser, %llu ms with the grammar",
+		           iterations, (int)entry.first.size(), (unsigned long long)fastTime,
+		           (unsigned long long)grammarTime);
+	}
+}
+
 static int fake_im_encryption_engine_process_incoming_message_cb(BCTBX_UNUSED(LinphoneImEncryptionEngine *engine),
                                                                  BCTBX_UNUSED(LinphoneChatRoom *room),
                                                                  LinphoneChatMessage *msg) {
@@ -291,9 +421,12 @@ static void cpim_chat_message_modifier_base(bool useMultipart) {
 		content->setBodyFromUtf8("Hello Part 2");
 		marieMessage->addContent(content);
 	}
+	const auto start = chrono::steady_clock::now();
 	marieMessage->send();
 
 	BC_ASSERT_TRUE(wait_for(pauline->lc, marie->lc, &pauline->stat.number_of_LinphoneMessageReceived, 1));
+	const long long elapsed =
+	    chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
 	BC_ASSERT_TRUE(marieMessage->getInternalContent()
 	                   .getContentType()
 	                   .isEmpty()); // Internal content is cleaned after message is sent or received
@@ -304,6 +437,17 @@ static void cpim_chat_message_modifier_base(bool useMultipart) {
 		const string expected = ContentType::PlainText.getMediaType();
 		BC_ASSERT_STRING_EQUAL(linphone_chat_message_get_content_type(pauline->stat.last_received_chat_message),
 		                       expected.c_str());
+
+		// Every modification step of the reception is timed.
+		const ChatMessagePrivate::ReceiveTimings &timings =
+		    L_GET_PRIVATE(ChatMessage::toCpp(pauline->stat.last_received_chat_message))->getReceiveTimings();
+		const int steps = ChatMessagePrivate::Step::Encryption | ChatMessagePrivate::Step::Cpim |
+		                  ChatMessagePrivate::Step::Multipart | ChatMessagePrivate::Step::FileDownload;
+		BC_ASSERT_EQUAL(timings.steps & steps, steps, int, "%d");
+		for (long long timing : {timings.encryption, timings.cpim, timings.multipart, timings.fileTransfer})
+			BC_ASSERT_GREATER(timing, 0, long long, "%lld");
+		BC_ASSERT_LOWER(timings.encryption + timings.cpim + timings.multipart + timings.fileTransfer, elapsed,
+		                long long, "%lld");
 	}
 
 	marieMessage.reset();
@@ -350,6 +494,8 @@ test_t cpim_tests[] = {
     TEST_NO_TAG("Parse RFC example", parse_rfc_example),
     TEST_NO_TAG("Parse Message with generic header parameters", parse_message_with_generic_header_parameters),
     TEST_NO_TAG("Build Message", build_message),
+    TEST_NO_TAG("Fast parser matches grammar", fast_parser_matches_grammar),
+    TEST_NO_TAG("Fast parser benchmark", fast_parser_benchmark),
     TEST_NO_TAG("CPIM chat message modifier", cpim_chat_message_modifier),
     TEST_NO_TAG("CPIM chat message modifier with multipart body", cpim_chat_message_modifier_with_multipart_body),
     TEST_ONE_TAG("CPIM ephemeral message", ephemeral_message, "Ephemeral")};
@@ -18,10 +18,15 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "conference/handlers/local-conference-event-handler.h"
+#include "conference/local-conference.h"
 #include "conference/participant.h"
 #include "core/core-p.h"
 #include "liblinphone_tester.h"
 #include "local-conference-tester-functions.h"
+#include "tools/private-access.h"
+
+L_ENABLE_ATTR_ACCESS(LocalConference, shared_ptr<LocalConferenceEventHandler>, eventHandler);
 
 namespace LinphoneTest {
 
@@ -1978,6 +1983,123 @@ static void group_chat_room_bulk_notify_to_participant(void) {
 	}
 }
 
+static void conference_notify_received(LinphoneCore *lc,
+                                       BCTBX_UNUSED(LinphoneEvent *lev),
+                                       const char *eventname,
+                                       const LinphoneContent *content) {
+	if (!content || strcmp(eventname, "conference") != 0) return;
+	auto bodies = static_cast<list<string> *>(linphone_core_cbs_get_user_data(linphone_core_get_current_callbacks(lc)));
+	const char *body = linphone_content_get_utf8_text(content);
+	bodies->push_back(body ? body : "");
+}
+
+static void group_chat_room_notify_fan_out(void) {
+	Focus focus("chloe_rc");
+	{ // to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getConferenceFactoryAddress());
+		ClientConference pauline("pauline_rc", focus.getConferenceFactoryAddress());
+		ClientConference michelle("michelle_rc", focus.getConferenceFactoryAddress());
+
+		focus.registerAsParticipantDevice(marie);
+		focus.registerAsParticipantDevice(pauline);
+		focus.registerAsParticipantDevice(michelle);
+
+		bctbx_list_t *coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		coresList = bctbx_list_append(coresList, michelle.getLc());
+		Address paulineAddr = pauline.getIdentity();
+		bctbx_list_t *participantsAddresses = bctbx_list_append(NULL, linphone_address_ref(paulineAddr.toC()));
+		Address michelleAddr = michelle.getIdentity();
+		participantsAddresses = bctbx_list_append(participantsAddresses, linphone_address_ref(michelleAddr.toC()));
+
+		stats initialMarieStats = marie.getStats();
+		stats initialPaulineStats = pauline.getStats();
+		stats initialMichelleStats = michelle.getStats();
+
+		// Marie creates a new group chat room
+		const char *initialSubject = "Fan-out";
+		LinphoneChatRoom *marieCr =
+		    create_chat_room_client_side(coresList, marie.getCMgr(), &initialMarieStats, participantsAddresses,
+		                                 initialSubject, FALSE, LinphoneChatRoomEphemeralModeDeviceManaged);
+		const LinphoneAddress *confAddr = linphone_chat_room_get_conference_address(marieCr);
+		check_creation_chat_room_client_side(coresList, pauline.getCMgr(), &initialPaulineStats, confAddr,
+		                                     initialSubject, 2, FALSE);
+		check_creation_chat_room_client_side(coresList, michelle.getCMgr(), &initialMichelleStats, confAddr,
+		                                     initialSubject, 2, FALSE);
+
+		BC_ASSERT_TRUE(CoreManagerAssert({focus, marie, pauline, michelle}).wait([&focus] {
+			for (auto chatRoom : focus.getCore().getChatRooms()) {
+				for (auto participant : chatRoom->getParticipants()) {
+					for (auto device : participant->getDevices())
+						if (device->getState() != ParticipantDevice::State::Present) {
+							return false;
+						}
+				}
+			}
+			return true;
+		}));
+
+		list<shared_ptr<AbstractChatRoom>> focusChatRooms = focus.getCore().getChatRooms();
+		BC_ASSERT_EQUAL(focusChatRooms.size(), 1, size_t, "%zu");
+		if (focusChatRooms.empty()) {
+			bctbx_list_free(coresList);
+			return;
+		}
+		shared_ptr<LocalConference> localConf =
+		    dynamic_pointer_cast<LocalConference>(focusChatRooms.front()->getConference());
+		BC_ASSERT_PTR_NOT_NULL(localConf);
+		if (!localConf) {
+			bctbx_list_free(coresList);
+			return;
+		}
+		LocalConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+		const LocalConferenceEventHandler::NotifyFanOutStats initialFanOutStats = localHandler->getNotifyFanOutStats();
+
+		// Record the bodies of the conference NOTIFYs received by every device
+		list<string> bodies;
+		LinphoneCoreCbs *cbs = linphone_factory_create_core_cbs(linphone_factory_get());
+		linphone_core_cbs_set_notify_received(cbs, conference_notify_received);
+		linphone_core_cbs_set_user_data(cbs, &bodies);
+		for (const auto client : {marie.getLc(), pauline.getLc(), michelle.getLc()})
+			linphone_core_add_callbacks(client, cbs);
+
+		// Marie now changes the subject, the same NOTIFY is sent to the 3 devices
+		const char *newSubject = "Fan-out of the NOTIFY";
+		linphone_chat_room_set_subject(marieCr, newSubject);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_subject_changed,
+		                             initialMarieStats.number_of_subject_changed + 1, liblinphone_tester_sip_timeout));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_subject_changed,
+		                             initialPaulineStats.number_of_subject_changed + 1,
+		                             liblinphone_tester_sip_timeout));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &michelle.getStats().number_of_subject_changed,
+		                             initialMichelleStats.number_of_subject_changed + 1,
+		                             liblinphone_tester_sip_timeout));
+
+		const LocalConferenceEventHandler::NotifyFanOutStats &fanOutStats = localHandler->getNotifyFanOutStats();
+		BC_ASSERT_GREATER(fanOutStats.fanOutCount, initialFanOutStats.fanOutCount + 1, unsigned long long, "%llu");
+		BC_ASSERT_GREATER(fanOutStats.notifyCount, initialFanOutStats.notifyCount + 3, unsigned long long, "%llu");
+
+		BC_ASSERT_EQUAL(bodies.size(), 3, size_t, "%zu");
+		for (const auto &body : bodies) {
+			BC_ASSERT_FALSE(body.empty());
+			BC_ASSERT_TRUE(body == bodies.front());
+		}
+
+		for (const auto client : {marie.getLc(), pauline.getLc(), michelle.getLc()})
+			linphone_core_remove_callbacks(client, cbs);
+		linphone_core_cbs_unref(cbs);
+
+		// to avoid creation attempt of a new chatroom
+		auto config = focus.getDefaultProxyConfig();
+		linphone_proxy_config_edit(config);
+		linphone_proxy_config_set_conference_factory_uri(config, NULL);
+		linphone_proxy_config_done(config);
+
+		bctbx_list_free(coresList);
+	}
+}
+
 static void one_to_one_chatroom_exhumed_while_offline(void) {
 	Focus focus("chloe_rc");
 	{ // to make sure focus is destroyed after clients.
@@ -3018,6 +3140,7 @@ static test_t local_conference_chat_basic_tests[] = {
                  "LeaksMemory"), /* beacause of coreMgr restart*/
     TEST_NO_TAG("Group chat room bulk notify to participant",
                 LinphoneTest::group_chat_room_bulk_notify_to_participant), /* because of network up and down*/
+    TEST_NO_TAG("Group chat room NOTIFY fan-out", LinphoneTest::group_chat_room_notify_fan_out),
     TEST_ONE_TAG("One to one chatroom exhumed while participant is offline",
                  LinphoneTest::one_to_one_chatroom_exhumed_while_offline,
                  "LeaksMemory"), /* because of network up and down*/
@@ -20,7 +20,13 @@
 
 #include "address/address.h"
 #include "c-wrapper/internal/c-tools.h"
+#include "chat/chat-message/chat-message-p.h"
+#include "chat/chat-room/chat-room-params.h"
+#include "conference/conference.h"
+#include "conference/participant.h"
+#include "content/content.h"
 #include "core/core-p.h"
+#include "db/main-db-p.h"
 #include "db/main-db.h"
 #include "event-log/events.h"
 // TODO: Remove me.
@@ -28,6 +34,17 @@
 #include "private.h"
 #include "tools/tester.h"
 
+#include <algorithm>
+#include <map>
+#include <regex>
+#include <set>
+
+#ifdef HAVE_SOCI
+#include <soci/soci.h>
+
+#include "db/internal/db-transaction.h"
+#endif // HAVE_SOCI
+
 #ifndef _WIN32
 #include <sys/resource.h>
 #include <sys/time.h>
@@ -46,12 +63,13 @@ public:
 	MainDbProvider() : MainDbProvider("db/linphone.db") {
 	}
 
-	MainDbProvider(const char *db_file) {
+	MainDbProvider(const char *db_file, bool walEnabled = false) {
 		mCoreManager = linphone_core_manager_create("empty_rc");
 		char *roDbPath = bc_tester_res(db_file);
 		char *rwDbPath = bc_tester_file(core_db);
 		BC_ASSERT_FALSE(liblinphone_tester_copy_file(roDbPath, rwDbPath));
 		linphone_config_set_string(linphone_core_get_config(mCoreManager->lc), "storage", "uri", rwDbPath);
+		linphone_config_set_bool(linphone_core_get_config(mCoreManager->lc), "storage", "wal_enabled", walEnabled);
 		bc_free(roDbPath);
 		bc_free(rwDbPath);
 		linphone_core_manager_start(mCoreManager, false);
@@ -74,6 +92,10 @@ public:
 		return *L_GET_PRIVATE(mCoreManager->lc->cppPtr)->mainDb;
 	}
 
+	LinphoneCore *getCore() const {
+		return mCoreManager->lc;
+	}
+
 private:
 	LinphoneCoreManager *mCoreManager;
 	const char *core_db = "linphone.db";
@@ -81,6 +103,93 @@ private:
 
 // -----------------------------------------------------------------------------
 
+#ifdef HAVE_SOCI
+// Records the statements prepared on a soci session.
+class QueryRecorder : public soci::logger_impl {
+public:
+	explicit QueryRecorder(const shared_ptr<set<string>> &queries) : mQueries(queries) {
+	}
+
+	void start_query(const string &query) override {
+		mQueries->insert(query);
+	}
+
+private:
+	soci::logger_impl *do_clone() const override {
+		return new QueryRecorder(mQueries);
+	}
+
+	shared_ptr<set<string>> mQueries;
+};
+
+// Records the statements issued by a sqlite3 MainDb, then runs them through EXPLAIN QUERY PLAN to find the full
+// scans of the tables which grow with the history.
+class QueryPlanAuditor {
+public:
+	explicit QueryPlanAuditor(MainDb &mainDb)
+	    : mDbSession(L_GET_PRIVATE(&mainDb)->dbSession), mSession(*mDbSession.getBackendSession()),
+	      mPreviousLogger(mSession.get_logger()) {
+		mSession.set_logger(new QueryRecorder(mQueries));
+		// The statements of the cache were prepared before the recording.
+		mDbSession.clearStatementCache();
+	}
+
+	~QueryPlanAuditor() {
+		mSession.set_logger(mPreviousLogger);
+	}
+
+	// Returns the full table scans as "<plan step>: <statement>".
+	list<string> getFullTableScans() const {
+		static const set<string> largeTables = {"chat_message_content",
+		                                        "chat_message_participant",
+		                                        "conference_call",
+		                                        "conference_chat_message_event",
+		                                        "conference_event",
+		                                        "conference_info",
+		                                        "conference_info_participant",
+		                                        "event",
+		                                        "sip_address"};
+		static const regex statementRegex("^\\s*(SELECT|UPDATE|DELETE)\\b", regex::icase);
+		static const regex aliasRegex("\\b(\\w+) AS (\\w+)\\b", regex::icase);
+		// "SCAN TABLE <table> [AS <alias>]" before sqlite 3.36, "SCAN <table or alias>" since.
+		static const regex scanRegex("^SCAN (?:TABLE )?(\\w+)(?: AS \\w+)?$");
+
+		// EXPLAIN QUERY PLAN statements are recorded too.
+		const set<string> queries = *mQueries;
+
+		list<string> scans;
+		for (const auto &query : queries) {
+			if (!regex_search(query, statementRegex)) continue;
+
+			map<string, string> aliases;
+			for (sregex_iterator it(query.cbegin(), query.cend(), aliasRegex), end; it != end; ++it)
+				aliases[(*it)[2]] = (*it)[1];
+
+			soci::rowset<soci::row> steps = (mSession.prepare << "EXPLAIN QUERY PLAN " + query);
+			for (const auto &step : steps) {
+				const string detail = step.get<string>(3);
+				smatch match;
+				if (!regex_match(detail, match, scanRegex)) continue;
+
+				string table = match[1];
+				auto it = aliases.find(table);
+				if (it != aliases.end()) table = it->second;
+				if (largeTables.find(table) != largeTables.end()) scans.push_back(detail + ": " + query);
+			}
+		}
+		return scans;
+	}
+
+private:
+	DbSession &mDbSession;
+	soci::session &mSession;
+	soci::logger mPreviousLogger;
+	shared_ptr<set<string>> mQueries = make_shared<set<string>>();
+};
+#endif // HAVE_SOCI
+
+// -----------------------------------------------------------------------------
+
 static void get_events_count(void) {
 	MainDbProvider provider;
 	const MainDb &mainDb = provider.getMainDb();
@@ -160,6 +269,154 @@ static void get_history(void) {
 	}
 }
 
+static void get_history_before(void) {
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		ConferenceId conferenceId(Address::create("sip:test-1@sip.linphone.org")->getSharedFromThis(),
+		                          Address::create("sip:test-1@sip.linphone.org"));
+		list<shared_ptr<EventLog>> history =
+		    mainDb.getHistoryRange(conferenceId, 0, -1, MainDb::Filter::ConferenceChatMessageFilter);
+
+		// Scroll back page by page, each page starts before the oldest event of the previous one.
+		list<shared_ptr<EventLog>> pages;
+		shared_ptr<EventLog> before;
+		for (;;) {
+			list<shared_ptr<EventLog>> page =
+			    mainDb.getHistoryBefore(conferenceId, before, 100, MainDb::Filter::ConferenceChatMessageFilter);
+			if (page.empty()) break;
+			BC_ASSERT_LOWER(page.size(), 100, size_t, "%zu");
+			before = page.front();
+			pages.splice(pages.begin(), page);
+		}
+		BC_ASSERT_EQUAL(pages.size(), history.size(), size_t, "%zu");
+		BC_ASSERT_TRUE(equal(pages.cbegin(), pages.cend(), history.cbegin(), history.cend(),
+		                     [](const shared_ptr<EventLog> &a, const shared_ptr<EventLog> &b) {
+			                     return a->getCreationTime() == b->getCreationTime() && a->getType() == b->getType();
+		                     }));
+
+		// A cursor taken from another chat room is rejected.
+		ConferenceId otherConferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                               Address::create("sip:test-1@sip.linphone.org"));
+		list<shared_ptr<EventLog>> otherHistory =
+		    mainDb.getHistory(otherConferenceId, 1, MainDb::Filter::ConferenceChatMessageFilter);
+		BC_ASSERT_EQUAL(otherHistory.size(), 1, size_t, "%zu");
+		if (!otherHistory.empty())
+			BC_ASSERT_TRUE(mainDb.getHistoryBefore(conferenceId, otherHistory.front(), 100).empty());
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void prepared_statements_cache(void) {
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		ConferenceId conferenceId(Address::create("sip:test-1@sip.linphone.org")->getSharedFromThis(),
+		                          Address::create("sip:test-1@sip.linphone.org"));
+		BC_ASSERT_EQUAL((int)mainDb.getHistory(conferenceId, 100, MainDb::Filter::ConferenceChatMessageFilter).size(),
+		                100, int, "%d");
+		unsigned long long hits = mainDb.getStatementCacheHits();
+		unsigned long long misses = mainDb.getStatementCacheMisses();
+
+		// Same queries with other parameters: everything must come from the cache.
+		BC_ASSERT_EQUAL((int)mainDb.getHistory(conferenceId, 50, MainDb::Filter::ConferenceChatMessageFilter).size(),
+		                50, int, "%d");
+		BC_ASSERT_GREATER(mainDb.getStatementCacheHits(), hits + 1, unsigned long long, "%llu");
+		BC_ASSERT_EQUAL(mainDb.getStatementCacheMisses(), misses, unsigned long long, "%llu");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void read_sessions(void) {
+	{
+		// The write-ahead log is off by default.
+		MainDbProvider provider;
+		BC_ASSERT_FALSE(provider.getMainDb().writeAheadLogEnabled());
+		BC_ASSERT_PTR_NULL(provider.getMainDb().acquireReadSession().get());
+	}
+
+	MainDbProvider provider("db/linphone.db", true);
+	const MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+	BC_ASSERT_TRUE(mainDb.writeAheadLogEnabled());
+
+	// The pool holds two sessions by default.
+	shared_ptr<soci::session> first = mainDb.acquireReadSession();
+	shared_ptr<soci::session> second = mainDb.acquireReadSession();
+	BC_ASSERT_PTR_NOT_NULL(first.get());
+	BC_ASSERT_PTR_NOT_NULL(second.get());
+	BC_ASSERT_PTR_NULL(mainDb.acquireReadSession().get());
+
+#ifdef HAVE_SOCI
+	int count = 0;
+	*first << "SELECT COUNT(*) FROM event", soci::into(count);
+	BC_ASSERT_EQUAL(count, mainDb.getEventCount(), int, "%d");
+
+	bool writeFailed = false;
+	try {
+		*first << "DELETE FROM event";
+	} catch (const soci::soci_error &) {
+		writeFailed = true;
+	}
+	BC_ASSERT_TRUE(writeFailed);
+	BC_ASSERT_EQUAL(mainDb.getEventCount(), count, int, "%d");
+#endif // HAVE_SOCI
+
+	// A released session goes back to the pool.
+	const soci::session *released = second.get();
+	second = nullptr;
+	BC_ASSERT_PTR_EQUAL(mainDb.acquireReadSession().get(), released);
+}
+
+static void get_history_async(void) {
+	// The reads run on the worker thread only with the write-ahead log.
+	MainDbProvider provider("db/linphone.db", true);
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	ConferenceId conferenceId(Address::create("sip:test-1@sip.linphone.org")->getSharedFromThis(),
+	                          Address::create("sip:test-1@sip.linphone.org"));
+	list<shared_ptr<EventLog>> history =
+	    mainDb.getHistoryRange(conferenceId, 0, 100, MainDb::Filter::ConferenceChatMessageFilter);
+	list<shared_ptr<CallLog>> callLogs = mainDb.getCallHistory();
+
+	int done = 0;
+	list<shared_ptr<EventLog>> asyncHistory;
+	mainDb.getHistoryRangeAsync(conferenceId, 0, 100, MainDb::Filter::ConferenceChatMessageFilter,
+	                            [&done, &asyncHistory](const list<shared_ptr<EventLog>> &result) {
+		                            asyncHistory = result;
+		                            done++;
+	                            });
+	list<shared_ptr<CallLog>> asyncCallLogs;
+	mainDb.getCallHistoryAsync(-1, [&done, &asyncCallLogs](const list<shared_ptr<CallLog>> &result) {
+		asyncCallLogs = result;
+		done++;
+	});
+	// The results are never given from the calling function.
+	BC_ASSERT_EQUAL(done, 0, int, "%d");
+	BC_ASSERT_TRUE(wait_for_until(provider.getCore(), nullptr, &done, 2, 5000));
+
+	// The events are built on the core thread, the ones still alive are reused.
+	BC_ASSERT_EQUAL(asyncHistory.size(), history.size(), size_t, "%zu");
+	BC_ASSERT_TRUE(asyncHistory == history);
+	BC_ASSERT_EQUAL(asyncCallLogs.size(), callLogs.size(), size_t, "%zu");
+
+	// The results of the cancelled reads are dropped.
+	mainDb.getHistoryRangeAsync(conferenceId, 0, 100, MainDb::Filter::ConferenceChatMessageFilter,
+	                            [&done](const list<shared_ptr<EventLog>> &) { done++; });
+	mainDb.cancelAsyncReads();
+	wait_for_until(provider.getCore(), nullptr, &done, 3, 500);
+	BC_ASSERT_EQUAL(done, 2, int, "%d");
+}
+
 static void get_conference_notified_events(void) {
 	MainDbProvider provider;
 	const MainDb &mainDb = provider.getMainDb();
@@ -213,6 +470,131 @@ static void get_conference_notified_events(void) {
 	}
 }
 
+static void get_chat_room_descriptors() {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		list<MainDb::ChatRoomDescriptor> descriptors = mainDb.getChatRoomDescriptors();
+		// Built chat rooms sharing a conference id are merged, their descriptors are not.
+		const size_t chatRoomCount = mainDb.getChatRooms().size();
+		BC_ASSERT_GREATER(chatRoomCount, 11, size_t, "%zu");
+		BC_ASSERT_GREATER(descriptors.size(), chatRoomCount, size_t, "%zu");
+
+		time_t lastUpdateTime = descriptors.empty() ? 0 : descriptors.front().lastUpdateTime;
+		for (const auto &descriptor : descriptors) {
+			BC_ASSERT_LOWER(descriptor.lastUpdateTime, lastUpdateTime, time_t, "%ld");
+			lastUpdateTime = descriptor.lastUpdateTime;
+		}
+
+		list<MainDb::ChatRoomDescriptor> page = mainDb.getChatRoomDescriptors(10, 5);
+		BC_ASSERT_EQUAL(page.size(), 5, size_t, "%zu");
+		if (page.size() == 5 && descriptors.size() > 10) {
+			BC_ASSERT_TRUE(page.front().conferenceId == next(descriptors.begin(), 10)->conferenceId);
+		}
+
+		// A single chat room can be built from its descriptor.
+		if (!descriptors.empty()) {
+			shared_ptr<AbstractChatRoom> chatRoom = mainDb.getChatRoom(descriptors.front().conferenceId);
+			BC_ASSERT_PTR_NOT_NULL(chatRoom);
+			if (chatRoom) BC_ASSERT_TRUE(chatRoom->getConferenceId() == descriptors.front().conferenceId);
+		}
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void find_one_to_one_chat_rooms() {
+	MainDbProvider provider;
+	if (!provider.getMainDb().isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	LinphoneConfig *config = linphone_core_get_config(provider.getCore());
+	linphone_config_set_int(config, "misc", "hide_empty_chat_rooms", 0);
+	linphone_config_set_int(config, "misc", "hide_chat_rooms_from_removed_proxies", 0);
+	shared_ptr<Core> core = provider.getCore()->cppPtr;
+	list<shared_ptr<AbstractChatRoom>> chatRooms = core->getChatRooms();
+	BC_ASSERT_GREATER(chatRooms.size(), 0, size_t, "%zu");
+
+	shared_ptr<AbstractChatRoom> basicChatRoom;
+	for (const auto &chatRoom : chatRooms) {
+		list<shared_ptr<AbstractChatRoom>> peerChatRooms = core->findChatRooms(chatRoom->getPeerAddress());
+		BC_ASSERT_TRUE(find(peerChatRooms.begin(), peerChatRooms.end(), chatRoom) != peerChatRooms.end());
+
+		AbstractChatRoom::CapabilitiesMask capabilities = chatRoom->getCapabilities();
+		if (!(capabilities & AbstractChatRoom::Capabilities::OneToOne)) continue;
+
+		const bool encrypted = bool(capabilities & AbstractChatRoom::Capabilities::Encrypted);
+		if (capabilities & AbstractChatRoom::Capabilities::Basic) {
+			// Weakly duplicated chat rooms may be found instead.
+			shared_ptr<AbstractChatRoom> found = core->findOneToOneChatRoom(
+			    chatRoom->getLocalAddress(), chatRoom->getPeerAddress(), true, false, encrypted);
+			BC_ASSERT_PTR_NOT_NULL(found);
+			if (found) BC_ASSERT_TRUE(found->getPeerAddress()->weakEqual(*chatRoom->getPeerAddress()));
+			if (!basicChatRoom) basicChatRoom = chatRoom;
+		} else if (!chatRoom->getParticipants().empty()) {
+			const shared_ptr<Address> &participantAddress = chatRoom->getParticipants().front()->getAddress();
+			shared_ptr<AbstractChatRoom> found =
+			    core->findOneToOneChatRoom(chatRoom->getLocalAddress(), participantAddress, false, true, encrypted);
+			BC_ASSERT_PTR_NOT_NULL(found);
+			if (found)
+				BC_ASSERT_TRUE(found->getParticipants().front()->getAddress()->weakEqual(*participantAddress));
+		}
+	}
+
+	// Deleted chat rooms are removed from the indexes.
+	BC_ASSERT_PTR_NOT_NULL(basicChatRoom);
+	if (basicChatRoom) {
+		const bool encrypted = bool(basicChatRoom->getCapabilities() & AbstractChatRoom::Capabilities::Encrypted);
+		Core::deleteChatRoom(basicChatRoom);
+		BC_ASSERT_TRUE(core->findOneToOneChatRoom(basicChatRoom->getLocalAddress(), basicChatRoom->getPeerAddress(),
+		                                          true, false, encrypted) != basicChatRoom);
+		list<shared_ptr<AbstractChatRoom>> peerChatRooms = core->findChatRooms(basicChatRoom->getPeerAddress());
+		BC_ASSERT_TRUE(find(peerChatRooms.begin(), peerChatRooms.end(), basicChatRoom) == peerChatRooms.end());
+	}
+
+	// And created ones are added.
+	shared_ptr<Address> localAddress = Address::create("sip:index-local@sip.example.org");
+	shared_ptr<Address> peerAddress = Address::create("sip:index-peer@sip.example.org");
+	shared_ptr<AbstractChatRoom> chatRoom = core->getOrCreateBasicChatRoom(localAddress, peerAddress);
+	BC_ASSERT_PTR_NOT_NULL(chatRoom);
+	BC_ASSERT_PTR_EQUAL(core->findOneToOneChatRoom(localAddress, peerAddress, true, false, false), chatRoom);
+	BC_ASSERT_PTR_EQUAL(core->getOrCreateBasicChatRoom(localAddress, peerAddress), chatRoom);
+	BC_ASSERT_EQUAL(core->findChatRooms(peerAddress).size(), 1, size_t, "%zu");
+
+#ifdef HAVE_ADVANCED_IM
+	// One to one conference chat rooms are indexed again when their participant changes.
+	shared_ptr<Address> gruuAddress = Address::create("sip:index-local@sip.example.org;gr=index");
+	shared_ptr<Address> conferenceAddress = Address::create("sip:index-conference@sip.example.org");
+	shared_ptr<ChatRoomParams> params =
+	    ChatRoomParams::create("", false, false, ChatRoomParams::ChatRoomBackend::FlexisipChat);
+	shared_ptr<AbstractChatRoom> conferenceChatRoom = L_GET_PRIVATE(core)->createClientGroupChatRoom(
+	    "", conferenceAddress, ConferenceId(conferenceAddress, gruuAddress), Content(),
+	    ChatRoomParams::toCapabilities(params), params, false);
+	BC_ASSERT_PTR_NOT_NULL(conferenceChatRoom);
+	if (!conferenceChatRoom) return;
+	L_GET_PRIVATE(core)->insertChatRoom(conferenceChatRoom);
+
+	const shared_ptr<Conference> conference = conferenceChatRoom->getConference();
+	for (const char *uri : {"sip:index-first@sip.example.org", "sip:index-second@sip.example.org"}) {
+		const list<shared_ptr<Participant>> participants = conferenceChatRoom->getParticipants();
+		for (const auto &participant : participants) {
+			conference->removeParticipant(participant);
+			conference->notifyParticipantRemoved(time(nullptr), true, participant);
+		}
+
+		shared_ptr<Address> participantAddress = Address::create(uri);
+		conference->addParticipant(participantAddress);
+		conference->notifyParticipantAdded(time(nullptr), true, conference->findParticipant(participantAddress));
+		BC_ASSERT_PTR_EQUAL(core->findOneToOneChatRoom(gruuAddress, participantAddress, false, true, false),
+		                    conferenceChatRoom);
+	}
+	BC_ASSERT_PTR_NULL(core->findOneToOneChatRoom(gruuAddress, Address::create("sip:index-first@sip.example.org"),
+	                                              false, true, false));
+#endif // HAVE_ADVANCED_IM
+}
+
 static void set_get_conference_info() {
 	MainDbProvider provider;
 	MainDb &mainDb = provider.getMainDb();
@@ -360,6 +742,390 @@ static void get_chat_rooms() {
 	}
 }
 
+static void sip_address_interning_rollback(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	MainDbPrivate *d = L_GET_PRIVATE(&mainDb);
+	const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+	                                Address::create("sip:test-1@sip.linphone.org"));
+
+	// The transaction of this read is rolled back, the ids it selected are still valid.
+	BC_ASSERT_PTR_NOT_NULL(mainDb.getLastChatMessage(conferenceId));
+	BC_ASSERT_GREATER((int)d->getInternedSipAddressId(conferenceId.getPeerAddress()->toStringUriOnlyOrdered()), 0,
+	                  int, "%d");
+	BC_ASSERT_GREATER((int)d->getInternedSipAddressId(conferenceId.getLocalAddress()->toStringUriOnlyOrdered()), 0,
+	                  int, "%d");
+
+#ifdef HAVE_SOCI
+	// The row inserted by a rolled back transaction does not exist, its id is forgotten.
+	const auto device = Address::create("sip:rolled-back@sip.linphone.org;gr=urn:uuid:rolled-back");
+	const string deviceSipAddress = device->toStringUriOnlyOrdered();
+	{
+		SmartTransaction tr(d, __func__);
+		mainDb.insertDevice(device, "Rolled back");
+		BC_ASSERT_GREATER((int)d->getInternedSipAddressId(deviceSipAddress), 0, int, "%d");
+	}
+	BC_ASSERT_EQUAL((int)d->getInternedSipAddressId(deviceSipAddress), -1, int, "%d");
+	BC_ASSERT_EQUAL((int)d->getUncommittedSipAddressCount(), 0, int, "%d");
+#endif // HAVE_SOCI
+}
+
+static void write_behind_batching(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		list<shared_ptr<AbstractChatRoom>> chatRooms = mainDb.getChatRooms();
+		BC_ASSERT_FALSE(chatRooms.empty());
+		if (chatRooms.empty()) return;
+
+		shared_ptr<AbstractChatRoom> chatRoom = chatRooms.front();
+		const ConferenceId conferenceId = chatRoom->getConferenceId();
+		int initialCount = mainDb.getChatMessageCount(conferenceId);
+
+		// Long flush interval so that only the operation count triggers the commit.
+		mainDb.enableWriteBehind(true, 60000, 3);
+		BC_ASSERT_TRUE(mainDb.writeBehindEnabled());
+
+		int completed = 0;
+		int succeeded = 0;
+		auto onCompleted = [&completed, &succeeded](bool success) {
+			completed++;
+			if (success) succeeded++;
+		};
+		for (int i = 0; i < 2; i++) {
+			shared_ptr<ChatMessage> message = chatRoom->createChatMessageFromUtf8("Write-behind");
+			BC_ASSERT_TRUE(
+			    mainDb.addEvent(make_shared<ConferenceChatMessageEvent>(time(nullptr), message), onCompleted));
+		}
+
+		// Pending writes are visible but not committed yet.
+		BC_ASSERT_EQUAL(completed, 0, int, "%d");
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), initialCount + 2, int, "%d");
+
+		shared_ptr<ChatMessage> message = chatRoom->createChatMessageFromUtf8("Write-behind");
+		BC_ASSERT_TRUE(mainDb.addEvent(make_shared<ConferenceChatMessageEvent>(time(nullptr), message), onCompleted));
+		BC_ASSERT_EQUAL(completed, 3, int, "%d");
+		BC_ASSERT_EQUAL(succeeded, 3, int, "%d");
+
+		message = chatRoom->createChatMessageFromUtf8("Write-behind");
+		BC_ASSERT_TRUE(mainDb.addEvent(make_shared<ConferenceChatMessageEvent>(time(nullptr), message), onCompleted));
+		BC_ASSERT_EQUAL(completed, 3, int, "%d");
+		mainDb.flushPendingWrites();
+		BC_ASSERT_EQUAL(completed, 4, int, "%d");
+		BC_ASSERT_EQUAL(succeeded, 4, int, "%d");
+
+		mainDb.enableWriteBehind(false);
+		BC_ASSERT_FALSE(mainDb.writeBehindEnabled());
+
+		message = nullptr;
+		chatRoom = nullptr;
+		chatRooms.clear();
+		provider.reStart();
+		BC_ASSERT_EQUAL(provider.getMainDb().getChatMessageCount(conferenceId), initialCount + 4, int, "%d");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void write_behind_abort(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	list<shared_ptr<AbstractChatRoom>> chatRooms = mainDb.getChatRooms();
+	BC_ASSERT_FALSE(chatRooms.empty());
+	if (chatRooms.empty()) return;
+
+	shared_ptr<AbstractChatRoom> chatRoom = chatRooms.front();
+	const ConferenceId conferenceId = chatRoom->getConferenceId();
+	int initialCount = mainDb.getChatMessageCount(conferenceId);
+
+	mainDb.enableWriteBehind(true, 60000, 100);
+	int completed = 0;
+	int succeeded = 0;
+	auto onCompleted = [&completed, &succeeded](bool success) {
+		completed++;
+		if (success) succeeded++;
+	};
+
+	shared_ptr<ChatMessage> message = chatRoom->createChatMessageFromUtf8("Write-behind");
+	BC_ASSERT_TRUE(mainDb.addEvent(make_shared<ConferenceChatMessageEvent>(time(nullptr), message), onCompleted));
+	BC_ASSERT_EQUAL(completed, 0, int, "%d");
+
+	// A write outside of the batch commits it.
+	const shared_ptr<Address> uri = Address::create("sip:test-1@sip.linphone.org;conf-id=write-behind");
+	std::shared_ptr<ConferenceInfo> info = ConferenceInfo::create();
+	info->setOrganizer(Address::create("sip:test-47@sip.linphone.org"));
+	info->addParticipant(Address::create("sip:test-11@sip.linphone.org"));
+	info->setUri(uri);
+	info->setDateTime(1682770620);
+	BC_ASSERT_GREATER(mainDb.insertConferenceInfo(info), 0, long long, "%lld");
+	BC_ASSERT_EQUAL(completed, 1, int, "%d");
+	BC_ASSERT_EQUAL(succeeded, 1, int, "%d");
+
+	// Only the batched operations which follow are lost by an abort.
+	message = chatRoom->createChatMessageFromUtf8("Write-behind");
+	BC_ASSERT_TRUE(mainDb.addEvent(make_shared<ConferenceChatMessageEvent>(time(nullptr), message), onCompleted));
+	L_GET_PRIVATE(&mainDb)->abortWriteBehindBatch();
+	BC_ASSERT_EQUAL(completed, 2, int, "%d");
+	BC_ASSERT_EQUAL(succeeded, 1, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), initialCount + 1, int, "%d");
+	mainDb.enableWriteBehind(false);
+
+	info = nullptr;
+	message = nullptr;
+	chatRoom = nullptr;
+	chatRooms.clear();
+	provider.reStart();
+	BC_ASSERT_PTR_NOT_NULL(provider.getMainDb().getConferenceInfoFromURI(uri));
+	BC_ASSERT_EQUAL(provider.getMainDb().getChatMessageCount(conferenceId), initialCount + 1, int, "%d");
+}
+
+static void delete_events_in_batch(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-4@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		list<shared_ptr<EventLog>> history = mainDb.getHistory(conferenceId, 3, MainDb::ConferenceChatMessageFilter);
+		BC_ASSERT_EQUAL((int)history.size(), 3, int, "%d");
+		int initialCount = mainDb.getChatMessageCount(conferenceId);
+
+		list<shared_ptr<const EventLog>> events(history.begin(), history.end());
+		BC_ASSERT_TRUE(mainDb.deleteEvents(events));
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), initialCount - 3, int, "%d");
+		for (const auto &event : history)
+			BC_ASSERT_TRUE(static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage()->getStorageId() < 0);
+
+		// The last message of the chat room is one which is still in database.
+		shared_ptr<ChatMessage> lastMessage = mainDb.getLastChatMessage(conferenceId);
+		BC_ASSERT_PTR_NOT_NULL(lastMessage);
+		if (lastMessage) BC_ASSERT_TRUE(lastMessage->getStorageId() >= 0);
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void ephemeral_messages_scheduling(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	shared_ptr<Core> core = provider.getCore()->cppPtr;
+	CorePrivate *dCore = L_GET_PRIVATE(core);
+	const ConferenceId conferenceId(Address::create("sip:test-4@sip.linphone.org")->getSharedFromThis(),
+	                                Address::create("sip:test-1@sip.linphone.org"));
+	shared_ptr<AbstractChatRoom> chatRoom = core->findChatRoom(conferenceId);
+	BC_ASSERT_PTR_NOT_NULL(chatRoom);
+	if (!chatRoom) return;
+
+	// Far enough in the future for the timer not to fire during the test.
+	const time_t start = time(nullptr) + 3600;
+	list<shared_ptr<ChatMessage>> messages;
+	auto addEphemeralMessage = [&](time_t expireTime) {
+		shared_ptr<ChatMessage> message = chatRoom->createChatMessageFromUtf8("Ephemeral");
+		ChatMessagePrivate *dMessage = L_GET_PRIVATE(message);
+		dMessage->enableEphemeralWithTime(60);
+		dMessage->setEphemeralExpireTime(expireTime);
+		BC_ASSERT_TRUE(mainDb.addEvent(make_shared<ConferenceChatMessageEvent>(time(nullptr), message)));
+		messages.push_back(message);
+		return message;
+	};
+
+	// More messages than loaded at once, inserted out of order.
+	const int messageCount = EPHEMERAL_MESSAGE_TASKS_MAX_NB + 2;
+	for (int i = 0; i < messageCount; i++)
+		addEphemeralMessage(start + 10 * ((i * 7) % messageCount));
+	const int initialCount = mainDb.getChatMessageCount(conferenceId);
+
+	// The heap holds the first messages to expire, up to the last one loaded.
+	dCore->initEphemeralMessages();
+	const time_t horizon = start + 10 * (EPHEMERAL_MESSAGE_TASKS_MAX_NB - 1);
+	dCore->updateEphemeralMessages(addEphemeralMessage(start + 45));
+	dCore->updateEphemeralMessages(addEphemeralMessage(horizon + 100));
+
+	// Messages are deleted in the order of their expire time.
+	int deletedCount = 0;
+	for (int i = 0; i < EPHEMERAL_MESSAGE_TASKS_MAX_NB - 1; i++) {
+		dCore->handleEphemeralMessages(start + 10 * i + 1);
+		deletedCount += (i == 5) ? 2 : 1; // The message expiring at start + 45 goes with the one at start + 50.
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), initialCount + 2 - deletedCount, int, "%d");
+	}
+
+	// Messages expiring after the horizon are only loaded once the heap is empty, even if they expired meanwhile.
+	dCore->handleEphemeralMessages(horizon + 1000);
+	BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), initialCount + 2 - deletedCount - 1, int, "%d");
+	dCore->handleEphemeralMessages(horizon + 1000);
+	BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), initialCount - messageCount, int, "%d");
+}
+
+static void bulk_transfer(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+	                                Address::create("sip:test-1@sip.linphone.org"));
+	const int messageCount = mainDb.getChatMessageCount();
+	const int unreadMessageCount = mainDb.getUnreadChatMessageCount();
+	const int conferenceEventCount = mainDb.getEventCount(MainDb::ConferenceInfoFilter);
+
+	char *exportPath = bc_tester_file("bulk-export.db");
+	unlink(exportPath);
+
+	// Small batches to go through several transactions per table.
+	unsigned long long exportedEvents = 0;
+	int progressCount = 0;
+	BC_ASSERT_TRUE(mainDb.bulkExport(
+	    MainDb::Sqlite3, exportPath, MainDb::BulkAllEntities,
+	    [&exportedEvents, &progressCount](const string &table, unsigned long long rowCount) {
+		    progressCount++;
+		    if (table == "event") exportedEvents = rowCount;
+	    },
+	    1000));
+	BC_ASSERT_EQUAL((int)exportedEvents, mainDb.getEventCount(), int, "%d");
+	BC_ASSERT_GREATER(progressCount, 6, int, "%d");
+
+	// The chat rooms already exist, the events are appended to them.
+	BC_ASSERT_TRUE(mainDb.bulkImport(MainDb::Sqlite3, exportPath, MainDb::BulkChatEvents));
+	BC_ASSERT_EQUAL(mainDb.getChatMessageCount(), 2 * messageCount, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 2 * 861, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(), 2 * unreadMessageCount, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getEventCount(MainDb::ConferenceInfoFilter), 2 * conferenceEventCount, int, "%d");
+
+	unlink(exportPath);
+	bc_free(exportPath);
+}
+
+static void bulk_import_into_running_core(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	shared_ptr<Core> core = provider.getCore()->cppPtr;
+	const ConferenceId keptId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+	                          Address::create("sip:test-1@sip.linphone.org"));
+	const ConferenceId deletedId(Address::create("sip:test-4@sip.linphone.org")->getSharedFromThis(),
+	                             Address::create("sip:test-1@sip.linphone.org"));
+	// Also fills the unread count cache.
+	const int keptUnreadCount = mainDb.getUnreadChatMessageCount(keptId);
+	const int deletedMessageCount = mainDb.getChatMessageCount(deletedId);
+	BC_ASSERT_GREATER(deletedMessageCount, 0, int, "%d");
+
+	char *exportPath = bc_tester_file("bulk-export-core.db");
+	unlink(exportPath);
+	BC_ASSERT_TRUE(mainDb.bulkExport(MainDb::Sqlite3, exportPath, MainDb::BulkChatEvents));
+
+	shared_ptr<AbstractChatRoom> deletedChatRoom = core->findChatRoom(deletedId);
+	BC_ASSERT_PTR_NOT_NULL(deletedChatRoom);
+	if (deletedChatRoom) Core::deleteChatRoom(deletedChatRoom);
+	BC_ASSERT_PTR_NULL(core->findChatRoom(deletedId, false));
+
+	BC_ASSERT_TRUE(mainDb.bulkImport(MainDb::Sqlite3, exportPath, MainDb::BulkChatEvents));
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(keptId), 2 * keptUnreadCount, int, "%d");
+
+	// The imported chat room is available without restarting the core.
+	shared_ptr<AbstractChatRoom> importedChatRoom = core->findChatRoom(deletedId);
+	BC_ASSERT_PTR_NOT_NULL(importedChatRoom);
+	if (importedChatRoom) {
+		BC_ASSERT_FALSE(importedChatRoom->isEmpty());
+		BC_ASSERT_EQUAL(importedChatRoom->getChatMessageCount(), deletedMessageCount, int, "%d");
+	}
+
+	unlink(exportPath);
+	bc_free(exportPath);
+}
+
+static void bulk_transfer_phone_only_friends(void) {
+#ifdef HAVE_SOCI
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	soci::session &session = *L_GET_PRIVATE(&mainDb)->dbSession.getBackendSession();
+	auto countFriends = [&session]() {
+		int count = 0;
+		session << "SELECT count(*) FROM friend WHERE sip_address_id IS NULL AND v_card = 'phone-only'",
+		    soci::into(count);
+		return count;
+	};
+
+	long long friendsListId = 0;
+	session << "INSERT INTO friends_list (name, rls_uri, sync_uri, revision) VALUES ('bulk', '', '', 0)";
+	session << "SELECT id FROM friends_list WHERE name = 'bulk'", soci::into(friendsListId);
+	session << "INSERT INTO friend (friends_list_id, sip_address_id, subscribe_policy, send_subscribe, "
+	           "presence_received, starred, ref_key, v_card) VALUES (:listId, NULL, 0, 0, 0, 0, '', 'phone-only')",
+	    soci::use(friendsListId);
+
+	char *exportPath = bc_tester_file("bulk-export-friends.db");
+	unlink(exportPath);
+	BC_ASSERT_TRUE(mainDb.bulkExport(MainDb::Sqlite3, exportPath, MainDb::BulkFriends));
+
+	// Imported into a database without it, then reused by its vCard.
+	session << "DELETE FROM friend WHERE sip_address_id IS NULL";
+	BC_ASSERT_TRUE(mainDb.bulkImport(MainDb::Sqlite3, exportPath, MainDb::BulkFriends));
+	BC_ASSERT_EQUAL(countFriends(), 1, int, "%d");
+	BC_ASSERT_TRUE(mainDb.bulkImport(MainDb::Sqlite3, exportPath, MainDb::BulkFriends));
+	BC_ASSERT_EQUAL(countFriends(), 1, int, "%d");
+
+	unlink(exportPath);
+	bc_free(exportPath);
+#endif // HAVE_SOCI
+}
+
+static void query_plans(void) {
+#ifdef HAVE_SOCI
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (!mainDb.isInitialized()) {
+		BC_FAIL("Database not initialized");
+		return;
+	}
+
+	list<string> scans;
+	{
+		QueryPlanAuditor auditor(mainDb);
+
+		mainDb.getCallHistoryForLocalAddress(Address::create("sip:test-1@sip.linphone.org"), 10);
+		mainDb.findChatMessagesFromCallId("query-plans-call-id");
+		mainDb.getConferenceInfos(1682770620);
+
+		std::shared_ptr<ConferenceInfo> info = ConferenceInfo::create();
+		info->setOrganizer(Address::create("sip:test-47@sip.linphone.org"));
+		info->addParticipant(Address::create("sip:test-11@sip.linphone.org"));
+		info->setUri(Address::create("sip:test-1@sip.linphone.org;conf-id=query-plans"));
+		info->setDateTime(1682770620);
+		mainDb.insertConferenceInfo(info);
+
+		scans = auditor.getFullTableScans();
+	}
+
+	for (const auto &scan : scans)
+		ms_error("Full table scan: %s", scan.c_str());
+	BC_ASSERT_TRUE(scans.empty());
+#endif // HAVE_SOCI
+}
+
 static void load_a_lot_of_chatrooms(void) {
 	long expectedDurationMs = 600;
 	float referenceBogomips = 6384.00; // the bogomips on the shuttle-linux (x86_64)
@@ -422,9 +1188,24 @@ test_t main_db_tests[] = {TEST_NO_TAG("Get events count", get_events_count),
                           TEST_NO_TAG("Get messages count", get_messages_count),
                           TEST_NO_TAG("Get unread messages count", get_unread_messages_count),
                           TEST_NO_TAG("Get history", get_history),
+                          TEST_NO_TAG("Get history before", get_history_before),
+                          TEST_NO_TAG("Prepared statements cache", prepared_statements_cache),
+                          TEST_NO_TAG("Read sessions", read_sessions),
+                          TEST_NO_TAG("Get history asynchronously", get_history_async),
                           TEST_NO_TAG("Get conference events", get_conference_notified_events),
                           TEST_NO_TAG("Get chat rooms", get_chat_rooms),
+                          TEST_NO_TAG("Get chat room descriptors", get_chat_room_descriptors),
+                          TEST_NO_TAG("Find one to one chat rooms", find_one_to_one_chat_rooms),
                           TEST_NO_TAG("Set/get conference info", set_get_conference_info),
+                          TEST_NO_TAG("Write-behind batching", write_behind_batching),
+                          TEST_NO_TAG("Write-behind abort", write_behind_abort),
+                          TEST_NO_TAG("Sip address interning rollback", sip_address_interning_rollback),
+                          TEST_NO_TAG("Delete events in batch", delete_events_in_batch),
+                          TEST_NO_TAG("Ephemeral messages scheduling", ephemeral_messages_scheduling),
+                          TEST_NO_TAG("Bulk transfer", bulk_transfer),
+                          TEST_NO_TAG("Bulk import into a running core", bulk_import_into_running_core),
+                          TEST_NO_TAG("Bulk transfer of phone only friends", bulk_transfer_phone_only_friends),
+                          TEST_NO_TAG("Query plans", query_plans),
                           TEST_NO_TAG("Load a lot of chatrooms", load_a_lot_of_chatrooms),
                           TEST_NO_TAG("Load chatroom and conference", load_chatroom_conference)};
 
@@ -1174,8 +1174,10 @@ void transfer_message_base4(LinphoneCoreManager *marie,
 		BC_ASSERT_TRUE(
 		    wait_for_until(pauline->lc, marie->lc, &marie->stat.number_of_LinphoneMessageReceivedWithFile, 1, 60000));
 		if (two_files) {
+			// Both files are uploaded at the same time, the message is done once the last one is.
 			BC_ASSERT_TRUE(wait_for_until(pauline->lc, marie->lc,
-			                              &pauline->stat.number_of_LinphoneMessageFileTransferDone, 2, 1000));
+			                              &pauline->stat.number_of_LinphoneMessageFileTransferDone, 1, 1000));
+			BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferDone, 1, int, "%d");
 		}
 
 		if (marie->stat.last_received_chat_message) {
@@ -1296,8 +1298,7 @@ void transfer_message_base4(LinphoneCoreManager *marie,
 			}
 		}
 		BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageInProgress, 1, int, "%d");
-		if (two_files) BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferInProgress, 2, int, "%d");
-		else BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferInProgress, 1, int, "%d");
+		BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferInProgress, 1, int, "%d");
 		if (linphone_im_notif_policy_get_recv_imdn_displayed(linphone_core_get_im_notif_policy(pauline->lc)) &&
 		    linphone_im_notif_policy_get_send_imdn_delivered(linphone_core_get_im_notif_policy(marie->lc))) {
 			// In case imdn arrives before 200ok, state Delivered is never be notified
@@ -1989,6 +1990,156 @@ static void transfer_message_download_cancelled(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+static void transfer_message_download_resumed_after_io_error(void) {
+	LinphoneChatRoom *chat_room;
+	LinphoneChatMessage *msg;
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
+	char *send_filepath = bc_tester_res("sounds/sintel_trailer_opus_h264.mkv");
+	char *receive_filepath = bc_tester_file("receive_file.dump");
+
+	/* Globally configure an http file transfer server. */
+	linphone_core_set_file_transfer_server(pauline->lc, file_transfer_url);
+	/* Keep on resuming the download as long as the network error lasts */
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "misc", "file_transfer_download_max_retries", 100);
+
+	/* create a chatroom on pauline's side */
+	chat_room = linphone_core_get_chat_room(pauline->lc, marie->identity);
+	msg = create_message_from_sintel_trailer(chat_room);
+	linphone_chat_message_send(msg);
+
+	/* wait for marie to receive pauline's msg */
+	BC_ASSERT_TRUE(
+	    wait_for_until(pauline->lc, marie->lc, &marie->stat.number_of_LinphoneMessageReceivedWithFile, 1, 60000));
+
+	LinphoneChatMessage *marie_msg = marie->stat.last_received_chat_message;
+	if (marie_msg) {
+		LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(marie_msg);
+		linphone_chat_message_cbs_set_msg_state_changed(cbs, liblinphone_tester_chat_message_msg_state_changed);
+		linphone_chat_message_cbs_set_file_transfer_progress_indication(cbs, file_transfer_progress_indication);
+		/* Only a download to a file can be resumed */
+		remove(receive_filepath);
+		linphone_chat_message_set_file_transfer_filepath(marie_msg, receive_filepath);
+		linphone_chat_message_download_file(marie_msg);
+
+		/* wait for file to be 10% downloaded and simulate a network error for a while */
+		BC_ASSERT_TRUE(wait_for(pauline->lc, marie->lc, &marie->stat.progress_of_LinphoneFileTransfer, 10));
+		belle_http_provider_set_recv_error(linphone_core_get_http_provider(marie->lc), -1);
+		wait_for_until(pauline->lc, marie->lc, NULL, 0, 200);
+		belle_http_provider_set_recv_error(linphone_core_get_http_provider(marie->lc), 1);
+
+		/* the rest of the file is appended to the part received before the error */
+		if (BC_ASSERT_TRUE(wait_for_until(pauline->lc, marie->lc,
+		                                  &marie->stat.number_of_LinphoneFileTransferDownloadSuccessful, 1, 55000))) {
+			compare_files(send_filepath, receive_filepath);
+		}
+		BC_ASSERT_TRUE(wait_for(pauline->lc, marie->lc, &marie->stat.number_of_LinphoneMessageFileTransferDone, 1));
+		BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneMessageFileTransferError, 0, int, "%d");
+	}
+
+	remove(receive_filepath);
+	bc_free(receive_filepath);
+	bc_free(send_filepath);
+	linphone_chat_message_unref(msg);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+static void transfer_message_2_files_downloaded_simultaneously_base(bool_t one_transfer_at_a_time) {
+	if (!linphone_factory_is_database_storage_available(linphone_factory_get())) {
+		ms_warning("Test skipped, database storage is not available");
+		return;
+	}
+
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
+	char *send_filepath = bc_tester_res("sounds/sintel_trailer_opus_h264.mkv");
+	char *send_filepath2 = bc_tester_res("sounds/ahbahouaismaisbon.wav");
+	char *receive_filepath = bc_tester_file("receive_file.dump");
+	char *receive_filepath2 = bc_tester_file("receive_file_2.dump");
+
+	/* Globally configure an http file transfer server. */
+	linphone_core_set_file_transfer_server(pauline->lc, file_transfer_url);
+	if (one_transfer_at_a_time) {
+		/* the second download waits for the first one to be done */
+		linphone_config_set_int(linphone_core_get_config(marie->lc), "misc", "max_parallel_file_transfers", 1);
+	}
+
+	/* create a chatroom on pauline's side and a message with two files */
+	LinphoneChatRoom *chat_room = linphone_core_get_chat_room(pauline->lc, marie->identity);
+	linphone_chat_room_allow_multipart(chat_room);
+	linphone_chat_room_allow_cpim(chat_room);
+	LinphoneChatMessage *msg = create_file_transfer_message_from_sintel_trailer(chat_room);
+	LinphoneContent *content = linphone_core_create_content(pauline->lc);
+	linphone_content_set_type(content, "audio");
+	linphone_content_set_subtype(content, "wav");
+	linphone_content_set_name(content, "ahbahouaismaisbon.wav");
+	linphone_content_set_file_path(content, send_filepath2);
+	linphone_chat_message_add_file_content(msg, content);
+	linphone_content_unref(content);
+	linphone_chat_message_send(msg);
+
+	BC_ASSERT_TRUE(
+	    wait_for_until(pauline->lc, marie->lc, &marie->stat.number_of_LinphoneMessageReceivedWithFile, 1, 60000));
+	/* both files were uploaded at the same time */
+	BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferInProgress, 1, int, "%d");
+	BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferDone, 1, int, "%d");
+
+	LinphoneChatMessage *recv_msg = marie->stat.last_received_chat_message;
+	if (BC_ASSERT_PTR_NOT_NULL(recv_msg)) {
+		LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(recv_msg);
+		linphone_chat_message_cbs_set_msg_state_changed(cbs, liblinphone_tester_chat_message_msg_state_changed);
+		linphone_chat_message_cbs_set_file_transfer_progress_indication(cbs, file_transfer_progress_indication);
+
+		/* The downloaded contents are replaced in the message, keep a ref on them */
+		bctbx_list_t *contents = bctbx_list_copy_with_data(linphone_chat_message_get_contents(recv_msg),
+		                                                   (bctbx_list_copy_func)linphone_content_ref);
+		BC_ASSERT_EQUAL((int)bctbx_list_size(contents), 2, int, "%d");
+		remove(receive_filepath);
+		remove(receive_filepath2);
+		for (bctbx_list_t *it = contents; it != NULL; it = bctbx_list_next(it)) {
+			LinphoneContent *file_transfer_content = (LinphoneContent *)bctbx_list_get_data(it);
+			BC_ASSERT_TRUE(linphone_content_is_file_transfer(file_transfer_content));
+			bool_t is_sintel =
+			    strcmp(linphone_content_get_name(file_transfer_content), "sintel_trailer_opus_h264.mkv") == 0;
+			linphone_content_set_file_path(file_transfer_content, is_sintel ? receive_filepath : receive_filepath2);
+			/* the second download does not wait for the first one to be done */
+			BC_ASSERT_TRUE(linphone_chat_message_download_content(recv_msg, file_transfer_content));
+		}
+		BC_ASSERT_TRUE(linphone_chat_message_is_file_transfer_in_progress(recv_msg));
+
+		if (BC_ASSERT_TRUE(wait_for_until(pauline->lc, marie->lc,
+		                                  &marie->stat.number_of_LinphoneFileTransferDownloadSuccessful, 2, 55000))) {
+			compare_files(send_filepath, receive_filepath);
+			compare_files(send_filepath2, receive_filepath2);
+		}
+		/* the message is done once the last of its files is */
+		BC_ASSERT_TRUE(wait_for(pauline->lc, marie->lc, &marie->stat.number_of_LinphoneMessageFileTransferDone, 1));
+		BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneMessageFileTransferInProgress, 1, int, "%d");
+		BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneMessageFileTransferDone, 1, int, "%d");
+		BC_ASSERT_FALSE(linphone_chat_message_is_file_transfer_in_progress(recv_msg));
+		bctbx_list_free_with_data(contents, (bctbx_list_free_func)linphone_content_unref);
+	}
+
+	remove(receive_filepath);
+	remove(receive_filepath2);
+	bc_free(receive_filepath);
+	bc_free(receive_filepath2);
+	bc_free(send_filepath);
+	bc_free(send_filepath2);
+	linphone_chat_message_unref(msg);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+static void transfer_message_2_files_downloaded_simultaneously(void) {
+	transfer_message_2_files_downloaded_simultaneously_base(FALSE);
+}
+
+static void transfer_message_2_files_downloaded_one_at_a_time(void) {
+	transfer_message_2_files_downloaded_simultaneously_base(TRUE);
+}
+
 static void transfer_message_auto_download_aborted(void) {
 	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
 	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
@@ -3985,6 +4136,10 @@ test_t message_tests[] = {
     TEST_NO_TAG("Transfer message upload cancelled", transfer_message_upload_cancelled),
     TEST_NO_TAG("Transfer message upload finished during stop", transfer_message_upload_finished_during_stop),
     TEST_NO_TAG("Transfer message download cancelled", transfer_message_download_cancelled),
+    TEST_NO_TAG("Transfer message download resumed after io error", transfer_message_download_resumed_after_io_error),
+    TEST_NO_TAG("Transfer message 2 files downloaded simultaneously",
+                transfer_message_2_files_downloaded_simultaneously),
+    TEST_NO_TAG("Transfer message 2 files downloaded one at a time", transfer_message_2_files_downloaded_one_at_a_time),
     TEST_NO_TAG("Transfer message auto download aborted", transfer_message_auto_download_aborted),
     TEST_NO_TAG("Transfer message core stopped async 1", transfer_message_core_stopped_async_1),
     TEST_NO_TAG("Transfer message core stopped async 2", transfer_message_core_stopped_async_2),
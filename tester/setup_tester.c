@@ -414,6 +414,57 @@ static void linphone_address_test(void) {
 	linphone_address_unref(address);
 }
 
+static void linphone_buffer_view_test(void) {
+	const char data[] = "chunk-of-a-larger-transfer";
+
+	// The view covers "chunk", the borrowed memory goes on after it without a NUL.
+	LinphoneBuffer *view = linphone_buffer_new_view((const uint8_t *)data, 5);
+	BC_ASSERT_TRUE(linphone_buffer_get_size(view) == 5);
+	BC_ASSERT_PTR_EQUAL(linphone_buffer_get_content(view), data);
+	BC_ASSERT_STRING_EQUAL(linphone_buffer_get_string_content(view), "chunk");
+	BC_ASSERT_TRUE(linphone_buffer_get_content(view) != (const uint8_t *)data);
+	BC_ASSERT_TRUE(linphone_buffer_get_size(view) == 5);
+	linphone_buffer_release_view(view);
+
+	// A view kept by the application gets its own copy when it is released.
+	view = linphone_buffer_new_view((const uint8_t *)data, 5);
+	linphone_buffer_ref(view);
+	linphone_buffer_release_view(view);
+	BC_ASSERT_TRUE(linphone_buffer_get_content(view) != (const uint8_t *)data);
+	BC_ASSERT_STRING_EQUAL(linphone_buffer_get_string_content(view), "chunk");
+	linphone_buffer_unref(view);
+}
+
+static void check_address_uri_only(const LinphoneAddress *address, const char *expected) {
+	char *str = linphone_address_as_string_uri_only(address);
+	BC_ASSERT_STRING_EQUAL(str, expected);
+	ms_free(str);
+}
+
+static void linphone_address_cached_forms_test(void) {
+	LinphoneAddress *address = linphone_address_new("sip:pauline@sip.example.org");
+	if (!BC_ASSERT_PTR_NOT_NULL(address)) return;
+
+	/* The URI only form is computed once, then every setter must drop it. */
+	check_address_uri_only(address, "sip:pauline@sip.example.org");
+	check_address_uri_only(address, "sip:pauline@sip.example.org");
+	linphone_address_set_username(address, "marie");
+	check_address_uri_only(address, "sip:marie@sip.example.org");
+	linphone_address_set_port(address, 5070);
+	check_address_uri_only(address, "sip:marie@sip.example.org:5070");
+	linphone_address_set_uri_param(address, "gr", "urn:uuid:1234");
+	check_address_uri_only(address, "sip:marie@sip.example.org:5070;gr=urn:uuid:1234");
+
+	LinphoneAddress *clone = linphone_address_clone(address);
+	check_address_uri_only(clone, "sip:marie@sip.example.org:5070;gr=urn:uuid:1234");
+	linphone_address_remove_uri_param(clone, "gr");
+	check_address_uri_only(clone, "sip:marie@sip.example.org:5070");
+	check_address_uri_only(address, "sip:marie@sip.example.org:5070;gr=urn:uuid:1234");
+
+	linphone_address_unref(clone);
+	linphone_address_unref(address);
+}
+
 static void core_sip_transport_test(void) {
 	LinphoneCore *lc;
 	LCSipTransports tr;
@@ -639,6 +690,240 @@ static void linphone_lpconfig_from_file_zerolen_value(void) {
 	linphone_config_destroy(conf);
 }
 
+static void linphone_lpconfig_many_sections(void) {
+	const int sectionCount = 250;
+	const int keyCount = 20;
+	const int loopCount = 20;
+	char section[32];
+	char key[32];
+	LpConfig *conf = linphone_config_new_from_buffer("# Provisioning with many accounts\n[misc]\nversion=1\n");
+
+	uint64_t start = bctbx_get_cur_time_ms();
+	for (int i = 0; i < sectionCount; i++) {
+		snprintf(section, sizeof(section), "proxy_%i", i);
+		for (int j = 0; j < keyCount; j++) {
+			snprintf(key, sizeof(key), "key_%i", j);
+			linphone_config_set_int(conf, section, key, i * keyCount + j);
+		}
+	}
+	uint64_t setDuration = bctbx_get_cur_time_ms() - start;
+
+	int errors = 0;
+	start = bctbx_get_cur_time_ms();
+	for (int loop = 0; loop < loopCount; loop++) {
+		for (int i = 0; i < sectionCount; i++) {
+			snprintf(section, sizeof(section), "proxy_%i", i);
+			for (int j = 0; j < keyCount; j++) {
+				snprintf(key, sizeof(key), "key_%i", j);
+				if (linphone_config_get_int(conf, section, key, -1) != i * keyCount + j) errors++;
+			}
+		}
+	}
+	uint64_t getDuration = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_EQUAL(errors, 0, int, "%d");
+	ms_message("LPConfig with %i sections of %i keys: %i sets in %llu ms, %i gets in %llu ms", sectionCount, keyCount,
+	           sectionCount * keyCount, (unsigned long long)setDuration, loopCount * sectionCount * keyCount,
+	           (unsigned long long)getDuration);
+
+	// Removed entries and sections can no longer be found, the others still can
+	linphone_config_clean_entry(conf, "proxy_10", "key_5");
+	BC_ASSERT_FALSE(linphone_config_has_entry(conf, "proxy_10", "key_5"));
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "proxy_10", "key_6", -1), 10 * keyCount + 6, int, "%d");
+	linphone_config_clean_section(conf, "proxy_20");
+	BC_ASSERT_FALSE(linphone_config_has_section(conf, "proxy_20"));
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "proxy_21", "key_0", -1), 21 * keyCount, int, "%d");
+	linphone_config_set_int(conf, "proxy_20", "key_0", 42);
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "proxy_20", "key_0", -1), 42, int, "%d");
+
+	// Sections keep their insertion order
+	char *dump = linphone_config_dump(conf);
+	BC_ASSERT_PTR_NOT_NULL(strstr(dump, "[proxy_0]"));
+	BC_ASSERT_TRUE(strstr(dump, "[misc]") < strstr(dump, "[proxy_0]"));
+	BC_ASSERT_TRUE(strstr(dump, "[proxy_0]") < strstr(dump, "[proxy_1]"));
+	BC_ASSERT_TRUE(strstr(dump, "[proxy_21]") < strstr(dump, "[proxy_20]"));
+	bctbx_free(dump);
+
+	linphone_config_destroy(conf);
+}
+
+static void linphone_lpconfig_snapshot_cache(void) {
+	char *res = bc_tester_res("rcfiles/marie_rc");
+	char *file = bc_tester_file("snapshot_marie_rc");
+	char *snapshot = bctbx_strdup_printf("%s.snapshot", file);
+
+	BC_ASSERT_EQUAL(liblinphone_tester_copy_file(res, file), 0, int, "%d");
+	unlink(snapshot);
+	linphone_config_enable_snapshot_cache(TRUE);
+
+	/* The first instantiation parses the file and saves the snapshot. */
+	LinphoneConfig *cfg = linphone_config_new(file);
+	BC_ASSERT_PTR_NOT_NULL(cfg);
+	BC_ASSERT_TRUE(bctbx_file_exist(snapshot) == 0);
+	char *parsed = linphone_config_dump(cfg);
+	linphone_config_destroy(cfg);
+
+	/* The second one loads the snapshot, with the same content. */
+	cfg = linphone_config_new(file);
+	char *loaded = linphone_config_dump(cfg);
+	BC_ASSERT_STRING_EQUAL(loaded, parsed);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(cfg, "proxy_0", "realm", NULL), "sip.example.org");
+	bctbx_free(loaded);
+	bctbx_free(parsed);
+
+	/* Changing the file outdates the snapshot. */
+	linphone_config_set_string(cfg, "misc", "somekey", "somevalue");
+	linphone_config_sync(cfg);
+	linphone_config_destroy(cfg);
+	cfg = linphone_config_new(file);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(cfg, "misc", "somekey", NULL), "somevalue");
+	linphone_config_destroy(cfg);
+
+	/* A corrupted snapshot is ignored. */
+	FILE *f = fopen(snapshot, "r+b");
+	if (BC_ASSERT_PTR_NOT_NULL(f)) {
+		fseek(f, -1, SEEK_END);
+		fputc('#', f);
+		fclose(f);
+	}
+	cfg = linphone_config_new(file);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(cfg, "misc", "somekey", NULL), "somevalue");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(cfg, "proxy_0", "realm", NULL), "sip.example.org");
+	linphone_config_destroy(cfg);
+
+	linphone_config_enable_snapshot_cache(FALSE);
+	unlink(snapshot);
+	unlink(file);
+	bctbx_free(snapshot);
+	bc_free(res);
+	bc_free(file);
+}
+
+/* Reads the value of an entry in the file, NULL if it was not written yet. */
+static char *linphone_lpconfig_read_entry(const char *file, const char *section, const char *key) {
+	LinphoneConfig *cfg = linphone_config_new(file);
+	if (!cfg) return NULL;
+	const char *value = linphone_config_get_string(cfg, section, key, NULL);
+	char *result = value ? bctbx_strdup(value) : NULL;
+	linphone_config_destroy(cfg);
+	return result;
+}
+
+static bool_t linphone_lpconfig_wait_for_entry(const char *file, const char *section, const char *key, int timeout_ms) {
+	uint64_t start = bctbx_get_cur_time_ms();
+	while (bctbx_get_cur_time_ms() - start < (uint64_t)timeout_ms) {
+		char *value = linphone_lpconfig_read_entry(file, section, key);
+		if (value) {
+			bctbx_free(value);
+			return TRUE;
+		}
+		ms_usleep(20000);
+	}
+	return FALSE;
+}
+
+static void linphone_lpconfig_background_sync(void) {
+	char *res = bc_tester_res("rcfiles/marie_rc");
+	char *file = bc_tester_file("background_sync_marie_rc");
+
+	BC_ASSERT_EQUAL(liblinphone_tester_copy_file(res, file), 0, int, "%d");
+	LinphoneConfig *cfg = linphone_config_new(file);
+	BC_ASSERT_PTR_NOT_NULL(cfg);
+
+	/* The file is written by the background thread once the delay is over. */
+	linphone_config_set_string(cfg, "misc", "first", "1");
+	BC_ASSERT_EQUAL(linphone_config_sync_in_background(cfg, 1000), 0, int, "%d");
+	BC_ASSERT_FALSE(linphone_config_needs_commit(cfg));
+	char *value = linphone_lpconfig_read_entry(file, "misc", "first");
+	BC_ASSERT_PTR_NULL(value);
+	bctbx_free(value);
+
+	/* A snapshot posted before the deadline replaces the pending one, both changes are written at once. */
+	linphone_config_set_string(cfg, "misc", "second", "2");
+	linphone_config_sync_in_background(cfg, 1000);
+	BC_ASSERT_TRUE(linphone_lpconfig_wait_for_entry(file, "misc", "first", 5000));
+	value = linphone_lpconfig_read_entry(file, "misc", "second");
+	BC_ASSERT_STRING_EQUAL(value, "2");
+	bctbx_free(value);
+
+	/* Flushing writes the pending snapshot without waiting for its delay. */
+	linphone_config_set_string(cfg, "misc", "third", "3");
+	linphone_config_sync_in_background(cfg, 60000);
+	linphone_config_flush_background_sync(cfg);
+	value = linphone_lpconfig_read_entry(file, "misc", "third");
+	BC_ASSERT_STRING_EQUAL(value, "3");
+	bctbx_free(value);
+
+	/* A failed write leaves the changes to be synced again. */
+	linphone_config_simulate_crash_during_sync(cfg, TRUE);
+	linphone_config_set_string(cfg, "misc", "fourth", "4");
+	linphone_config_sync_in_background(cfg, 0);
+	linphone_config_flush_background_sync(cfg);
+	BC_ASSERT_TRUE(linphone_config_needs_commit(cfg));
+	value = linphone_lpconfig_read_entry(file, "misc", "fourth");
+	BC_ASSERT_PTR_NULL(value);
+	bctbx_free(value);
+	linphone_config_simulate_crash_during_sync(cfg, FALSE);
+	linphone_config_sync_in_background(cfg, 0);
+	linphone_config_flush_background_sync(cfg);
+	BC_ASSERT_FALSE(linphone_config_needs_commit(cfg));
+	value = linphone_lpconfig_read_entry(file, "misc", "fourth");
+	BC_ASSERT_STRING_EQUAL(value, "4");
+	bctbx_free(value);
+
+	/* Destroying the config writes the pending snapshot. */
+	linphone_config_set_string(cfg, "misc", "fifth", "5");
+	linphone_config_sync_in_background(cfg, 60000);
+	linphone_config_destroy(cfg);
+	value = linphone_lpconfig_read_entry(file, "misc", "fifth");
+	BC_ASSERT_STRING_EQUAL(value, "5");
+	bctbx_free(value);
+
+	unlink(file);
+	bc_free(res);
+	bc_free(file);
+}
+
+static void linphone_lpconfig_dirty_sections(void) {
+	char *res = bc_tester_res("rcfiles/marie_rc");
+	char *file = bc_tester_file("dirty_sections_marie_rc");
+
+	BC_ASSERT_EQUAL(liblinphone_tester_copy_file(res, file), 0, int, "%d");
+	LinphoneConfig *cfg = linphone_config_new(file);
+	BC_ASSERT_PTR_NOT_NULL(cfg);
+	/* Every section gets its cached text. */
+	linphone_config_sync(cfg);
+
+	/* Each kind of change must make the cached text of its section outdated. */
+	linphone_config_set_string(cfg, "proxy_0", "realm", "sip.example.com");
+	linphone_config_set_int(cfg, "sip", "new_key", 42);
+	linphone_config_clean_entry(cfg, "rtp", "audio_rtp_port");
+	linphone_config_clean_section(cfg, "auth_info_0");
+	linphone_config_set_string(cfg, "new_section", "key", "value");
+	linphone_config_sync(cfg);
+
+	/* Syncing again without change reuses the cached text of every section. */
+	linphone_config_sync(cfg);
+
+	LinphoneConfig *reloaded = linphone_config_new(file);
+	BC_ASSERT_PTR_NOT_NULL(reloaded);
+	char *expected = linphone_config_dump(cfg);
+	char *written = linphone_config_dump(reloaded);
+	BC_ASSERT_STRING_EQUAL(written, expected);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(reloaded, "proxy_0", "realm", NULL), "sip.example.com");
+	BC_ASSERT_EQUAL(linphone_config_get_int(reloaded, "sip", "new_key", 0), 42, int, "%d");
+	BC_ASSERT_FALSE(linphone_config_has_entry(reloaded, "rtp", "audio_rtp_port"));
+	BC_ASSERT_FALSE(linphone_config_has_section(reloaded, "auth_info_0"));
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(reloaded, "new_section", "key", NULL), "value");
+	bctbx_free(expected);
+	bctbx_free(written);
+	linphone_config_destroy(reloaded);
+	linphone_config_destroy(cfg);
+
+	unlink(file);
+	bc_free(res);
+	bc_free(file);
+}
+
 void linphone_lpconfig_invalid_friend(void) {
 	LinphoneCoreManager *mgr = linphone_core_manager_new_with_proxies_check("invalid_friends_rc", FALSE);
 	LinphoneFriendList *friendList = linphone_core_get_default_friend_list(mgr->lc);
@@ -1584,6 +1869,44 @@ static void search_friend_with_phone_number_2(void) {
 	linphone_core_manager_destroy(manager);
 }
 
+static void find_friend_by_phone_number_after_edition(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("chloe_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+	LinphoneFriend *stephanieFriend = linphone_core_create_friend(manager->lc);
+	LinphoneFriend *laureFriend = linphone_core_create_friend(manager->lc);
+
+	linphone_friend_set_name(stephanieFriend, "stephanie de monaco");
+	linphone_friend_add_phone_number(stephanieFriend, "0633889977");
+	linphone_friend_list_add_friend(lfl, stephanieFriend);
+	linphone_friend_set_name(laureFriend, "Laure");
+	linphone_friend_add_phone_number(laureFriend, "+33641424344");
+	linphone_friend_list_add_friend(lfl, laureFriend);
+
+	BC_ASSERT_PTR_EQUAL(linphone_friend_list_find_friend_by_phone_number(lfl, "0633889977"), stephanieFriend);
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_phone_number(lfl, "0612131415"));
+
+	// Phone numbers added after a first lookup can be found
+	linphone_friend_add_phone_number(laureFriend, "0612131415");
+	BC_ASSERT_PTR_EQUAL(linphone_friend_list_find_friend_by_phone_number(lfl, "06 12 13 14 15"), laureFriend);
+
+	// A number shared by two friends resolves to the other one once removed from the first
+	linphone_friend_add_phone_number(stephanieFriend, "0612131415");
+	BC_ASSERT_PTR_EQUAL(linphone_friend_list_find_friend_by_phone_number(lfl, "0612131415"), laureFriend);
+	linphone_friend_remove_phone_number(laureFriend, "0612131415");
+	BC_ASSERT_PTR_EQUAL(linphone_friend_list_find_friend_by_phone_number(lfl, "0612131415"), stephanieFriend);
+
+	// Removed friends can no longer be found
+	linphone_friend_list_remove_friend(lfl, stephanieFriend);
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_phone_number(lfl, "0612131415"));
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_phone_number(lfl, "0633889977"));
+	BC_ASSERT_PTR_EQUAL(linphone_friend_list_find_friend_by_phone_number(lfl, "+33641424344"), laureFriend);
+
+	linphone_friend_list_remove_friend(lfl, laureFriend);
+	linphone_friend_unref(stephanieFriend);
+	linphone_friend_unref(laureFriend);
+	linphone_core_manager_destroy(manager);
+}
+
 static void search_friend_with_presence(void) {
 	LinphoneMagicSearch *magicSearch = NULL;
 	bctbx_list_t *resultList = NULL;
@@ -1672,6 +1995,61 @@ static void search_friend_with_presence(void) {
 	linphone_core_manager_destroy(manager);
 }
 
+static void search_friend_after_edition(void) {
+	LinphoneMagicSearch *magicSearch = NULL;
+	bctbx_list_t *resultList = NULL;
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+
+	_create_friends_from_tab(manager->lc, lfl, sFriends, sSizeFriend);
+	LinphoneFriend *zorro = linphone_core_create_friend_with_address(manager->lc, "sip:zorro@sip.example.org");
+	linphone_friend_list_add_friend(lfl, zorro);
+
+	magicSearch = linphone_magic_search_new(manager->lc);
+
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "zorr", "", LinphoneMagicSearchSourceFriends,
+	                                                     LinphoneMagicSearchAggregationNone);
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, "sip:zorro@sip.example.org", NULL);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+
+	// The friends index is updated once the edition is done.
+	LinphoneAddress *bernardoAddress = linphone_address_new("sip:bernardo@sip.example.org");
+	linphone_friend_edit(zorro);
+	linphone_friend_set_address(zorro, bernardoAddress);
+	linphone_friend_set_name(zorro, "Bernardo");
+	linphone_friend_done(zorro);
+	linphone_address_unref(bernardoAddress);
+
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "zo", "", LinphoneMagicSearchSourceFriends,
+	                                                     LinphoneMagicSearchAggregationNone);
+	BC_ASSERT_PTR_NULL(resultList);
+	if (resultList) bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "bernard", "", LinphoneMagicSearchSourceFriends,
+	                                                     LinphoneMagicSearchAggregationNone);
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, "sip:bernardo@sip.example.org", NULL);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+
+	linphone_friend_list_remove_friend(lfl, zorro);
+	linphone_friend_unref(zorro);
+
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "bernard", "", LinphoneMagicSearchSourceFriends,
+	                                                     LinphoneMagicSearchAggregationNone);
+	BC_ASSERT_PTR_NULL(resultList);
+	if (resultList) bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+
+	_remove_friends_from_list(lfl, sFriends, sSizeFriend);
+
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
 static void search_friend_in_call_log(void) {
 	LinphoneMagicSearch *magicSearch = NULL;
 	bctbx_list_t *resultList = NULL;
@@ -1760,6 +2138,68 @@ static void search_friend_in_call_log(void) {
 	bctbx_free(zrtp_secrets_db_path);
 }
 
+static void search_friend_in_call_log_while_typing(void) {
+	LinphoneMagicSearch *magicSearch = NULL;
+	bctbx_list_t *resultList = NULL;
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	const char *chloeSipUri = {"sip:chloe@sip.example.org"};
+	const char *charlesSipUri = {"sip:charles@sip.test.org"};
+	const char *chrisSipUri = {"sip:chris@sip.test.org"};
+	LinphoneAddress *chloeAddress = linphone_address_new(chloeSipUri);
+	LinphoneAddress *charlesAddress = linphone_address_new(charlesSipUri);
+	LinphoneAddress *chrisAddress = linphone_address_new(chrisSipUri);
+	LinphoneAddress *ronanAddress = linphone_address_new("sip:ronan@sip.example.org");
+
+	_create_call_log(manager->lc, ronanAddress, chloeAddress, LinphoneCallOutgoing);
+	_create_call_log(manager->lc, ronanAddress, chloeAddress, LinphoneCallOutgoing);
+	_create_call_log(manager->lc, ronanAddress, charlesAddress, LinphoneCallOutgoing);
+	_create_call_log(manager->lc, ronanAddress, chloeAddress, LinphoneCallOutgoing);
+
+	magicSearch = linphone_magic_search_new(manager->lc);
+
+	// Each keystroke refines the filter.
+	const char *filters[] = {"c", "ch", "chl"};
+	const int expected[] = {2, 2, 1};
+	for (int i = 0; i < 3; i++) {
+		resultList = linphone_magic_search_get_contacts_list(magicSearch, filters[i], "",
+		                                                     LinphoneMagicSearchSourceCallLogs,
+		                                                     LinphoneMagicSearchAggregationNone);
+		if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+			BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), expected[i], int, "%d");
+			_check_friend_result_list(manager->lc, resultList, expected[i] - 1, chloeSipUri, NULL);
+			bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+		}
+	}
+
+	// The cache is reset automatically: a call log added after a search with an empty filter, which is a prefix of
+	// every filter, is found by the next search.
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "", "", LinphoneMagicSearchSourceCallLogs,
+	                                                     LinphoneMagicSearchAggregationNone);
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 2, int, "%d");
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+	_create_call_log(manager->lc, ronanAddress, chrisAddress, LinphoneCallOutgoing);
+
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "ch", "", LinphoneMagicSearchSourceCallLogs,
+	                                                     LinphoneMagicSearchAggregationNone);
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 3, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, charlesSipUri, NULL);
+		_check_friend_result_list(manager->lc, resultList, 1, chloeSipUri, NULL);
+		_check_friend_result_list(manager->lc, resultList, 2, chrisSipUri, NULL);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+
+	linphone_address_unref(chloeAddress);
+	linphone_address_unref(charlesAddress);
+	linphone_address_unref(chrisAddress);
+	linphone_address_unref(ronanAddress);
+
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
 static void search_friend_in_call_log_already_exist(void) {
 	LinphoneMagicSearch *magicSearch = NULL;
 	bctbx_list_t *resultList = NULL;
@@ -3709,6 +4149,8 @@ test_t setup_tests[] = {
     TEST_NO_TAG("Version check", linphone_version_test),
     TEST_NO_TAG("Version update check", linphone_version_update_test),
     TEST_NO_TAG("Linphone Address", linphone_address_test),
+    TEST_NO_TAG("Linphone Address cached forms", linphone_address_cached_forms_test),
+    TEST_NO_TAG("Linphone Buffer view", linphone_buffer_view_test),
     TEST_NO_TAG("Linphone proxy config address equal (internal api)", linphone_proxy_config_address_equal_test),
     TEST_NO_TAG("Linphone proxy config server address change (internal api)",
                 linphone_proxy_config_is_server_config_changed_test),
@@ -3727,6 +4169,10 @@ test_t setup_tests[] = {
     TEST_NO_TAG("LPConfig zero_len value from buffer", linphone_lpconfig_from_buffer_zerolen_value),
     TEST_NO_TAG("LPConfig zero_len value from file", linphone_lpconfig_from_file_zerolen_value),
     TEST_NO_TAG("LPConfig zero_len value from XML", linphone_lpconfig_from_xml_zerolen_value),
+    TEST_NO_TAG("LPConfig with many sections", linphone_lpconfig_many_sections),
+    TEST_NO_TAG("LPConfig snapshot cache", linphone_lpconfig_snapshot_cache),
+    TEST_NO_TAG("LPConfig background sync", linphone_lpconfig_background_sync),
+    TEST_NO_TAG("LPConfig dirty sections", linphone_lpconfig_dirty_sections),
     TEST_NO_TAG("LPConfig invalid friend", linphone_lpconfig_invalid_friend),
     TEST_NO_TAG("LPConfig invalid friend remote provisoning", linphone_lpconfig_invalid_friend_remote_provisioning),
     TEST_NO_TAG("Chat room", chat_room_test),
@@ -3747,8 +4193,11 @@ test_t setup_tests[] = {
         "Multiple looking for friends with cache resetting", search_friend_research_estate_reset, "MagicSearch"),
     TEST_ONE_TAG("Search friend with phone number", search_friend_with_phone_number, "MagicSearch"),
     TEST_NO_TAG("Search friend with phone number 2", search_friend_with_phone_number_2),
+    TEST_NO_TAG("Find friend by phone number after edition", find_friend_by_phone_number_after_edition),
     TEST_ONE_TAG("Search friend and find it with its presence", search_friend_with_presence, "MagicSearch"),
+    TEST_ONE_TAG("Search friend after edition", search_friend_after_edition, "MagicSearch"),
     TEST_ONE_TAG("Search friend in call log", search_friend_in_call_log, "MagicSearch"),
+    TEST_ONE_TAG("Search friend in call log while typing", search_friend_in_call_log_while_typing, "MagicSearch"),
     TEST_ONE_TAG("Search friend in call log but don't add address which already exist",
                  search_friend_in_call_log_already_exist,
                  "MagicSearch"),
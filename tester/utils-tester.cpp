@@ -18,9 +18,14 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
 #include "bctoolbox/utils.hh"
 
 #include "address/address.h"
+#include "chat/modifier/file-transfer-chat-message-modifier.h"
 #include "conference/conference-id.h"
 #include "liblinphone_tester.h"
 #include "linphone/utils/utils.h"
@@ -139,6 +144,34 @@ static void conferenceId_comparisons(void) {
 	BC_ASSERT_FALSE(c7 == c5);
 }
 
+static void address_hashes(void) {
+	Address a("sip:Marie@sip.example.org");
+	Address b("\"Marie\" <sip:Marie@SIP.Example.org>");
+	BC_ASSERT_TRUE(a == b);
+	BC_ASSERT_EQUAL(a.getHash(), b.getHash(), size_t, "%zu");
+
+	unordered_set<Address> addresses = {a};
+	BC_ASSERT_TRUE(addresses.find(b) != addresses.end());
+	BC_ASSERT_TRUE(addresses.find(Address("sip:marie@sip.example.org")) == addresses.end());
+
+	// The cached forms of a shared address are computed concurrently.
+	const Address shared("sip:pauline@sip.example.org;transport=tcp");
+	const size_t expectedHash = Address(shared).getHash();
+	const string expectedUri = Address(shared).asStringUriOnly();
+	vector<thread> threads;
+	atomic<int> mismatches{0};
+	for (int i = 0; i < 4; i++) {
+		threads.emplace_back([&]() {
+			if (shared.getHash() != expectedHash || shared.asStringUriOnly() != expectedUri ||
+			    shared.toStringOrdered().empty())
+				mismatches++;
+		});
+	}
+	for (auto &t : threads)
+		t.join();
+	BC_ASSERT_EQUAL(mismatches.load(), 0, int, "%d");
+}
+
 static void parse_capabilities(void) {
 	auto caps = Utils::parseCapabilityDescriptor("groupchat,lime,ephemeral");
 	BC_ASSERT_TRUE(caps.find("groupchat") != caps.end());
@@ -151,14 +184,55 @@ static void parse_capabilities(void) {
 	BC_ASSERT_TRUE(caps["ephemeral"] == Version(1, 0));
 }
 
+static bool continuesPartialDownload(const char *rawResponse, size_t offset) {
+	belle_sip_message_t *response = belle_sip_message_parse(rawResponse);
+	BC_ASSERT_PTR_NOT_NULL(response);
+	if (!response) return false;
+	bool result = FileTransferChatMessageModifier::continuesPartialDownload(BELLE_HTTP_RESPONSE(response), offset);
+	belle_sip_object_unref(response);
+	return result;
+}
+
+static void resumed_download_responses(void) {
+	// Honored Range request.
+	BC_ASSERT_TRUE(continuesPartialDownload("HTTP/1.1 206 Partial Content\r\n"
+	                                        "Content-Range: bytes 100-199/200\r\n"
+	                                        "Content-Length: 100\r\n\r\n",
+	                                        100));
+
+	// Whole file sent again.
+	BC_ASSERT_FALSE(continuesPartialDownload("HTTP/1.1 200 OK\r\n"
+	                                         "Content-Length: 200\r\n\r\n",
+	                                         100));
+	// Range not starting at the end of the partial file.
+	BC_ASSERT_FALSE(continuesPartialDownload("HTTP/1.1 206 Partial Content\r\n"
+	                                         "Content-Range: bytes 50-199/200\r\n"
+	                                         "Content-Length: 150\r\n\r\n",
+	                                         100));
+	// Unknown length of the remainder.
+	BC_ASSERT_FALSE(continuesPartialDownload("HTTP/1.1 206 Partial Content\r\n"
+	                                         "Content-Range: bytes 100-199/200\r\n\r\n",
+	                                         100));
+	BC_ASSERT_FALSE(continuesPartialDownload("HTTP/1.1 206 Partial Content\r\n"
+	                                         "Content-Range: bytes 100-199/200\r\n"
+	                                         "Content-Length: 50\r\n\r\n",
+	                                         100));
+	// No range at all.
+	BC_ASSERT_FALSE(continuesPartialDownload("HTTP/1.1 206 Partial Content\r\n"
+	                                         "Content-Length: 100\r\n\r\n",
+	                                         100));
+}
+
 // clang-format off
 test_t utils_tests[] = {
     TEST_NO_TAG("split", split),
     TEST_NO_TAG("trim", trim),
     TEST_NO_TAG("Version comparisons", version_comparisons),
     TEST_NO_TAG("Address comparisons", address_comparisons),
+    TEST_NO_TAG("Address hashes", address_hashes),
     TEST_NO_TAG("Conference ID comparisons", conferenceId_comparisons),
-    TEST_NO_TAG("Parse capabilities", parse_capabilities)
+    TEST_NO_TAG("Parse capabilities", parse_capabilities),
+    TEST_NO_TAG("Resumed download responses", resumed_download_responses)
 };
 // clang-format on
 
@@ -92,6 +92,7 @@ static void register_user(const uint16_t encryptionModule, const char *random_id
 	marie = linphone_core_manager_create_local(createUsers ? "marie_rc" : NULL, localRc, linphone_db, lime_db,
 	                                           zrtp_secrets_db);
 	set_lime_server_and_curve(25519, marie);
+	linphone_config_set_bool(linphone_core_get_config(marie->lc), "storage", "wal_enabled", TRUE);
 	linphone_core_manager_start(marie, TRUE);
 
 	// check it registers ok and lime user is created
@@ -127,6 +128,14 @@ static void register_user(const uint16_t encryptionModule, const char *random_id
 		BC_ASSERT_TRUE(is_filepath_encrypted(localRc));
 	}
 
+	// The write-ahead log of the linphone db is merged back at closing, and its index is only kept in memory.
+	auto linphone_db_wal = bctbx_strdup_printf("%s-wal", linphone_db);
+	auto linphone_db_shm = bctbx_strdup_printf("%s-shm", linphone_db);
+	BC_ASSERT_NOT_EQUAL(bctbx_file_exist(linphone_db_wal), 0, int, "%d");
+	BC_ASSERT_NOT_EQUAL(bctbx_file_exist(linphone_db_shm), 0, int, "%d");
+	bctbx_free(linphone_db_wal);
+	bctbx_free(linphone_db_shm);
+
 	if (createUsers == false) {
 		unlink(localRc);
 		unlink(linphone_db);